@@ -75,6 +75,7 @@ float exMag    = 0.0f, eyMag    = 0.0f, ezMag    = 0.0f; // mag error
 float exMagInt = 0.0f, eyMagInt = 0.0f, ezMagInt = 0.0f; // mag integral error
 
 float kpAcc, kiAcc;
+float kpMag;
 
 float qMeas[4] = { 1.0f, 0.0f, 0.0f, 0.0f };
 
@@ -171,7 +172,8 @@ void MargAHRSinit(float ax, float ay, float az, float mx, float my, float mz)
 void MargAHRSupdate(float gx, float gy, float gz,
                     float ax, float ay, float az,
                     float mx, float my, float mz,
-                    uint8_t magDataUpdate, float dt)
+                    uint8_t magDataUpdate, float magDt,
+                    float dt)
 {
     float norm, normR;
     float hx, hy, hz, bx, bz;
@@ -254,12 +256,13 @@ void MargAHRSupdate(float gx, float gy, float gz,
             eyMag = mz * wx - mx * wz;
             ezMag = mx * wy - my * wx;
 
-			// use un-extrapolated old values between magnetometer updates
-			// dubious as dT does not apply to the magnetometer calculation so
-			// time scaling is embedded in KpMag and KiMag
-			gx += exMag * eepromConfig.KpMag;
-			gy += eyMag * eepromConfig.KpMag;
-			gz += ezMag * eepromConfig.KpMag;
+			// applied once per magnetometer sample, scaled by the time since the
+			// previous sample so KpMag (1/sec) is independent of the mag rate
+			kpMag = eepromConfig.KpMag * magDt / dt;
+
+			gx += exMag * kpMag;
+			gy += eyMag * kpMag;
+			gz += ezMag * kpMag;
         }
 
         //-------------------------------------------
@@ -62,7 +62,8 @@ extern float q3q3;
 void MargAHRSupdate(float gx, float gy, float gz,
                     float ax, float ay, float az,
                     float mx, float my, float mz,
-                    uint8_t magDataUpdate, float dt);
+                    uint8_t magDataUpdate, float magDt,
+                    float dt);
 
 //=====================================================================================================
 // End of file
@@ -0,0 +1,301 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Autotune Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+// Relay feedback (Astrom-Hagglund).  The PID output of the axis under test
+// is replaced by +/- relay amplitude switched on the sign of the error, with
+// hysteresis.  The resulting limit cycle gives the ultimate gain
+// Ku = 4 * d / (pi * a) and ultimate period Tu, from which candidate gains
+// are computed.  The axes of the selected loop are tuned in turn.
+
+#define AUTOTUNE_RATE_RELAY         100.0f  // Motor command counts
+#define AUTOTUNE_RATE_HYSTERESIS      0.05f // rad/sec
+
+#define AUTOTUNE_ATTITUDE_RELAY       1.0f  // rad/sec rate command
+#define AUTOTUNE_ATTITUDE_HYSTERESIS  0.02f // rad
+
+#define AUTOTUNE_SETTLE_CYCLES        2
+#define AUTOTUNE_MEASURE_CYCLES       5
+
+#define AUTOTUNE_AXIS_TIMEOUT        10.0f  // sec
+
+uint8_t   autoTuneActive = false;
+uint8_t   autoTuneLoop;
+uint8_t   autoTuneAxis;
+
+PIDdata_t autoTuneGains[NUMBER_OF_PIDS];
+uint8_t   autoTuneValid[NUMBER_OF_PIDS];
+float     autoTuneKu[NUMBER_OF_PIDS];
+float     autoTuneTu[NUMBER_OF_PIDS];
+
+static float   relayAmplitude;
+static float   relayHysteresis;
+static float   relayOutput;
+
+static uint8_t cycles;
+static float   cycleTime;
+static float   axisTime;
+static float   errorMax;
+static float   errorMin;
+static float   periodSum;
+static float   amplitudeSum;
+
+///////////////////////////////////////////////////////////////////////////////
+// Autotune PID Index
+///////////////////////////////////////////////////////////////////////////////
+
+static uint8_t autoTunePid(void)
+{
+	if (autoTuneLoop == AUTOTUNE_RATE)
+		return ROLL_RATE_PID + autoTuneAxis;
+	else
+		return ROLL_ATT_PID  + autoTuneAxis;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Autotune Axis Start
+///////////////////////////////////////////////////////////////////////////////
+
+static void autoTuneAxisStart(void)
+{
+	relayOutput  = 1.0f;
+	cycles       = 0;
+	cycleTime    = 0.0f;
+	axisTime     = 0.0f;
+	errorMax     = 0.0f;
+	errorMin     = 0.0f;
+	periodSum    = 0.0f;
+	amplitudeSum = 0.0f;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Autotune Axis Complete
+///////////////////////////////////////////////////////////////////////////////
+
+static void autoTuneAxisComplete(uint8_t valid)
+{
+	uint8_t pid = autoTunePid();
+	float   a, ku, tu;
+
+	autoTuneValid[pid] = false;
+
+	if (valid == true)
+	{
+		a  = amplitudeSum / AUTOTUNE_MEASURE_CYCLES;
+		a  = sqrt(fabs(a * a - relayHysteresis * relayHysteresis)) + 1.0e-6f;
+
+		ku = 4.0f * relayAmplitude / (PI * a);
+		tu = periodSum / AUTOTUNE_MEASURE_CYCLES;
+
+		autoTuneKu[pid] = ku;
+		autoTuneTu[pid] = tu;
+
+		if (autoTuneLoop == AUTOTUNE_RATE)
+		{
+			// Ziegler-Nichols PID, Kp = 0.6 Ku, Ti = Tu / 2, Td = Tu / 8
+
+			autoTuneGains[pid].P = 0.6f   * ku;
+			autoTuneGains[pid].I = 1.2f   * ku / tu;
+			autoTuneGains[pid].D = 0.075f * ku * tu;
+		}
+		else
+		{
+			// Proportional only, as flown, Kp = 0.5 Ku
+
+			autoTuneGains[pid].P = 0.5f * ku;
+			autoTuneGains[pid].I = 0.0f;
+			autoTuneGains[pid].D = 0.0f;
+		}
+
+		autoTuneGains[pid].N = eepromConfig.PID[pid].N;
+
+		autoTuneValid[pid] = true;
+	}
+
+	setPIDstates(pid, 0.0f);
+
+	autoTuneAxis++;
+
+	if ( ((autoTuneLoop == AUTOTUNE_RATE)     && (autoTuneAxis > YAW  )) ||
+		 ((autoTuneLoop == AUTOTUNE_ATTITUDE) && (autoTuneAxis > PITCH)) )
+		autoTuneActive = false;
+	else
+		autoTuneAxisStart();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Autotune Start
+///////////////////////////////////////////////////////////////////////////////
+
+void autoTuneStart(uint8_t loop)
+{
+	autoTuneLoop = loop;
+	autoTuneAxis = ROLL;
+
+	if (loop == AUTOTUNE_RATE)
+	{
+		relayAmplitude  = AUTOTUNE_RATE_RELAY;
+		relayHysteresis = AUTOTUNE_RATE_HYSTERESIS;
+	}
+	else
+	{
+		relayAmplitude  = AUTOTUNE_ATTITUDE_RELAY;
+		relayHysteresis = AUTOTUNE_ATTITUDE_HYSTERESIS;
+	}
+
+	autoTuneAxisStart();
+
+	autoTuneActive = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Autotune Stop
+///////////////////////////////////////////////////////////////////////////////
+
+void autoTuneStop(void)
+{
+	if (autoTuneActive == true)
+	{
+		autoTuneActive = false;
+		setPIDstates(autoTunePid(), 0.0f);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Autotune Relay
+///////////////////////////////////////////////////////////////////////////////
+
+// Called in place of the PID of the axis under test with that PID's error,
+// returns the relay output.
+
+float autoTuneRelay(float error, float dt)
+{
+	float output = relayOutput * relayAmplitude;
+
+	axisTime  += dt;
+	cycleTime += dt;
+
+	if (error > errorMax) errorMax = error;
+	if (error < errorMin) errorMin = error;
+
+	if ((relayOutput < 0.0f) && (error > relayHysteresis))
+	{
+		// Switch to positive output, one full cycle since the last one
+
+		relayOutput = 1.0f;
+
+		if (cycles >= AUTOTUNE_SETTLE_CYCLES)
+		{
+			periodSum    += cycleTime;
+			amplitudeSum += (errorMax - errorMin) * 0.5f;
+		}
+
+		cycles++;
+
+		cycleTime = 0.0f;
+		errorMax  = error;
+		errorMin  = error;
+
+		if (cycles >= (AUTOTUNE_SETTLE_CYCLES + AUTOTUNE_MEASURE_CYCLES))
+			autoTuneAxisComplete(true);
+	}
+	else if ((relayOutput > 0.0f) && (error < -relayHysteresis))
+	{
+		relayOutput = -1.0f;
+	}
+
+	if ((autoTuneActive == true) && (axisTime > AUTOTUNE_AXIS_TIMEOUT))
+		autoTuneAxisComplete(false);
+
+	return output;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Autotune Apply Gains
+///////////////////////////////////////////////////////////////////////////////
+
+// Copies valid candidates into the RAM copy of eepromConfig only, write
+// EEPROM separately to keep them.
+
+void autoTuneApplyGains(void)
+{
+	uint8_t pid;
+
+	for (pid = 0; pid < NUMBER_OF_PIDS; pid++)
+	{
+		if (autoTuneValid[pid] == true)
+		{
+			eepromConfig.PID[pid] = autoTuneGains[pid];
+			setPIDstates(pid, 0.0f);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Autotune Report
+///////////////////////////////////////////////////////////////////////////////
+
+void autoTuneReport(void)
+{
+	uint8_t pid;
+
+	const char *pidNames[5] = { "Roll Rate ", "Pitch Rate", "Yaw Rate  ",
+			                    "Roll Att  ", "Pitch Att " };
+
+	cliPortPrint("\nAutotune Candidate Gains:\n\n");
+	cliPortPrint("              Ku        Tu        P         I         D\n");
+
+	for (pid = ROLL_RATE_PID; pid <= PITCH_ATT_PID; pid++)
+	{
+		if (autoTuneValid[pid] == true)
+			cliPortPrintF("%s  %8.3f  %8.4f  %8.4f  %8.4f  %8.4f\n", pidNames[pid],
+					                                                 autoTuneKu[pid],
+					                                                 autoTuneTu[pid],
+					                                                 autoTuneGains[pid].P,
+					                                                 autoTuneGains[pid].I,
+					                                                 autoTuneGains[pid].D);
+		else
+			cliPortPrintF("%s  Not Tuned\n", pidNames[pid]);
+	}
+
+	if (autoTuneActive == true)
+		cliPortPrintF("\nAutotune in progress, %s loop, axis %1d....\n", (autoTuneLoop == AUTOTUNE_RATE) ? "rate" : "attitude", autoTuneAxis);
+
+	cliPortPrint("\n");
+}
+
+///////////////////////////////////////////////////////////////////////////////
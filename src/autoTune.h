@@ -0,0 +1,80 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Autotune Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+enum { AUTOTUNE_RATE, AUTOTUNE_ATTITUDE };
+
+extern uint8_t   autoTuneActive;
+extern uint8_t   autoTuneLoop;
+extern uint8_t   autoTuneAxis;
+
+extern PIDdata_t autoTuneGains[NUMBER_OF_PIDS];
+extern uint8_t   autoTuneValid[NUMBER_OF_PIDS];
+extern float     autoTuneKu[NUMBER_OF_PIDS];
+extern float     autoTuneTu[NUMBER_OF_PIDS];
+
+///////////////////////////////////////////////////////////////////////////////
+// Autotune Start
+///////////////////////////////////////////////////////////////////////////////
+
+void autoTuneStart(uint8_t loop);
+
+///////////////////////////////////////////////////////////////////////////////
+// Autotune Stop
+///////////////////////////////////////////////////////////////////////////////
+
+void autoTuneStop(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Autotune Relay
+///////////////////////////////////////////////////////////////////////////////
+
+float autoTuneRelay(float error, float dt);
+
+///////////////////////////////////////////////////////////////////////////////
+// Autotune Apply Gains
+///////////////////////////////////////////////////////////////////////////////
+
+void autoTuneApplyGains(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Autotune Report
+///////////////////////////////////////////////////////////////////////////////
+
+void autoTuneReport(void);
+
+///////////////////////////////////////////////////////////////////////////////
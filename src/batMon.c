@@ -31,6 +31,9 @@ uint8_t batteryNumCells = 3;
 
 float   batteryVoltage;
 
+float   voltageCompensation        = 1.0f;
+float   voltageCompensationInverse = 1.0f;
+
 void batMonLow(void);
 void batMonVeryLow(void);
 void batMonMaxLow(void);
@@ -46,6 +49,10 @@ static const float alpha = 1.0f / ( 1.0f + 0.1f );
 static float v_bat_ave   = 0.0f;
 static int thresholdCount[thresholdsNUM]; /* Will be inited to zero */
 
+/* Voltage compensation filter, 2 second time constant at 10Hz. */
+static const float compensationAlpha = 0.1f / (2.0f + 0.1f);
+static float v_comp_ave = 0.0f;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void measureBattery(void)
@@ -38,6 +38,9 @@ extern uint8_t batteryNumCells;
 
 extern float   batteryVoltage;
 
+extern float   voltageCompensation;
+extern float   voltageCompensationInverse;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void batMonTick(void);
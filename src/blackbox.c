@@ -0,0 +1,413 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Blackbox Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+// While armed, every blackboxDivider 500 Hz cycles the flight recorder
+// values go to the SPI flash as a frame.  Every BLACKBOX_I_INTERVAL frames
+// an I frame holds absolute values, the P frames between hold the error of
+// a prediction from the two frames before.  Values are zigzag mapped, so
+// small numbers of either sign stay small, then written as varints, 7 bits
+// a byte, low bits first, the top bit set on all but the last byte.
+//
+//   I frame  'I', time (varint), values (zigzag varints)
+//   P frame  'P', time less the last frame time and the period (zigzag
+//            varint), a bit per group whose values all met their
+//            predictions (varint), then for the other groups the values
+//            less their predictions (zigzag varints)
+//   End      'E', frames dropped (varint)
+//
+// A log starts on a fresh page with a header, "FFBB", version, group count,
+// I frame interval (uint8), frame period in uSec (uint16), start time
+// (uint32), then per group the value count (uint8), scale (float) and
+// predictor (uint8).  A frame the flash queue can't take is dropped whole
+// and an I frame follows, a log that loses power before its end marker
+// still decodes up to the last page written.
+
+#define BLACKBOX_VERSION      1
+
+#define BLACKBOX_I_INTERVAL   32
+#define BLACKBOX_BASE_PERIOD  2000  // uSec, 500 Hz
+
+#define BLACKBOX_HEADER       (13 + RECORDER_GROUPS * 6)
+#define BLACKBOX_FRAME_MAX    (1 + 5 + 2 + RECORDER_FIELDS * 3)  // Prediction errors fit 3 varint bytes
+#define BLACKBOX_END_MAX      (1 + 5)
+#define BLACKBOX_RAW_FRAME    (4 + RECORDER_FIELDS * 2)
+
+enum { BLACKBOX_PREDICT_PREVIOUS, BLACKBOX_PREDICT_LINEAR, BLACKBOX_PREDICT_AVERAGE };
+
+// Noisy measurements are best predicted by the mean of the last two frames,
+// smooth ones by the line through them, stepped commands by the last frame.
+
+static const uint8_t blackboxPredictor[RECORDER_GROUPS] =
+{
+    BLACKBOX_PREDICT_AVERAGE,   // Gyro
+    BLACKBOX_PREDICT_AVERAGE,   // Accel
+    BLACKBOX_PREDICT_LINEAR,    // Attitude
+    BLACKBOX_PREDICT_PREVIOUS,  // Rate command
+    BLACKBOX_PREDICT_AVERAGE,   // Rate PID
+    BLACKBOX_PREDICT_AVERAGE,   // Motor
+    BLACKBOX_PREDICT_PREVIOUS,  // Receiver command
+};
+
+blackboxStateType blackboxState;
+
+static int16_t  blackboxHistory[2][RECORDER_FIELDS];  // Last frame, and the one before it
+static uint32_t blackboxLastTime;
+static uint32_t blackboxStartTime;
+static uint32_t blackboxPeriod;
+static uint8_t  blackboxDivider;
+static uint8_t  blackboxDividerCount;
+static uint8_t  blackboxFrameIndex;                   // 0 sends an I frame
+static uint8_t  blackboxWasArmed = false;
+
+///////////////////////////////////////////////////////////////////////////////
+// Blackbox Varints
+///////////////////////////////////////////////////////////////////////////////
+
+static uint8_t *blackboxWriteUnsigned(uint8_t *out, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        *out++ = (uint8_t)value | 0x80;
+        value >>= 7;
+    }
+
+    *out++ = (uint8_t)value;
+
+    return out;
+}
+
+///////////////////////////////////////
+
+static uint8_t *blackboxWriteSigned(uint8_t *out, int32_t value)
+{
+    return blackboxWriteUnsigned(out, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));  // Zigzag
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Blackbox Encode Frame
+///////////////////////////////////////////////////////////////////////////////
+
+static uint8_t blackboxEncodeFrame(const int16_t *sample, uint32_t time, uint8_t *frame)
+{
+    const int16_t *last   = blackboxHistory[0];
+    const int16_t *before = blackboxHistory[1];
+
+    uint8_t *out       = frame;
+    uint8_t  field     = 0;
+    uint32_t predicted = (1 << RECORDER_GROUPS) - 1;  // Groups with no prediction error
+    uint8_t  groupIndex;
+    uint8_t  index;
+    int32_t  prediction;
+    int32_t  error[RECORDER_FIELDS];
+
+    if (blackboxFrameIndex == 0)
+    {
+        *out++ = 'I';
+        out = blackboxWriteUnsigned(out, time);
+
+        for (field = 0; field < RECORDER_FIELDS; field++)
+            out = blackboxWriteSigned(out, sample[field]);
+    }
+    else
+    {
+        for (groupIndex = 0; groupIndex < RECORDER_GROUPS; groupIndex++)
+        {
+            for (index = 0; index < recorderGroups[groupIndex].count; index++)
+            {
+                switch (blackboxPredictor[groupIndex])
+                {
+                    case BLACKBOX_PREDICT_LINEAR:
+                        prediction = 2 * (int32_t)last[field] - before[field];
+                        break;
+
+                    case BLACKBOX_PREDICT_AVERAGE:
+                        prediction = ((int32_t)last[field] + before[field]) / 2;
+                        break;
+
+                    default:
+                        prediction = last[field];
+                        break;
+                }
+
+                error[field] = sample[field] - prediction;
+
+                if (error[field] != 0)
+                    predicted &= ~(1 << groupIndex);
+
+                field++;
+            }
+        }
+
+        *out++ = 'P';
+        out = blackboxWriteSigned(out, (int32_t)(time - blackboxLastTime - blackboxPeriod));
+        out = blackboxWriteUnsigned(out, predicted);
+
+        field = 0;
+
+        for (groupIndex = 0; groupIndex < RECORDER_GROUPS; groupIndex++)
+        {
+            for (index = 0; index < recorderGroups[groupIndex].count; index++)
+            {
+                if ((predicted & (1 << groupIndex)) == 0)
+                    out = blackboxWriteSigned(out, error[field]);
+
+                field++;
+            }
+        }
+    }
+
+    return out - frame;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Blackbox Start
+///////////////////////////////////////////////////////////////////////////////
+
+static void blackboxStart(void)
+{
+    uint8_t  header[BLACKBOX_HEADER];
+    uint8_t  length = 0;
+    uint8_t  groupIndex;
+    uint16_t period;
+
+    if ((eepromConfig.blackboxEnabled == false) || (spiFlashPresent == false))
+        return;
+
+    if (spiFlashFree() < (BLACKBOX_HEADER + BLACKBOX_FRAME_MAX + BLACKBOX_END_MAX))
+    {
+        blackboxState.state = BLACKBOX_FULL;
+        return;
+    }
+
+    blackboxStatsReset();
+    spiFlashStatsReset();
+
+    blackboxDivider      = eepromConfig.blackboxDivider;
+    blackboxDividerCount = blackboxDivider - 1;  // First frame this cycle
+    blackboxPeriod       = (uint32_t)BLACKBOX_BASE_PERIOD * blackboxDivider;
+    blackboxFrameIndex   = 0;
+    blackboxStartTime    = micros();
+
+    period = (uint16_t)blackboxPeriod;
+
+    memcpy(&header[length], "FFBB", 4);
+    length += 4;
+
+    header[length++] = BLACKBOX_VERSION;
+    header[length++] = RECORDER_GROUPS;
+    header[length++] = BLACKBOX_I_INTERVAL;
+
+    memcpy(&header[length], &period, 2);
+    length += 2;
+
+    memcpy(&header[length], &blackboxStartTime, 4);
+    length += 4;
+
+    for (groupIndex = 0; groupIndex < RECORDER_GROUPS; groupIndex++)
+    {
+        header[length++] = recorderGroups[groupIndex].count;
+        memcpy(&header[length], &recorderGroups[groupIndex].scale, 4);
+        length += 4;
+        header[length++] = blackboxPredictor[groupIndex];
+    }
+
+    spiFlashFlush();  // Logs start on a fresh page
+
+    if (spiFlashWrite(header, length) == true)
+        blackboxState.state = BLACKBOX_LOGGING;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Blackbox Stop
+///////////////////////////////////////////////////////////////////////////////
+
+static void blackboxStop(uint8_t state)
+{
+    uint8_t end[BLACKBOX_END_MAX];
+    uint8_t length;
+
+    end[0] = 'E';
+    length = blackboxWriteUnsigned(&end[1], blackboxState.dropCnt) - end;
+
+    spiFlashWrite(end, length);
+    spiFlashFlush();
+
+    blackboxState.state = state;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Blackbox Initialization
+///////////////////////////////////////////////////////////////////////////////
+
+void blackboxInit(void)
+{
+    memset(&blackboxState, 0, sizeof(blackboxState));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Blackbox Update
+//
+// Called every 500 Hz cycle after the mixer, armed or not.
+///////////////////////////////////////////////////////////////////////////////
+
+void blackboxUpdate(void)
+{
+    uint32_t startCycles = *DWT_CYCCNT;
+    int16_t  sample[RECORDER_FIELDS];
+    uint8_t  frame[BLACKBOX_FRAME_MAX];
+    uint8_t  length;
+    uint32_t time;
+
+    if ((armed == true) && (blackboxWasArmed == false))
+        blackboxStart();
+
+    if ((armed == false) && (blackboxWasArmed == true) && (blackboxState.state == BLACKBOX_LOGGING))
+        blackboxStop(BLACKBOX_IDLE);
+
+    blackboxWasArmed = armed;
+
+    if (blackboxState.state != BLACKBOX_LOGGING)
+        return;
+
+    if (++blackboxDividerCount < blackboxDivider)
+        return;
+
+    blackboxDividerCount = 0;
+
+    if (spiFlashFree() < (BLACKBOX_FRAME_MAX + BLACKBOX_END_MAX))
+    {
+        blackboxStop(BLACKBOX_FULL);
+        return;
+    }
+
+    time = micros();
+
+    flightRecorderSample(sample);
+
+    length = blackboxEncodeFrame(sample, time, frame);
+
+    if (spiFlashWrite(frame, length) == true)
+    {
+        if (blackboxFrameIndex == 0)
+        {
+            blackboxState.iFrameCnt++;
+            memcpy(blackboxHistory[1], sample, sizeof(blackboxHistory[1]));
+        }
+        else
+        {
+            blackboxState.pFrameCnt++;
+            memcpy(blackboxHistory[1], blackboxHistory[0], sizeof(blackboxHistory[1]));
+        }
+
+        memcpy(blackboxHistory[0], sample, sizeof(blackboxHistory[0]));
+
+        blackboxState.logBytes += length;
+        blackboxState.rawBytes += BLACKBOX_RAW_FRAME;
+        blackboxState.logTime   = time - blackboxStartTime;
+
+        blackboxLastTime   = time;
+        blackboxFrameIndex = (blackboxFrameIndex + 1) % BLACKBOX_I_INTERVAL;
+    }
+    else
+    {
+        blackboxState.dropCnt++;
+        blackboxFrameIndex = 0;  // The decoder lost its history
+    }
+
+    blackboxState.cyclesLast   = *DWT_CYCCNT - startCycles;
+    blackboxState.cyclesTotal += blackboxState.cyclesLast;
+
+    if (blackboxState.cyclesLast > blackboxState.cyclesMax)
+        blackboxState.cyclesMax = blackboxState.cyclesLast;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Blackbox Download
+//
+// Binary, "FFBD" and the byte count (uint32), then the flash from the start
+// to the end of the last log.  Paced to the 115200 baud CLI port, a full
+// 2 MByte chip takes a little over 3 minutes.  tools/blackboxDecode.c makes
+// CSV of it.
+///////////////////////////////////////////////////////////////////////////////
+
+void blackboxDownload(void)
+{
+    uint8_t  buffer[128];
+    uint32_t used;
+    uint32_t address;
+    uint16_t length;
+
+    spiFlashFlush();
+
+    used = spiFlashUsed();
+
+    memcpy(&buffer[0], "FFBD", 4);
+    memcpy(&buffer[4], &used,  4);
+
+    cliPortPrintBinary(buffer, 8);
+
+    for (address = 0; address < used; address += length)
+    {
+        length = ((used - address) < sizeof(buffer)) ? (used - address) : sizeof(buffer);
+
+        spiFlashRead(address, buffer, length);
+
+        delay(12);  // 128 bytes take 11 mSec at 115200 baud
+        cliPortPrintBinary(buffer, length);
+    }
+
+    delay(12);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Blackbox Stats Reset
+///////////////////////////////////////////////////////////////////////////////
+
+void blackboxStatsReset(void)
+{
+    blackboxState.iFrameCnt   = 0;
+    blackboxState.pFrameCnt   = 0;
+    blackboxState.dropCnt     = 0;
+    blackboxState.logBytes    = 0;
+    blackboxState.rawBytes    = 0;
+    blackboxState.logTime     = 0;
+    blackboxState.cyclesLast  = 0;
+    blackboxState.cyclesMax   = 0;
+    blackboxState.cyclesTotal = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
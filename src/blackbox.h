@@ -0,0 +1,80 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Blackbox Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+enum { BLACKBOX_IDLE, BLACKBOX_LOGGING, BLACKBOX_FULL };
+
+typedef struct blackboxStateType
+{
+    uint8_t  state;
+    uint32_t iFrameCnt;
+    uint32_t pFrameCnt;
+    uint32_t dropCnt;      // Frames the flash queue couldn't take
+    uint32_t logBytes;     // Frame bytes written
+    uint32_t rawBytes;     // What the same frames take as a time and int16 fields
+    uint32_t logTime;      // uSec spanned by the logged frames
+    uint32_t cyclesLast;   // Cost of the last frame
+    uint32_t cyclesMax;
+    uint32_t cyclesTotal;
+} blackboxStateType;
+
+extern blackboxStateType blackboxState;
+
+///////////////////////////////////////////////////////////////////////////////
+// Blackbox Initialization
+///////////////////////////////////////////////////////////////////////////////
+
+void blackboxInit(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Blackbox Update
+///////////////////////////////////////////////////////////////////////////////
+
+void blackboxUpdate(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Blackbox Download
+///////////////////////////////////////////////////////////////////////////////
+
+void blackboxDownload(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Blackbox Stats Reset
+///////////////////////////////////////////////////////////////////////////////
+
+void blackboxStatsReset(void);
+
+///////////////////////////////////////////////////////////////////////////////
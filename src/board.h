@@ -46,6 +46,8 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 #include "stm32f10x.h"
 #include "stm32f10x_conf.h"
 
+#define MAVLINK_COMM_NUM_BUFFERS 1  // UART1 only, each receive buffer is a whole message of RAM
+
 #include "mavlink.h"
 
 ///////////////////////////////////////
@@ -56,18 +58,24 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 #include "drv_adc.h"
 #include "drv_crc.h"
+#include "drv_dshot.h"
 #include "drv_gpio.h"
 #include "drv_i2c.h"
 #include "drv_ppmRx.h"
 #include "drv_pwmEsc.h"
 #include "drv_pwmServo.h"
+#include "drv_rxCommon.h"
+#include "drv_sbus.h"
+#include "drv_softSerial.h"
 #include "drv_spektrum.h"
+#include "drv_spiFlash.h"
 #include "drv_system.h"
 #include "drv_uart1.h"
 
 #include "sensorCommon.h"
 
 #include "adxl345.h"
+#include "baroManager.h"
 #include "bmp085.h"
 #include "hmc5883.h"
 #include "mpu3050.h"
@@ -76,7 +84,10 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 #include "accelCalibrationADXL345.h"
 #include "accelCalibrationMPU.h"
+#include "autoTune.h"
 #include "batMon.h"
+#include "blackbox.h"
+#include "calibration.h"
 #include "cli.h"
 #include "computeAxisCommands.h"
 #include "config.h"
@@ -85,12 +96,17 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 #include "evr.h"
 #include "firstOrderFilter.h"
 #include "flightCommand.h"
+#include "flightRecorder.h"
+#include "gainSchedule.h"
 #include "magCalibration.h"
 #include "mavlinkStrings.h"
 #include "MargAHRS.h"
 #include "mixer.h"
 #include "mpu3050Calibration.h"
 #include "mpu6050Calibration.h"
+#include "rcInterpolation.h"
+#include "sysId.h"
+#include "telemetry.h"
 #include "utilities.h"
 #include "vertCompFilter.h"
 #include "watchdogs.h"
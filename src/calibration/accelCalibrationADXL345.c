@@ -32,137 +32,108 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 #include "board.h"
 
 ///////////////////////////////////////////////////////////////////////////////
-// Accelerometer Calibration
+// Accelerometer Calibration Defines and Variables
 ///////////////////////////////////////////////////////////////////////////////
 
-void accelCalibrationADXL345(void)
-{
-    float noseUp        = 0.0f;
-    float noseDown      = 0.0f;
-    float leftWingDown  = 0.0f;
-    float rightWingDown = 0.0f;
-    float upSideDown    = 0.0f;
-    float rightSideUp   = 0.0f;
-
-    int16_t index;
+#define ACCEL_CALIBRATION_SAMPLES 2500  // 5 seconds of data at 500 Hz
 
-    cliPortPrint("\nAccelerometer Calibration:\n\n");
+static const char *orientationPrompt[6] = { "Place accelerometer right side up\n",
+		                                    "Place accelerometer up side down\n",
+		                                    "Place accelerometer left edge down\n",
+		                                    "Place accelerometer right edge down\n",
+		                                    "Place accelerometer rear edge down\n",
+		                                    "Place accelerometer front edge down\n" };
 
-    ///////////////////////////////////
-
-    cliPortPrint("Place accelerometer right side up\n");
-    cliPortPrint("  Send a character when ready to proceed\n\n");
+static const uint8_t orientationAxis[6] = { ZAXIS, ZAXIS, YAXIS, YAXIS, XAXIS, XAXIS };
 
-    while (cliPortAvailable() == false);
-    cliPortRead();
+static uint8_t  orientation;
+static uint8_t  gatheringData;
+static uint16_t sampleCount;
+static float    orientationAverage[6];
 
-    cliPortPrint("  Gathering Data...\n\n");
-
-    for (index = 0; index < 5000; index++) {
-        readAdxl345();
-        rightSideUp += (float) rawAccel[ZAXIS].value;
-        delayMicroseconds(1000);
-    }
-
-    rightSideUp /= 5000.0f;
-
-    cliPortPrint("Place accelerometer up side down\n");
-    cliPortPrint("  Send a character when ready to proceed\n\n");
-
-    while (cliPortAvailable() == false);
-    cliPortRead();
-
-    cliPortPrint("  Gathering Data...\n\n");
-
-    for (index = 0; index < 5000; index++) {
-        readAdxl345();
-        upSideDown += (float) rawAccel[ZAXIS].value;
-        delayMicroseconds(1000);
-    }
+///////////////////////////////////////////////////////////////////////////////
+// Accelerometer Calibration
+///////////////////////////////////////////////////////////////////////////////
 
-    upSideDown /= 5000.0f;
+void accelCalibrationADXL345(void)
+{
+    orientation   = 0;
+    gatheringData = false;
 
-    ///////////////////////////////////
+    calibrationPrint("\nAccelerometer Calibration:\n\n");
 
-    cliPortPrint("Place accelerometer left edge down\n");
-    cliPortPrint("  Send a character when ready to proceed\n\n");
+    calibrationPrint((char *)orientationPrompt[orientation]);
+    calibrationPrint("  Send a character when ready to proceed\n\n");
 
-    while (cliPortAvailable() == false);
-    cliPortRead();
+    accelCalibrating = true;
+}
 
-    cliPortPrint("  Gathering Data...\n\n");
+///////////////////////////////////////////////////////////////////////////////
+// Accelerometer Calibration Tick, 500 Hz
+///////////////////////////////////////////////////////////////////////////////
 
-    for (index = 0; index < 5000; index++) {
-        readAdxl345();
-        leftWingDown += (float) rawAccel[YAXIS].value;
-        delayMicroseconds(1000);
-    }
+void accelCalibrationADXL345Tick(void)
+{
+    uint8_t axis;
 
-    leftWingDown /= 5000.0f;
+    if (gatheringData == false)
+    {
+        if (cliPortAvailable() == false)
+        	return;
 
-    cliPortPrint("Place accelerometer right edge down\n");
-    cliPortPrint("  Send a character when ready to proceed\n\n");
+        cliPortRead();
 
-    while (cliPortAvailable() == false);
-    cliPortRead();
+        calibrationPrint("  Gathering Data...\n\n");
 
-    cliPortPrint("  Gathering Data...\n\n");
+        orientationAverage[orientation] = 0.0f;
+        sampleCount   = 0;
+        gatheringData = true;
 
-    for (index = 0; index < 5000; index++) {
-        readAdxl345();
-        rightWingDown += (float) rawAccel[YAXIS].value;
-        delayMicroseconds(1000);
+        return;
     }
 
-    rightWingDown /= 5000.0f;
-
     ///////////////////////////////////
 
-    cliPortPrint("Place accelerometer rear edge down\n");
-    cliPortPrint("  Send a character when ready to proceed\n\n");
+    axis = orientationAxis[orientation];
 
-    while (cliPortAvailable() == false);
-    cliPortRead();
+    orientationAverage[orientation] += (float)accelData500Hz[axis];
 
-    cliPortPrint("  Gathering Data...\n\n");
+    sampleCount++;
 
-    for (index = 0; index < 5000; index++) {
-        readAdxl345();
-        noseUp += (float) rawAccel[XAXIS].value;
-        delayMicroseconds(1000);
-    }
+    if ((sampleCount % (ACCEL_CALIBRATION_SAMPLES / 5)) == 0)
+        calibrationPrintF("    %3d%%\n", (int)(100 * sampleCount / ACCEL_CALIBRATION_SAMPLES));
 
-    noseUp /= 5000.0f;
+    if (sampleCount < ACCEL_CALIBRATION_SAMPLES)
+    	return;
 
-    cliPortPrint("Place accelerometer front edge down\n");
-    cliPortPrint("  Send a character when ready to proceed\n\n");
+    orientationAverage[orientation] /= (float)ACCEL_CALIBRATION_SAMPLES;
 
-    while (cliPortAvailable() == false);
-    cliPortRead();
+    gatheringData = false;
+    orientation++;
 
-    cliPortPrint("  Gathering Data...\n\n");
+    if (orientation < 6)
+    {
+        calibrationPrint((char *)orientationPrompt[orientation]);
+        calibrationPrint("  Send a character when ready to proceed\n\n");
 
-    for (index = 0; index < 5000; index++) {
-        readAdxl345();
-        noseDown += (float) rawAccel[XAXIS].value;
-        delayMicroseconds(1000);
+        return;
     }
 
-    noseDown /= 5000.0f;
-
     ///////////////////////////////////
 
-    eepromConfig.accelBias[ZAXIS]        = (rightSideUp + upSideDown) / 2.0f;
-    eepromConfig.accelScaleFactor[ZAXIS] = (2.0f * 9.8065f) / fabsf(rightSideUp - upSideDown);
+    eepromConfig.accelBias[ZAXIS]        = (orientationAverage[0] + orientationAverage[1]) / 2.0f;
+    eepromConfig.accelScaleFactor[ZAXIS] = (2.0f * 9.8065f) / fabsf(orientationAverage[0] - orientationAverage[1]);
 
-    eepromConfig.accelBias[YAXIS]        = (leftWingDown + rightWingDown) / 2.0f;
-    eepromConfig.accelScaleFactor[YAXIS] = (2.0f * 9.8065f) / fabsf(leftWingDown - rightWingDown);
+    eepromConfig.accelBias[YAXIS]        = (orientationAverage[2] + orientationAverage[3]) / 2.0f;
+    eepromConfig.accelScaleFactor[YAXIS] = (2.0f * 9.8065f) / fabsf(orientationAverage[2] - orientationAverage[3]);
 
-    eepromConfig.accelBias[XAXIS]        = (noseUp + noseDown) / 2.0f;
-    eepromConfig.accelScaleFactor[XAXIS] = (2.0f * 9.8065f) / fabsf(noseUp - noseDown);
+    eepromConfig.accelBias[XAXIS]        = (orientationAverage[4] + orientationAverage[5]) / 2.0f;
+    eepromConfig.accelScaleFactor[XAXIS] = (2.0f * 9.8065f) / fabsf(orientationAverage[4] - orientationAverage[5]);
 
     ///////////////////////////////////
 
+    calibrationPrint("Accelerometer Calibration Complete.\n\n");
+
     accelCalibrating = false;
 }
 
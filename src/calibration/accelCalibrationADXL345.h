@@ -38,3 +38,9 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 void accelCalibrationADXL345(void);
 
 ///////////////////////////////////////////////////////////////////////////////
+// Accelerometer Calibration Tick, 500 Hz
+///////////////////////////////////////////////////////////////////////////////
+
+void accelCalibrationADXL345Tick(void);
+
+///////////////////////////////////////////////////////////////////////////////
@@ -38,163 +38,108 @@
 #include "board.h"
 
 ///////////////////////////////////////////////////////////////////////////////
-// Accelerometer Calibration
+// Accelerometer Calibration Defines and Variables
 ///////////////////////////////////////////////////////////////////////////////
 
-void accelCalibrationMPU(void)
-{
-    float noseUp        = 0.0f;
-	float noseDown      = 0.0f;
-	float leftWingDown  = 0.0f;
-	float rightWingDown = 0.0f;
-	float upSideDown    = 0.0f;
-    float rightSideUp   = 0.0f;
-
-    int16_t index;
-
-    accelCalibrating = true;
-
-    cliPortPrint("\nMPU6000 Accelerometer Calibration:\n\n");
-
-    ///////////////////////////////////
-
-    cliPortPrint("Place accelerometer right side up\n");
-    cliPortPrint("  Send a character when ready to proceed\n\n");
-
-    while (cliPortAvailable() == false);
-    cliPortRead();
-
-    cliPortPrint("  Gathering Data...\n\n");
+#define ACCEL_CALIBRATION_SAMPLES 2500  // 5 seconds of data at 500 Hz
 
-    for (index = 0; index < 5000; index++)
-    {
-        readMpu6050();
-
-        computeMpu6050TCBias();
-
-        rightSideUp += (float)rawAccel[ZAXIS].value - accelTCBias[ZAXIS];
-        delayMicroseconds(1000);
-    }
-
-    rightSideUp /= 5000.0f;
-
-    cliPortPrint("Place accelerometer up side down\n");
-    cliPortPrint("  Send a character when ready to proceed\n\n");
+static const char *orientationPrompt[6] = { "Place accelerometer right side up\n",
+		                                    "Place accelerometer up side down\n",
+		                                    "Place accelerometer left edge down\n",
+		                                    "Place accelerometer right edge down\n",
+		                                    "Place accelerometer rear edge down\n",
+		                                    "Place accelerometer front edge down\n" };
 
-    while (cliPortAvailable() == false);
-    cliPortRead();
+static const uint8_t orientationAxis[6] = { ZAXIS, ZAXIS, YAXIS, YAXIS, XAXIS, XAXIS };
 
-    cliPortPrint("  Gathering Data...\n\n");
+static uint8_t  orientation;
+static uint8_t  gatheringData;
+static uint16_t sampleCount;
+static float    orientationAverage[6];
 
-    for (index = 0; index < 5000; index++)
-    {
-        readMpu6050();
-
-        computeMpu6050TCBias();
+///////////////////////////////////////////////////////////////////////////////
+// Accelerometer Calibration
+///////////////////////////////////////////////////////////////////////////////
 
-        upSideDown += (float)rawAccel[ZAXIS].value - accelTCBias[ZAXIS];
-        delayMicroseconds(1000);
-    }
+void accelCalibrationMPU(void)
+{
+    orientation   = 0;
+    gatheringData = false;
 
-    upSideDown /= 5000.0f;
+    calibrationPrint("\nMPU6000 Accelerometer Calibration:\n\n");
 
-    ///////////////////////////////////
+    calibrationPrint((char *)orientationPrompt[orientation]);
+    calibrationPrint("  Send a character when ready to proceed\n\n");
 
-    cliPortPrint("Place accelerometer left edge down\n");
-    cliPortPrint("  Send a character when ready to proceed\n\n");
+    accelCalibrating = true;
+}
 
-    while (cliPortAvailable() == false);
-    cliPortRead();
+///////////////////////////////////////////////////////////////////////////////
+// Accelerometer Calibration Tick, 500 Hz
+///////////////////////////////////////////////////////////////////////////////
 
-    cliPortPrint("  Gathering Data...\n\n");
+void accelCalibrationMPUTick(void)
+{
+    uint8_t axis;
 
-    for (index = 0; index < 5000; index++)
+    if (gatheringData == false)
     {
-        readMpu6050();
-
-        computeMpu6050TCBias();
-
-        leftWingDown += (float)rawAccel[YAXIS].value - accelTCBias[YAXIS];
-        delayMicroseconds(1000);
-    }
-
-    leftWingDown /= 5000.0f;
+        if (cliPortAvailable() == false)
+        	return;
 
-    cliPortPrint("Place accelerometer right edge down\n");
-    cliPortPrint("  Send a character when ready to proceed\n\n");
+        cliPortRead();
 
-    while (cliPortAvailable() == false);
-    cliPortRead();
+        calibrationPrint("  Gathering Data...\n\n");
 
-    cliPortPrint("  Gathering Data...\n\n");
+        orientationAverage[orientation] = 0.0f;
+        sampleCount   = 0;
+        gatheringData = true;
 
-    for (index = 0; index < 5000; index++)
-    {
-        readMpu6050();
-
-        computeMpu6050TCBias();
-
-        rightWingDown += (float)rawAccel[YAXIS].value - accelTCBias[YAXIS];
-        delayMicroseconds(1000);
+        return;
     }
 
-    rightWingDown /= 5000.0f;
-
     ///////////////////////////////////
 
-    cliPortPrint("Place accelerometer rear edge down\n");
-    cliPortPrint("  Send a character when ready to proceed\n\n");
-
-    while (cliPortAvailable() == false);
-    cliPortRead();
-
-    cliPortPrint("  Gathering Data...\n\n");
+    axis = orientationAxis[orientation];
 
-    for (index = 0; index < 5000; index++)
-    {
-        readMpu6050();
-
-        computeMpu6050TCBias();
+    orientationAverage[orientation] += (float)accelData500Hz[axis] - accelTCBias[axis];
 
-        noseUp += (float)rawAccel[XAXIS].value - accelTCBias[XAXIS];
-        delayMicroseconds(1000);
-    }
+    sampleCount++;
 
-    noseUp /= 5000.0f;
+    if ((sampleCount % (ACCEL_CALIBRATION_SAMPLES / 5)) == 0)
+        calibrationPrintF("    %3d%%\n", (int)(100 * sampleCount / ACCEL_CALIBRATION_SAMPLES));
 
-    cliPortPrint("Place accelerometer front edge down\n");
-    cliPortPrint("  Send a character when ready to proceed\n\n");
+    if (sampleCount < ACCEL_CALIBRATION_SAMPLES)
+    	return;
 
-    while (cliPortAvailable() == false);
-    cliPortRead();
+    orientationAverage[orientation] /= (float)ACCEL_CALIBRATION_SAMPLES;
 
-    cliPortPrint("  Gathering Data...\n\n");
+    gatheringData = false;
+    orientation++;
 
-    for (index = 0; index < 5000; index++)
+    if (orientation < 6)
     {
-        readMpu6050();
+        calibrationPrint((char *)orientationPrompt[orientation]);
+        calibrationPrint("  Send a character when ready to proceed\n\n");
 
-        computeMpu6050TCBias();
-
-        noseDown += (float)rawAccel[XAXIS].value - accelTCBias[XAXIS];
-        delayMicroseconds(1000);
+        return;
     }
 
-    noseDown /= 5000.0f;
-
     ///////////////////////////////////
 
-    eepromConfig.accelBias[ZAXIS]        = (rightSideUp + upSideDown) / 2.0f;
-    eepromConfig.accelScaleFactor[ZAXIS] = (2.0f * 9.8065f) / fabsf(rightSideUp - upSideDown);
+    eepromConfig.accelBias[ZAXIS]        = (orientationAverage[0] + orientationAverage[1]) / 2.0f;
+    eepromConfig.accelScaleFactor[ZAXIS] = (2.0f * 9.8065f) / fabsf(orientationAverage[0] - orientationAverage[1]);
 
-    eepromConfig.accelBias[YAXIS]        = (leftWingDown + rightWingDown) / 2.0f;
-    eepromConfig.accelScaleFactor[YAXIS] = (2.0f * 9.8065f) / fabsf(leftWingDown - rightWingDown);
+    eepromConfig.accelBias[YAXIS]        = (orientationAverage[2] + orientationAverage[3]) / 2.0f;
+    eepromConfig.accelScaleFactor[YAXIS] = (2.0f * 9.8065f) / fabsf(orientationAverage[2] - orientationAverage[3]);
 
-    eepromConfig.accelBias[XAXIS]        = (noseUp + noseDown) / 2.0f;
-    eepromConfig.accelScaleFactor[XAXIS] = (2.0f * 9.8065f) / fabsf(noseUp - noseDown);
+    eepromConfig.accelBias[XAXIS]        = (orientationAverage[4] + orientationAverage[5]) / 2.0f;
+    eepromConfig.accelScaleFactor[XAXIS] = (2.0f * 9.8065f) / fabsf(orientationAverage[4] - orientationAverage[5]);
 
     ///////////////////////////////////
 
+    calibrationPrint("Accelerometer Calibration Complete.\n\n");
+
 	accelCalibrating = false;
 }
 
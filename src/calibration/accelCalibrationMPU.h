@@ -44,3 +44,9 @@
 void accelCalibrationMPU(void);
 
 ///////////////////////////////////////////////////////////////////////////////
+// Accelerometer Calibration Tick, 500 Hz
+///////////////////////////////////////////////////////////////////////////////
+
+void accelCalibrationMPUTick(void);
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,77 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Calibration Active
+///////////////////////////////////////////////////////////////////////////////
+
+// The calibrations run as state machines ticked from the scheduled frames in
+// main.c.  While one is in progress the aircraft must not arm and the CLI
+// leaves the serial input to the calibration.
+
+uint8_t calibrationActive(void)
+{
+    return ((accelCalibrating == true) ||
+    		(escCalibrating   == true) ||
+    		(magCalibrating   == true) ||
+    		(mpuCalibrating   == true));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Calibration Progress Reporting
+///////////////////////////////////////////////////////////////////////////////
+
+void calibrationPrint(char *str)
+{
+    if (eepromConfig.mavlinkEnabled == true)
+        mavlinkSendStatusText(MAV_SEVERITY_INFO, str);
+    else
+        cliPortPrint(str);
+}
+
+///////////////////////////////////////
+
+void calibrationPrintF(const char * fmt, ...)
+{
+	char buf[128];
+
+	va_list  vlist;
+	va_start (vlist, fmt);
+
+	vsnprintf(buf, sizeof(buf), fmt, vlist);
+	calibrationPrint(buf);
+	va_end(vlist);
+}
+
+///////////////////////////////////////////////////////////////////////////////
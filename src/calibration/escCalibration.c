@@ -34,7 +34,8 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 ///////////////////////////////////////////////////////////////////////////////
 
 uint8_t escCalibrating = false;
-char    temp;
+
+static uint8_t escCalibrationConfirmed;
 
 ///////////////////////////////////////////////////////////////////////////////
 // ESC Calibration
@@ -42,123 +43,120 @@ char    temp;
 
 void escCalibration(void)
 {
+    armed = false;
+
+    escCalibrationConfirmed = false;
+
+    calibrationPrint("\nESC Calibration:\n\n");
+    calibrationPrint("!!!! CAUTION - Remove all propellers and disconnect !!!!\n");
+    calibrationPrint("!!!! flight battery before proceeding any further   !!!!\n\n");
+    calibrationPrint("Type 'Y' to continue, any other character exits\n\n");
+
     escCalibrating = true;
+}
 
-    armed = false;
+///////////////////////////////////////////////////////////////////////////////
+// ESC Calibration Tick, 10 Hz
+///////////////////////////////////////////////////////////////////////////////
 
-    cliPortPrint("\nESC Calibration:\n\n");
-    cliPortPrint("!!!! CAUTION - Remove all propellers and disconnect !!!!\n");
-    cliPortPrint("!!!! flight battery before proceeding any further   !!!!\n\n");
-    cliPortPrint("Type 'Y' to continue, any other character exits\n\n");
+void escCalibrationTick(void)
+{
+    char temp;
+
+    if (cliPortAvailable() == false)
+    	return;
 
-    while (cliPortAvailable() == false);
     temp = cliPortRead();
-    if (temp != 'Y')
+
+    if (escCalibrationConfirmed == false)
     {
-    	cliPortPrint("ESC Calibration Canceled!!\n\n");
-    	escCalibrating = false;
-    	return;
-    }
+        if (temp != 'Y')
+        {
+    	    calibrationPrint("ESC Calibration Canceled!!\n\n");
+    	    escCalibrating = false;
+    	    return;
+        }
 
-    ///////////////////////////////////
+        escCalibrationConfirmed = true;
 
-    cliPortPrint("For ESC Calibration:\n");
-    cliPortPrint("  Enter 'h' for Max Command....\n");
-    cliPortPrint("  Enter 'm' for Mid Command....\n");
-    cliPortPrint("  Enter 'l' for Min Command....\n");
-    cliPortPrint("  Enter 'x' to exit....\n\n");
-    cliPortPrint("For Motor Order Verification:\n");
-    cliPortPrint("  Enter '0' to turn off all motors....\n");
-    cliPortPrint("  Enter '1' to turn on Motor1....\n");
-    cliPortPrint("  Enter '2' to turn on Motor2....\n");
-    cliPortPrint("  Enter '3' to turn on Motor3....\n");
-    cliPortPrint("  Enter '4' to turn on Motor4....\n");
-    cliPortPrint("  Enter '5' to turn on Motor5....\n");
-    cliPortPrint("  Enter '6' to turn on Motor6....\n\n");
+        temp = '?';
+    }
 
     ///////////////////////////////////
 
-    while(true)
-    {
-		while (cliPortAvailable() == false);
-
-		temp = cliPortRead();
-
-		switch (temp)
-		{
-			case 'h':
-			    cliPortPrint("Applying Max Command....\n\n");
-			    writeAllMotors(eepromConfig.maxThrottle);
-			    break;
-
-			case 'm':
-			    cliPortPrint("Applying Mid Command....\n\n");
-			    writeAllMotors(eepromConfig.midCommand);
-			    break;
-
-			case 'l':
-			    cliPortPrint("Applying Min Command....\n\n");
-			    writeAllMotors(MINCOMMAND);
-			    break;
-
-			case 'x':
-			    cliPortPrint("Applying Min Command, Exiting Calibration....\n\n");
-			    writeAllMotors(MINCOMMAND);
-			    escCalibrating = false;
-			    return;
-			    break;
-
-			case '0':
-			    cliPortPrint("Motors at Min Command....\n\n");
-			    writeAllMotors(MINCOMMAND);
-			    break;
-
-			case '1':
-				cliPortPrint("Motor1 at Min Throttle....\n\n");
-				pwmEscWrite(0, eepromConfig.minThrottle);
-				break;
-
-			case '2':
-				cliPortPrint("Motor2 at Min Throttle....\n\n");
-				pwmEscWrite(1, eepromConfig.minThrottle);
-				break;
-
-			case '3':
-				cliPortPrint("Motor3 at Min Throttle....\n\n");
-				pwmEscWrite(2, eepromConfig.minThrottle);
-				break;
-
-			case '4':
-				cliPortPrint("Motor4 at Min Throttle....\n\n");
-				pwmEscWrite(3, eepromConfig.minThrottle);
-				break;
-
-			case '5':
-				cliPortPrint("Motor5 at Min Throttle....\n\n");
-				pwmEscWrite(4, eepromConfig.minThrottle);
-				break;
-
-			case '6':
-				cliPortPrint("Motor6 at Min Throttle....\n\n");
-				pwmEscWrite(5, eepromConfig.minThrottle);
-				break;
-
-			case '?':
-			    cliPortPrint("For ESC Calibration:\n");
-			    cliPortPrint("  Enter 'h' for Max Command....\n");
-			    cliPortPrint("  Enter 'm' for Mid Command....\n");
-			    cliPortPrint("  Enter 'l' for Min Command....\n");
-			    cliPortPrint("  Enter 'x' to exit....\n\n");
-			    cliPortPrint("For Motor Order Verification:\n");
-			    cliPortPrint("  Enter '0' to turn off all motors....\n");
-			    cliPortPrint("  Enter '1' to turn on Motor1....\n");
-			    cliPortPrint("  Enter '2' to turn on Motor2....\n");
-			    cliPortPrint("  Enter '3' to turn on Motor3....\n");
-			    cliPortPrint("  Enter '4' to turn on Motor4....\n");
-			    cliPortPrint("  Enter '5' to turn on Motor5....\n");
-			    cliPortPrint("  Enter '6' to turn on Motor6....\n\n");
-			    break;
-		}
+	switch (temp)
+	{
+		case 'h':
+		    calibrationPrint("Applying Max Command....\n\n");
+		    writeAllMotors(eepromConfig.maxThrottle);
+		    break;
+
+		case 'm':
+		    calibrationPrint("Applying Mid Command....\n\n");
+		    writeAllMotors(eepromConfig.midCommand);
+		    break;
+
+		case 'l':
+		    calibrationPrint("Applying Min Command....\n\n");
+		    writeAllMotors(MINCOMMAND);
+		    break;
+
+		case 'x':
+		    calibrationPrint("Applying Min Command, Exiting Calibration....\n\n");
+		    writeAllMotors(MINCOMMAND);
+		    escCalibrating = false;
+		    break;
+
+		case '0':
+		    calibrationPrint("Motors at Min Command....\n\n");
+		    writeAllMotors(MINCOMMAND);
+		    break;
+
+		case '1':
+			calibrationPrint("Motor1 at Min Throttle....\n\n");
+			motor[0] = eepromConfig.minThrottle;
+			break;
+
+		case '2':
+			calibrationPrint("Motor2 at Min Throttle....\n\n");
+			motor[1] = eepromConfig.minThrottle;
+			break;
+
+		case '3':
+			calibrationPrint("Motor3 at Min Throttle....\n\n");
+			motor[2] = eepromConfig.minThrottle;
+			break;
+
+		case '4':
+			calibrationPrint("Motor4 at Min Throttle....\n\n");
+			motor[3] = eepromConfig.minThrottle;
+			break;
+
+		case '5':
+			calibrationPrint("Motor5 at Min Throttle....\n\n");
+			motor[4] = eepromConfig.minThrottle;
+			break;
+
+		case '6':
+			calibrationPrint("Motor6 at Min Throttle....\n\n");
+			motor[5] = eepromConfig.minThrottle;
+			break;
+
+		case '?':
+		    calibrationPrint("For ESC Calibration:\n");
+		    calibrationPrint("  Enter 'h' for Max Command....\n");
+		    calibrationPrint("  Enter 'm' for Mid Command....\n");
+		    calibrationPrint("  Enter 'l' for Min Command....\n");
+		    calibrationPrint("  Enter 'x' to exit....\n\n");
+		    calibrationPrint("For Motor Order Verification:\n");
+		    calibrationPrint("  Enter '0' to turn off all motors....\n");
+		    calibrationPrint("  Enter '1' to turn on Motor1....\n");
+		    calibrationPrint("  Enter '2' to turn on Motor2....\n");
+		    calibrationPrint("  Enter '3' to turn on Motor3....\n");
+		    calibrationPrint("  Enter '4' to turn on Motor4....\n");
+		    calibrationPrint("  Enter '5' to turn on Motor5....\n");
+		    calibrationPrint("  Enter '6' to turn on Motor6....\n\n");
+		    break;
 	}
 }
 
@@ -42,3 +42,9 @@ extern uint8_t escCalibrating;
 void escCalibration(void);
 
 ///////////////////////////////////////////////////////////////////////////////
+// ESC Calibration Tick, 10 Hz
+///////////////////////////////////////////////////////////////////////////////
+
+void escCalibrationTick(void);
+
+///////////////////////////////////////////////////////////////////////////////
@@ -35,57 +35,180 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 uint8_t magCalibrating = false;
 
+///////////////////////////////////////////////////////////////////////////////
+// Magnetometer Calibration Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+#define MAG_CALIBRATION_MAX_SAMPLES (300 * MAG_RATE)  // 5 minutes of data
+
+static ellipsoidFitData_t magFit;
+
+static uint8_t gatheringData;
+
 ///////////////////////////////////////////////////////////////////////////////
 // Magnetometer Calibration
 ///////////////////////////////////////////////////////////////////////////////
 
 void magCalibration()
 {
-	uint16_t calibrationCounter = 0;
-	uint16_t population[2][3];
+	gatheringData = false;
 
-	float    d[600][3];       // 600 Samples = 60 seconds of data at 10 Hz
-	float    sphereOrigin[3];
-	float    sphereRadius;
+	calibrationPrint("\n\nMagnetometer Calibration:\n\n");
+
+    calibrationPrint("Rotate magnetometer around all axes multiple times\n");
+    calibrationPrint("  Send a character when ready to begin and another when complete\n\n");
 
 	magCalibrating = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Magnetometer Calibration Tick, each new mag sample, 75 Hz
+///////////////////////////////////////////////////////////////////////////////
+
+void magCalibrationTick()
+{
+	float    offset[3];
+	float    softIron[3][3];
+	float    radius;
+	uint8_t  axis;
+	uint32_t fitTime;
 
-	cliPortPrint("\n\nMagnetometer Calibration:\n\n");
+	if (gatheringData == false)
+	{
+		if (cliPortAvailable() == false)
+			return;
 
-    cliPortPrint("Rotate magnetometer around all axes multiple times\n");
-    cliPortPrint("Must complete within 60 seconds....\n\n");
-    cliPortPrint("  Send a character when ready to begin and another when complete\n\n");
+		cliPortRead();
 
-    while (cliPortAvailable() == false);
+		calibrationPrint("  Start rotations.....\n\n");
 
-    cliPortPrint("  Start rotations.....\n\n");
+		ellipsoidFitInit(&magFit);
 
-    cliPortRead();
+		gatheringData = true;
 
-    while ((cliPortAvailable() == false) && (calibrationCounter <= 3000))
+		return;
+	}
+
+	///////////////////////////////////
+
+	if (newMagData == true)
+	{
+		ellipsoidFitAccumulate(&magFit, (float)rawMag[XAXIS].value * magScaleFactor[XAXIS],
+				                        (float)rawMag[YAXIS].value * magScaleFactor[YAXIS],
+				                        (float)rawMag[ZAXIS].value * magScaleFactor[ZAXIS]);
+
+		if ((magFit.samples % 100) == 0)
+			calibrationPrintF("    %4d samples\n", magFit.samples);
+	}
+
+	if ((cliPortAvailable() == false) && (magFit.samples < MAG_CALIBRATION_MAX_SAMPLES))
+		return;
+
+	if (cliPortAvailable() == true)
+		cliPortRead();
+
+	///////////////////////////////////
+
+	calibrationPrintF("\n\nMagnetometer Ellipsoid Fit, %4d samples collected\n", magFit.samples);
+
+	fitTime = micros();
+
+	if (ellipsoidFitSolve(&magFit, offset, softIron, &radius) == true)
 	{
-		if (readMag() == true)
+		fitTime = micros() - fitTime;
+
+		for (axis = XAXIS; axis <= ZAXIS; axis++)
 		{
-			d[calibrationCounter][XAXIS] = (float)rawMag[XAXIS].value * magScaleFactor[XAXIS];
-			d[calibrationCounter][YAXIS] = (float)rawMag[YAXIS].value * magScaleFactor[YAXIS];
-			d[calibrationCounter][ZAXIS] = (float)rawMag[ZAXIS].value * magScaleFactor[ZAXIS];
+		    eepromConfig.magBias[axis] = offset[axis];
 
-			calibrationCounter++;
+		    eepromConfig.magSoftIron[axis][XAXIS] = softIron[axis][XAXIS];
+		    eepromConfig.magSoftIron[axis][YAXIS] = softIron[axis][YAXIS];
+		    eepromConfig.magSoftIron[axis][ZAXIS] = softIron[axis][ZAXIS];
 		}
 
-		delay(100);
+		calibrationPrintF("Field Radius %7.4f, fit time %ld uSec\n", radius, fitTime);
+	    calibrationPrint("Magnetometer Calibration Complete.\n\n");
+	}
+	else
+	{
+		calibrationPrint("Ellipsoid fit failed, rotate through more orientations.\n");
+		calibrationPrint("Magnetometer Calibration Unchanged.\n\n");
+	}
+
+    magCalibrating = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Magnetometer Calibration Benchmark
+///////////////////////////////////////////////////////////////////////////////
+
+// Times the streaming ellipsoid fit against the batch sphereFit on the same
+// synthetic data set, a spiral of points on an offset, tilted ellipsoid.
+// The sample count is kept small as sphereFit needs the buffer on the stack.
+
+#define MAG_BENCHMARK_SAMPLES 100
+
+void magCalibrationBenchmark(void)
+{
+	uint16_t index;
+	uint16_t population[2][3];
+
+	float    d[MAG_BENCHMARK_SAMPLES][3];
+	float    sphereOrigin[3];
+	float    sphereRadius;
+	float    offset[3];
+	float    softIron[3][3];
+	float    radius;
+	float    theta, phi;
+
+	uint32_t sphereFitTime, accumulateTime, solveTime;
+
+	for (index = 0; index < MAG_BENCHMARK_SAMPLES; index++)
+	{
+		theta = acosf(1.0f - 2.0f * ((float)index + 0.5f) / (float)MAG_BENCHMARK_SAMPLES);
+		phi   = (float)index * 2.39996f;
+
+		d[index][XAXIS] =  0.12f + 0.55f * sinf(theta) * cosf(phi) + 0.03f * cosf(theta);
+		d[index][YAXIS] = -0.08f + 0.45f * sinf(theta) * sinf(phi);
+		d[index][ZAXIS] =  0.20f + 0.50f * cosf(theta)             + 0.03f * sinf(theta) * cosf(phi);
 	}
 
-	cliPortPrintF("\n\nMagnetometer Bias Calculation, %3ld samples collected out of 600 max)\n", calibrationCounter);
+	///////////////////////////////////
 
-	sphereFit(d, calibrationCounter, 100, 0.0f, population, sphereOrigin, &sphereRadius);
+	sphereFitTime = micros();
 
-	eepromConfig.magBias[XAXIS] = sphereOrigin[XAXIS];
-	eepromConfig.magBias[YAXIS] = sphereOrigin[YAXIS];
-	eepromConfig.magBias[ZAXIS] = sphereOrigin[ZAXIS];
+	sphereFit(d, MAG_BENCHMARK_SAMPLES, 100, 0.0f, population, sphereOrigin, &sphereRadius);
 
-    magCalibrating = false;
-}
+	sphereFitTime = micros() - sphereFitTime;
+
+	///////////////////////////////////
+
+	accumulateTime = micros();
+
+	ellipsoidFitInit(&magFit);
+
+	for (index = 0; index < MAG_BENCHMARK_SAMPLES; index++)
+		ellipsoidFitAccumulate(&magFit, d[index][XAXIS], d[index][YAXIS], d[index][ZAXIS]);
+
+	accumulateTime = micros() - accumulateTime;
 
+	solveTime = micros();
+
+	ellipsoidFitSolve(&magFit, offset, softIron, &radius);
+
+	solveTime = micros() - solveTime;
+
+	///////////////////////////////////
+
+	cliPortPrintF("\nMag Fit Benchmark, %d samples, true offset 0.1200, -0.0800, 0.2000\n\n", MAG_BENCHMARK_SAMPLES);
+
+	cliPortPrintF("Sphere Fit:    %7ld uSec total                       offset %7.4f, %7.4f, %7.4f\n",
+			      sphereFitTime, sphereOrigin[XAXIS], sphereOrigin[YAXIS], sphereOrigin[ZAXIS]);
+
+	cliPortPrintF("Ellipsoid Fit: %7ld uSec total, %4ld uSec per sample, offset %7.4f, %7.4f, %7.4f\n",
+			      accumulateTime + solveTime, accumulateTime / MAG_BENCHMARK_SAMPLES, offset[XAXIS], offset[YAXIS], offset[ZAXIS]);
+
+	cliPortPrintF("               %7ld uSec solve\n\n", solveTime);
+}
 
 ///////////////////////////////////////////////////////////////////////////////
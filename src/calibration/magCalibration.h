@@ -40,3 +40,11 @@ extern uint8_t magCalibrating;
 void magCalibration(void);
 
 ///////////////////////////////////////////////////////////////////////////////
+
+void magCalibrationTick(void);
+
+///////////////////////////////////////////////////////////////////////////////
+
+void magCalibrationBenchmark(void);
+
+///////////////////////////////////////////////////////////////////////////////
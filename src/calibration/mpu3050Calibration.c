@@ -31,94 +31,134 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 #include "board.h"
 
+///////////////////////////////////////////////////////////////////////////////
+// MPU Temperature Calibration Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+#define MPU3050_CALIBRATION_SAMPLES 1000     // 2 seconds of data at 500 Hz
+#define MPU3050_CALIBRATION_WAIT    600000   // Number of mSec in 10 minutes
+
+enum { MPU3050_CAL_1ST_MEASUREMENTS, MPU3050_CAL_WAITING, MPU3050_CAL_2ND_MEASUREMENTS };
+
+static uint8_t  calibrationState;
+static uint16_t sampleCount;
+static uint32_t waitStartTime;
+static uint8_t  minutesReported;
+
+static float    gyroBias[2][3];
+static float    mpu3050Temperature[2];
+
 ///////////////////////////////////////////////////////////////////////////////
 // MPU Temperature Calibration
 ///////////////////////////////////////////////////////////////////////////////
 
 void mpu3050Calibration(void)
 {
-    uint16_t sampleRate      = 1000;
-    uint16_t numberOfSamples = 2000;
+    uint8_t axis;
+
+    for (axis = 0; axis < 3; axis++)
+        gyroBias[0][axis] = gyroBias[1][axis] = 0.0f;
+
+    mpu3050Temperature[0] = mpu3050Temperature[1] = 0.0f;
 
-    float gyroBias1[3]        = { 0.0f, 0.0f, 0.0f };
-    float mpu3050Temperature1 = 0.0f;
+    sampleCount      = 0;
+    calibrationState = MPU3050_CAL_1ST_MEASUREMENTS;
 
-    float gyroBias2[3]        = { 0.0f, 00.f, 0.0f };
-    float mpu3050Temperature2 = 0.0f;
+    calibrationPrint("\nGyro Temperature Calibration:\n");
 
-    uint16_t index;
+    calibrationPrint("\nBegin 1st Gyro Measurements...\n");
 
     mpuCalibrating = true;
+}
 
-    cliPortPrint("\nGyro Temperature Calibration:\n");
+///////////////////////////////////////////////////////////////////////////////
+// MPU Temperature Calibration Tick, 500 Hz
+///////////////////////////////////////////////////////////////////////////////
 
-    ///////////////////////////////////
-    // Get samples at temperature1
-    ///////////////////////////////////
+void mpu3050CalibrationTick(void)
+{
+    uint8_t axis;
+    uint8_t pass;
+    uint8_t minutes;
 
-    cliPortPrint("\nBegin 1st Gyro Measurements...\n");
-    for (index = 0; index < numberOfSamples; index++)
+    switch (calibrationState)
     {
-        readMpu3050();
+        case MPU3050_CAL_WAITING:
+            ///////////////////////////////////
+            // Time delay for temperature
+            // Stabilization
+            ///////////////////////////////////
 
-        gyroBias1[ROLL ]    += rawGyro[ROLL].value;
-        gyroBias1[PITCH]    += rawGyro[PITCH].value;
-        gyroBias1[YAW  ]    += rawGyro[YAW].value;
-        mpu3050Temperature1 += ((float) rawMpuTemperature.value + 13200.0f) / 280.0f + 35.0f;
+        	minutes = (millis() - waitStartTime) / 60000;
 
-        delayMicroseconds(sampleRate);
-    }
+            if (minutes >= MPU3050_CALIBRATION_WAIT / 60000)
+            {
+                sampleCount      = 0;
+                calibrationState = MPU3050_CAL_2ND_MEASUREMENTS;
 
-    gyroBias1[ROLL]     /= (float) numberOfSamples;
-    gyroBias1[PITCH]    /= (float) numberOfSamples;
-    gyroBias1[YAW]      /= (float) numberOfSamples;
-    mpu3050Temperature1 /= (float) numberOfSamples;
+                calibrationPrint("\nBegin 2nd Gyro Measurements...\n");
+            }
+            else if (minutes != minutesReported)
+            {
+                minutesReported = minutes;
 
-    cliPortPrintF("\nGyro Temperature Reading: %6.2f", mpu3050Temperature1);
+                calibrationPrintF("  %2d minutes remaining...\n", MPU3050_CALIBRATION_WAIT / 60000 - minutes);
+            }
 
-    cliPortPrint("\n\nEnd 1st Gyro Measurements\n");
+            return;
 
-    ///////////////////////////////////
-    // Time delay for temperature
-    // Stabilizaiton
-    ///////////////////////////////////
+        ///////////////////////////////
 
-    cliPortPrint("\nWaiting for 10 minutes for gyro temp to rise...\n");
-    delay(600000);              // Number of mSec in 10 minutes
+        case MPU3050_CAL_1ST_MEASUREMENTS:
+        case MPU3050_CAL_2ND_MEASUREMENTS:
+            pass = (calibrationState == MPU3050_CAL_1ST_MEASUREMENTS) ? 0 : 1;
 
-    ///////////////////////////////////
-    // Get samples at temperature2
-    ///////////////////////////////////
+            gyroBias[pass][ROLL ]    += gyroData500Hz[ROLL ];
+            gyroBias[pass][PITCH]    += gyroData500Hz[PITCH];
+            gyroBias[pass][YAW  ]    += gyroData500Hz[YAW  ];
+            mpu3050Temperature[pass] += ((float) rawMpuTemperature.value + 13200.0f) / 280.0f + 35.0f;
 
-    cliPortPrint("\nBegin 2nd Gyro Measurements...\n");
-    for (index = 0; index < numberOfSamples; index++)
-    {
-        readMpu3050();
+            sampleCount++;
 
-        gyroBias2[ROLL]     += rawGyro[ROLL].value;
-        gyroBias2[PITCH]    += rawGyro[PITCH].value;
-        gyroBias2[YAW]      += rawGyro[YAW].value;
-        mpu3050Temperature2 += ((float) rawMpuTemperature.value + 13200.0f) / 280.0f + 35.0f;
+            if (sampleCount < MPU3050_CALIBRATION_SAMPLES)
+            	return;
 
-        delayMicroseconds(sampleRate);
-    }
+            for (axis = 0; axis < 3; axis++)
+                gyroBias[pass][axis] /= (float)MPU3050_CALIBRATION_SAMPLES;
+
+            mpu3050Temperature[pass] /= (float)MPU3050_CALIBRATION_SAMPLES;
+
+            calibrationPrintF("\nGyro Temperature Reading: %6.2f", mpu3050Temperature[pass]);
+
+            if (pass == 0)
+            {
+                calibrationPrint("\n\nEnd 1st Gyro Measurements\n");
+
+                calibrationPrint("\nWaiting for 10 minutes for gyro temp to rise...\n");
 
-    gyroBias2[ROLL ]    /= (float) numberOfSamples;
-    gyroBias2[PITCH]    /= (float) numberOfSamples;
-    gyroBias2[YAW  ]    /= (float) numberOfSamples;
-    mpu3050Temperature2 /= (float) numberOfSamples;
+                waitStartTime    = millis();
+                minutesReported  = 0;
+                calibrationState = MPU3050_CAL_WAITING;
 
-    cliPortPrintF("\nGyro Temperature Reading: %6.2f", mpu3050Temperature2);
+                return;
+            }
 
-    cliPortPrint("\n\nEnd 2nd Gyro Measurements\n");
+            calibrationPrint("\n\nEnd 2nd Gyro Measurements\n");
 
-    eepromConfig.gyroTCBiasSlope[ROLL ] = (gyroBias2[ROLL ] - gyroBias1[ROLL ]) / (mpu3050Temperature2 - mpu3050Temperature1);
-    eepromConfig.gyroTCBiasSlope[PITCH] = (gyroBias2[PITCH] - gyroBias1[PITCH]) / (mpu3050Temperature2 - mpu3050Temperature1);
-    eepromConfig.gyroTCBiasSlope[YAW  ] = (gyroBias2[YAW  ] - gyroBias1[YAW  ]) / (mpu3050Temperature2 - mpu3050Temperature1);
+            break;
+    }
+
+    ///////////////////////////////////
+
+    for (axis = 0; axis < 3; axis++)
+    {
+        eepromConfig.gyroTCBiasSlope[axis]     = (gyroBias[1][axis] - gyroBias[0][axis]) / (mpu3050Temperature[1] - mpu3050Temperature[0]);
+        eepromConfig.gyroTCBiasIntercept[axis] = gyroBias[1][axis] - eepromConfig.gyroTCBiasSlope[axis] * mpu3050Temperature[1];
+    }
+
+    ///////////////////////////////////
 
-    eepromConfig.gyroTCBiasIntercept[ROLL ] = gyroBias2[ROLL ] - eepromConfig.gyroTCBiasSlope[ROLL ] * mpu3050Temperature2;
-    eepromConfig.gyroTCBiasIntercept[PITCH] = gyroBias2[PITCH] - eepromConfig.gyroTCBiasSlope[PITCH] * mpu3050Temperature2;
-    eepromConfig.gyroTCBiasIntercept[YAW  ] = gyroBias2[YAW  ] - eepromConfig.gyroTCBiasSlope[YAW  ] * mpu3050Temperature2;
+    calibrationPrint("\nGyro Temperature Calibration Complete.\n\n");
 
     mpuCalibrating = false;
 }
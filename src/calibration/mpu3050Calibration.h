@@ -38,3 +38,9 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 void mpu3050Calibration(void);
 
 ///////////////////////////////////////////////////////////////////////////////
+// MPU Temperature Calibration Tick, 500 Hz
+///////////////////////////////////////////////////////////////////////////////
+
+void mpu3050CalibrationTick(void);
+
+///////////////////////////////////////////////////////////////////////////////
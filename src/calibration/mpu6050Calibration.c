@@ -33,128 +33,147 @@ along with EvvGC. If not, see <http://www.gnu.org/licenses/>.
 
 #include "board.h"
 
+///////////////////////////////////////////////////////////////////////////////
+// MPU6050 Calibration Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+#define MPU6050_CALIBRATION_SAMPLES 1000     // 2 seconds of data at 500 Hz
+#define MPU6050_CALIBRATION_WAIT    600000   // Number of mSec in 10 minutes
+
+enum { MPU6050_CAL_1ST_MEASUREMENTS, MPU6050_CAL_WAITING, MPU6050_CAL_2ND_MEASUREMENTS };
+
+static uint8_t  calibrationState;
+static uint16_t sampleCount;
+static uint32_t waitStartTime;
+static uint8_t  minutesReported;
+
+static float    accelBias[2][3];
+static float    gyroBias[2][3];
+static float    mpu6050Temperature[2];
+
 ///////////////////////////////////////////////////////////////////////////////
 // MPU6050 Calibration
 ///////////////////////////////////////////////////////////////////////////////
 
 void mpu6050Calibration(void)
 {
-    uint16_t sampleRate      = 1000;
-    uint16_t numberOfSamples = 2000;
+    uint8_t axis;
 
-    float accelBias1[3]       = { 0.0f, 0.0f, 0.0f };
-    float gyroBias1[3]        = { 0.0f, 0.0f, 0.0f };
-    float mpu6050Temperature1 = 0.0f;
+    for (axis = 0; axis < 3; axis++)
+    {
+        accelBias[0][axis] = accelBias[1][axis] = 0.0f;
+        gyroBias[0][axis]  = gyroBias[1][axis]  = 0.0f;
+    }
 
-    float accelBias2[3]       = { 0.0f, 0.0f, 0.0f };
-    float gyroBias2[3]        = { 0.0f, 0.0f, 0.0f };
-    float mpu6050Temperature2 = 0.0f;
+    mpu6050Temperature[0] = mpu6050Temperature[1] = 0.0f;
 
-    uint16_t index;
+    sampleCount      = 0;
+    calibrationState = MPU6050_CAL_1ST_MEASUREMENTS;
 
-    mpuCalibrating = true;
+    calibrationPrintF("\nMPU6050 Calibration:\n");
 
-    cliPortPrintF("\nMPU6050 Calibration:\n");
+    calibrationPrintF("\nBegin 1st MPU6050 Measurements...\n");
 
-    ///////////////////////////////////
-    // Get samples at temperature1
-    ///////////////////////////////////
+    mpuCalibrating = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// MPU6050 Calibration Tick, 500 Hz
+///////////////////////////////////////////////////////////////////////////////
 
-    cliPortPrintF("\nBegin 1st MPU6050 Measurements...\n");
+void mpu6050CalibrationTick(void)
+{
+    uint8_t axis;
+    uint8_t pass;
+    uint8_t minutes;
 
-    for (index = 0; index < numberOfSamples; index++)
+    switch (calibrationState)
     {
-        readMpu6050();
+        case MPU6050_CAL_WAITING:
+            ///////////////////////////////////
+            // Time delay for temperature
+            // Stabilization
+            ///////////////////////////////////
 
-        rawAccel[ZAXIS].value = rawAccel[ZAXIS].value - 8192;
+        	minutes = (millis() - waitStartTime) / 60000;
 
-        accelBias1[XAXIS]    += rawAccel[XAXIS].value;
-        accelBias1[YAXIS]    += rawAccel[YAXIS].value;
-        accelBias1[ZAXIS]    += rawAccel[ZAXIS].value;
-        gyroBias1[ROLL ]     += rawGyro[ROLL ].value;
-        gyroBias1[PITCH]     += rawGyro[PITCH].value;
-        gyroBias1[YAW  ]     += rawGyro[YAW  ].value;
-        mpu6050Temperature1  += (float)(rawMpuTemperature.value) / 340.0f + 35.0f;
+            if (minutes >= MPU6050_CALIBRATION_WAIT / 60000)
+            {
+                sampleCount      = 0;
+                calibrationState = MPU6050_CAL_2ND_MEASUREMENTS;
 
-        delayMicroseconds(sampleRate);
-    }
+                calibrationPrintF("\nBegin 2nd MPU6050 Measurements...\n");
+            }
+            else if (minutes != minutesReported)
+            {
+                minutesReported = minutes;
 
-    accelBias1[XAXIS]   /= (float) numberOfSamples;
-    accelBias1[YAXIS]   /= (float) numberOfSamples;
-    accelBias1[ZAXIS]   /= (float) numberOfSamples;
-    gyroBias1[ROLL ]    /= (float) numberOfSamples;
-    gyroBias1[PITCH]    /= (float) numberOfSamples;
-    gyroBias1[YAW  ]    /= (float) numberOfSamples;
-    mpu6050Temperature1 /= (float) numberOfSamples;
+                calibrationPrintF("  %2d minutes remaining...\n", MPU6050_CALIBRATION_WAIT / 60000 - minutes);
+            }
 
-    cliPortPrintF("\nGyro Temperature Reading: %6.2f", mpu6050Temperature1);
+            return;
 
-    cliPortPrintF("\n\nEnd 1st MPU6050 Measurements\n");
+        ///////////////////////////////
 
-    ///////////////////////////////////
-    // Time delay for temperature
-    // Stabilization
-    ///////////////////////////////////
+        case MPU6050_CAL_1ST_MEASUREMENTS:
+        case MPU6050_CAL_2ND_MEASUREMENTS:
+            pass = (calibrationState == MPU6050_CAL_1ST_MEASUREMENTS) ? 0 : 1;
 
-    cliPortPrintF("\nWaiting for 10 minutes for MPU6050 temp to rise...\n");
-    delay(600000);    // Number of mSec in 10 minutes
+            accelBias[pass][XAXIS]    += accelData500Hz[XAXIS];
+            accelBias[pass][YAXIS]    += accelData500Hz[YAXIS];
+            accelBias[pass][ZAXIS]    += accelData500Hz[ZAXIS] - 8192;
+            gyroBias[pass][ROLL ]     += gyroData500Hz[ROLL ];
+            gyroBias[pass][PITCH]     += gyroData500Hz[PITCH];
+            gyroBias[pass][YAW  ]     += gyroData500Hz[YAW  ];
+            mpu6050Temperature[pass]  += (float)(rawMpuTemperature.value) / 340.0f + 35.0f;
 
-    ///////////////////////////////////
-    // Get samples at temperature2
-    ///////////////////////////////////
+            sampleCount++;
 
-    cliPortPrintF("\nBegin 2nd MPU6050 Measurements...\n");
+            if (sampleCount < MPU6050_CALIBRATION_SAMPLES)
+            	return;
 
-    for (index = 0; index < numberOfSamples; index++)
-    {
-        readMpu6050();
+            for (axis = 0; axis < 3; axis++)
+            {
+                accelBias[pass][axis] /= (float)MPU6050_CALIBRATION_SAMPLES;
+                gyroBias[pass][axis]  /= (float)MPU6050_CALIBRATION_SAMPLES;
+            }
 
-        rawAccel[ZAXIS].value = rawAccel[ZAXIS].value - 8192;
+            mpu6050Temperature[pass] /= (float)MPU6050_CALIBRATION_SAMPLES;
 
-        accelBias2[XAXIS]    += rawAccel[XAXIS].value;
-        accelBias2[YAXIS]    += rawAccel[YAXIS].value;
-        accelBias2[ZAXIS]    += rawAccel[ZAXIS].value;
-        gyroBias2[ROLL ]     += rawGyro[ROLL ].value;
-        gyroBias2[PITCH]     += rawGyro[PITCH].value;
-        gyroBias2[YAW  ]     += rawGyro[YAW  ].value;
-        mpu6050Temperature2  += (float)(rawMpuTemperature.value) / 340.0f + 35.0f;
+            calibrationPrintF("\nGyro Temperature Reading: %6.2f", mpu6050Temperature[pass]);
 
-        delayMicroseconds(sampleRate);
-    }
+            if (pass == 0)
+            {
+                calibrationPrintF("\n\nEnd 1st MPU6050 Measurements\n");
 
-    accelBias2[XAXIS]   /= (float) numberOfSamples;
-    accelBias2[YAXIS]   /= (float) numberOfSamples;
-    accelBias2[ZAXIS]   /= (float) numberOfSamples;
-    gyroBias2[ROLL ]    /= (float) numberOfSamples;
-    gyroBias2[PITCH]    /= (float) numberOfSamples;
-    gyroBias2[YAW  ]    /= (float) numberOfSamples;
-    mpu6050Temperature2 /= (float) numberOfSamples;
+                calibrationPrintF("\nWaiting for 10 minutes for MPU6050 temp to rise...\n");
 
-    cliPortPrintF("\nGyro Temperature Reading: %6.2f", mpu6050Temperature2);
+                waitStartTime    = millis();
+                minutesReported  = 0;
+                calibrationState = MPU6050_CAL_WAITING;
 
-    cliPortPrintF("\n\nEnd 2st MPU6050 Measurements\n");
+                return;
+            }
 
-    ///////////////////////////////////
+            calibrationPrintF("\n\nEnd 2nd MPU6050 Measurements\n");
 
-    eepromConfig.accelTCBiasSlope[XAXIS]     = (accelBias2[XAXIS] - accelBias1[XAXIS]) / (mpu6050Temperature2 - mpu6050Temperature1);
-    eepromConfig.accelTCBiasSlope[YAXIS]     = (accelBias2[YAXIS] - accelBias1[YAXIS]) / (mpu6050Temperature2 - mpu6050Temperature1);
-    eepromConfig.accelTCBiasSlope[ZAXIS]     = (accelBias2[ZAXIS] - accelBias1[ZAXIS]) / (mpu6050Temperature2 - mpu6050Temperature1);
+            break;
+    }
 
-    eepromConfig.accelTCBiasIntercept[XAXIS] = accelBias2[XAXIS] - eepromConfig.accelTCBiasSlope[XAXIS] * mpu6050Temperature2;
-    eepromConfig.accelTCBiasIntercept[YAXIS] = accelBias2[YAXIS] - eepromConfig.accelTCBiasSlope[YAXIS] * mpu6050Temperature2;
-    eepromConfig.accelTCBiasIntercept[ZAXIS] = accelBias2[ZAXIS] - eepromConfig.accelTCBiasSlope[ZAXIS] * mpu6050Temperature2;
+    ///////////////////////////////////
 
-    eepromConfig.gyroTCBiasSlope[ROLL ]      = (gyroBias2[ROLL ] - gyroBias1[ROLL ]) / (mpu6050Temperature2 - mpu6050Temperature1);
-    eepromConfig.gyroTCBiasSlope[PITCH]      = (gyroBias2[PITCH] - gyroBias1[PITCH]) / (mpu6050Temperature2 - mpu6050Temperature1);
-    eepromConfig.gyroTCBiasSlope[YAW  ]      = (gyroBias2[YAW  ] - gyroBias1[YAW  ]) / (mpu6050Temperature2 - mpu6050Temperature1);
+    for (axis = 0; axis < 3; axis++)
+    {
+        eepromConfig.accelTCBiasSlope[axis]     = (accelBias[1][axis] - accelBias[0][axis]) / (mpu6050Temperature[1] - mpu6050Temperature[0]);
+        eepromConfig.accelTCBiasIntercept[axis] = accelBias[1][axis] - eepromConfig.accelTCBiasSlope[axis] * mpu6050Temperature[1];
 
-    eepromConfig.gyroTCBiasIntercept[ROLL ]  = gyroBias2[ROLL ] - eepromConfig.gyroTCBiasSlope[ROLL ] * mpu6050Temperature2;
-    eepromConfig.gyroTCBiasIntercept[PITCH]  = gyroBias2[PITCH] - eepromConfig.gyroTCBiasSlope[PITCH] * mpu6050Temperature2;
-    eepromConfig.gyroTCBiasIntercept[YAW  ]  = gyroBias2[YAW  ] - eepromConfig.gyroTCBiasSlope[YAW  ] * mpu6050Temperature2;
+        eepromConfig.gyroTCBiasSlope[axis]      = (gyroBias[1][axis] - gyroBias[0][axis]) / (mpu6050Temperature[1] - mpu6050Temperature[0]);
+        eepromConfig.gyroTCBiasIntercept[axis]  = gyroBias[1][axis] - eepromConfig.gyroTCBiasSlope[axis] * mpu6050Temperature[1];
+    }
 
     ///////////////////////////////////
 
-    cliPortPrintF("\nMPU6050 Calibration Complete.\n\n");
+    calibrationPrintF("\nMPU6050 Calibration Complete.\n\n");
 
     mpuCalibrating = false;
 }
@@ -40,3 +40,9 @@ along with EvvGC. If not, see <http://www.gnu.org/licenses/>.
 void mpu6050Calibration(void);
 
 ///////////////////////////////////////////////////////////////////////////////
+// MPU6050 Calibration Tick, 500 Hz
+///////////////////////////////////////////////////////////////////////////////
+
+void mpu6050CalibrationTick(void);
+
+///////////////////////////////////////////////////////////////////////////////
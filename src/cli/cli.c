@@ -41,6 +41,8 @@ void     (*cliPortPrint)(char *str);
 
 void     (*cliPortPrintF)(const char * fmt, ...);
 
+void     (*cliPortPrintBinary)(uint8_t *buf, uint16_t length);
+
 ///////////////////////////////////////
 
 uint8_t cliBusy = false;
@@ -121,9 +123,9 @@ void readCliPID(unsigned char PIDid)
   pid->I               = readFloatCLI();
   pid->D               = readFloatCLI();
   pid->N               = readFloatCLI();
-  pid->integratorState = 0.0f;
-  pid->filterState     = 0.0f;
-  pid->prevResetState  = false;
+
+  setPIDstates(PIDid, 0.0f);
+  pidState.prevResetState[PIDid] = false;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -133,11 +135,30 @@ void readCliPID(unsigned char PIDid)
 void cliCom(void)
 {
 	uint8_t  index;
+	float    tempFloat;
+	uint8_t  sysIdAxisCmd, sysIdTypeCmd;
+	float    sysIdAmplitude, sysIdFMin, sysIdFMax;
 	char mvlkToggleString[5] = { 0, 0, 0, 0, 0 };
 
-    if ((cliPortAvailable() && !validCliCommand))
+	// Interactive calibrations own the serial input until they complete
+
+	if ((accelCalibrating == true) || (escCalibrating == true) || (magCalibrating == true))
+		return;
+
+    // In MAVLink mode mavlinkReceive() owns the port and stops at a '#' outside of a message
+
+    if ((mavlinkCliEscape == true) ||
+    	((eepromConfig.mavlinkEnabled == false) && cliPortAvailable() && !validCliCommand))
     {
-		cliQuery = cliPortRead();
+		if (mavlinkCliEscape == true)
+		{
+			mavlinkCliEscape = false;
+			cliQuery = '#';
+		}
+		else
+		{
+			cliQuery = cliPortRead();
+		}
 
         if (cliQuery == '#')                       // Check to see if we should toggle mavlink msg state
         {
@@ -297,9 +318,9 @@ void cliCom(void)
             ///////////////////////////////
 
             case 'j': // 10 Hz Mag Data
-            	cliPortPrintF("%9.4f, %9.4f, %9.4f\n", sensors.mag10Hz[XAXIS],
-            			                               sensors.mag10Hz[YAXIS],
-            			                               sensors.mag10Hz[ZAXIS]);
+            	cliPortPrintF("%9.4f, %9.4f, %9.4f\n", sensors.mag75Hz[XAXIS],
+            			                               sensors.mag75Hz[YAXIS],
+            			                               sensors.mag75Hz[ZAXIS]);
             	validCliCommand = false;
             	break;
 
@@ -333,6 +354,17 @@ void cliCom(void)
 
             ///////////////////////////////
 
+            case 'n': // PID Benchmark
+            	if (armed == true)
+            		cliPortPrint("\nDisarm before running the PID benchmark....\n\n");
+            	else
+            		pidBenchmark();
+
+            	validCliCommand = false;
+            	break;
+
+            ///////////////////////////////
+
             case 'o':
                 cliPortPrintF("%9.4f\n", batteryVoltage);
 
@@ -342,23 +374,24 @@ void cliCom(void)
             ///////////////////////////////
 
             case 'p': // Primary Spektrum Raw Data
-            	cliPortPrintF("%04X, %04X, %04X, %04X, %04X, %04X, %04X, %04X, %04X, %04X\n", primarySpektrumState.lostFrameCnt,
-            			                                                                      primarySpektrumState.rcAvailable,
-            			                                                                      primarySpektrumState.values[0],
-            			                                                                      primarySpektrumState.values[1],
-            			                                                                      primarySpektrumState.values[2],
-            			                                                                      primarySpektrumState.values[3],
-            			                                                                      primarySpektrumState.values[4],
-            			                                                                      primarySpektrumState.values[5],
-            			                                                                      primarySpektrumState.values[6],
-            			                                                                      primarySpektrumState.values[7]);
+            	cliPortPrintF("%04X, %04X, %04X, %04X, %04X, %04X, %04X, %04X, %04X\n", primarySpektrumState.lostFrameCnt,
+            			                                                                primarySpektrumState.system,
+            			                                                                primarySpektrumState.values[0],
+            			                                                                primarySpektrumState.values[1],
+            			                                                                primarySpektrumState.values[2],
+            			                                                                primarySpektrumState.values[3],
+            			                                                                primarySpektrumState.values[4],
+            			                                                                primarySpektrumState.values[5],
+            			                                                                primarySpektrumState.values[6]);
             	validCliCommand = false;
             	break;
 
             ///////////////////////////////
 
-            case 'q': // Not Used
-                cliQuery = 'x';
+            case 'q': // System ID Capture
+            	sysIdDump();
+
+            	cliQuery = 'x';
                	validCliCommand = false;
                	break;
 
@@ -420,12 +453,19 @@ void cliCom(void)
                 }
                 else if ((eepromConfig.receiverType == SPEKTRUM) && (maxChannelNum == 0))
                     cliPortPrint("Invalid Number of Spektrum Channels....\n");
+                else if (eepromConfig.receiverType == SBUS)
+                {
+                	for (index = 0; index < SBUS_CHANNELS - 1; index++)
+                        cliPortPrintF("%4i, ", sbusRead(index));
+
+                    cliPortPrintF("%4i\n", sbusRead(SBUS_CHANNELS - 1));
+                }
 		        else
 		        {
 		    		for (index = 0; index < 7; index++)
-                        cliPortPrintF("%4i, ", ppmRxRead(index));
+                        cliPortPrintF("%4i, ", rcFrameValue(index));
 
-                    cliPortPrintF("%4i\n", ppmRxRead(7));
+                    cliPortPrintF("%4i\n", rcFrameValue(7));
                 }
 
             	validCliCommand = false;
@@ -467,6 +507,19 @@ void cliCom(void)
 
             ///////////////////////////////
 
+            case 'w': // Autotune Results
+            	if (eepromConfig.autoTuneChannel == 0)
+            		cliPortPrint("\nAutotune Switch:  Disabled\n");
+            	else
+            		cliPortPrintF("\nAutotune Switch:  AUX%1d\n", eepromConfig.autoTuneChannel - AUX1 + 1);
+
+            	autoTuneReport();
+
+            	validCliCommand = false;
+            	break;
+
+            ///////////////////////////////
+
             case 'x':
             	validCliCommand = false;
             	break;
@@ -474,7 +527,12 @@ void cliCom(void)
             ///////////////////////////////
 
             case 'y': // ESC Calibration
-            	escCalibration();
+            	if (calibrationActive() == true)
+            		cliPortPrint("\nCalibration already in progress....\n\n");
+            	else if (eepromConfig.escProtocol >= ESC_DSHOT150)
+            		cliPortPrint("\nDShot ESCs do not require calibration....\n\n");
+            	else
+            	    escCalibration();
 
             	cliQuery = 'x';
             	break;
@@ -555,6 +613,25 @@ void cliCom(void)
 
             ///////////////////////////////
 
+            case 'G': // Apply Autotune Gains
+            	autoTuneApplyGains();
+            	cliPortPrint("\nValid autotune gains applied, 'W' to write to EEPROM....\n");
+
+            	cliQuery = 'a';
+            	validCliCommand = false;
+            	break;
+
+            ///////////////////////////////
+
+            case 'H': // Blackbox CLI
+                blackboxCLI();
+
+                cliQuery = 'x';
+                validCliCommand = false;
+                break;
+
+            ///////////////////////////////
+
             case 'I': // Read hDot PID Values
                 readCliPID(HDOT_PID);
                 cliPortPrint( "\nhDot PID Received....\n" );
@@ -563,6 +640,38 @@ void cliCom(void)
               	validCliCommand = false;
               	break;
 
+            ///////////////////////////////
+
+            case 'J': // Read Autotune Channel
+            	tempFloat = readFloatCLI();
+
+            	if ((tempFloat >= 1.0f) && (tempFloat <= 4.0f))
+            		eepromConfig.autoTuneChannel = AUX1 + (uint8_t)tempFloat - 1;
+            	else
+            		eepromConfig.autoTuneChannel = 0;
+
+            	cliQuery = 'w';
+            	validCliCommand = true;
+            	break;
+
+       	    ///////////////////////////////
+
+            case 'K': // Start System ID
+            	sysIdAxisCmd   = (uint8_t)constrain(readFloatCLI(), ROLL, YAW);
+            	sysIdTypeCmd   = (readFloatCLI() == 0.0f) ? SYSID_CHIRP : SYSID_PRBS;
+            	sysIdAmplitude = constrain(readFloatCLI(),         0.0f,   5.0f);
+            	sysIdFMin      = constrain(readFloatCLI(),         0.1f,  50.0f);
+            	sysIdFMax      = constrain(readFloatCLI(),    sysIdFMin, 100.0f);
+
+            	if (armed == true)
+            		cliPortPrint("\nDisarm before starting System ID....\n");
+            	else
+            		sysIdStart(sysIdAxisCmd, sysIdTypeCmd, sysIdAmplitude, sysIdFMin, sysIdFMax);
+
+            	cliQuery = 'q';
+            	validCliCommand = true;
+            	break;
+
        	    ///////////////////////////////
 
             case 'L': // Read h PID Values
@@ -575,6 +684,15 @@ void cliCom(void)
 
             ///////////////////////////////
 
+            case 'M': // Gain Schedule CLI
+                gainScheduleCLI();
+
+                cliQuery = 'x';
+                validCliCommand = false;
+                break;
+
+            ///////////////////////////////
+
             case 'N': // Mixer CLI
                 mixerCLI();
 
@@ -656,14 +774,34 @@ void cliCom(void)
 
             ///////////////////////////////
 
-            case 'X': // Not Used
+            case 'X': // Flight Recorder Binary Dump
+            	if ((armed == false) && (flightRecorderState.state == RECORDER_FROZEN))
+            		flightRecorderDump();
+            	else
+            		cliPortPrint("\nFlight recorder dumps once frozen and disarmed....\n\n");
+
                 cliQuery = 'x';
                 validCliCommand = false;
                 break;
 
             ///////////////////////////////
 
-            case 'Y': // Not Used
+            case 'Y': // Flight Recorder Status
+            	{
+            		const char *stateNames[4]   = { "Idle", "Recording", "Triggered", "Frozen" };
+            		const char *triggerNames[4] = { "None", "Disarm", "Crash", "EVR" };
+            		uint16_t    records         = flightRecorderRecords();
+
+            		cliPortPrintF("\nFlight Recorder:  %s, Trigger %s at %ld uSec\n", stateNames[flightRecorderState.state],
+            				                                                         triggerNames[flightRecorderState.trigger],
+            				                                                         flightRecorderState.triggerTime);
+            		cliPortPrintF("%d Blocks, %d Records, %5.2f Seconds, %5.1f Bytes/Record\n", flightRecorderState.blockCnt,
+            				                                                                 records,
+            				                                                                 (float)records * 0.002f,
+            				                                                                 records ? (float)flightRecorderState.blockCnt * 512.0f / (float)records : 0.0f);
+            		cliPortPrintF("Update %ld Cycles, %ld Max\n\n", flightRecorderState.cyclesLast, flightRecorderState.cyclesMax);
+            	}
+
                 cliQuery = 'x';
                 break;
 
@@ -685,11 +823,11 @@ void cliCom(void)
    		        cliPortPrint("'d' Position PIDs                          'D' Set Roll Att PID Data    DB;P;I;D;windupGuard;dErrorCalc\n");
    		        cliPortPrint("'e' Loop Delta Times                       'E' Set Pitch Att PID Data   EB;P;I;D;windupGuard;dErrorCalc\n");
    		        cliPortPrint("'f' Loop Execution Times                   'F' Set Hdg Hold PID Data    FB;P;I;D;windupGuard;dErrorCalc\n");
-   		        cliPortPrint("'g' 500 Hz Accels                          'G' Not Used\n");
-   		        cliPortPrint("'h' 100 Hz Earth Axis Accels               'H' Not Used\n");
+   		        cliPortPrint("'g' 500 Hz Accels                          'G' Apply Autotune Gains\n");
+   		        cliPortPrint("'h' 100 Hz Earth Axis Accels               'H' Blackbox CLI\n");
    		        cliPortPrint("'i' 500 Hz Gyros                           'I' Set hDot PID Data        IB;P;I;D;windupGuard;dErrorCalc\n");
-   		        cliPortPrint("'j' 10 hz Mag Data                         'J' Not Used\n");
-   		        cliPortPrint("'k' Vertical Axis Variable                 'K' Not Used\n");
+   		        cliPortPrint("'j' 10 hz Mag Data                         'J' Set Autotune Switch       J0 Off, J1 thru J4 AUX1-4\n");
+   		        cliPortPrint("'k' Vertical Axis Variable                 'K' Start System ID           KAxis;0 Chirp 1 PRBS;Amp;fMin;fMax\n");
    		        cliPortPrint("'l' Attitudes                              'L' Set h PID Data           LB;P;I;D;windupGuard;dErrorCalc\n");
    		        cliPortPrint("\n");
 
@@ -707,18 +845,18 @@ void cliCom(void)
    		        }
 
    		        cliPortPrint("\n");
-   		        cliPortPrint("'m' Axis PIDs                              'M' Not Used\n");
-   		        cliPortPrint("'n' Not Used                               'N' Mixer CLI\n");
+   		        cliPortPrint("'m' Axis PIDs                              'M' Gain Schedule CLI\n");
+   		        cliPortPrint("'n' PID Benchmark                          'N' Mixer CLI\n");
    		        cliPortPrint("'o' Battery Voltage                        'O' Receiver CLI\n");
-   		        cliPortPrint("'p' Not Used                               'P' Sensor CLI\n");
-   		        cliPortPrint("'q' Primary Spektrum Raw Data              'Q' Not Used\n");
+   		        cliPortPrint("'p' Primary Spektrum Raw Data              'P' Sensor CLI\n");
+   		        cliPortPrint("'q' System ID Capture                      'Q' Not Used\n");
    		        cliPortPrint("'r' Mode States                            'R' Reset and Enter Bootloader\n");
    		        cliPortPrint("'s' Raw Receiver Commands                  'S' Reset\n");
    		        cliPortPrint("'t' Processed Receiver Commands            'T' Telemetry CLI\n");
    		        cliPortPrint("'u' Command In Detent Discretes            'U' EEPROM CLI\n");
    		        cliPortPrint("'v' Motor PWM Outputs                      'V' Reset EEPROM Parameters\n");
-   		        cliPortPrint("'w' Not Used                               'W' Write EEPROM Parameters\n");
-   		        cliPortPrint("'x' Terminate Serial Communication         'X' Not Used\n");
+   		        cliPortPrint("'w' Autotune Results                       'W' Write EEPROM Parameters\n");
+   		        cliPortPrint("'x' Terminate Serial Communication         'X' Flight Recorder Binary Dump\n");
    		        cliPortPrint("\n");
 
    		        cliPortPrint("Press space bar for more, or enter a command....\n");
@@ -735,7 +873,7 @@ void cliCom(void)
    		        }
 
    		        cliPortPrint("\n");
-   		        cliPortPrint("'y' ESC Calibration                        'Y' Not Used\n");
+   		        cliPortPrint("'y' ESC Calibration                        'Y' Flight Recorder Status\n");
    		        cliPortPrint("'z' ADC Values                             'Z' Not Used\n");
    		        cliPortPrint("'#####' Toggle MavLink Msg State           '?' Command Summary\n");
    		        cliPortPrint("\n");
@@ -41,6 +41,8 @@ extern void     (*cliPortPrint)(char *str);
 
 extern void     (*cliPortPrintF)(const char * fmt, ...);
 
+extern void     (*cliPortPrintBinary)(uint8_t *buf, uint16_t length);
+
 ///////////////////////////////////////
 
 extern uint8_t cliBusy;
@@ -63,12 +65,24 @@ char *readStringCLI(char *data, uint8_t length);
 
 void cliCom(void);
 
+///////////////////////////////////////////////////////////////////////////////
+// Blackbox CLI
+///////////////////////////////////////////////////////////////////////////////
+
+void blackboxCLI(void);
+
 ///////////////////////////////////////////////////////////////////////////////
 // EEPROM CLI
 ///////////////////////////////////////////////////////////////////////////////
 
 void eepromCLI(void);
 
+///////////////////////////////////////////////////////////////////////////////
+// Gain Schedule CLI
+///////////////////////////////////////////////////////////////////////////////
+
+void gainScheduleCLI(void);
+
 ///////////////////////////////////////////////////////////////////////////////
 // GPS CLI
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,211 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Blackbox CLI
+///////////////////////////////////////////////////////////////////////////////
+
+void blackboxCLI()
+{
+    uint8_t  blackboxQuery = 'x';
+    uint8_t  validQuery = false;
+
+    cliBusy = true;
+
+    cliPortPrint("\nEntering Blackbox CLI....\n\n");
+
+    while(true)
+    {
+        cliPortPrint("Blackbox CLI -> ");
+
+            while ((cliPortAvailable() == false) && (validQuery == false));
+
+	    if (validQuery == false)
+		blackboxQuery = cliPortRead();
+
+	    cliPortPrint("\n");
+
+	    switch(blackboxQuery)
+
+	    {
+            ///////////////////////////
+
+            case 'a': // Blackbox Status
+            	{
+            		const char *stateNames[3] = { "Idle", "Logging", "Flash Full" };
+            		uint32_t    frames        = blackboxState.iFrameCnt + blackboxState.pFrameCnt;
+            		float       logCycles     = (float)blackboxState.logTime * 72.0f;  // 72 MHz
+
+            		cliPortPrintF("\nBlackbox %s, %5.1f Hz, %s\n", eepromConfig.blackboxEnabled ? "Enabled" : "Disabled",
+            				                                       500.0f / (float)eepromConfig.blackboxDivider,
+            				                                       stateNames[blackboxState.state]);
+
+            		if (spiFlashPresent == false)
+            		{
+            			cliPortPrint("No SPI flash found, rev 5 boards only\n\n");
+            		}
+            		else
+            		{
+            			cliPortPrintF("Flash JEDEC ID %06lX, %ld KBytes, %ld KBytes Used, %ld KBytes Free\n",
+            					      spiFlashJedecId, spiFlashSize / 1024, spiFlashUsed() / 1024, spiFlashFree() / 1024);
+
+            			if (blackboxState.logTime > 0)
+            				cliPortPrintF("%6.1f Seconds Left at the Last Log's Rate\n",
+            						      (float)spiFlashFree() * (float)blackboxState.logTime * 0.000001f / (float)blackboxState.logBytes);
+
+            			cliPortPrint("\nLast Log:\n");
+            			cliPortPrintF("    I Frames:        %10ld\n",   blackboxState.iFrameCnt);
+            			cliPortPrintF("    P Frames:        %10ld\n",   blackboxState.pFrameCnt);
+            			cliPortPrintF("    Dropped Frames:  %10ld\n",   blackboxState.dropCnt);
+            			cliPortPrintF("    Seconds:         %10.1f\n", (float)blackboxState.logTime * 0.000001f);
+            			cliPortPrintF("    Bytes:           %10ld\n",   blackboxState.logBytes);
+            			cliPortPrintF("    Bytes/Frame:     %10.1f\n", frames ? (float)blackboxState.logBytes / (float)frames : 0.0f);
+            			cliPortPrintF("    Compression:     %10.2f\n", blackboxState.logBytes ? (float)blackboxState.rawBytes / (float)blackboxState.logBytes : 0.0f);
+            			cliPortPrintF("    Encode Cycles:   %10ld Last, %ld Max, %ld Mean\n", blackboxState.cyclesLast,
+            					                                                            blackboxState.cyclesMax,
+            					                                                            frames ? blackboxState.cyclesTotal / frames : 0);
+            			cliPortPrintF("    Encode CPU:      %10.3f%%\n", logCycles > 0.0f ? (float)blackboxState.cyclesTotal * 100.0f / logCycles : 0.0f);
+            			cliPortPrintF("    Pages Written:   %10ld\n",   spiFlashStats.pageCnt);
+            			cliPortPrintF("    Dropped Writes:  %10ld\n",   spiFlashStats.dropCnt);
+            			cliPortPrintF("    Queue High:      %10ld of %d Pages\n", spiFlashStats.highWater, SPI_FLASH_QUEUE_PAGES);
+            			cliPortPrintF("    Flash Cycles:    %10ld Max Pass\n", spiFlashStats.cyclesMax);
+            			cliPortPrintF("    Flash CPU:       %10.3f%%\n\n", logCycles > 0.0f ? (float)spiFlashStats.cycles * 100.0f / logCycles : 0.0f);
+            		}
+            	}
+
+                validQuery = false;
+                break;
+
+            ///////////////////////////
+
+            case 'b': // Toggle Blackbox Enable
+                eepromConfig.blackboxEnabled = !eepromConfig.blackboxEnabled;
+
+                blackboxQuery = 'a';
+                validQuery    = true;
+                break;
+
+            ///////////////////////////
+
+            case 'c': // Erase Flash
+            	if ((armed == true) || (spiFlashPresent == false))
+            	{
+            		cliPortPrint("\nErase needs the flash, disarmed....\n\n");
+            	}
+            	else
+            	{
+            		cliPortPrint("\nErasing Flash, up to 40 seconds");
+
+            		spiFlashEraseChip();
+
+            		while (spiFlashIdle() == false)
+            		{
+            			delay(1000);
+            			cliPortPrint(".");
+            		}
+
+            		blackboxState.state = BLACKBOX_IDLE;
+
+            		cliPortPrint("\nFlash Erased....\n\n");
+            	}
+
+                validQuery = false;
+                break;
+
+            ///////////////////////////
+
+            case 'd': // Download Flash
+            	if ((armed == true) || (spiFlashPresent == false))
+            		cliPortPrint("\nDownload needs the flash, disarmed....\n\n");
+            	else
+            		blackboxDownload();
+
+                validQuery = false;
+                break;
+
+            ///////////////////////////
+
+            case 'e': // Reset Blackbox Statistics
+                blackboxStatsReset();
+                spiFlashStatsReset();
+
+                blackboxQuery = 'a';
+                validQuery    = true;
+                break;
+
+            ///////////////////////////
+
+			case 'x':
+			    cliPortPrint("\nExiting Blackbox CLI....\n\n");
+			    cliBusy = false;
+			    return;
+			    break;
+
+            ///////////////////////////
+
+            case 'A': // Set Blackbox Divider
+                eepromConfig.blackboxDivider = (uint8_t)constrain(readFloatCLI(), 1.0f, 250.0f);
+
+                blackboxQuery = 'a';
+                validQuery    = true;
+                break;
+
+            ///////////////////////////
+
+            case 'W': // Write EEPROM Parameters
+                cliPortPrint("\nWriting EEPROM Parameters....\n\n");
+                writeEEPROM();
+
+                validQuery = false;
+                break;
+
+            ///////////////////////////
+
+			case '?':
+			   	cliPortPrint("\n");
+			   	cliPortPrint("'a' Blackbox Status\n");
+   		        cliPortPrint("'b' Toggle Blackbox Enable                 'A' Set Blackbox Divider                 Adivider, rate is 500 Hz / divider\n");
+   		        cliPortPrint("'c' Erase Flash\n");
+   		        cliPortPrint("'d' Download Flash, Binary\n");
+   		        cliPortPrint("'e' Reset Blackbox Statistics\n");
+   		        cliPortPrint("                                           'W' Write EEPROM Parameters\n");
+   		        cliPortPrint("'x' Exit Blackbox CLI                      '?' Command Summary\n");
+   		        cliPortPrint("\n");
+	    	    break;
+
+	    	///////////////////////////
+	    }
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -108,8 +108,6 @@ void eepromCLI()
             case 'a': // config struct data
                 c1 = eepromConfig.CRCAtEnd[0];
 
-                zeroPIDstates();
-
                 c2 = crc32bEEPROM(&eepromConfig, false);
 
                 cliPortPrintF("Config structure information:\n");
@@ -129,12 +127,6 @@ void eepromCLI()
             ///////////////////////////
 
             case 'c': // Write out to Console in Hex.  (RAM -> console)
-                // we assume the flyer is not in the air, so that this is ok;
-                // these change randomly when not in flight and can mistakenly
-                // make one think that the in-memory eeprom struct has changed
-
-                zeroPIDstates();
-
                 cliPortPrintF("\n");
 
                 cliPrintEEPROM(&eepromConfig);
@@ -221,8 +213,6 @@ void eepromCLI()
                     // check to see if the newly received eeprom config
                     // actually differs from what's in-memory
 
-                    zeroPIDstates();
-
                     int i;
                     for (i = 0; i < sz; i++)
                         if (((uint8_t*)&e)[i] != ((uint8_t*)&eepromConfig)[i])
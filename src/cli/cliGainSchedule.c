@@ -0,0 +1,243 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Gain Schedule CLI
+///////////////////////////////////////////////////////////////////////////////
+
+void gainScheduleCLI()
+{
+    float    tempFloat[GS_THROTTLE_POINTS];
+
+    uint8_t  axis, term, index, column;
+    uint8_t  valid;
+
+    uint8_t  gainScheduleQuery = 'x';
+    uint8_t  validQuery        = false;
+
+    const char *axisNames[3] = { "Roll", "Pitch", "Yaw" };
+    const char *termNames[3] = { "P", "I", "D" };
+
+    cliBusy = true;
+
+    cliPortPrint("\nEntering Gain Schedule CLI....\n\n");
+
+    while(true)
+    {
+        cliPortPrint("Gain Schedule CLI -> ");
+
+		while ((cliPortAvailable() == false) && (validQuery == false));
+
+		if (validQuery == false)
+		    gainScheduleQuery = cliPortRead();
+
+		cliPortPrint("\n");
+
+		switch(gainScheduleQuery)
+		{
+            ///////////////////////////
+
+            case 'a': // Gain Schedule Tables
+            	cliPortPrint("\nRate PID Gain Schedule, percent, throttle rows, cell voltage columns\n\n");
+
+            	for (axis = 0; axis < 3; axis++)
+            	{
+            		for (term = 0; term < 3; term++)
+            		{
+            			cliPortPrintF("%-5s %s       ", axisNames[axis], termNames[term]);
+
+            			for (column = 0; column < GS_VOLTAGE_POINTS; column++)
+            				cliPortPrintF("  %4.2fV", eepromConfig.gainScheduleCellVoltage[column]);
+
+            			cliPortPrint("\n");
+
+            			for (index = 0; index < GS_THROTTLE_POINTS; index++)
+            			{
+            				cliPortPrintF("  %4d        ", eepromConfig.gainScheduleThrottle[index]);
+
+            				for (column = 0; column < GS_VOLTAGE_POINTS; column++)
+            					cliPortPrintF("  %5d", eepromConfig.gainScheduleTable[axis][term][index][column]);
+
+            				cliPortPrint("\n");
+            			}
+            		}
+
+            		cliPortPrint("\n");
+            	}
+
+            	validQuery = false;
+            	break;
+
+            ///////////////////////////
+
+            case 'b': // Current Gain Scales
+            	cliPortPrint("\nCurrent Rate PID Scales:\n\n");
+
+            	for (axis = 0; axis < 3; axis++)
+            		cliPortPrintF("%-5s  P %5.3f  I %5.3f  D %5.3f\n", axisNames[axis],
+            				                                          gainScale[axis][GS_P],
+            				                                          gainScale[axis][GS_I],
+            				                                          gainScale[axis][GS_D]);
+
+            	cliPortPrint("\n");
+
+            	validQuery = false;
+            	break;
+
+            ///////////////////////////
+
+			case 'x':
+			    cliPortPrint("\nExiting Gain Schedule CLI....\n\n");
+			    cliBusy = false;
+			    return;
+			    break;
+
+            ///////////////////////////
+
+            case 'A': // Read Throttle Breakpoints
+            	valid = true;
+
+            	for (index = 0; index < GS_THROTTLE_POINTS; index++)
+            	{
+            		tempFloat[index] = readFloatCLI();
+
+            		if ((tempFloat[index] < MINCOMMAND) || (tempFloat[index] > MAXCOMMAND) ||
+            		    ((index > 0) && (tempFloat[index] <= tempFloat[index - 1])))
+            			valid = false;
+            	}
+
+            	if (valid == true)
+            	{
+            		for (index = 0; index < GS_THROTTLE_POINTS; index++)
+            			eepromConfig.gainScheduleThrottle[index] = (uint16_t)tempFloat[index];
+
+            		gainScheduleVoltageUpdate();
+            	}
+            	else
+            		cliPortPrint("\nThrottle breakpoints must increase within 2000 to 4000....\n");
+
+            	gainScheduleQuery = 'a';
+            	validQuery        = true;
+            	break;
+
+            ///////////////////////////
+
+            case 'B': // Read Cell Voltage Breakpoints
+            	valid = true;
+
+            	for (index = 0; index < GS_VOLTAGE_POINTS; index++)
+            	{
+            		tempFloat[index] = readFloatCLI();
+
+            		if ((index > 0) && (tempFloat[index] <= tempFloat[index - 1]))
+            			valid = false;
+            	}
+
+            	if (valid == true)
+            	{
+            		for (index = 0; index < GS_VOLTAGE_POINTS; index++)
+            			eepromConfig.gainScheduleCellVoltage[index] = tempFloat[index];
+
+            		gainScheduleVoltageUpdate();
+            	}
+            	else
+            		cliPortPrint("\nCell voltage breakpoints must increase....\n");
+
+            	gainScheduleQuery = 'a';
+            	validQuery        = true;
+            	break;
+
+            ///////////////////////////
+
+            case 'C': // Read Gain Schedule Row
+            	axis  = (uint8_t)readFloatCLI();
+            	term  = (uint8_t)readFloatCLI();
+            	index = (uint8_t)readFloatCLI();
+
+            	for (column = 0; column < GS_VOLTAGE_POINTS; column++)
+            		tempFloat[column] = constrain(readFloatCLI(), 0.0f, 255.0f);
+
+            	if ((axis < 3) && (term < 3) && (index < GS_THROTTLE_POINTS))
+            	{
+            		for (column = 0; column < GS_VOLTAGE_POINTS; column++)
+            			eepromConfig.gainScheduleTable[axis][term][index][column] = (uint8_t)tempFloat[column];
+
+            		gainScheduleVoltageUpdate();
+            	}
+            	else
+            		cliPortPrint("\nAxis, term or throttle row out of range....\n");
+
+            	gainScheduleQuery = 'a';
+            	validQuery        = true;
+            	break;
+
+            ///////////////////////////
+
+            case 'D': // Reset Gain Schedule Tables
+            	memset(eepromConfig.gainScheduleTable, 100, sizeof(eepromConfig.gainScheduleTable));
+
+            	gainScheduleVoltageUpdate();
+
+            	gainScheduleQuery = 'a';
+            	validQuery        = true;
+            	break;
+
+            ///////////////////////////
+
+            case 'W': // Write EEPROM Parameters
+                cliPortPrint("\nWriting EEPROM Parameters....\n\n");
+                writeEEPROM();
+
+                validQuery = false;
+                break;
+
+			///////////////////////////
+
+			case '?':
+			   	cliPortPrint("\n");
+			   	cliPortPrint("'a' Gain Schedule Tables                   'A' Set Throttle Breakpoints             AT0;T1;T2;T3\n");
+			   	cliPortPrint("'b' Current Gain Scales                    'B' Set Cell Voltage Breakpoints         BV0;V1;V2\n");
+			   	cliPortPrint("                                           'C' Set Table Row                        CAxis;Term;Row;Pct0;Pct1;Pct2\n");
+			   	cliPortPrint("                                           'D' Reset Tables to 100 Percent\n");
+			   	cliPortPrint("                                           'W' Write EEPROM Parameters\n");
+			   	cliPortPrint("'x' Exit Gain Schedule CLI                 '?' Command Summary\n");
+			   	cliPortPrint("\n");
+	    	    break;
+
+	    	///////////////////////////
+	    }
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -86,8 +86,43 @@ void mixerCLI()
                 }
 
                 cliPortPrintF("Number of Motors:                    %1d\n",  numberMotor);
+
+                switch (eepromConfig.escProtocol)
+                {
+                    case ESC_PWM:
+                        cliPortPrint("ESC Protocol:                       PWM\n");
+                        break;
+
+                    case ESC_ONESHOT125:
+                        cliPortPrint("ESC Protocol:                OneShot125\n");
+                        break;
+
+                    case ESC_ONESHOT42:
+                        cliPortPrint("ESC Protocol:                 OneShot42\n");
+                        break;
+
+                    case ESC_DSHOT150:
+                        cliPortPrint("ESC Protocol:                  DShot150\n");
+                        break;
+
+                    case ESC_DSHOT300:
+                        cliPortPrint("ESC Protocol:                  DShot300\n");
+                        break;
+
+                    case ESC_DSHOT600:
+                        cliPortPrint("ESC Protocol:                  DShot600\n");
+                        break;
+                }
+
+                if ((eepromConfig.escProtocol >= ESC_DSHOT150) && (numberMotor > 6))
+                	cliPortPrint("DShot supports 6 motors, using PWM....\n");
+
                 cliPortPrintF("ESC PWM Rate:                      %3ld\n",   eepromConfig.escPwmRate);
-                cliPortPrintF("Servo PWM Rate:                    %3ld\n\n", eepromConfig.servoPwmRate);
+
+                if (numberMotor > 6)
+                	cliPortPrint("Servo Outputs:      Off, Motors 7 and 8\n\n");
+                else
+                	cliPortPrintF("Servo PWM Rate:                    %3ld\n\n", eepromConfig.servoPwmRate);
 
                 if (eepromConfig.yawDirection == 1.0f)
                 	cliPortPrintF("Yaw Direction:                  Normal\n\n");
@@ -129,6 +164,29 @@ void mixerCLI()
                 validQuery = false;
                 break;
 
+            ///////////////////////////
+
+            case 'b': // Mixer Benchmark
+            	if (armed == true)
+            		cliPortPrint("\nDisarm before running the mixer benchmark....\n\n");
+            	else
+            		mixerBenchmark();
+
+            	validQuery = false;
+            	break;
+
+            ///////////////////////////
+
+            case 'c': // ESC Latency
+                cliPortPrint("\nMeasured on Motor 1, command to end of pulse or frame\n");
+                cliPortPrintF("ESC Command to Pulse Latency Average: %7.2f uSec\n",   escLatencyAverage);
+                cliPortPrintF("ESC Command to Pulse Latency Max:     %7.2f uSec\n\n", escLatencyMax);
+
+                escLatencyMax = 0.0f;
+
+                validQuery = false;
+                break;
+
             ///////////////////////////
 
 			case 'x':
@@ -164,6 +222,21 @@ void mixerCLI()
 
             ///////////////////////////
 
+            case 'C': // Read ESC Protocol
+                tempFloat = readFloatCLI();
+
+                if ((tempFloat >= ESC_PWM) && (tempFloat <= ESC_DSHOT600))
+                {
+                	eepromConfig.escProtocol = (uint8_t)tempFloat;
+                	pwmEscInit();
+                }
+
+                mixerQuery = 'a';
+                validQuery = true;
+                break;
+
+            ///////////////////////////
+
             case 'D': // Read yaw direction
                 tempFloat = readFloatCLI();
                 if (tempFloat >= 0.0)
@@ -173,6 +246,8 @@ void mixerCLI()
 
                 eepromConfig.yawDirection = tempFloat;
 
+                initMixer();
+
                 mixerQuery = 'a';
                 validQuery = true;
                 break;
@@ -284,6 +359,7 @@ void mixerCLI()
                 {
                 	eepromConfig.freeMixMotors = (uint8_t)readFloatCLI();
            	        initMixer();
+           	        pwmEscInit();
 				}
 				else
 				{
@@ -303,8 +379,13 @@ void mixerCLI()
                 {
                 	rows    = (uint8_t)readFloatCLI() - 1;
                     columns = (uint8_t)readFloatCLI() - 1;
+                    tempFloat = readFloatCLI();
 
-                    eepromConfig.freeMix[rows][columns] = readFloatCLI();
+                    if ((rows < MAX_NUMBER_OF_MOTORS) && (columns < 3))
+                    {
+                    	eepromConfig.freeMix[rows][columns] = tempFloat;
+                    	initMixer();
+                    }
 				}
 				else
 				{
@@ -353,7 +434,8 @@ void mixerCLI()
 			case '?':
 			   	cliPortPrint("\n");
 			   	cliPortPrint("'a' Mixer Configuration Data               'A' Set Mixer Configuration              A0 thru 3, see ff32_Naze32.h\n");
-   		        cliPortPrint("                                           'B' Set PWM Rates                        BESC;Servo\n");
+   		        cliPortPrint("'b' Mixer Benchmark                        'B' Set PWM Rates                        BESC;Servo\n");
+   		        cliPortPrint("'c' ESC Latency                            'C' Set ESC Protocol                     C0 PWM, 1-2 OS125/42, 3-5 DS150/300/600\n");
    		        cliPortPrint("                                           'D' Set Yaw Direction                    D1 or D-1\n");
 
    		        if (eepromConfig.mixerConfiguration == MIXERTYPE_TRI)
@@ -367,7 +449,7 @@ void mixerCLI()
 
    		        if (eepromConfig.mixerConfiguration == MIXERTYPE_FREE)
    		    	{
-   		        	cliPortPrint("                                           'J' Set Number of FreeMix Motors         JNumb\n");
+   		        	cliPortPrint("                                           'J' Set Number of FreeMix Motors         JNumb, 7-8 turn servo outputs off\n");
    		        	cliPortPrint("                                           'K' Set FreeMix Matrix Element           KRow;Col;Value\n");
 			   	}
 
@@ -65,16 +65,7 @@ void receiverCLI()
             ///////////////////////////
 
             case 'a': // Receiver Configuration
-                cliPortPrint("\nReceiver Type:                  ");
-                switch(eepromConfig.receiverType)
-                {
-                    case PPM:
-                        cliPortPrint("PPM\n");
-                        break;
-                    case SPEKTRUM:
-                        cliPortPrint("Spektrum\n");
-                        break;
-		        }
+                cliPortPrintF("\nReceiver Type:                  %s\n", rxDrivers[eepromConfig.receiverType].name);
 
                 cliPortPrint("Current RC Channel Assignment:  ");
                 for (index = 0; index < 8; index++)
@@ -86,11 +77,34 @@ void receiverCLI()
 
                 cliPortPrintF("Secondary Spektrum:             ");
 
-                if ((eepromConfig.slaveSpektrum == true) && false)  // HJI Inhibit Slave Spektrum on Naze32 Pro
-                    cliPortPrintF("Installed\n");
+                if (eepromConfig.slaveSpektrum == true)
+                    cliPortPrintF("Installed on RC2\n");
                 else
                     cliPortPrintF("Uninstalled\n");
 
+                if (eepromConfig.receiverType == SPEKTRUM)
+                {
+                	cliPortPrint("Spektrum System:                ");
+                	switch (spektrumSystem)
+                	{
+                		case 0x01:
+                			cliPortPrint("DSM2 1024 22 mSec\n");
+                			break;
+                		case 0x12:
+                			cliPortPrint("DSM2 2048 11 mSec\n");
+                			break;
+                		case 0xA2:
+                			cliPortPrint("DSMX 2048 22 mSec\n");
+                			break;
+                		case 0xB2:
+                			cliPortPrint("DSMX 2048 11 mSec\n");
+                			break;
+                		default:
+                			cliPortPrint("Unknown\n");
+                			break;
+                	}
+                }
+
                 cliPortPrintF("Mid Command:                    %4ld\n",   (uint16_t)eepromConfig.midCommand);
 				cliPortPrintF("Min Check:                      %4ld\n",   (uint16_t)eepromConfig.minCheck);
 				cliPortPrintF("Max Check:                      %4ld\n",   (uint16_t)eepromConfig.maxCheck);
@@ -106,12 +120,111 @@ void receiverCLI()
 				tempFloat = eepromConfig.attitudeScaling * 180000.0 / PI;
                 cliPortPrintF("Max Attitude Cmd:               %6.2f Degrees\n\n", tempFloat);
 
-				cliPortPrintF("Arm Delay Count:                %3d Frames\n",   eepromConfig.armCount);
-				cliPortPrintF("Disarm Delay Count:             %3d Frames\n\n", eepromConfig.disarmCount);
+				cliPortPrint("RC Interpolation:               ");
+				if (eepromConfig.rcInterpolation == true)
+					cliPortPrint("On\n");
+				else
+					cliPortPrint("Off\n");
+
+				cliPortPrintF("RC Smoothing Cutoff:            %6.2f Hz\n\n", eepromConfig.rcSmoothingCutoff);
+
+				cliPortPrintF("Arm Delay Count:                %3d x 20 mSec\n",   eepromConfig.armCount);
+				cliPortPrintF("Disarm Delay Count:             %3d x 20 mSec\n\n", eepromConfig.disarmCount);
 
 				validQuery = false;
 				break;
 
+            ///////////////////////////
+
+            case 'b': // Receiver Frame Timing
+                cliPortPrintF("\nRC Frame Interval:                       %7ld uSec\n", rcFrameDeltaTime);
+                cliPortPrintF("RC Frame End to Command Latency Average: %7.2f uSec\n",   rcLatencyAverage);
+                cliPortPrintF("RC Frame End to Command Latency Max:     %7.2f uSec\n", rcLatencyMax);
+
+                if (rcFailsafe == true)
+                	cliPortPrintF("RC Failsafe:                    Active, %7.2f Sec\n", (float)rcFailsafeTime * 1.0e-6f);
+                else
+                	cliPortPrint("RC Failsafe:                    Inactive\n");
+
+                cliPortPrintF("RC Interval Estimate R/P/Y/T:            %7.2f, %7.2f, %7.2f, %7.2f mSec\n\n",
+                		      rcInterpolationInterval(ROLL    ) * 1000.0f,
+                		      rcInterpolationInterval(PITCH   ) * 1000.0f,
+                		      rcInterpolationInterval(YAW     ) * 1000.0f,
+                		      rcInterpolationInterval(THROTTLE) * 1000.0f);
+
+                rcLatencyMax = 0.0f;
+
+                tempFloat = (float)(micros() - rxIsrStatsStart);
+
+                cliPortPrintF("Receiver ISR Calls:                      %7ld\n",          rxIsrCnt);
+                cliPortPrintF("Receiver ISR Average:                    %7.2f Cycles\n",   (rxIsrCnt > 0) ? (float)rxIsrCycles / (float)rxIsrCnt : 0.0f);
+                cliPortPrintF("Receiver ISR Load:                       %7.4f %%\n\n",     (float)rxIsrCycles / (tempFloat * 72.0f) * 100.0f);
+
+                rxIsrStatsReset();
+
+                if (eepromConfig.receiverType == PPM)
+                {
+                	cliPortPrint("            Frames  Bad  Lost  Overrun  Channels  Interval Avg/Max uSec  Jitter Avg/Max uSec\n");
+                	cliPortPrintF("PPM:   %10ld  %3ld  %4ld  %7ld  %8d  %8.1f, %ld  %10.2f, %.1f\n\n",
+                			      ppmState.frameCnt, ppmState.badFrameCnt, ppmState.lostCnt, ppmState.overrunCnt,
+                			      ppmState.channelCnt, ppmState.frameIntervalAverage, ppmState.frameIntervalMax,
+                			      ppmState.frameJitterAverage, ppmState.frameJitterMax);
+
+                	ppmRxStatsReset();
+                }
+
+                if (eepromConfig.receiverType == SPEKTRUM)
+                {
+                	cliPortPrint("                        Frames  Fades  Bad  Overrun  Duplicate  Interval Avg/Max uSec\n");
+                	cliPortPrintF("Primary Spektrum:  %10ld  %5d  %3ld  %7ld  %9ld  %8.1f, %ld\n",
+                			      primarySpektrumState.frameCnt, primarySpektrumState.lostFrameCnt, primarySpektrumState.badFrameCnt,
+                			      primarySpektrumState.overrunCnt, primarySpektrumState.duplicateCnt,
+                			      primarySpektrumState.frameIntervalAverage, primarySpektrumState.frameIntervalMax);
+
+                	if (eepromConfig.slaveSpektrum == true)
+                		cliPortPrintF("Slave Spektrum:    %10ld  %5d  %3ld  %7ld  %9ld  %8.1f, %ld\n",
+                				      slaveSpektrumState.frameCnt, slaveSpektrumState.lostFrameCnt, slaveSpektrumState.badFrameCnt,
+                				      slaveSpektrumState.overrunCnt, slaveSpektrumState.duplicateCnt,
+                				      slaveSpektrumState.frameIntervalAverage, slaveSpektrumState.frameIntervalMax);
+
+                	cliPortPrint("\n");
+
+                	spektrumStatsReset();
+                }
+
+                if (eepromConfig.receiverType == SBUS)
+                {
+                	cliPortPrint("                Frames  Bad  Lost  Failsafe  Overrun  Interval Avg/Max uSec  Flags\n");
+                	cliPortPrintF("SBUS:      %10ld  %3ld  %4ld  %8ld  %7ld  %8.1f, %ld  0x%02X\n\n",
+                			      sbusState.frameCnt, sbusState.badFrameCnt, sbusState.lostFrameCnt,
+                			      sbusState.failsafeCnt, sbusState.overrunCnt,
+                			      sbusState.frameIntervalAverage, sbusState.frameIntervalMax, sbusState.flags);
+
+                	sbusStatsReset();
+                }
+
+                if (eepromConfig.receiverType == MAVLINK_RC)
+                	cliPortPrintF("MAVLink RC Overrides:                    %7ld\n\n", mavlinkRcOverrideCnt);
+
+                validQuery = false;
+                break;
+
+            ///////////////////////////
+
+            case 'c': // SBUS Decode Benchmark
+            	{
+            		uint8_t  mismatches;
+            		uint32_t cycles;
+
+            		cycles = sbusBenchmark(1000, &mismatches);
+
+            		cliPortPrintF("\nSBUS Frame Decode:  %4ld Cycles, %6.2f uSec\n", cycles, (float)cycles / 72.0f);
+            		cliPortPrintF("SBUS Decode Check:  %s\n\n", (mismatches == 0) ? "Pass" : "FAIL");
+            	}
+
+                validQuery = false;
+                break;
+
             ///////////////////////////
 
 			case 'x':
@@ -122,7 +235,7 @@ void receiverCLI()
 
             ///////////////////////////
 
-            case 'A': // Toggle PPM/Spektrum Satellite Receiver
+            case 'A': // Cycle PPM/Spektrum Satellite/SBUS/MAVLink Receiver
             	NVIC_InitStructure.NVIC_IRQChannel                   = TIM2_IRQn;
             	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;
             	NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 1;
@@ -130,18 +243,11 @@ void receiverCLI()
 
             	NVIC_Init(&NVIC_InitStructure);
 
-            	if (eepromConfig.receiverType == PPM)
-                {
-                	TIM_ITConfig(TIM2, TIM_IT_CC1, DISABLE);
-                	eepromConfig.receiverType = SPEKTRUM;
-                    spektrumInit();
-                }
-                else
-                {
-                	TIM_ITConfig(TIM2, TIM_IT_Update, DISABLE);
-                  	eepromConfig.receiverType = PPM;
-                    ppmRxInit();
-                }
+            	rxStop();
+
+            	eepromConfig.receiverType = (eepromConfig.receiverType + 1) % NUMBER_OF_RECEIVER_TYPES;
+
+            	rxInit();
 
                 receiverQuery = 'a';
                 validQuery = true;
@@ -160,10 +266,16 @@ void receiverCLI()
             ///////////////////////////
 
             case 'C': // Toggle Slave Spektrum State
-                // HJI Inhibit Slave Spektrum on Naze32 Pro if (eepromConfig.slaveSpektrum == true)
+                if (eepromConfig.slaveSpektrum == true)
                     eepromConfig.slaveSpektrum = false;
-                // HJI Inhibit Slave Spektrum on Naze32 Pro else
-                // HJI Inhibit Slave Spektrum on Naze32 Pro	    eepromConfig.slaveSpektrum = true;
+                else
+                    eepromConfig.slaveSpektrum = true;
+
+                if (eepromConfig.receiverType == SPEKTRUM)
+                {
+                	spektrumStop();
+                	spektrumInit();
+                }
 
                 receiverQuery = 'a';
                 validQuery = true;
@@ -213,6 +325,16 @@ void receiverCLI()
 
             ///////////////////////////
 
+            case 'H': // Read RC Interpolation Settings
+                eepromConfig.rcInterpolation   = (uint8_t)readFloatCLI();
+                eepromConfig.rcSmoothingCutoff = constrain(readFloatCLI(), 0.0f, 200.0f);
+
+                receiverQuery = 'a';
+                validQuery = true;
+                break;
+
+            ///////////////////////////
+
             case 'W': // Write EEPROM Parameters
                 cliPortPrint("\nWriting EEPROM Parameters....\n\n");
                 writeEEPROM();
@@ -224,12 +346,14 @@ void receiverCLI()
 
 			case '?':
 			   	cliPortPrint("\n");
-			   	cliPortPrint("'a' Receiver Configuration Data            'A' Toggle PPM/Spektrum Receiver\n");
-   		        cliPortPrint("                                           'B' Set RC Control Order                 BTAER1234\n");
+			   	cliPortPrint("'a' Receiver Configuration Data            'A' Cycle PPM/Spektrum/SBUS/MAVLink Receiver\n");
+   		        cliPortPrint("'b' Receiver Frame Timing                  'B' Set RC Control Order                 BTAER1234\n");
+   		        cliPortPrint("'c' SBUS Decode Benchmark                  'C' Toggle Slave Spektrum on RC2\n");
 			   	cliPortPrint("                                           'D' Set RC Control Points                DmidCmd;minChk;maxChk;minThrot;maxThrot\n");
 			   	cliPortPrint("                                           'E' Set Arm/Disarm Counts                EarmCount;disarmCount\n");
 			   	cliPortPrint("                                           'F' Set Maximum Rate Commands            FRP;Y RP = Roll/Pitch, Y = Yaw\n");
 			   	cliPortPrint("                                           'G' Set Maximum Attitude Command\n");
+			   	cliPortPrint("                                           'H' Set RC Interpolation                 Hinterp;cutoffHz, interp 0 = Off, 1 = On\n");
 			   	cliPortPrint("                                           'W' Write EEPROM Parameters\n");
 			   	cliPortPrint("'x' Exit Receiver CLI                      '?' Command Summary\n");
 			   	cliPortPrint("\n");
@@ -92,10 +92,20 @@ void sensorCLI()
             	cliPortPrintF("Mag Bias:                  %9.4f, %9.4f, %9.4f\n", eepromConfig.magBias[XAXIS],
                                                 		                          eepromConfig.magBias[YAXIS],
                                                 		                          eepromConfig.magBias[ZAXIS]);
+            	cliPortPrintF("Mag Soft Iron:             %9.4f, %9.4f, %9.4f\n", eepromConfig.magSoftIron[XAXIS][XAXIS],
+            	                                                                  eepromConfig.magSoftIron[XAXIS][YAXIS],
+            	                                                                  eepromConfig.magSoftIron[XAXIS][ZAXIS]);
+            	cliPortPrintF("                           %9.4f, %9.4f, %9.4f\n", eepromConfig.magSoftIron[YAXIS][XAXIS],
+            	                                                                  eepromConfig.magSoftIron[YAXIS][YAXIS],
+            	                                                                  eepromConfig.magSoftIron[YAXIS][ZAXIS]);
+            	cliPortPrintF("                           %9.4f, %9.4f, %9.4f\n", eepromConfig.magSoftIron[ZAXIS][XAXIS],
+            	                                                                  eepromConfig.magSoftIron[ZAXIS][YAXIS],
+            	                                                                  eepromConfig.magSoftIron[ZAXIS][ZAXIS]);
                 cliPortPrintF("Accel One G:               %9.4f\n",   accelOneG);
                 cliPortPrintF("Accel Cutoff:              %9.4f\n",   eepromConfig.accelCutoff);
                 cliPortPrintF("KpAcc (MARG):              %9.4f\n",   eepromConfig.KpAcc);
                 cliPortPrintF("KpMag (MARG):              %9.4f\n",   eepromConfig.KpMag);
+                cliPortPrintF("Mag Sample Rate:           %9d Hz\n", magSampleRate);
                 cliPortPrintF("hdot est/h est Comp Fil A: %9.4f\n",   eepromConfig.compFilterA);
                 cliPortPrintF("hdot est/h est Comp Fil B: %9.4f\n",   eepromConfig.compFilterB);
 
@@ -120,9 +130,17 @@ void sensorCLI()
                 }
 
                 if (eepromConfig.useMs5611 == true)
+                {
                 	cliPortPrint("\nUsing MS5611....\n\n");
+                	cliPortPrintF("MS5611 OSR:                %9d\n", 256 << eepromConfig.ms5611Osr);
+                }
                 else
+                {
                 	cliPortPrint("\nUsing BMP085....\n\n");
+                	cliPortPrintF("BMP085 OSS:                %9d\n", eepromConfig.bmp085Oss);
+                }
+
+                cliPortPrintF("Baro Temperature Divider:  %9d\n\n", eepromConfig.baroTemperatureDivider);
 
                 if (eepromConfig.verticalVelocityHoldOnly == true)
                 	cliPortPrint("Vertical Velocity Hold Only\n\n");
@@ -137,40 +155,64 @@ void sensorCLI()
                 cliPortPrintF("Battery Very Low Setpoint: %4.2f volts\n",   eepromConfig.batteryVeryLow);
                 cliPortPrintF("Battery Max Low Setpoint:  %4.2f volts\n\n", eepromConfig.batteryMaxLow);
 
+                if (eepromConfig.voltageCompensation == true)
+                	cliPortPrintF("Voltage Compensation:      %4.2f volts/cell, factor %5.3f\n\n", eepromConfig.voltageCompensationCell, voltageCompensation);
+                else
+                	cliPortPrint("Voltage Compensation:      Off\n\n");
+
                 validQuery = false;
                 break;
 
             ///////////////////////////
 
             case 'b': // MPU Calibration
-            	if (eepromConfig.useMpu6050 == true)
-            		mpu6050Calibration();
-            	else
-            		mpu3050Calibration();
+            case 'c': // Magnetometer Calibration
+            case 'd': // Accel Calibration
+            	if (calibrationActive() == true)
+            	{
+            		cliPortPrint("Calibration already in progress....\n\n");
 
-                sensorQuery = 'a';
-                validQuery = true;
-                break;
+            		validQuery = false;
+            		break;
+            	}
 
-            ///////////////////////////
+            	// Calibrations run from the scheduled frames, so leave the
+            	// sensor CLI to let the scheduler run while they are active
 
-            case 'c': // Magnetometer Calibration
-                magCalibration();
+            	cliPortPrint("\nExiting Sensor CLI....\n");
 
-                sensorQuery = 'a';
-                validQuery = true;
-                break;
+            	if (sensorQuery == 'b')
+            	{
+            	    if (eepromConfig.useMpu6050 == true)
+            		    mpu6050Calibration();
+            	    else
+            		    mpu3050Calibration();
+            	}
+            	else if (sensorQuery == 'c')
+            	{
+            		magCalibration();
+            	}
+            	else
+            	{
+            	    if (eepromConfig.useMpu6050 == false)
+            	        accelCalibrationADXL345();
+            	    else
+            	        accelCalibrationMPU();
+            	}
+
+			    cliBusy = false;
+			    return;
+			    break;
 
             ///////////////////////////
 
-            case 'd': // Accel Calibration
-            	if (eepromConfig.useMpu6050 == false)
-            	    accelCalibrationADXL345();
+            case 'e': // Magnetometer Fit Benchmark
+            	if (calibrationActive() == true)
+            		cliPortPrint("Calibration already in progress....\n\n");
             	else
-            	    accelCalibrationMPU();
+            	    magCalibrationBenchmark();
 
-                sensorQuery = 'a';
-                validQuery = true;
+                validQuery = false;
                 break;
 
             ///////////////////////////
@@ -194,6 +236,22 @@ void sensorCLI()
 
             ///////////////////////////
 
+            case 'f': // Baro Rate and Noise Report
+                baroManagerReport();
+
+                validQuery = false;
+                break;
+
+            ///////////////////////////
+
+            case 'g': // Baro Altitude Benchmark
+                baroAltitudeBenchmark();
+
+                validQuery = false;
+                break;
+
+            ///////////////////////////
+
             case 'p': // Toggle BMP085/MS5611
                 if (eepromConfig.useMs5611)
                 {
@@ -206,6 +264,8 @@ void sensorCLI()
                     initMs5611();
                 }
 
+                initBaroManager();
+
                 sensorQuery = 'a';
                 validQuery = true;
                 break;
@@ -303,6 +363,22 @@ void sensorCLI()
 
             ///////////////////////////
 
+            case 'F': // Set Baro Oversampling and Temperature Divider
+                if (eepromConfig.useMs5611 == true)
+                	eepromConfig.ms5611Osr = constrain(readFloatCLI(), 0, 4);
+                else
+                	eepromConfig.bmp085Oss = constrain(readFloatCLI(), 0, 3);
+
+                eepromConfig.baroTemperatureDivider = constrain(readFloatCLI(), 2, 100);
+
+                initBaroManager();
+
+                sensorQuery = 'a';
+                validQuery = true;
+                break;
+
+            ///////////////////////////
+
             case 'N': // Set Voltage Monitor Trip Points
                 eepromConfig.batteryLow     = readFloatCLI();
                 eepromConfig.batteryVeryLow = readFloatCLI();
@@ -318,6 +394,16 @@ void sensorCLI()
 
             ///////////////////////////
 
+            case 'O': // Set Voltage Compensation
+                eepromConfig.voltageCompensation     = (readFloatCLI() != 0.0f);
+                eepromConfig.voltageCompensationCell = constrain(readFloatCLI(), 3.0f, 4.35f);
+
+                sensorQuery = 'a';
+                validQuery = true;
+                break;
+
+            ///////////////////////////
+
             case 'V': // Set Voltage Monitor Parameters
                 eepromConfig.voltageMonitorScale = readFloatCLI();
                 eepromConfig.voltageMonitorBias  = readFloatCLI();
@@ -349,9 +435,12 @@ void sensorCLI()
 			   	cliPortPrint("'b' MPU Calibration                        'B' Set Accel Cutoff                     BAccelCutoff\n");
 			   	cliPortPrint("'c' Magnetometer Calibration               'C' Set kpAcc                            CKpAcc\n");
 			   	cliPortPrint("'d' Accel Calibration                      'D' Set kpMag                            DKpMag\n");
-			   	cliPortPrint("                                           'E' Set h dot est/h est Comp Filter A/B  EA;B\n");
+			   	cliPortPrint("'e' Magnetometer Fit Benchmark             'E' Set h dot est/h est Comp Filter A/B  EA;B\n");
+			   	cliPortPrint("'f' Baro Rate and Noise Report             'F' Set Baro OSR/OSS and Temp Divider    Fosr;divider\n");
+			   	cliPortPrint("'g' Baro Altitude Benchmark\n");
 			   	cliPortPrint("'m' Toggle MPU3050/MPU6050\n");
 			   	cliPortPrint("                                           'N' Set Voltage Monitor Trip Points      Nlow;veryLow;maxLow\n");
+			   	cliPortPrint("                                           'O' Set Voltage Compensation             Oon;cellVolts\n");
 			   	cliPortPrint("'p' Toggle BMP085/MS5611\n");
 			   	cliPortPrint("'v' Toggle Vertical Velocity Hold Only     'V' Set Voltage Monitor Parameters       Vscale;bias;cells\n");
 			    cliPortPrint("                                           'W' Write EEPROM Parameters\n");
@@ -37,6 +37,7 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 void telemetryCLI()
 {
+    uint8_t  index;
     uint8_t  telemetryQuery = 'x';
     uint8_t  validQuery = false;
 
@@ -61,31 +62,28 @@ void telemetryCLI()
             ///////////////////////////
 
             case 'a': // Telemetry Configuration
-                cliPortPrint("\nTelemetry Configuration:\n");
-
-                cliPortPrint("    Telemetry Set 1: ");
-                cliPortPrintF("%s\n", eepromConfig.activeTelemetry == 1 ?   "  Active" : "Inactive");
-
-                cliPortPrint("    Telemetry Set 2: ");
-                cliPortPrintF("%s\n", eepromConfig.activeTelemetry == 2 ?   "  Active" : "Inactive");
-
-                cliPortPrint("    Telemetry Set 3: ");
-                cliPortPrintF("%s\n", eepromConfig.activeTelemetry == 4 ?   "  Active" : "Inactive");
-
-                cliPortPrint("    Telemetry Set 4: ");
-                cliPortPrintF("%s\n", eepromConfig.activeTelemetry == 8 ?   "  Active" : "Inactive");
-
-                cliPortPrint("    Telemetry Set 5: ");
-                cliPortPrintF("%s\n", eepromConfig.activeTelemetry == 16 ?  "  Active" : "Inactive");
-
-                cliPortPrint("    Telemetry Set 6: ");
-                cliPortPrintF("%s\n", eepromConfig.activeTelemetry == 32 ?  "  Active" : "Inactive");
-
-                cliPortPrint("    Telemetry Set 7: ");
-                cliPortPrintF("%s\n", eepromConfig.activeTelemetry == 64 ?  "  Active" : "Inactive");
-
-                cliPortPrint("    Telemetry Set 8: ");
-                cliPortPrintF("%s\n", eepromConfig.activeTelemetry == 128 ? "  Active" : "Inactive");
+            	{
+            		uint8_t  set;
+            		uint32_t bandwidth = telemetryBandwidth();
+
+            		cliPortPrintF("\nTelemetry Configuration, %s Format:\n\n", eepromConfig.telemetryFormat == TELEMETRY_BINARY ? "Binary" : "Text");
+            		cliPortPrint("    Set  Name            State  Divider  Rate Hz  Bytes/Line  Bytes/Sec\n");
+
+            		for (set = 0; set < NUMBER_OF_TELEMETRY_SETS; set++)
+            		{
+            			cliPortPrintF("     %1d   %-12s  %8s  %7d  %7d  %10d  %9ld\n",
+            					      set + 1,
+            					      telemetrySets[set].name,
+            					      (eepromConfig.activeTelemetry & (1 << set)) ? "Active" : "Inactive",
+            					      eepromConfig.telemetryDivider[set],
+            					      TELEMETRY_RATE / eepromConfig.telemetryDivider[set],
+            					      telemetryLineBytes(set),
+            					      telemetrySetBandwidth(set));
+            		}
+
+            		cliPortPrintF("\n    Active Sets: %ld Bytes/Sec, %5.1f%% of the link at %ld baud\n\n",
+            				      bandwidth, (float)bandwidth * 1000.0f / (float)UART1_BAUD_RATE, UART1_BAUD_RATE);
+            	}
 
                 validQuery = false;
                 break;
@@ -102,7 +100,7 @@ void telemetryCLI()
             ///////////////////////////
 
             case 'c': // Toggle Telemetry Set 1 State
-                eepromConfig.activeTelemetry = 1;
+                eepromConfig.activeTelemetry ^= 1;
 
                 telemetryQuery = 'a';
                 validQuery     = true;
@@ -111,7 +109,7 @@ void telemetryCLI()
             ///////////////////////////
 
             case 'd': // Toggle Telemetry Set 2 State
-                eepromConfig.activeTelemetry = 2;
+                eepromConfig.activeTelemetry ^= 2;
 
                 telemetryQuery = 'a';
                 validQuery     = true;
@@ -120,7 +118,7 @@ void telemetryCLI()
             ///////////////////////////
 
             case 'e': // Toggle Telemetry Set 3 State
-                eepromConfig.activeTelemetry = 4;
+                eepromConfig.activeTelemetry ^= 4;
 
                 telemetryQuery = 'a';
                 validQuery     = true;
@@ -129,7 +127,7 @@ void telemetryCLI()
             ///////////////////////////
 
             case 'f': // Toggle Telemetry Set 4 State
-                eepromConfig.activeTelemetry = 8;
+                eepromConfig.activeTelemetry ^= 8;
 
                 telemetryQuery = 'a';
                 validQuery     = true;
@@ -138,7 +136,7 @@ void telemetryCLI()
             ///////////////////////////
 
             case 'g': // Toggle Telemetry Set 5 State
-                eepromConfig.activeTelemetry = 16;
+                eepromConfig.activeTelemetry ^= 16;
 
                 telemetryQuery = 'a';
                 validQuery     = true;
@@ -147,7 +145,7 @@ void telemetryCLI()
             ///////////////////////////
 
             case 'h': // Toggle Telemetry Set 6 State
-                eepromConfig.activeTelemetry = 32;
+                eepromConfig.activeTelemetry ^= 32;
 
                 telemetryQuery = 'a';
                 validQuery     = true;
@@ -155,17 +153,76 @@ void telemetryCLI()
 
             ///////////////////////////
 
-            case 'i': // Toggle Telemetry Set 7 State
-                eepromConfig.activeTelemetry = 64;
+            case 'k': // Telemetry Port Statistics
+                cliPortPrint("\nUART1 Transmit:\n");
+                cliPortPrintF("    DMA Transfers:   %10ld\n", uart1TxStats.dmaCnt);
+                cliPortPrintF("    Bytes Sent:      %10ld\n", uart1TxStats.byteCnt);
+                cliPortPrintF("    Bytes/Transfer:  %10.1f\n", uart1TxStats.dmaCnt ? (float)uart1TxStats.byteCnt / (float)uart1TxStats.dmaCnt : 0.0f);
+                cliPortPrintF("    Dropped Writes:  %10ld\n", uart1TxStats.dropCnt);
+                cliPortPrintF("    Dropped Bytes:   %10ld\n", uart1TxStats.dropBytes);
+                cliPortPrintF("    Buffer High:     %10ld\n\n", uart1TxStats.highWater);
 
-                telemetryQuery = 'a';
+                cliPortPrint("    Set        Lines   Deferred    Skipped\n");
+
+                for (index = 0; index < NUMBER_OF_TELEMETRY_SETS; index++)
+                	cliPortPrintF("     %1d   %10ld %10ld %10ld\n", index + 1,
+                			      telemetryStats[index].lineCnt,
+                			      telemetryStats[index].deferCnt,
+                			      telemetryStats[index].skipCnt);
+
+                cliPortPrint("\n");
+
+                validQuery = false;
+                break;
+
+            ///////////////////////////
+
+            case 'l': // Reset Telemetry Port Statistics
+                uart1TxStatsReset();
+                telemetryStatsReset();
+
+                telemetryQuery = 'k';
                 validQuery     = true;
                 break;
 
             ///////////////////////////
 
-            case 'j': // Toggle Telemetry Set 8 State
-                eepromConfig.activeTelemetry = 128;
+            case 'm': // Telemetry Format Benchmark
+            	{
+            		uint8_t  set;
+            		uint32_t textCycles, binaryCycles;
+            		uint16_t textBytes,  binaryBytes;
+            		float    rate;
+
+            		cliPortPrintF("\nPer line encode cost, CPU and bandwidth at each set's rate, %ld baud:\n\n", UART1_BAUD_RATE);
+            		cliPortPrint("Set  Rate Hz  Text Cycles  Bytes  Binary Cycles  Bytes   Text CPU  Binary CPU   Text Link  Binary Link\n");
+
+            		for (set = 0; set < NUMBER_OF_TELEMETRY_SETS; set++)
+            		{
+            			telemetryBenchmark(set, 100, &textCycles, &textBytes, &binaryCycles, &binaryBytes);
+
+            			rate = (float)TELEMETRY_RATE / (float)eepromConfig.telemetryDivider[set];
+
+            			cliPortPrintF(" %1d   %7.1f  %11ld  %5d  %13ld  %5d  %8.3f%%  %9.3f%%  %9.1f%%  %10.1f%%\n",
+            					      set + 1, rate,
+            					      textCycles,   textBytes,
+            					      binaryCycles, binaryBytes,
+            					      (float)textCycles   * rate / 720000.0f,  // * 100% / 72 MHz
+            					      (float)binaryCycles * rate / 720000.0f,
+            					      (float)textBytes    * rate * 1000.0f / (float)UART1_BAUD_RATE,  // 10 bits per byte * 100%
+            					      (float)binaryBytes  * rate * 1000.0f / (float)UART1_BAUD_RATE);
+            		}
+
+            		cliPortPrint("\n");
+            	}
+
+                validQuery = false;
+                break;
+
+            ///////////////////////////
+
+            case 'n': // Toggle Telemetry Format
+                eepromConfig.telemetryFormat = (eepromConfig.telemetryFormat == TELEMETRY_BINARY) ? TELEMETRY_TEXT : TELEMETRY_BINARY;
 
                 telemetryQuery = 'a';
                 validQuery     = true;
@@ -181,6 +238,18 @@ void telemetryCLI()
 
             ///////////////////////////
 
+            case 'A': // Set Telemetry Set Divider
+            	index = (uint8_t)readFloatCLI() - 1;
+
+            	if (index < NUMBER_OF_TELEMETRY_SETS)
+            		eepromConfig.telemetryDivider[index] = (uint8_t)constrain(readFloatCLI(), 1.0f, 250.0f);
+
+                telemetryQuery = 'a';
+                validQuery     = true;
+                break;
+
+            ///////////////////////////
+
             case 'W': // Write EEPROM Parameters
                 cliPortPrint("\nWriting EEPROM Parameters....\n\n");
                 writeEEPROM();
@@ -194,14 +263,16 @@ void telemetryCLI()
 			   	cliPortPrint("\n");
 			   	cliPortPrint("'a' Telemetry Configuration Data\n");
    		        cliPortPrint("'b' Turn all Telemetry Off\n");
-			   	cliPortPrint("'c' Toggle Telemetry Set 1 State\n");
+			   	cliPortPrint("'c' Toggle Telemetry Set 1 State           'A' Set Telemetry Set Divider            Aset;divider, rate is 500 Hz / divider\n");
 			   	cliPortPrint("'d' Toggle Telemetry Set 2 State\n");
 			   	cliPortPrint("'e' Toggle Telemetry Set 3 State\n");
 			   	cliPortPrint("'f' Toggle Telemetry Set 4 State\n");
    		        cliPortPrint("'g' Toggle Telemetry Set 5 State\n");
    		        cliPortPrint("'h' Toggle Telemetry Set 6 State\n");
-   		        cliPortPrint("'i' Toggle Telemetry Set 7 State\n");
-   		        cliPortPrint("'j' Toggle Telemetry Set 8 State\n");
+   		        cliPortPrint("'k' Telemetry Port Statistics\n");
+   		        cliPortPrint("'l' Reset Telemetry Port Statistics\n");
+   		        cliPortPrint("'m' Telemetry Format Benchmark\n");
+   		        cliPortPrint("'n' Toggle Text/Binary Telemetry Format\n");
    		        cliPortPrint("                                           'W' Write EEPROM Parameters\n");
    		        cliPortPrint("'x' Exit Telemetry CLI                     '?' Command Summary\n");
    		        cliPortPrint("\n");
@@ -56,28 +56,35 @@ float   verticalVelocityCmd;
 void computeAxisCommands(float dt)
 {
     float error;
+    float rateError[3];
+    float rateMaxCmd[3];
     float tempAttCompensation;
 
     if (flightMode == ATTITUDE)
     {
-        attCmd[ROLL ] = rxCommand[ROLL ] * eepromConfig.attitudeScaling;
-        attCmd[PITCH] = rxCommand[PITCH] * eepromConfig.attitudeScaling;
+        attCmd[ROLL ] = rcInterpolatedCommand[ROLL ] * eepromConfig.attitudeScaling;
+        attCmd[PITCH] = rcInterpolatedCommand[PITCH] * eepromConfig.attitudeScaling;
     }
 
     if (flightMode >= ATTITUDE)
     {
         error = standardRadianFormat(attCmd[ROLL] - sensors.attitude500Hz[ROLL]);
-        attPID[ROLL]  = updatePID(error, dt, eepromConfig.attitudeScaling, pidReset, &eepromConfig.PID[ROLL_ATT_PID ]);
+        attPID[ROLL]  = updatePID(error, dt, eepromConfig.attitudeScaling, pidReset, ROLL_ATT_PID);
+
+        if ((autoTuneActive == true) && (autoTuneLoop == AUTOTUNE_ATTITUDE) && (autoTuneAxis == ROLL))
+        	attPID[ROLL] = autoTuneRelay(error, dt);
 
         error = standardRadianFormat(attCmd[PITCH] + sensors.attitude500Hz[PITCH]);
-        attPID[PITCH] = updatePID(error, dt, eepromConfig.attitudeScaling, pidReset, &eepromConfig.PID[PITCH_ATT_PID]);
+        attPID[PITCH] = updatePID(error, dt, eepromConfig.attitudeScaling, pidReset, PITCH_ATT_PID);
 
+        if ((autoTuneActive == true) && (autoTuneLoop == AUTOTUNE_ATTITUDE) && (autoTuneAxis == PITCH))
+        	attPID[PITCH] = autoTuneRelay(error, dt);
     }
 
     if (flightMode == RATE)
     {
-        rateCmd[ROLL ] = rxCommand[ROLL ] * eepromConfig.rollAndPitchRateScaling;
-        rateCmd[PITCH] = rxCommand[PITCH] * eepromConfig.rollAndPitchRateScaling;
+        rateCmd[ROLL ] = rcInterpolatedCommand[ROLL ] * eepromConfig.rollAndPitchRateScaling;
+        rateCmd[PITCH] = rcInterpolatedCommand[PITCH] * eepromConfig.rollAndPitchRateScaling;
     }
     else
     {
@@ -90,26 +97,40 @@ void computeAxisCommands(float dt)
     if (headingHoldEngaged == true)  // Heading Hold is ON
     {
         error = standardRadianFormat(headingReference - sensors.attitude500Hz[YAW]);
-        rateCmd[YAW] = updatePID(error, dt, eepromConfig.attitudeScaling, pidReset, &eepromConfig.PID[HEADING_PID]);
+        rateCmd[YAW] = updatePID(error, dt, eepromConfig.attitudeScaling, pidReset, HEADING_PID);
     }
     else                             // Heading Hold is OFF
-        rateCmd[YAW] = rxCommand[YAW] * eepromConfig.yawRateScaling;
+        rateCmd[YAW] = rcInterpolatedCommand[YAW] * eepromConfig.yawRateScaling;
+
+    ///////////////////////////////////
+
+    if (sysIdState != SYSID_IDLE)
+    	rateCmd[sysIdAxis] += sysIdExcitation();
 
     ///////////////////////////////////
 
-    error = rateCmd[ROLL] - sensors.gyro500Hz[ROLL];
-    ratePID[ROLL] = updatePID(error, dt, eepromConfig.rollAndPitchRateScaling, pidReset, &eepromConfig.PID[ROLL_RATE_PID ]);
+    rateError[ROLL ] = rateCmd[ROLL ] - sensors.gyro500Hz[ROLL ];
+    rateError[PITCH] = rateCmd[PITCH] + sensors.gyro500Hz[PITCH];
+    rateError[YAW  ] = rateCmd[YAW  ] - sensors.gyro500Hz[YAW  ];
+
+    rateMaxCmd[ROLL ] = eepromConfig.rollAndPitchRateScaling;
+    rateMaxCmd[PITCH] = eepromConfig.rollAndPitchRateScaling;
+    rateMaxCmd[YAW  ] = eepromConfig.yawRateScaling;
+
+    gainScheduleUpdate(throttleCmd);  // Throttle command of the previous cycle
+
+    updatePID3(rateError, dt, rateMaxCmd, pidReset, ROLL_RATE_PID, scheduledRateGains, ratePID);
 
-    error = rateCmd[PITCH] + sensors.gyro500Hz[PITCH];
-    ratePID[PITCH] = updatePID(error, dt, eepromConfig.rollAndPitchRateScaling, pidReset, &eepromConfig.PID[PITCH_RATE_PID]);
+    if ((autoTuneActive == true) && (autoTuneLoop == AUTOTUNE_RATE))
+    	ratePID[autoTuneAxis] = autoTuneRelay(rateError[autoTuneAxis], dt);
 
-    error = rateCmd[YAW] - sensors.gyro500Hz[YAW];
-    ratePID[YAW] = updatePID(error, dt, eepromConfig.yawRateScaling, pidReset, &eepromConfig.PID[YAW_RATE_PID  ]);
+    if (sysIdState == SYSID_RUNNING)
+    	sysIdCapture(rateCmd[sysIdAxis], ratePID[sysIdAxis], sensors.gyro500Hz[sysIdAxis]);
 
     ///////////////////////////////////
 
 	if (verticalModeState == ALT_DISENGAGED_THROTTLE_ACTIVE)            // Manual Mode is ON
-        throttleCmd = rxCommand[THROTTLE];
+        throttleCmd = rcInterpolatedCommand[THROTTLE];
 
     else
     {
@@ -118,7 +139,7 @@ void computeAxisCommands(float dt)
             (verticalModeState == ALT_DISENGAGED_THROTTLE_INACTIVE))
         {
             error = altitudeHoldReference - hEstimate;
-			verticalVelocityCmd = updatePID(error, dt, eepromConfig.hDotScaling, pidReset, &eepromConfig.PID[H_PID]);
+			verticalVelocityCmd = updatePID(error, dt, eepromConfig.hDotScaling, pidReset, H_PID);
 		}
         else                                                            // Vertical Velocity Hold is ON
         {
@@ -126,7 +147,7 @@ void computeAxisCommands(float dt)
         }
 
     	error = verticalVelocityCmd - hDotEstimate;
-		throttleCmd = throttleReference + updatePID(error, dt, eepromConfig.hDotScaling, pidReset, &eepromConfig.PID[HDOT_PID]);
+		throttleCmd = throttleReference + updatePID(error, dt, eepromConfig.hDotScaling, pidReset, HDOT_PID);
 
 	    // Get Roll Angle, Constrain to +/-20 degrees (default)
 	    tempAttCompensation = constrain(sensors.attitude500Hz[ROLL ], eepromConfig.rollAttAltCompensationLimit,  -eepromConfig.rollAttAltCompensationLimit);
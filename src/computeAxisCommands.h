@@ -33,6 +33,8 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 ///////////////////////////////////////////////////////////////////////////////
 
+extern float   rateCmd[3];
+
 extern float   ratePID[3];
 
 extern float   verticalVelocityCmd;
@@ -37,7 +37,7 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 const char rcChannelLetters[] = "AERT1234";
 
-static uint8_t checkNewEEPROMConf = 8;
+static uint8_t checkNewEEPROMConf = 21;
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -88,6 +88,13 @@ void readEEPROM(void)
 	    eepromConfig.yawDirection = 1.0f;
 	else
         eepromConfig.yawDirection = -1.0f;
+
+	eepromConfig.ms5611Osr              = constrain(eepromConfig.ms5611Osr,              0,   4);
+	eepromConfig.bmp085Oss              = constrain(eepromConfig.bmp085Oss,              0,   3);
+	eepromConfig.baroTemperatureDivider = constrain(eepromConfig.baroTemperatureDivider, 2, 100);
+
+	if ((eepromConfig.autoTuneChannel < AUX1) || (eepromConfig.autoTuneChannel > AUX4))
+		eepromConfig.autoTuneChannel = 0;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -99,11 +106,9 @@ uint8_t writeEEPROM(void)
 
     ///////////////////////////////////
 
-    if (eepromConfig.receiverType == SPEKTRUM)
+    if ((eepromConfig.receiverType == SPEKTRUM) || (eepromConfig.receiverType == SBUS))
     {
     	USART_Cmd(USART2, DISABLE);
-
-        TIM_Cmd(TIM2, DISABLE);
     }
 
     ///////////////////////////////////
@@ -111,9 +116,6 @@ uint8_t writeEEPROM(void)
     eepromConfig_t *src = &eepromConfig;
     uint32_t       *dst = (uint32_t*)FLASH_WRITE_EEPROM_ADDR;
 
-    // there's no reason to write these values to EEPROM, they'll just be noise
-    zeroPIDstates();
-
     if (src->CRCFlags & CRC_HistoryBad)
         evrPush(EVR_ConfigBadHistory,0);
 
@@ -143,12 +145,8 @@ uint8_t writeEEPROM(void)
 
     ///////////////////////////////////
 
-    if (eepromConfig.receiverType == SPEKTRUM)
+    if ((eepromConfig.receiverType == SPEKTRUM) || (eepromConfig.receiverType == SBUS))
     {
-    	primarySpektrumState.reSync = 1;
-
-    	TIM_Cmd(TIM2, ENABLE);
-
     	USART_Cmd(USART2, ENABLE);
     }
 
@@ -176,6 +174,10 @@ void checkFirstTime(bool eepromReset)
 
         eepromConfig.useMs5611  = false;
 
+        eepromConfig.ms5611Osr              = 4;
+        eepromConfig.bmp085Oss              = 1;
+        eepromConfig.baroTemperatureDivider = 10;
+
         ///////////////////////////////
 
         eepromConfig.accelBias[XAXIS] = 0.0f;
@@ -218,6 +220,16 @@ void checkFirstTime(bool eepromReset)
 	    eepromConfig.magBias[YAXIS] = 0.0f;
 	    eepromConfig.magBias[ZAXIS] = 0.0f;
 
+	    eepromConfig.magSoftIron[XAXIS][XAXIS] = 1.0f;
+	    eepromConfig.magSoftIron[XAXIS][YAXIS] = 0.0f;
+	    eepromConfig.magSoftIron[XAXIS][ZAXIS] = 0.0f;
+	    eepromConfig.magSoftIron[YAXIS][XAXIS] = 0.0f;
+	    eepromConfig.magSoftIron[YAXIS][YAXIS] = 1.0f;
+	    eepromConfig.magSoftIron[YAXIS][ZAXIS] = 0.0f;
+	    eepromConfig.magSoftIron[ZAXIS][XAXIS] = 0.0f;
+	    eepromConfig.magSoftIron[ZAXIS][YAXIS] = 0.0f;
+	    eepromConfig.magSoftIron[ZAXIS][ZAXIS] = 1.0f;
+
 		///////////////////////////////
 
 		eepromConfig.accelCutoff = 0.25f;
@@ -225,7 +237,7 @@ void checkFirstTime(bool eepromReset)
 		///////////////////////////////
 
 		eepromConfig.KpAcc = 1.0f;  // proportional gain governs rate of convergence to accelerometer
-	    eepromConfig.KpMag = 5.0f;  // proportional gain governs rate of convergence to magnetometer
+	    eepromConfig.KpMag = 0.1f;  // proportional gain governs rate of convergence to magnetometer, 1/sec
 
 	    ///////////////////////////////
 
@@ -254,6 +266,10 @@ void checkFirstTime(bool eepromReset)
 
         parseRcChannels("TAER2134");
 
+        eepromConfig.rcInterpolation   = true;
+        eepromConfig.rcSmoothingCutoff = 0.0f;
+
+        eepromConfig.escProtocol  = ESC_PWM;
         eepromConfig.escPwmRate   = 450;
         eepromConfig.servoPwmRate = 50;
 
@@ -293,6 +309,14 @@ void checkFirstTime(bool eepromReset)
 		eepromConfig.freeMix[5][PITCH]    =  0.0f;
         eepromConfig.freeMix[5][YAW  ]    =  0.0f;
 
+		eepromConfig.freeMix[6][ROLL ]    =  0.0f;
+		eepromConfig.freeMix[6][PITCH]    =  0.0f;
+		eepromConfig.freeMix[6][YAW  ]    =  0.0f;
+
+		eepromConfig.freeMix[7][ROLL ]    =  0.0f;
+		eepromConfig.freeMix[7][PITCH]    =  0.0f;
+		eepromConfig.freeMix[7][YAW  ]    =  0.0f;
+
         eepromConfig.rollAttAltCompensationGain   =  1.0f;
         eepromConfig.rollAttAltCompensationLimit  =  0.0f * D2R;
 
@@ -311,65 +335,54 @@ void checkFirstTime(bool eepromReset)
         eepromConfig.PID[ROLL_RATE_PID].I                =  100.0f;
         eepromConfig.PID[ROLL_RATE_PID].D                =    0.0f;
         eepromConfig.PID[ROLL_RATE_PID].N                =  100.0f;
-        eepromConfig.PID[ROLL_RATE_PID].integratorState  =    0.0f;
-        eepromConfig.PID[ROLL_RATE_PID].filterState      =    0.0f;
-        eepromConfig.PID[ROLL_RATE_PID].prevResetState   =   false;
 
         eepromConfig.PID[PITCH_RATE_PID].P               =  250.0f;
         eepromConfig.PID[PITCH_RATE_PID].I               =  100.0f;
         eepromConfig.PID[PITCH_RATE_PID].D               =    0.0f;
         eepromConfig.PID[PITCH_RATE_PID].N               =  100.0f;
-        eepromConfig.PID[PITCH_RATE_PID].integratorState =    0.0f;
-        eepromConfig.PID[PITCH_RATE_PID].filterState     =    0.0f;
-        eepromConfig.PID[PITCH_RATE_PID].prevResetState  =   false;
 
         eepromConfig.PID[YAW_RATE_PID].P                 =  350.0f;
         eepromConfig.PID[YAW_RATE_PID].I                 =  100.0f;
         eepromConfig.PID[YAW_RATE_PID].D                 =    0.0f;
         eepromConfig.PID[YAW_RATE_PID].N                 =  100.0f;
-        eepromConfig.PID[YAW_RATE_PID].integratorState   =    0.0f;
-        eepromConfig.PID[YAW_RATE_PID].filterState       =    0.0f;
-        eepromConfig.PID[YAW_RATE_PID].prevResetState    =   false;
 
         eepromConfig.PID[ROLL_ATT_PID].P                 =    2.0f;
         eepromConfig.PID[ROLL_ATT_PID].I                 =    0.0f;
         eepromConfig.PID[ROLL_ATT_PID].D                 =    0.0f;
         eepromConfig.PID[ROLL_ATT_PID].N                 =  100.0f;
-        eepromConfig.PID[ROLL_ATT_PID].integratorState   =    0.0f;
-        eepromConfig.PID[ROLL_ATT_PID].filterState       =    0.0f;
-        eepromConfig.PID[ROLL_ATT_PID].prevResetState    =   false;
 
         eepromConfig.PID[PITCH_ATT_PID].P                =    2.0f;
         eepromConfig.PID[PITCH_ATT_PID].I                =    0.0f;
         eepromConfig.PID[PITCH_ATT_PID].D                =    0.0f;
         eepromConfig.PID[PITCH_ATT_PID].N                =  100.0f;
-        eepromConfig.PID[PITCH_ATT_PID].integratorState  =    0.0f;
-        eepromConfig.PID[PITCH_ATT_PID].filterState      =    0.0f;
-        eepromConfig.PID[PITCH_ATT_PID].prevResetState   =   false;
 
         eepromConfig.PID[HEADING_PID].P                  =    3.0f;
         eepromConfig.PID[HEADING_PID].I                  =    0.0f;
         eepromConfig.PID[HEADING_PID].D                  =    0.0f;
         eepromConfig.PID[HEADING_PID].N                  =  100.0f;
-        eepromConfig.PID[HEADING_PID].integratorState    =    0.0f;
-        eepromConfig.PID[HEADING_PID].filterState        =    0.0f;
-        eepromConfig.PID[HEADING_PID].prevResetState     =   false;
 
         eepromConfig.PID[HDOT_PID].P                     =    2.0f;
         eepromConfig.PID[HDOT_PID].I                     =    0.0f;
         eepromConfig.PID[HDOT_PID].D                     =    0.0f;
         eepromConfig.PID[HDOT_PID].N                     =  100.0f;
-        eepromConfig.PID[HDOT_PID].integratorState       =    0.0f;
-        eepromConfig.PID[HDOT_PID].filterState           =    0.0f;
-        eepromConfig.PID[HDOT_PID].prevResetState        =   false;
 
         eepromConfig.PID[H_PID].P                        =    2.0f;
         eepromConfig.PID[H_PID].I                        =    0.0f;
         eepromConfig.PID[H_PID].D                        =    0.0f;
         eepromConfig.PID[H_PID].N                        =  100.0f;
-        eepromConfig.PID[H_PID].integratorState          =    0.0f;
-        eepromConfig.PID[H_PID].filterState              =    0.0f;
-        eepromConfig.PID[H_PID].prevResetState           =   false;
+
+        eepromConfig.autoTuneChannel                     = 0;
+
+        eepromConfig.gainScheduleThrottle[0]             = 2000;
+        eepromConfig.gainScheduleThrottle[1]             = 2667;
+        eepromConfig.gainScheduleThrottle[2]             = 3333;
+        eepromConfig.gainScheduleThrottle[3]             = 4000;
+
+        eepromConfig.gainScheduleCellVoltage[0]          = 3.3f;
+        eepromConfig.gainScheduleCellVoltage[1]          = 3.7f;
+        eepromConfig.gainScheduleCellVoltage[2]          = 4.2f;
+
+        memset(eepromConfig.gainScheduleTable, 100, sizeof(eepromConfig.gainScheduleTable));
 
 		///////////////////////////////
 
@@ -381,12 +394,27 @@ void checkFirstTime(bool eepromReset)
         eepromConfig.batteryVeryLow       = 3.20f;
         eepromConfig.batteryMaxLow        = 3.10f;
 
+        eepromConfig.voltageCompensation     = false;
+        eepromConfig.voltageCompensationCell = 3.8f;
+
         eepromConfig.armCount             =  50;
         eepromConfig.disarmCount          =  0;
 
         eepromConfig.activeTelemetry      =  0;
+
+        eepromConfig.telemetryDivider[0]  =  5;  // 500 Hz / divider, 100 Hz
+        eepromConfig.telemetryDivider[1]  =  5;
+        eepromConfig.telemetryDivider[2]  =  5;
+        eepromConfig.telemetryDivider[3]  =  5;
+        eepromConfig.telemetryDivider[4]  =  5;
+        eepromConfig.telemetryDivider[5]  =  5;
+
+        eepromConfig.telemetryFormat      =  TELEMETRY_TEXT;
         eepromConfig.mavlinkEnabled       =  false;
 
+        eepromConfig.blackboxEnabled      =  false;
+        eepromConfig.blackboxDivider      =  1;  // 500 Hz / divider, 500 Hz
+
     	eepromConfig.verticalVelocityHoldOnly = true;
 
     	eepromConfig.CRCFlags = 0;
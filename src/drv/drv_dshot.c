@@ -0,0 +1,115 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// DShot Frame Encoder
+///////////////////////////////////////////////////////////////////////////////
+
+// 11 bit value, 0 is motor stop, 1 to 47 are ESC commands, 48 to 2047 is
+// throttle.  Telemetry request bit follows, then a 4 bit XOR checksum of the
+// preceding three nibbles.
+
+uint16_t dshotEncodeFrame(uint16_t value, uint8_t telemetry)
+{
+    uint16_t frame;
+    uint16_t crc;
+
+    frame = ((value & 0x07FF) << 1) | (telemetry ? 1 : 0);
+
+    crc   = (frame ^ (frame >> 4) ^ (frame >> 8)) & 0x000F;
+
+    return (frame << 4) | crc;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// DShot Throttle
+///////////////////////////////////////////////////////////////////////////////
+
+// Motor command (2000 to 4000) to DShot throttle (48 to 2047), MINCOMMAND
+// and below is motor stop
+
+uint16_t dshotThrottle(uint16_t value)
+{
+    if (value <= MINCOMMAND)
+    	return 0;
+
+    if (value >= (MINCOMMAND + 2000))
+    	return 2047;
+
+    return 48 + ((uint32_t)(value - MINCOMMAND) * 1999) / 2000;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// DShot Fill Column
+///////////////////////////////////////////////////////////////////////////////
+
+// Writes one output's frame, MSB first, down its CCR column of the bit rows
+
+void dshotFillColumn(uint16_t rows[DSHOT_FRAME_ROWS][4], uint8_t column, uint16_t frame, uint16_t bitOne, uint16_t bitZero)
+{
+    uint8_t bit;
+
+    for (bit = 0; bit < DSHOT_FRAME_BITS; bit++)
+    {
+    	rows[bit][column] = (frame & 0x8000) ? bitOne : bitZero;
+    	frame <<= 1;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// DShot DMA Busy
+///////////////////////////////////////////////////////////////////////////////
+
+// A frame is going out while the channel is enabled with transfers left.
+// DMA_Init() leaves CNDTR at the buffer size with the channel disabled, and
+// a finished frame leaves CNDTR at zero with the channel still enabled.
+
+uint8_t dshotDmaBusy(DMA_Channel_TypeDef *dma)
+{
+    return ((dma->CCR & DMA_CCR1_EN) != 0) && (dma->CNDTR != 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// DShot DMA Arm
+///////////////////////////////////////////////////////////////////////////////
+
+// CNDTR can only be written with the channel disabled
+
+void dshotDmaArm(DMA_Channel_TypeDef *dma)
+{
+    dma->CCR  &= ~DMA_CCR1_EN;
+    dma->CNDTR = DSHOT_FRAME_ROWS * 4;
+    dma->CCR  |=  DMA_CCR1_EN;
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,72 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+
+// One 4 half word row of CCR1 to CCR4 values per bit, the two trailing zero
+// rows leave the outputs low until the next frame
+
+#define DSHOT_FRAME_BITS   16
+#define DSHOT_FRAME_ROWS   (DSHOT_FRAME_BITS + 2)
+
+///////////////////////////////////////////////////////////////////////////////
+// DShot Frame Encoder
+///////////////////////////////////////////////////////////////////////////////
+
+uint16_t dshotEncodeFrame(uint16_t value, uint8_t telemetry);
+
+///////////////////////////////////////////////////////////////////////////////
+// DShot Throttle
+///////////////////////////////////////////////////////////////////////////////
+
+uint16_t dshotThrottle(uint16_t value);
+
+///////////////////////////////////////////////////////////////////////////////
+// DShot Fill Column
+///////////////////////////////////////////////////////////////////////////////
+
+void dshotFillColumn(uint16_t rows[DSHOT_FRAME_ROWS][4], uint8_t column, uint16_t frame, uint16_t bitOne, uint16_t bitZero);
+
+///////////////////////////////////////////////////////////////////////////////
+// DShot DMA Busy
+///////////////////////////////////////////////////////////////////////////////
+
+uint8_t dshotDmaBusy(DMA_Channel_TypeDef *dma);
+
+///////////////////////////////////////////////////////////////////////////////
+// DShot DMA Arm
+///////////////////////////////////////////////////////////////////////////////
+
+void dshotDmaArm(DMA_Channel_TypeDef *dma);
+
+///////////////////////////////////////////////////////////////////////////////
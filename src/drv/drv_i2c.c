@@ -290,6 +290,25 @@ void I2C2_EV_IRQHandler(void)
     I2C_EV_Handler();
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// I2C Wait For Idle
+///////////////////////////////////////////////////////////////////////////////
+
+// An async read may still own the bus, let it finish before starting a new job
+
+static void i2cWaitForIdle(void)
+{
+    uint32_t timeout = I2C_DEFAULT_TIMEOUT;
+
+    while (busy && --timeout > 0);
+    if (timeout == 0) {
+        if (I2Cx == I2C1) i2c1ErrorCount++;
+        if (I2Cx == I2C2) i2c2ErrorCount++;
+        i2cInit(I2Cx);                                                  // Reinit peripheral + clock out garbage
+        busy = 0;
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // I2C Write Buffer
 ///////////////////////////////////////////////////////////////////////////////
@@ -300,6 +319,8 @@ bool i2cWriteBuffer(I2C_TypeDef *I2C, uint8_t addr_, uint8_t reg_, uint8_t len_,
     uint8_t my_data[16];
     uint32_t timeout = I2C_DEFAULT_TIMEOUT;
 
+    i2cWaitForIdle();
+
     I2Cx = I2C;
 
     addr = addr_ << 1;
@@ -332,6 +353,7 @@ bool i2cWriteBuffer(I2C_TypeDef *I2C, uint8_t addr_, uint8_t reg_, uint8_t len_,
         if (I2Cx == I2C1) i2c1ErrorCount++;
         if (I2Cx == I2C2) i2c2ErrorCount++;
         i2cInit(I2Cx);                                                  // Reinit peripheral + clock out garbage
+        busy = 0;
         return false;
     }
 
@@ -348,13 +370,11 @@ bool i2cWrite(I2C_TypeDef *I2C, uint8_t addr_, uint8_t reg_, uint8_t data)
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-// I2C Read
+// I2C Start Read
 ///////////////////////////////////////////////////////////////////////////////
 
-bool i2cRead(I2C_TypeDef *I2C, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t *buf)
+static void i2cStartRead(I2C_TypeDef *I2C, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t *buf)
 {
-    uint32_t timeout = I2C_DEFAULT_TIMEOUT;
-
     I2Cx = I2C;
 
     addr = addr_ << 1;
@@ -375,18 +395,57 @@ bool i2cRead(I2C_TypeDef *I2C, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t
         }
         I2C_ITConfig(I2Cx, I2C_IT_EVT | I2C_IT_ERR, ENABLE);            // Allow the interrupts to fire off again
     }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// I2C Read
+///////////////////////////////////////////////////////////////////////////////
+
+bool i2cRead(I2C_TypeDef *I2C, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t *buf)
+{
+    uint32_t timeout = I2C_DEFAULT_TIMEOUT;
+
+    i2cWaitForIdle();
+
+    i2cStartRead(I2C, addr_, reg_, len, buf);
 
     while (busy && --timeout > 0);
     if (timeout == 0) {
         if (I2Cx == I2C1) i2c1ErrorCount++;
         if (I2Cx == I2C2) i2c2ErrorCount++;
         i2cInit(I2Cx);                                                  // Reinit peripheral + clock out garbage
+        busy = 0;
         return false;
     }
 
     return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// I2C Read Async
+///////////////////////////////////////////////////////////////////////////////
+
+// Starts the read and returns, buf must stay valid until i2cBusy() is false
+
+bool i2cReadAsync(I2C_TypeDef *I2C, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t *buf)
+{
+    if (busy)
+        return false;
+
+    i2cStartRead(I2C, addr_, reg_, len, buf);
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// I2C Busy
+///////////////////////////////////////////////////////////////////////////////
+
+bool i2cBusy(void)
+{
+    return busy;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // I2C Unstick
 ///////////////////////////////////////////////////////////////////////////////
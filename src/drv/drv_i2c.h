@@ -55,6 +55,18 @@ bool i2cWrite(I2C_TypeDef *I2C, uint8_t addr_, uint8_t reg, uint8_t data);
 
 bool i2cRead(I2C_TypeDef *I2C, uint8_t addr_, uint8_t reg, uint8_t len, uint8_t* buf);
 
+///////////////////////////////////////////////////////////////////////////////
+// I2C Read Async
+///////////////////////////////////////////////////////////////////////////////
+
+bool i2cReadAsync(I2C_TypeDef *I2C, uint8_t addr_, uint8_t reg, uint8_t len, uint8_t* buf);
+
+///////////////////////////////////////////////////////////////////////////////
+// I2C Busy
+///////////////////////////////////////////////////////////////////////////////
+
+bool i2cBusy(void);
+
 ///////////////////////////////////////////////////////////////////////////////
 // Get I2C Error Count
 ///////////////////////////////////////////////////////////////////////////////
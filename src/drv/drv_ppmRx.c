@@ -35,17 +35,222 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 // PPM Receiver Defines and Variables
 ///////////////////////////////////////////////////////////////////////////////
 
-#define RX_PULSE_1p5MS 3000  // 1.5 ms pulse width
+// TIM2 runs in PWM input reset mode, each rising edge on TIM2_CH1 (PA0)
+// captures the time since the previous edge in CCR1 and resets the counter.
+// The reset is an update event, which requests a DMA transfer of CCR1 into
+// a circular buffer on DMA1 Channel 2 (TIM2_CH1 has no DMA request of its
+// own that UART1 isn't already using).  No interrupt is taken per edge, the
+// main loop decodes whatever has been captured, and the counter is the time
+// since the latest edge.
 
-uint8_t i;
+#define RX_PULSE_1p5MS     3000   // 1.5 ms pulse width
 
-uint16_t pulseWidth[8];      // Computed pulse width
+#define PPM_PULSE_MIN      1500   // 0.5 uSec ticks, 750 uSec
+#define PPM_PULSE_MAX      4500   // 2250 uSec
+#define PPM_SYNC_MIN       5400   // Per http://www.rcgroups.com/forums/showpost.php?p=21996147&postcount=3960
+                                  // "So, if you use 2.5ms or higher as being the reset for the PPM stream start,
+                                  // you will be fine. I use 2.7ms just to be safe."
+#define PPM_SIGNAL_LOST   50000   // 25 mSec without an edge, before the counter wraps and captures garbage
+
+#define PPM_MIN_CHANNELS      4
+
+#define PPM_BUFFER_SIZE      64   // Power of 2, captures
+
+#define PPM_OVERRUN_TIME  (PPM_BUFFER_SIZE * PPM_PULSE_MIN / 2)  // uSec, shortest time to fill the buffer
+
+static volatile uint16_t ppmDmaBuffer[PPM_BUFFER_SIZE];
+
+static uint8_t  ppmTail;
+static uint32_t ppmLastProcessTime;
+
+static uint8_t  ppmSynced;
+static uint8_t  ppmChannel;             // Channels so far in the current frame
+static uint8_t  ppmFrameBad;
+static uint8_t  ppmFrameDelivered;
+static uint8_t  ppmPreviousChannelCnt;  // Channels in the previous good frame
+static uint8_t  ppmExpectedChannels;    // Set once two frames agree, 0 until then
+static uint32_t ppmFrameTicks;          // Captures summed since the previous sync
+
+static uint16_t ppmFrame[PPM_MAX_CHANNELS];
+
+///////////////////////////////////////
+
+ppmStateType ppmState;
+
+uint16_t pulseWidth[PPM_MAX_CHANNELS];  // Computed pulse width
+
+///////////////////////////////////////////////////////////////////////////////
+// PPM Frame Deliver
+///////////////////////////////////////////////////////////////////////////////
+
+static void ppmFrameDeliver(uint32_t frameTime)
+{
+	memcpy(pulseWidth, ppmFrame, ppmChannel * sizeof(ppmFrame[0]));
+
+	rcFrameComplete(frameTime, (1 << ppmChannel) - 1, true, ppmFrame);
+
+	ppmFrameDelivered = true;
+}
 
 ///////////////////////////////////////////////////////////////////////////////
-// PPM Receiver Interrupt Handler
+// PPM Frame Sync, the capture that ends a sync gap
 ///////////////////////////////////////////////////////////////////////////////
 
-// See drv_rxCommon.c
+static void ppmFrameSync(uint32_t frameEndTime)
+{
+	float    interval, deviation;
+
+	// Sync to sync interval and jitter, in timer ticks so the main loop
+	// latency doesn't show up in them
+
+	interval = (float)ppmFrameTicks * 0.5f;
+
+	if (ppmState.frameCnt == 0)
+		ppmState.frameIntervalAverage = interval;
+
+	ppmState.frameIntervalAverage = ppmState.frameIntervalAverage * 0.99f + interval * 0.01f;
+
+	if ((uint32_t)interval > ppmState.frameIntervalMax)
+		ppmState.frameIntervalMax = (uint32_t)interval;
+
+	deviation = fabsf(interval - ppmState.frameIntervalAverage);
+
+	ppmState.frameJitterAverage = ppmState.frameJitterAverage * 0.99f + deviation * 0.01f;
+
+	if (deviation > ppmState.frameJitterMax)
+		ppmState.frameJitterMax = deviation;
+
+	// The frame, unless it was already passed on when its last expected
+	// channel arrived.  A channel count that changes isn't trusted until
+	// it has been seen twice.
+
+	if ((ppmFrameBad == false) && (ppmChannel >= PPM_MIN_CHANNELS) && (ppmChannel <= PPM_MAX_CHANNELS))
+	{
+		ppmState.frameCnt++;
+		ppmState.channelCnt = ppmChannel;
+
+		if ((ppmFrameDelivered == false) && (ppmChannel == ppmPreviousChannelCnt))
+			ppmFrameDeliver(frameEndTime);
+
+		ppmExpectedChannels   = (ppmChannel == ppmPreviousChannelCnt) ? ppmChannel : 0;
+		ppmPreviousChannelCnt = ppmChannel;
+	}
+	else
+	{
+		ppmState.badFrameCnt++;
+
+		ppmExpectedChannels   = 0;
+		ppmPreviousChannelCnt = 0;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PPM Receiver Process
+//
+// Called from the main loop on every pass.  Each capture is the width from
+// the previous rising edge, a width over PPM_SYNC_MIN ends a frame.  With
+// the channel count known, a frame is passed on as soon as its last channel
+// is captured, rather than 2.7 mSec or more later at the end of the sync gap.
+///////////////////////////////////////////////////////////////////////////////
+
+void ppmRxProcess(void)
+{
+	uint8_t  head;
+	uint16_t sinceEdge, width;
+	uint32_t now, latestEdgeTime, edgeTime;
+	uint32_t batchTicks = 0;
+	uint8_t  index;
+
+	// Position of the latest capture and the time since its edge, read
+	// again if an edge came along in between
+
+	do
+	{
+		head      = (uint8_t)(PPM_BUFFER_SIZE - DMA1_Channel2->CNDTR) & (PPM_BUFFER_SIZE - 1);
+		sinceEdge = TIM2->CNT;
+		now       = micros();
+	}
+	while (head != ((uint8_t)(PPM_BUFFER_SIZE - DMA1_Channel2->CNDTR) & (PPM_BUFFER_SIZE - 1)));
+
+	if (sinceEdge > PPM_SIGNAL_LOST)
+	{
+		if (ppmSynced == true)
+			ppmState.lostCnt++;
+
+		ppmSynced             = false;
+		ppmExpectedChannels   = 0;
+		ppmPreviousChannelCnt = 0;
+		ppmTail               = head;
+		ppmLastProcessTime    = now;
+		return;
+	}
+
+	if ((now - ppmLastProcessTime) > PPM_OVERRUN_TIME)  // Main loop was held up, the buffer may have wrapped
+	{
+		ppmState.overrunCnt++;
+
+		ppmSynced             = false;
+		ppmExpectedChannels   = 0;
+		ppmPreviousChannelCnt = 0;
+		ppmTail               = head;
+	}
+
+	ppmLastProcessTime = now;
+
+	if (head == ppmTail)
+		return;
+
+	for (index = ppmTail; index != head; index = (index + 1) & (PPM_BUFFER_SIZE - 1))
+		batchTicks += ppmDmaBuffer[index];
+
+	latestEdgeTime = now - sinceEdge / 2;
+
+	///////////////////////////////////
+
+	while (ppmTail != head)
+	{
+		width   = ppmDmaBuffer[ppmTail];
+		ppmTail = (ppmTail + 1) & (PPM_BUFFER_SIZE - 1);
+
+		batchTicks    -= width;
+		edgeTime       = latestEdgeTime - batchTicks / 2;
+		ppmFrameTicks += width;
+
+		if (width >= PPM_SYNC_MIN)
+		{
+			if (ppmSynced == true)
+				ppmFrameSync(edgeTime - width / 2);  // The last channel ended where the sync gap began
+
+			ppmSynced         = true;
+			ppmChannel        = 0;
+			ppmFrameBad       = false;
+			ppmFrameDelivered = false;
+			ppmFrameTicks     = 0;
+		}
+		else if (ppmSynced == true)
+		{
+			if ((ppmChannel < PPM_MAX_CHANNELS) && (width >= PPM_PULSE_MIN) && (width <= PPM_PULSE_MAX))
+				ppmFrame[ppmChannel] = width;
+			else
+				ppmFrameBad = true;
+
+			ppmChannel++;
+
+			if ((ppmChannel == ppmExpectedChannels) && (ppmFrameBad == false))
+				ppmFrameDeliver(edgeTime);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PPM Receiver Statistics Reset
+///////////////////////////////////////////////////////////////////////////////
+
+void ppmRxStatsReset(void)
+{
+	ppmState.frameIntervalMax = 0;
+	ppmState.frameJitterMax   = 0.0f;
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 // PPM Receiver Initialization
@@ -54,9 +259,26 @@ uint16_t pulseWidth[8];      // Computed pulse width
 void ppmRxInit(void)
 {
     GPIO_InitTypeDef         GPIO_InitStructure;
+    DMA_InitTypeDef          DMA_InitStructure;
     TIM_ICInitTypeDef        TIM_ICInitStructure;
     TIM_TimeBaseInitTypeDef  TIM_TimeBaseStructure;
-    NVIC_InitTypeDef         NVIC_InitStructure;
+
+    uint8_t                  channel;
+
+    ///////////////////////////////////
+
+    DMA_Cmd(DMA1_Channel2, DISABLE);
+
+    TIM_DeInit(TIM2);  // Clear anything the Spektrum soft serial left behind
+
+    memset(&ppmState, 0, sizeof(ppmState));
+
+    ppmTail               = 0;
+    ppmSynced             = false;
+    ppmExpectedChannels   = 0;
+    ppmPreviousChannelCnt = 0;
+    ppmFrameTicks         = 0;
+    ppmLastProcessTime    = micros();
 
     ///////////////////////////////////
 
@@ -64,8 +286,8 @@ void ppmRxInit(void)
     // TIM2_CH1 PA0
 
     // preset channels to center
-	for (i = 0; i < 8; i++)
-	    pulseWidth[i] = RX_PULSE_1p5MS;
+	for (channel = 0; channel < PPM_MAX_CHANNELS; channel++)
+	    pulseWidth[channel] = RX_PULSE_1p5MS;
 
 	GPIO_InitStructure.GPIO_Pin   = GPIO_Pin_0;
 	GPIO_InitStructure.GPIO_Mode  = GPIO_Mode_IPD;
@@ -73,13 +295,6 @@ void ppmRxInit(void)
 
 	GPIO_Init(GPIOA, &GPIO_InitStructure);
 
-	NVIC_InitStructure.NVIC_IRQChannel                   = TIM2_IRQn;
-    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;
-    NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 1;
-    NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
-
-    NVIC_Init(&NVIC_InitStructure);
-
     TIM_TimeBaseStructure.TIM_Prescaler         = (36 - 1);
 	TIM_TimeBaseStructure.TIM_CounterMode       = TIM_CounterMode_Up;
 	TIM_TimeBaseStructure.TIM_Period            = 0xFFFF;
@@ -96,10 +311,46 @@ void ppmRxInit(void)
 
     TIM_ICInit(TIM2, &TIM_ICInitStructure);
 
-    TIM_ITConfig(TIM2, TIM_IT_CC1, ENABLE);
+    // Each edge captures then resets the counter, the reset is an update event
+
+    TIM_SelectInputTrigger(TIM2, TIM_TS_TI1FP1);
+    TIM_SelectSlaveMode(TIM2, TIM_SlaveMode_Reset);
+
+    // Update DMA requests copy each capture into a circular buffer
+
+    DMA_DeInit(DMA1_Channel2);
+
+    DMA_InitStructure.DMA_Priority           = DMA_Priority_Medium;
+    DMA_InitStructure.DMA_M2M                = DMA_M2M_Disable;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t) & TIM2->CCR1;
+    DMA_InitStructure.DMA_MemoryBaseAddr     = (uint32_t) ppmDmaBuffer;
+    DMA_InitStructure.DMA_DIR                = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_PeripheralInc      = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    DMA_InitStructure.DMA_MemoryInc          = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_MemoryDataSize     = DMA_MemoryDataSize_HalfWord;
+    DMA_InitStructure.DMA_BufferSize         = PPM_BUFFER_SIZE;
+    DMA_InitStructure.DMA_Mode               = DMA_Mode_Circular;
+
+    DMA_Init(DMA1_Channel2, &DMA_InitStructure);
+
+    DMA_Cmd(DMA1_Channel2, ENABLE);
+
+    TIM_DMACmd(TIM2, TIM_DMA_Update, ENABLE);
     TIM_Cmd(TIM2, ENABLE);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// PPM Receiver Stop
+///////////////////////////////////////////////////////////////////////////////
+
+void ppmRxStop(void)
+{
+	TIM_DMACmd(TIM2, TIM_DMA_Update, DISABLE);
+	DMA_Cmd(DMA1_Channel2, DISABLE);
+	TIM_DeInit(TIM2);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // PPM Receiver Read
 ///////////////////////////////////////////////////////////////////////////////
@@ -35,7 +35,26 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 // PPM Receiver Defines and Variables
 ///////////////////////////////////////////////////////////////////////////////
 
-extern uint16_t pulseWidth[8];  // Computed pulse width
+#define PPM_MAX_CHANNELS 12
+
+struct ppmStateStruct
+{
+    uint8_t  channelCnt;            // Channels in the latest complete frame
+    uint32_t frameCnt;
+    uint32_t badFrameCnt;           // Frames with a pulse out of range or too few or many channels
+    uint32_t lostCnt;               // Signal losses
+    uint32_t overrunCnt;            // Capture buffer overruns
+    float    frameIntervalAverage;  // uSec, sync to sync, from the timer captures
+    uint32_t frameIntervalMax;      // uSec
+    float    frameJitterAverage;    // uSec, mean absolute deviation from the average interval
+    float    frameJitterMax;        // uSec
+};
+
+typedef struct ppmStateStruct ppmStateType;
+
+extern ppmStateType ppmState;
+
+extern uint16_t pulseWidth[PPM_MAX_CHANNELS];  // Computed pulse width
 
 ///////////////////////////////////////////////////////////////////////////////
 // PPM Receiver Initialization
@@ -43,6 +62,24 @@ extern uint16_t pulseWidth[8];  // Computed pulse width
 
 void ppmRxInit(void);
 
+///////////////////////////////////////////////////////////////////////////////
+// PPM Receiver Stop
+///////////////////////////////////////////////////////////////////////////////
+
+void ppmRxStop(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// PPM Receiver Process
+///////////////////////////////////////////////////////////////////////////////
+
+void ppmRxProcess(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// PPM Receiver Statistics Reset
+///////////////////////////////////////////////////////////////////////////////
+
+void ppmRxStatsReset(void);
+
 ///////////////////////////////////////////////////////////////////////////////
 // PPM Receiver Read
 ///////////////////////////////////////////////////////////////////////////////
@@ -37,12 +37,355 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 #define ESC_PULSE_1MS    2000  // 1ms pulse width
 
+// OneShot timers run at 72 MHz, motor commands are in 0.5 uSec counts (2000 to 4000)
+//
+// OneShot125, 125 to 250 uSec, 9000 to 18000 counts, command * 9 / 2
+// OneShot42,   42 to  84 uSec, 3000 to  6000 counts, command * 3 / 2
+
+#define ONESHOT_DISABLED_PULSE  0xFFFF  // Compare never reached, no pulse
+
 static volatile uint16_t *OutputChannels[] = { &(TIM4->CCR4),
 	                                           &(TIM4->CCR3),
 	                                           &(TIM4->CCR2),
 	                                           &(TIM4->CCR1),
 	                                           &(TIM1->CCR4),
-	                                           &(TIM1->CCR1),};
+	                                           &(TIM1->CCR1),
+	                                           &(TIM3->CCR1),
+	                                           &(TIM3->CCR2),};
+
+static uint8_t  oneShotChannels = 0;  // Bit per output channel driven in one pulse mode
+
+static uint16_t oneShotWidth[8];
+
+static uint8_t  escTim3 = false;  // TIM3 taken from the servo outputs for motors 7 and 8
+
+// DShot frames are written by DMA burst into CCR1 to CCR4 of each timer, one
+// 4 half word row per bit.  TIM4 bursts on update (DMA1 Channel 7), TIM1 on
+// an internal CC2 compare (DMA1 Channel 3) as TIM1 update shares Channel 5
+// with the UART1 receiver.  Row 0 is written one bit period ahead, the
+// trailing zero rows leave the outputs low until the next frame.
+
+#define DSHOT_TIM4  0
+#define DSHOT_TIM1  1
+
+static uint8_t  dshotChannels = 0;  // Bit per output channel driven with DShot
+
+static uint16_t dshotValue[6];
+
+static uint16_t dshotBitOne;
+static uint16_t dshotBitZero;
+
+static uint16_t dshotBuffer[2][DSHOT_FRAME_ROWS][4];
+
+static const uint8_t dshotTimer[6]  = { DSHOT_TIM4, DSHOT_TIM4, DSHOT_TIM4, DSHOT_TIM4, DSHOT_TIM1, DSHOT_TIM1 };
+static const uint8_t dshotColumn[6] = { 3, 2, 1, 0, 3, 0 };  // CCRx - 1
+
+static DMA_Channel_TypeDef * const dshotDma[2] = { DMA1_Channel7, DMA1_Channel3 };
+
+// Latency is measured on motor 1, the command is stamped by pwmEscTrigger()
+// and the pulse or frame end by the TIM4 or DMA1 Channel 7 interrupt.
+
+float escLatencyAverage = 0.0f;
+
+float escLatencyMax     = 0.0f;
+
+static uint32_t          escCommandCycles;
+static volatile uint32_t escLatencyCycles;
+static volatile uint8_t  escLatencyPending = false;
+static volatile uint8_t  escLatencyReady   = false;
+
+///////////////////////////////////////////////////////////////////////////////
+// OneShot ESC Initialization
+///////////////////////////////////////////////////////////////////////////////
+
+// Each pulse is fired by pwmEscTrigger() in one pulse mode using PWM2, the
+// output goes active at CCR and the counter stops at ARR, so the pulses of
+// all motors end together at ARR.  Tricopter keeps TIM1 as PWM for the
+// yaw servo.  TIM3 only goes to one pulse mode with more than 6 motors,
+// when writeServos() leaves the servo outputs off.
+
+static void oneShotInit(void)
+{
+    TIM_TimeBaseInitTypeDef  TIM_TimeBaseStructure;
+    TIM_OCInitTypeDef        TIM_OCInitStructure;
+    uint8_t i;
+
+    TIM_TimeBaseStructure.TIM_Period            = 0xFFFF;
+    TIM_TimeBaseStructure.TIM_Prescaler         = 0;
+    TIM_TimeBaseStructure.TIM_ClockDivision     = TIM_CKD_DIV1;
+    TIM_TimeBaseStructure.TIM_CounterMode       = TIM_CounterMode_Up;
+    TIM_TimeBaseStructure.TIM_RepetitionCounter = 0x0000;
+
+    TIM_OCInitStructure.TIM_OCMode       = TIM_OCMode_PWM2;
+    TIM_OCInitStructure.TIM_OutputState  = TIM_OutputState_Enable;
+    TIM_OCInitStructure.TIM_OutputNState = TIM_OutputNState_Disable;
+    TIM_OCInitStructure.TIM_Pulse        = ONESHOT_DISABLED_PULSE;
+    TIM_OCInitStructure.TIM_OCPolarity   = TIM_OCPolarity_High;
+    TIM_OCInitStructure.TIM_OCNPolarity  = TIM_OCPolarity_High;
+    TIM_OCInitStructure.TIM_OCIdleState  = TIM_OCIdleState_Reset;
+    TIM_OCInitStructure.TIM_OCNIdleState = TIM_OCNIdleState_Reset;
+
+    TIM_Cmd(TIM4, DISABLE);
+    TIM_TimeBaseInit(TIM4, &TIM_TimeBaseStructure);
+    TIM_SelectOnePulseMode(TIM4, TIM_OPMode_Single);
+
+    TIM_OC1Init(TIM4, &TIM_OCInitStructure);
+    TIM_OC2Init(TIM4, &TIM_OCInitStructure);
+    TIM_OC3Init(TIM4, &TIM_OCInitStructure);
+    TIM_OC4Init(TIM4, &TIM_OCInitStructure);
+
+    oneShotChannels = 0x0F;
+
+    // All pulses end at the update that stops TIM4
+
+    TIM_ClearITPendingBit(TIM4, TIM_IT_Update);
+    TIM_ITConfig(TIM4, TIM_IT_Update, ENABLE);
+
+    if (eepromConfig.mixerConfiguration != MIXERTYPE_TRI)
+    {
+    	TIM_Cmd(TIM1, DISABLE);
+    	TIM_TimeBaseInit(TIM1, &TIM_TimeBaseStructure);
+    	TIM_SelectOnePulseMode(TIM1, TIM_OPMode_Single);
+
+    	TIM_OC1Init(TIM1, &TIM_OCInitStructure);
+    	TIM_OC4Init(TIM1, &TIM_OCInitStructure);
+
+    	TIM_CtrlPWMOutputs(TIM1, ENABLE);
+
+    	oneShotChannels |= 0x30;
+    }
+
+    if (numberMotor > 6)
+    {
+    	TIM_Cmd(TIM3, DISABLE);
+    	TIM_TimeBaseInit(TIM3, &TIM_TimeBaseStructure);
+    	TIM_SelectOnePulseMode(TIM3, TIM_OPMode_Single);
+
+    	TIM_OC1Init(TIM3, &TIM_OCInitStructure);
+    	TIM_OC2Init(TIM3, &TIM_OCInitStructure);
+
+    	oneShotChannels |= 0xC0;
+    }
+
+    for (i = 0; i < 8; i++)
+    	oneShotWidth[i] = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// DShot ESC Initialization
+///////////////////////////////////////////////////////////////////////////////
+
+// Supports the six motor outputs on TIM4 and TIM1.  Tricopter keeps TIM1
+// as PWM for the yaw servo.
+
+static void dshotInit(void)
+{
+    DMA_InitTypeDef          DMA_InitStructure;
+    TIM_TimeBaseInitTypeDef  TIM_TimeBaseStructure;
+    TIM_OCInitTypeDef        TIM_OCInitStructure;
+    uint16_t bitPeriod;
+    uint8_t  i, j;
+
+    switch (eepromConfig.escProtocol)
+    {
+        case ESC_DSHOT150:
+        	bitPeriod = 480;  // 6.67 uSec at 72 MHz
+        	break;
+
+        case ESC_DSHOT300:
+        	bitPeriod = 240;  // 3.33 uSec
+        	break;
+
+        default:
+        	bitPeriod = 120;  // 1.67 uSec
+        	break;
+    }
+
+    dshotBitOne  = bitPeriod * 3 / 4;
+    dshotBitZero = bitPeriod * 3 / 8;
+
+    for (i = 0; i < 2; i++)
+    	for (j = 0; j < DSHOT_FRAME_ROWS; j++)
+    	{
+    		dshotBuffer[i][j][0] = 0;
+    		dshotBuffer[i][j][1] = 0;
+    		dshotBuffer[i][j][2] = 0;
+    		dshotBuffer[i][j][3] = 0;
+    	}
+
+    for (i = 0; i < 6; i++)
+    	dshotValue[i] = 0;
+
+    ///////////////////////////////////
+
+    TIM_TimeBaseStructure.TIM_Period            = bitPeriod - 1;
+    TIM_TimeBaseStructure.TIM_Prescaler         = 0;
+    TIM_TimeBaseStructure.TIM_ClockDivision     = TIM_CKD_DIV1;
+    TIM_TimeBaseStructure.TIM_CounterMode       = TIM_CounterMode_Up;
+    TIM_TimeBaseStructure.TIM_RepetitionCounter = 0x0000;
+
+    TIM_OCInitStructure.TIM_OCMode       = TIM_OCMode_PWM1;
+    TIM_OCInitStructure.TIM_OutputState  = TIM_OutputState_Enable;
+    TIM_OCInitStructure.TIM_OutputNState = TIM_OutputNState_Disable;
+    TIM_OCInitStructure.TIM_Pulse        = 0;
+    TIM_OCInitStructure.TIM_OCPolarity   = TIM_OCPolarity_High;
+    TIM_OCInitStructure.TIM_OCNPolarity  = TIM_OCPolarity_High;
+    TIM_OCInitStructure.TIM_OCIdleState  = TIM_OCIdleState_Reset;
+    TIM_OCInitStructure.TIM_OCNIdleState = TIM_OCNIdleState_Reset;
+
+    DMA_InitStructure.DMA_DIR                = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_BufferSize         = DSHOT_FRAME_ROWS * 4;
+    DMA_InitStructure.DMA_PeripheralInc      = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc          = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    DMA_InitStructure.DMA_MemoryDataSize     = DMA_MemoryDataSize_HalfWord;
+    DMA_InitStructure.DMA_Mode               = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority           = DMA_Priority_High;
+    DMA_InitStructure.DMA_M2M                = DMA_M2M_Disable;
+
+    ///////////////////////////////////
+
+    TIM_Cmd(TIM4, DISABLE);
+    TIM_TimeBaseInit(TIM4, &TIM_TimeBaseStructure);
+
+    TIM_OC1Init(TIM4, &TIM_OCInitStructure);
+    TIM_OC2Init(TIM4, &TIM_OCInitStructure);
+    TIM_OC3Init(TIM4, &TIM_OCInitStructure);
+    TIM_OC4Init(TIM4, &TIM_OCInitStructure);
+
+    TIM_OC1PreloadConfig(TIM4, TIM_OCPreload_Enable);
+    TIM_OC2PreloadConfig(TIM4, TIM_OCPreload_Enable);
+    TIM_OC3PreloadConfig(TIM4, TIM_OCPreload_Enable);
+    TIM_OC4PreloadConfig(TIM4, TIM_OCPreload_Enable);
+
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&TIM4->DMAR;
+    DMA_InitStructure.DMA_MemoryBaseAddr     = (uint32_t)dshotBuffer[DSHOT_TIM4];
+
+    DMA_Init(DMA1_Channel7, &DMA_InitStructure);
+
+    DMA1_Channel7->CNDTR = 0;  // Idle until the first dshotTrigger()
+
+    // The last row loads at the update that ends the frame
+
+    DMA_ClearITPendingBit(DMA1_IT_TC7);
+    DMA_ITConfig(DMA1_Channel7, DMA_IT_TC, ENABLE);
+
+    TIM_DMAConfig(TIM4, TIM_DMABase_CCR1, TIM_DMABurstLength_4Transfers);
+    TIM_DMACmd(TIM4, TIM_DMA_Update, ENABLE);
+
+    TIM_Cmd(TIM4, ENABLE);
+
+    dshotChannels = 0x0F;
+
+    ///////////////////////////////////
+
+    if ((eepromConfig.mixerConfiguration != MIXERTYPE_TRI) && (numberMotor > 4))
+    {
+    	// CC2 has no output pin enabled, it only times the DMA burst
+
+    	for (j = 0; j < DSHOT_FRAME_ROWS; j++)
+    		dshotBuffer[DSHOT_TIM1][j][1] = bitPeriod / 8;
+
+    	TIM_Cmd(TIM1, DISABLE);
+    	TIM_TimeBaseInit(TIM1, &TIM_TimeBaseStructure);
+
+    	TIM_OC1Init(TIM1, &TIM_OCInitStructure);
+    	TIM_OC4Init(TIM1, &TIM_OCInitStructure);
+
+    	TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Disable;
+    	TIM_OCInitStructure.TIM_Pulse       = bitPeriod / 8;
+
+    	TIM_OC2Init(TIM1, &TIM_OCInitStructure);
+
+    	TIM_OC1PreloadConfig(TIM1, TIM_OCPreload_Enable);
+    	TIM_OC2PreloadConfig(TIM1, TIM_OCPreload_Enable);
+    	TIM_OC4PreloadConfig(TIM1, TIM_OCPreload_Enable);
+
+    	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&TIM1->DMAR;
+    	DMA_InitStructure.DMA_MemoryBaseAddr     = (uint32_t)dshotBuffer[DSHOT_TIM1];
+
+    	DMA_Init(DMA1_Channel3, &DMA_InitStructure);
+
+    	DMA1_Channel3->CNDTR = 0;
+
+    	TIM_DMAConfig(TIM1, TIM_DMABase_CCR1, TIM_DMABurstLength_4Transfers);
+    	TIM_DMACmd(TIM1, TIM_DMA_CC2, ENABLE);
+
+    	TIM_CtrlPWMOutputs(TIM1, ENABLE);
+
+    	TIM_Cmd(TIM1, ENABLE);
+
+    	dshotChannels |= 0x30;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// DShot Trigger
+///////////////////////////////////////////////////////////////////////////////
+
+// Fills the bit rows from the latest commands and re-arms the DMA channels,
+// returns false while the previous frame is still going out.
+
+static uint8_t dshotTrigger(void)
+{
+    uint8_t channel, timer, timers;
+
+    timers = (dshotChannels & 0x30) ? 2 : 1;
+
+    for (timer = 0; timer < timers; timer++)
+    	if (dshotDmaBusy(dshotDma[timer]))
+    		return false;  // Previous frame still in progress
+
+    for (channel = 0; channel < 6; channel++)
+    {
+    	if ((dshotChannels & (1 << channel)) == 0)
+    		continue;
+
+    	dshotFillColumn(dshotBuffer[dshotTimer[channel]], dshotColumn[channel],
+    			        dshotEncodeFrame(dshotThrottle(dshotValue[channel]), 0), dshotBitOne, dshotBitZero);
+    }
+
+    for (timer = 0; timer < timers; timer++)
+    	dshotDmaArm(dshotDma[timer]);
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// ESC Pulse End Interrupts
+///////////////////////////////////////////////////////////////////////////////
+
+static void escPulseEnd(void)
+{
+    if (escLatencyPending == true)
+    {
+    	escLatencyCycles  = *DWT_CYCCNT - escCommandCycles;
+    	escLatencyPending = false;
+    	escLatencyReady   = true;
+    }
+}
+
+///////////////////////////////////////
+
+// PWM motor 1 compare, the pulse end, or OneShot update
+
+void TIM4_IRQHandler(void)
+{
+    TIM_ClearITPendingBit(TIM4, TIM_IT_CC4 | TIM_IT_Update);
+
+    escPulseEnd();
+}
+
+///////////////////////////////////////
+
+// DShot TIM4 frame complete
+
+void DMA1_Channel7_IRQHandler(void)
+{
+    DMA_ClearITPendingBit(DMA1_IT_TC7);
+
+    escPulseEnd();
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 // PWM ESC Initialization
@@ -51,6 +394,7 @@ static volatile uint16_t *OutputChannels[] = { &(TIM4->CCR4),
 void pwmEscInit(void)
 {
     GPIO_InitTypeDef         GPIO_InitStructure;
+    NVIC_InitTypeDef         NVIC_InitStructure;
     TIM_TimeBaseInitTypeDef  TIM_TimeBaseStructure;
     TIM_OCInitTypeDef        TIM_OCInitStructure;
 
@@ -61,6 +405,8 @@ void pwmEscInit(void)
     // ESC PWM4  TIM4_CH1  PB6
     // ESC PWM5  TIM1_CH4  PA11
     // ESC PWM6  TIM1_CH1  PA8
+    // ESC PWM7  TIM3_CH1  PA6, servo output 1, only with more than 6 motors
+    // ESC PWM8  TIM3_CH2  PA7, servo output 2, only with more than 6 motors
 
     GPIO_InitStructure.GPIO_Pin   = GPIO_Pin_8 | GPIO_Pin_11;
     GPIO_InitStructure.GPIO_Mode  = GPIO_Mode_AF_PP;
@@ -75,6 +421,18 @@ void pwmEscInit(void)
 
     ///////////////////////////////////
 
+    // Return the output timers to reset state, clears OneShot and DShot setups
+
+    DMA_Cmd(DMA1_Channel7, DISABLE);
+    DMA_Cmd(DMA1_Channel3, DISABLE);
+
+    DMA_ITConfig(DMA1_Channel7, DMA_IT_TC, DISABLE);
+
+    TIM_DeInit(TIM4);
+    TIM_DeInit(TIM1);
+
+    ///////////////////////////////////
+
     // Output timers
 
 	TIM_TimeBaseStructure.TIM_Period            = (uint16_t)(2000000 / eepromConfig.escPwmRate) - 1;
@@ -115,6 +473,65 @@ void pwmEscInit(void)
 	TIM_CtrlPWMOutputs(TIM1, ENABLE);
 
     TIM_Cmd(TIM1, ENABLE);
+
+    ///////////////////////////////////
+
+    // Motors 7 and 8 retime all of TIM3, writeServos() leaves the servo outputs off
+
+    if (numberMotor > 6)
+    {
+        GPIO_InitStructure.GPIO_Pin = GPIO_Pin_6 | GPIO_Pin_7;
+
+        GPIO_Init(GPIOA, &GPIO_InitStructure);
+
+    	TIM_TimeBaseStructure.TIM_Period = (uint16_t)(2000000 / eepromConfig.escPwmRate) - 1;
+    	TIM_OCInitStructure.TIM_Pulse    = ESC_PULSE_1MS;
+
+    	TIM_TimeBaseInit(TIM3, &TIM_TimeBaseStructure);
+
+    	TIM_SelectOnePulseMode(TIM3, TIM_OPMode_Repetitive);
+
+    	TIM_OC1Init(TIM3, &TIM_OCInitStructure);
+    	TIM_OC2Init(TIM3, &TIM_OCInitStructure);
+
+    	TIM_Cmd(TIM3, ENABLE);
+    }
+    else if (escTim3 == true)
+    {
+    	// Hand TIM3 back at the servo rate, clears a OneShot setup
+
+    	TIM_DeInit(TIM3);
+    	pwmServoInit();
+    }
+
+    escTim3 = (numberMotor > 6);
+
+    ///////////////////////////////////
+
+    oneShotChannels   = 0;
+    dshotChannels     = 0;
+    escLatencyAverage = 0.0f;
+    escLatencyMax     = 0.0f;
+    escLatencyPending = false;
+    escLatencyReady   = false;
+
+    if ((eepromConfig.escProtocol == ESC_ONESHOT125) || (eepromConfig.escProtocol == ESC_ONESHOT42))
+    	oneShotInit();
+    else if ((eepromConfig.escProtocol >= ESC_DSHOT150) && (numberMotor <= 6))
+    	dshotInit();
+    else
+    	TIM_ITConfig(TIM4, TIM_IT_CC4, ENABLE);  // Motor 1 pulse end
+
+    NVIC_InitStructure.NVIC_IRQChannel                   = TIM4_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
+
+    NVIC_Init(&NVIC_InitStructure);
+
+    NVIC_InitStructure.NVIC_IRQChannel                   = DMA1_Channel7_IRQn;
+
+    NVIC_Init(&NVIC_InitStructure);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -123,7 +540,99 @@ void pwmEscInit(void)
 
 void pwmEscWrite(uint8_t channel, uint16_t value)
 {
-    *OutputChannels[channel] = value;
+    if (dshotChannels & (1 << channel))
+    {
+    	dshotValue[channel] = value;
+    }
+    else if (oneShotChannels & (1 << channel))
+    {
+    	if (eepromConfig.escProtocol == ESC_ONESHOT125)
+    		oneShotWidth[channel] = value * 9 / 2;
+    	else
+    		oneShotWidth[channel] = value * 3 / 2;
+    }
+    else
+    {
+        *OutputChannels[channel] = value;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PWM ESC Trigger
+///////////////////////////////////////////////////////////////////////////////
+
+// Called after all channels are written each cycle.  Starts the OneShot
+// pulses or DShot frames, stamps the command for the latency measurement
+// and folds the last measured latency into the statistics.
+
+void pwmEscTrigger(void)
+{
+    uint32_t commandCycles = *DWT_CYCCNT;
+    uint16_t period = 0;
+    float    latency;
+    uint8_t  i;
+
+    if (escLatencyReady == true)
+    {
+    	latency = (float)escLatencyCycles / 72.0f;
+
+    	escLatencyAverage = escLatencyAverage * 0.99f + latency * 0.01f;
+
+    	if (latency > escLatencyMax)
+    		escLatencyMax = latency;
+
+    	escLatencyReady = false;
+    }
+
+    if (dshotChannels != 0)
+    {
+    	if (dshotTrigger() == false)
+    		return;
+    }
+    else if (oneShotChannels != 0)
+    {
+        if ((TIM4->CR1 & TIM_CR1_CEN) || (TIM1->CR1 & TIM_CR1_CEN & (oneShotChannels >> 4)) || (TIM3->CR1 & TIM_CR1_CEN & (oneShotChannels >> 6)))
+        	return;  // Previous pulse still in progress
+
+        for (i = 0; i < 8; i++)
+        	if ((oneShotChannels & (1 << i)) && (oneShotWidth[i] > period))
+        		period = oneShotWidth[i];
+
+        period++;
+
+        for (i = 0; i < 8; i++)
+        {
+        	if (oneShotChannels & (1 << i))
+        	{
+        		if (oneShotWidth[i] == 0)
+        			*OutputChannels[i] = ONESHOT_DISABLED_PULSE;
+        		else
+        			*OutputChannels[i] = period - oneShotWidth[i];
+        	}
+        }
+
+        TIM4->ARR  = period;
+        TIM4->CR1 |= TIM_CR1_CEN;
+
+        if (oneShotChannels & 0x30)
+        {
+        	TIM1->ARR  = period;
+        	TIM1->CR1 |= TIM_CR1_CEN;
+        }
+
+        if (oneShotChannels & 0xC0)
+        {
+        	TIM3->ARR  = period;
+        	TIM3->CR1 |= TIM_CR1_CEN;
+        }
+    }
+
+    // PWM widths are written straight to the compare registers, the next
+    // motor 1 compare ends a pulse with the new width
+
+    escLatencyPending = false;
+    escCommandCycles  = commandCycles;
+    escLatencyPending = true;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -31,6 +31,12 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
+///////////////////////////////////////////////////////////////////////////////
+
+extern float escLatencyAverage;
+
+extern float escLatencyMax;
+
 ///////////////////////////////////////////////////////////////////////////////
 // PWM ESC Initialization
 ///////////////////////////////////////////////////////////////////////////////
@@ -44,3 +50,9 @@ void pwmEscInit(void);
 void pwmEscWrite(uint8_t channel, uint16_t value);
 
 ///////////////////////////////////////////////////////////////////////////////
+// PWM ESC Trigger
+///////////////////////////////////////////////////////////////////////////////
+
+void pwmEscTrigger(void);
+
+///////////////////////////////////////////////////////////////////////////////
@@ -32,55 +32,202 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 #include "board.h"
 
 ///////////////////////////////////////////////////////////////////////////////
-// TIM2 Interrupt Handler
+// Receiver Drivers
 ///////////////////////////////////////////////////////////////////////////////
 
-void TIM2_IRQHandler(void)
+const rxDriver_t rxDrivers[NUMBER_OF_RECEIVER_TYPES] =
 {
-    uint16_t diff;
-    static uint16_t now;
-    static uint16_t last = 0;
-    static uint8_t  chan = 0;
+    { "PPM",                 ppmRxInit,     ppmRxStop,    NULL,                ppmRxProcess    },
+    { "Spektrum Satellite",  spektrumInit,  spektrumStop, &spektrumFrameReady, spektrumProcess },
+    { "SBUS",                sbusInit,      sbusStop,     &sbusFrameReady,     sbusProcess     },
+    { "MAVLink RC Override", mavlinkRcInit, NULL,         NULL,                NULL            },  // Frames from mavlinkReceive()
+};
 
-    if (eepromConfig.receiverType == SPEKTRUM)
-    {
-    TIM_ClearFlag(TIM2, TIM_FLAG_Update);
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Frame Variables
+///////////////////////////////////////////////////////////////////////////////
 
-    if (primarySpektrumState.spektrumTimer)
-        --primarySpektrumState.spektrumTimer;
+static rxFrame_t rcFrame;
 
-    if ((eepromConfig.slaveSpektrum == true)  && false)  // HJI Inhibit Slave Spektrum on Naze32
-    {
-	    if (slaveSpektrumState.spektrumTimer)
-            --slaveSpektrumState.spektrumTimer;
-    }
-    }
-    else
-    {
-    	if (TIM_GetITStatus(TIM2, TIM_IT_CC1) == SET)
-        {
-            last = now;
-            now = TIM_GetCapture1(TIM2);
-            rcActive = true;
-        }
+semaphore_t      rcFrameReady = false;
+
+///////////////////////////////////////
+
+uint32_t rcDataLostCnt;
+
+semaphore_t rcDataLostActive = false;
+
+///////////////////////////////////////
+
+uint32_t rxIsrCnt        = 0;
+uint32_t rxIsrCycles     = 0;
+uint32_t rxIsrStatsStart = 0;
+
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Frame Complete
+//
+// Called by the receiver drivers from the main loop as soon as a frame has
+// been decoded.  values[] is indexed by receiver channel, only the channels
+// in the mask are copied, values may be NULL when the mask is empty.
+// processFlightCommands() runs on the next pass of the main loop.
+///////////////////////////////////////////////////////////////////////////////
+
+void rcFrameComplete(uint32_t frameTime, uint32_t channels, uint8_t valid, const uint16_t *values)
+{
+	uint8_t channel;
+
+	for (channel = 0; channel < RX_MAX_CHANNELS; channel++)
+		if ((channels & (1 << channel)) != 0)
+			rcFrame.value[channel] = values[channel];
+
+	rcFrame.time      = frameTime;
+	rcFrame.channels |= channels;  // Accumulates until read, a second frame doesn't hide the first one's channels
+	rcFrame.valid     = valid;
+
+	if (valid == true)
+	{
+		watchDogReset(rcDataLostCnt);
+		rcDataLostActive = false;
+	}
+
+	rcFrameReady = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Frame Read
+///////////////////////////////////////////////////////////////////////////////
+
+void rcFrameRead(rxFrame_t *frame)
+{
+	*frame = rcFrame;
+
+	rcFrame.channels = 0;
+	rcFrameReady     = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Frame Value
+///////////////////////////////////////////////////////////////////////////////
+
+uint16_t rcFrameValue(uint8_t channel)
+{
+	return rcFrame.value[channel];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// RC Data Lost Handler
+//
+// Called from the watchdog tick RC_DATA_LOST_TIME after the last valid
+// frame.  While rcDataLostActive is set the main loop passes on invalid
+// frames at 50 Hz, so the flight command failsafe runs with no receiver.
+///////////////////////////////////////////////////////////////////////////////
+
+void rcDataLost(void)
+{
+    evrPush(EVR_rcDataLost,0);
+
+    rcDataLostActive = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Initialization
+///////////////////////////////////////////////////////////////////////////////
+
+void rxInit(void)
+{
+	static uint8_t watchDogRegistered = false;
+
+	if (watchDogRegistered == false)  // Once, the watchdog table has no unregister
+	{
+		watchDogRegister(&rcDataLostCnt, RC_DATA_LOST_TIME, rcDataLost, true );
+		watchDogRegistered = true;
+	}
+
+	if (eepromConfig.receiverType >= NUMBER_OF_RECEIVER_TYPES)
+		eepromConfig.receiverType = PPM;
+
+	memset(&rcFrame, 0, sizeof(rcFrame));
+	rcFrameReady     = false;
+	rcDataLostActive = false;
+
+	rxDrivers[eepromConfig.receiverType].init();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Stop
+///////////////////////////////////////////////////////////////////////////////
+
+void rxStop(void)
+{
+	if (rxDrivers[eepromConfig.receiverType].stop != NULL)
+		rxDrivers[eepromConfig.receiverType].stop();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Process, decodes driver frames outside interrupt context
+///////////////////////////////////////////////////////////////////////////////
+
+void rxProcess(void)
+{
+	const rxDriver_t *driver = &rxDrivers[eepromConfig.receiverType];
+
+	if (driver->process == NULL)
+		return;
+
+	if ((driver->frameReceived == NULL) || (*driver->frameReceived == true))
+		driver->process();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Receiver ISR Load Statistics Reset
+///////////////////////////////////////////////////////////////////////////////
+
+void rxIsrStatsReset(void)
+{
+	rxIsrCnt        = 0;
+	rxIsrCycles     = 0;
+	rxIsrStatsStart = micros();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// USART2 Interrupt Handler, idle line at the end of each serial receiver frame
+///////////////////////////////////////////////////////////////////////////////
+
+void USART2_IRQHandler(void)
+{
+	uint32_t startCycles = *DWT_CYCCNT;
+	uint16_t status;
 
-        TIM_ClearITPendingBit(TIM2, TIM_IT_CC1);
+	status = USART2->SR;
 
-        diff = now - last;
+    if ((status & USART_SR_IDLE) != 0)
+    {
+        (void)USART2->DR;  // SR then DR read clears IDLE and the error flags
 
-        if (diff > 2700 * 2)   // Per http://www.rcgroups.com/forums/showpost.php?p=21996147&postcount=3960
-        {                      // "So, if you use 2.5ms or higher as being the reset for the PPM stream start,
-            chan = 0;          // you will be fine. I use 2.7ms just to be safe."
-        }
+        if (eepromConfig.receiverType == SBUS)
+        	sbusUsartIdle(status);
         else
-        {
-            if (diff > 1500 && diff < 4500 && chan < 8)    // 750 to 2250 ms is our 'valid' channel range
-            {
-                pulseWidth[chan] = diff;
-            }
-            chan++;
-         }
+        	spektrumUsartIdle();
     }
+
+    rxIsrCnt++;
+    rxIsrCycles += *DWT_CYCCNT - startCycles;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TIM2 Interrupt Handler
+///////////////////////////////////////////////////////////////////////////////
+
+void TIM2_IRQHandler(void)
+{
+    uint32_t startCycles = *DWT_CYCCNT;
+
+    // Slave Spektrum satellite soft serial, PPM is captured by DMA
+
+    softSerialIrqHandler();
+
+    rxIsrCnt++;
+    rxIsrCycles += *DWT_CYCCNT - startCycles;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
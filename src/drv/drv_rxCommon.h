@@ -0,0 +1,131 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Frame Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+#define RX_MAX_CHANNELS 18
+
+// Every receiver driver delivers its channels as a frame, stamped with the
+// micros() time the frame ended.  Values are in 0.5 uSec ticks, 2000 to 4000,
+// in receiver channel order.  Channels that are not in the mask keep their
+// previous value.
+
+typedef struct rxFrame_t
+{
+    uint32_t time;                    // micros() at the end of the frame
+    uint32_t channels;                // Bit mask of the receiver channels updated since the last read
+    uint8_t  valid;                   // false in receiver failsafe or with no frames, see failsafeCommands()
+    uint16_t value[RX_MAX_CHANNELS];
+} rxFrame_t;
+
+// Receiver drivers, indexed by eepromConfig.receiverType.  process() is
+// called from the main loop whenever *frameReceived is set, or on every pass
+// when frameReceived is NULL.  Drivers which complete their frames elsewhere
+// leave process NULL.
+
+typedef struct rxDriver_t
+{
+    char         *name;
+    void        (*init)(void);
+    void        (*stop)(void);
+    semaphore_t  *frameReceived;
+    void        (*process)(void);
+} rxDriver_t;
+
+extern const rxDriver_t rxDrivers[NUMBER_OF_RECEIVER_TYPES];
+
+extern semaphore_t rcFrameReady;     // Set when a receiver frame completes, cleared by rcFrameRead()
+
+///////////////////////////////////////
+
+#define RC_DATA_LOST_TIME 1000       // Watchdog ticks, 1 second
+
+extern uint32_t rcDataLostCnt;       // Watchdog handle, reset by every valid receiver frame
+
+extern semaphore_t rcDataLostActive; // Set by rcDataLost(), cleared by the next valid frame
+
+extern uint32_t rxIsrCnt;
+extern uint32_t rxIsrCycles;
+extern uint32_t rxIsrStatsStart;
+
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Frame Complete
+///////////////////////////////////////////////////////////////////////////////
+
+void rcFrameComplete(uint32_t frameTime, uint32_t channels, uint8_t valid, const uint16_t *values);
+
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Frame Read
+///////////////////////////////////////////////////////////////////////////////
+
+void rcFrameRead(rxFrame_t *frame);
+
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Frame Value
+///////////////////////////////////////////////////////////////////////////////
+
+uint16_t rcFrameValue(uint8_t channel);
+
+///////////////////////////////////////////////////////////////////////////////
+// RC Data Lost Handler
+///////////////////////////////////////////////////////////////////////////////
+
+void rcDataLost(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Initialization
+///////////////////////////////////////////////////////////////////////////////
+
+void rxInit(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Stop
+///////////////////////////////////////////////////////////////////////////////
+
+void rxStop(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Process
+///////////////////////////////////////////////////////////////////////////////
+
+void rxProcess(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Receiver ISR Load Statistics Reset
+///////////////////////////////////////////////////////////////////////////////
+
+void rxIsrStatsReset(void);
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,372 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// SBUS Receiver Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+#define SBUS_UART_PIN          GPIO_Pin_3
+#define SBUS_UART_GPIO         GPIOA
+
+///////////////////////////////////////
+
+// SBUS is 100000 baud, 8 data bits, even parity and 2 stop bits, with the
+// signal inverted.  The F103 USART can not invert its input, so an external
+// inverter is needed between the receiver and RC4 (PA3).
+//
+// A frame is 25 bytes, a 0x0F header, 22 bytes of 16 packed 11 bit channels,
+// a flag byte and a 0x00 footer (0x04, 0x14, 0x24 or 0x34 for SBUS2).  Frames
+// are sent every 7 or 14 mSec.  As with the Spektrum driver, USART2 receives
+// into a circular DMA buffer and the idle line interrupt marks the end of
+// each burst, a 25 byte burst is a frame and is decoded from the main loop.
+
+#define SBUS_BUFFER_SIZE       64    // Power of 2, 2 frames
+
+#define SBUS_FRAME_SIZE        25
+
+#define SBUS_HEADER            0x0F
+#define SBUS_FOOTER            0x00
+#define SBUS2_FOOTER_MASK      0x0F
+#define SBUS2_FOOTER           0x04
+
+#define SBUS_FLAG_CHANNEL_17   0x01
+#define SBUS_FLAG_CHANNEL_18   0x02
+#define SBUS_FLAG_FRAME_LOST   0x04
+#define SBUS_FLAG_FAILSAFE     0x08
+
+// 11 bit SBUS values of 172 to 1811 are 988 to 2012 uSec.  Commands are in
+// 0.5 uSec ticks, so command = sbus * 1.25 + 1760.
+
+#define SBUS_SCALE(x)          ((((uint16_t)(x) * 5) >> 2) + 1760)
+
+static volatile uint8_t  sbusDmaBuffer[SBUS_BUFFER_SIZE];
+
+static uint8_t           sbusTail       = 0;
+static volatile uint8_t  sbusFrameStart = 0;
+static volatile uint32_t sbusFrameTime  = 0;
+
+semaphore_t              sbusFrameReady = false;
+
+///////////////////////////////////////
+
+sbusStateType sbusState;
+
+uint16_t sbusBuf[SBUS_CHANNELS];
+
+///////////////////////////////////////////////////////////////////////////////
+// Decode Channels
+//
+// Unpacks the 16 little endian 11 bit channels in one pass through the
+// frame, each data byte is shifted into an accumulator and a channel is
+// taken out whenever 11 or more bits are waiting.
+///////////////////////////////////////////////////////////////////////////////
+
+static void decodeChannels(const uint8_t *frame, uint16_t *channels)
+{
+	uint32_t bits    = 0;
+	uint8_t  bitCnt  = 0;
+	uint8_t  channel = 0;
+	uint8_t  index;
+
+	for (index = 1; index < 23; index++)
+	{
+		bits   |= (uint32_t)frame[index] << bitCnt;
+		bitCnt += 8;
+
+		if (bitCnt >= 11)
+		{
+			channels[channel++] = SBUS_SCALE(bits & 0x07FF);
+			bits   >>= 11;
+			bitCnt  -= 11;
+		}
+	}
+
+	channels[16] = (frame[23] & SBUS_FLAG_CHANNEL_17) ? MAXCOMMAND : MINCOMMAND;
+	channels[17] = (frame[23] & SBUS_FLAG_CHANNEL_18) ? MAXCOMMAND : MINCOMMAND;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  SBUS Process, decodes received frames outside interrupt context
+///////////////////////////////////////////////////////////////////////////////
+
+void sbusProcess(void)
+{
+	uint8_t  frame[SBUS_FRAME_SIZE];
+	uint8_t  index, start;
+	uint32_t frameTime, interval;
+
+	sbusFrameReady = false;
+
+	start     = sbusFrameStart;
+	frameTime = sbusFrameTime;
+
+	for (index = 0; index < SBUS_FRAME_SIZE; index++)
+		frame[index] = sbusDmaBuffer[(start + index) & (SBUS_BUFFER_SIZE - 1)];
+
+	if ((frame[0] != SBUS_HEADER) ||
+		((frame[24] != SBUS_FOOTER) && ((frame[24] & SBUS2_FOOTER_MASK) != SBUS2_FOOTER)))
+	{
+		sbusState.badFrameCnt++;
+		return;
+	}
+
+	// Frame interval statistics
+
+	interval = frameTime - sbusState.previousFrameTime;
+
+	if (sbusState.frameCnt > 0)
+	{
+		sbusState.frameIntervalAverage = sbusState.frameIntervalAverage * 0.99f + (float)interval * 0.01f;
+
+		if (interval > sbusState.frameIntervalMax)
+			sbusState.frameIntervalMax = interval;
+	}
+
+	sbusState.previousFrameTime = frameTime;
+	sbusState.frameCnt++;
+
+	sbusState.flags = frame[23];
+
+	// A lost frame flag means the receiver missed a frame and is repeating
+	// the last good channel values, they are still the best data there is
+
+	if (sbusState.flags & SBUS_FLAG_FRAME_LOST)
+		sbusState.lostFrameCnt++;
+
+	// In failsafe the channels are the receiver's failsafe positions, which
+	// hold the last sticks unless the pilot programmed them.  Pass the frame
+	// on as invalid, failsafeCommands() in flightCommand.c then centres the
+	// sticks and brings the throttle down, whatever the receiver was set to
+
+	if (sbusState.flags & SBUS_FLAG_FAILSAFE)
+	{
+		sbusState.failsafeCnt++;
+		rcFrameComplete(frameTime, 0, false, sbusBuf);
+		return;
+	}
+
+	decodeChannels(frame, sbusBuf);
+
+	rcFrameComplete(frameTime, (1 << SBUS_CHANNELS) - 1, true, sbusBuf);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  SBUS UART Idle Line, called from USART2_IRQHandler
+///////////////////////////////////////////////////////////////////////////////
+
+void sbusUsartIdle(uint16_t status)
+{
+	uint8_t head, length;
+
+	head   = (uint8_t)(SBUS_BUFFER_SIZE - DMA1_Channel6->CNDTR);
+	length = (head - sbusTail) & (SBUS_BUFFER_SIZE - 1);
+
+	if ((length == SBUS_FRAME_SIZE) && ((status & (USART_SR_PE | USART_SR_FE | USART_SR_NE)) == 0))
+	{
+		if (sbusFrameReady == true)
+			sbusState.overrunCnt++;
+
+		sbusFrameStart = sbusTail;
+		sbusFrameTime  = micros();
+		sbusFrameReady = true;
+	}
+	else
+	{
+		sbusState.badFrameCnt++;
+	}
+
+	sbusTail = head;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SBUS Statistics Reset
+///////////////////////////////////////////////////////////////////////////////
+
+void sbusStatsReset(void)
+{
+	sbusState.frameIntervalMax = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SBUS Initialization
+///////////////////////////////////////////////////////////////////////////////
+
+void sbusInit(void)
+{
+    GPIO_InitTypeDef         GPIO_InitStructure;
+    NVIC_InitTypeDef         NVIC_InitStructure;
+    DMA_InitTypeDef          DMA_InitStructure;
+    USART_InitTypeDef        USART_InitStructure;
+
+    ///////////////////////////////////
+
+    DMA_Cmd(DMA1_Channel6, DISABLE);
+
+    memset(&sbusState, 0, sizeof(sbusState));
+
+    sbusTail       = 0;
+    sbusFrameReady = false;
+
+    rxIsrStatsReset();
+
+    ///////////////////////////////////
+
+    NVIC_InitStructure.NVIC_IRQChannel                   = USART2_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 2;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+
+    GPIO_InitStructure.GPIO_Pin   = SBUS_UART_PIN;
+    GPIO_InitStructure.GPIO_Mode  = GPIO_Mode_IN_FLOATING;
+    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+
+    GPIO_Init(SBUS_UART_GPIO, &GPIO_InitStructure);
+
+    USART_InitStructure.USART_BaudRate            = 100000;
+    USART_InitStructure.USART_WordLength          = USART_WordLength_9b;  // 8 data bits plus parity
+    USART_InitStructure.USART_StopBits            = USART_StopBits_2;
+    USART_InitStructure.USART_Parity              = USART_Parity_Even;
+    USART_InitStructure.USART_Mode                = USART_Mode_Rx;
+    USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+
+    USART_Init(USART2, &USART_InitStructure);
+
+    // Receive DMA into a circular buffer
+
+    DMA_DeInit(DMA1_Channel6);
+
+    DMA_InitStructure.DMA_Priority           = DMA_Priority_Medium;
+    DMA_InitStructure.DMA_M2M                = DMA_M2M_Disable;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t) & USART2->DR;
+    DMA_InitStructure.DMA_MemoryBaseAddr     = (uint32_t) sbusDmaBuffer;
+    DMA_InitStructure.DMA_DIR                = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_PeripheralInc      = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;  // Low 8 bits of DR, the parity bit is masked off
+    DMA_InitStructure.DMA_MemoryInc          = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_MemoryDataSize     = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_BufferSize         = SBUS_BUFFER_SIZE;
+    DMA_InitStructure.DMA_Mode               = DMA_Mode_Circular;
+
+    DMA_Init(DMA1_Channel6, &DMA_InitStructure);
+
+    DMA_Cmd(DMA1_Channel6, ENABLE);
+
+    USART_DMACmd(USART2, USART_DMAReq_Rx, ENABLE);
+
+    USART_ITConfig(USART2, USART_IT_IDLE, ENABLE);
+
+    USART_Cmd(USART2, ENABLE);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SBUS Stop
+///////////////////////////////////////////////////////////////////////////////
+
+void sbusStop(void)
+{
+	USART_ITConfig(USART2, USART_IT_IDLE, DISABLE);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SBUS Read
+///////////////////////////////////////////////////////////////////////////////
+
+uint16_t sbusRead(uint8_t channel)
+{
+    return sbusBuf[channel];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SBUS Decode Benchmark
+//
+// Packs a known set of channel values into a frame, then times the decode
+// of that frame with the cycle counter.  Returns the average cycles per
+// decode and the number of channels that did not decode to the value packed.
+///////////////////////////////////////////////////////////////////////////////
+
+uint32_t sbusBenchmark(uint16_t iterations, uint8_t *mismatches)
+{
+	uint8_t  frame[SBUS_FRAME_SIZE];
+	uint16_t raw[16];
+	uint16_t channels[SBUS_CHANNELS];
+	uint32_t bits   = 0;
+	uint8_t  bitCnt = 0;
+	uint8_t  index  = 1;
+	uint8_t  channel;
+	uint16_t iteration;
+	uint32_t startCycles, cycles;
+
+	memset(frame, 0, sizeof(frame));
+
+	frame[0]  = SBUS_HEADER;
+	frame[23] = SBUS_FLAG_CHANNEL_17;
+	frame[24] = SBUS_FOOTER;
+
+	// Full scale ramp, every bit position of every channel gets exercised
+
+	for (channel = 0; channel < 16; channel++)
+	{
+		raw[channel] = 172 + channel * 109;
+
+		bits   |= (uint32_t)raw[channel] << bitCnt;
+		bitCnt += 11;
+
+		while (bitCnt >= 8)
+		{
+			frame[index++] = (uint8_t)bits;
+			bits   >>= 8;
+			bitCnt  -= 8;
+		}
+	}
+
+	startCycles = *DWT_CYCCNT;
+
+	for (iteration = 0; iteration < iterations; iteration++)
+		decodeChannels(frame, channels);
+
+	cycles = *DWT_CYCCNT - startCycles;
+
+	*mismatches = 0;
+
+	for (channel = 0; channel < 16; channel++)
+		if (channels[channel] != SBUS_SCALE(raw[channel]))
+			(*mismatches)++;
+
+	if ((channels[16] != MAXCOMMAND) || (channels[17] != MINCOMMAND))
+		(*mismatches)++;
+
+	return (iterations > 0) ? cycles / iterations : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,105 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// SBUS Receiver Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+#define SBUS_CHANNELS 18  // 16 proportional, 2 digital
+
+///////////////////////////////////////
+
+struct sbusStateStruct
+{
+    uint8_t  flags;              // Flag byte of the latest frame
+    uint32_t frameCnt;
+    uint32_t badFrameCnt;        // Bursts that were not a whole frame, or had a bad header, footer or parity
+    uint32_t lostFrameCnt;       // Frames the receiver reported as lost
+    uint32_t failsafeCnt;        // Frames received with the receiver in failsafe
+    uint32_t overrunCnt;         // Frames replaced before they were decoded
+    uint32_t previousFrameTime;
+    float    frameIntervalAverage;  // uSec
+    uint32_t frameIntervalMax;      // uSec
+};
+
+typedef struct sbusStateStruct sbusStateType;
+
+extern sbusStateType sbusState;
+
+extern uint16_t sbusBuf[SBUS_CHANNELS];
+
+extern semaphore_t sbusFrameReady;
+
+///////////////////////////////////////////////////////////////////////////////
+//  SBUS Process
+///////////////////////////////////////////////////////////////////////////////
+
+void sbusProcess(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  SBUS UART Idle Line
+///////////////////////////////////////////////////////////////////////////////
+
+void sbusUsartIdle(uint16_t status);
+
+///////////////////////////////////////////////////////////////////////////////
+// SBUS Statistics Reset
+///////////////////////////////////////////////////////////////////////////////
+
+void sbusStatsReset(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// SBUS Initialization
+///////////////////////////////////////////////////////////////////////////////
+
+void sbusInit(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// SBUS Stop
+///////////////////////////////////////////////////////////////////////////////
+
+void sbusStop(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// SBUS Read
+///////////////////////////////////////////////////////////////////////////////
+
+uint16_t sbusRead(uint8_t channel);
+
+///////////////////////////////////////////////////////////////////////////////
+// SBUS Decode Benchmark
+///////////////////////////////////////////////////////////////////////////////
+
+uint32_t sbusBenchmark(uint16_t iterations, uint8_t *mismatches);
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,203 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Soft Serial Receiver Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+// Receive only software UART on RC2, PA1, TIM2_CH2.  The F1 input capture
+// can't trigger on both edges, so the capture polarity is flipped after
+// every edge and the bits are rebuilt from the time between edges.  TIM2
+// counts at 72 MHz, 625 ticks per bit at 115200 baud.
+//
+// A compare on TIM2_CH3 times out 20 bit times after the last edge.  It
+// finishes the trailing one bits of the last byte and plays the part of the
+// USART idle line interrupt, the receive buffer mirrors a circular DMA buffer.
+
+#define SOFT_SERIAL_PIN   GPIO_Pin_1
+#define SOFT_SERIAL_GPIO  GPIOA
+
+#define IDLE_BIT_TIMES    20
+
+volatile uint8_t softSerialBuffer[SOFT_SERIAL_BUFFER_SIZE];
+
+volatile uint8_t softSerialHead = 0;
+
+static void (*softSerialIdle)(uint8_t head) = NULL;
+
+static uint16_t bitTime;
+static uint16_t lastEdge;
+static uint8_t  rxLevel;     // Line level since lastEdge
+static uint8_t  rxBitIndex;  // 0 idle, 1 start bit, 2 thru 9 data bits, 10 stop bit
+static uint8_t  rxByte;
+static uint8_t  rxSinceIdle;
+
+///////////////////////////////////////////////////////////////////////////////
+// Soft Serial Receive Bits
+///////////////////////////////////////////////////////////////////////////////
+
+static void softSerialRxBits(uint8_t level, uint16_t count)
+{
+	while ((count > 0) && (rxBitIndex != 0))
+	{
+		if (rxBitIndex == 10)
+		{
+			if (level == 1)  // Good stop bit
+			{
+				softSerialBuffer[softSerialHead] = rxByte;
+				softSerialHead = (softSerialHead + 1) & (SOFT_SERIAL_BUFFER_SIZE - 1);
+				rxSinceIdle = true;
+			}
+
+			rxBitIndex = 0;
+			return;
+		}
+
+		if (rxBitIndex >= 2)
+			rxByte = (rxByte >> 1) | (level << 7);
+
+		rxBitIndex++;
+		count--;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Soft Serial Interrupt Handler, called from TIM2_IRQHandler
+///////////////////////////////////////////////////////////////////////////////
+
+void softSerialIrqHandler(void)
+{
+	uint16_t now;
+
+	if ((TIM2->SR & TIM_IT_CC2) != 0)
+	{
+		TIM2->SR = (uint16_t)~TIM_IT_CC2;
+
+		now = TIM2->CCR2;
+
+		if (rxBitIndex != 0)
+			softSerialRxBits(rxLevel, (uint16_t)(now - lastEdge + bitTime / 2) / bitTime);
+
+		rxLevel = (TIM2->CCER & TIM_CCER_CC2P) ? 0 : 1;  // Captured a falling edge, line is now low
+
+		if ((rxBitIndex == 0) && (rxLevel == 0))
+			rxBitIndex = 1;                              // Start bit
+
+		lastEdge = now;
+
+		TIM2->CCER ^= TIM_CCER_CC2P;
+
+		TIM2->CCR3  = now + IDLE_BIT_TIMES * bitTime;
+		TIM2->SR    = (uint16_t)~TIM_IT_CC3;
+		TIM2->DIER |= TIM_IT_CC3;
+	}
+
+	if (((TIM2->DIER & TIM_IT_CC3) != 0) && ((TIM2->SR & TIM_IT_CC3) != 0))
+	{
+		TIM2->SR    = (uint16_t)~TIM_IT_CC3;
+		TIM2->DIER &= ~TIM_IT_CC3;
+
+		if (rxLevel == 1)  // Otherwise the line is held low, drop the partial byte
+			softSerialRxBits(1, 10);
+
+		rxBitIndex = 0;
+
+		if ((rxSinceIdle == true) && (softSerialIdle != NULL))
+			softSerialIdle(softSerialHead);
+
+		rxSinceIdle = false;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Soft Serial Initialization
+///////////////////////////////////////////////////////////////////////////////
+
+void softSerialInit(uint32_t baudRate, void (*idleCallback)(uint8_t head))
+{
+    GPIO_InitTypeDef         GPIO_InitStructure;
+    NVIC_InitTypeDef         NVIC_InitStructure;
+    TIM_ICInitTypeDef        TIM_ICInitStructure;
+    TIM_OCInitTypeDef        TIM_OCInitStructure;
+    TIM_TimeBaseInitTypeDef  TIM_TimeBaseStructure;
+
+    ///////////////////////////////////
+
+    bitTime        = (uint16_t)(72000000 / baudRate);
+    rxBitIndex     = 0;
+    rxSinceIdle    = false;
+    softSerialHead = 0;
+    softSerialIdle = idleCallback;
+
+    GPIO_InitStructure.GPIO_Pin   = SOFT_SERIAL_PIN;
+    GPIO_InitStructure.GPIO_Mode  = GPIO_Mode_IPU;
+    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+
+    GPIO_Init(SOFT_SERIAL_GPIO, &GPIO_InitStructure);
+
+    NVIC_InitStructure.NVIC_IRQChannel                   = TIM2_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 1;
+    NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
+
+    NVIC_Init(&NVIC_InitStructure);
+
+    TIM_TimeBaseStructure.TIM_Prescaler         = 0;                   // 72 MHz
+    TIM_TimeBaseStructure.TIM_CounterMode       = TIM_CounterMode_Up;
+    TIM_TimeBaseStructure.TIM_Period            = 0xFFFF;
+    TIM_TimeBaseStructure.TIM_ClockDivision     = TIM_CKD_DIV1;
+    TIM_TimeBaseStructure.TIM_RepetitionCounter = 0x0000;
+
+    TIM_TimeBaseInit(TIM2, &TIM_TimeBaseStructure);
+
+    TIM_ICInitStructure.TIM_Channel     = TIM_Channel_2;
+    TIM_ICInitStructure.TIM_ICPolarity  = TIM_ICPolarity_Falling;     // Idle high, wait for a start bit
+    TIM_ICInitStructure.TIM_ICSelection = TIM_ICSelection_DirectTI;
+    TIM_ICInitStructure.TIM_ICPrescaler = TIM_ICPSC_DIV1;
+    TIM_ICInitStructure.TIM_ICFilter    = 0x0;
+
+    TIM_ICInit(TIM2, &TIM_ICInitStructure);
+
+    TIM_OCStructInit(&TIM_OCInitStructure);
+
+    TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_Timing;
+
+    TIM_OC3Init(TIM2, &TIM_OCInitStructure);
+
+    TIM_ClearITPendingBit(TIM2, TIM_IT_CC2 | TIM_IT_CC3);
+
+    TIM_ITConfig(TIM2, TIM_IT_CC2, ENABLE);
+    TIM_Cmd(TIM2, ENABLE);
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -38,8 +38,8 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 #define MASTER_SPEKTRUM_UART_PIN       GPIO_Pin_3
 #define MASTER_SPEKTRUM_UART_GPIO      GPIOA
 
-#define SLAVE_SPEKTRUM_UART_PIN        GPIO_Pin_3        // Dummy value for F1 Naze32 hardware
-#define SLAVE_SPEKTRUM_UART_GPIO       GPIOA             // Dummy value for F1 Naze32 hardware
+#define SLAVE_SPEKTRUM_UART_PIN        GPIO_Pin_1        // RC2, soft serial, no spare UART on F1 Naze32 hardware
+#define SLAVE_SPEKTRUM_UART_GPIO       GPIOA
 
 #define MASTER_BIND_COUNT   5
 #define SLAVE_BIND_COUNT    6
@@ -55,38 +55,71 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 ///////////////////////////////////////
 
-#define MIN_FRAME_SPACE 70  // 7.0 mSec
-#define MAX_BYTE_SPACE   3  // 0.3 mSec
+// The primary satellite is received by USART2 into a circular DMA buffer,
+// the idle line interrupt marks the end of each burst of bytes.  The slave
+// satellite is received by the soft serial driver on RC2, which emulates the
+// same buffer and idle line.  A 16 byte burst is a frame and is decoded from
+// the main loop.  Anything else is noise or a partial frame and is dropped,
+// the next idle line is always a frame boundary so no gap timer is needed to
+// stay in sync.
+//
+// Every frame is decoded as it arrives, so in 11 mSec modes the channels
+// carried by each frame update every 11 mSec.  With two satellites the
+// first copy of a frame is used and the copy from the other receiver, if it
+// arrives within DUPLICATE_FRAME_WINDOW, is counted and dropped.
+
+#define SPEKTRUM_BUFFER_SIZE   SOFT_SERIAL_BUFFER_SIZE  // Power of 2, 4 frames, both receivers
+
+#define DUPLICATE_FRAME_WINDOW 5000                     // uSec, less than the 11 mSec frame period
+
+enum { PRIMARY_SPEKTRUM, SLAVE_SPEKTRUM };
+
+typedef struct spektrumPort_t
+{
+	volatile uint8_t  *buffer;
+	uint8_t            tail;
+	volatile uint8_t   frameStart;
+	volatile uint32_t  frameTime;
+	volatile uint8_t   frameReady;
+} spektrumPort_t;
+
+static volatile uint8_t spektrumDmaBuffer[SPEKTRUM_BUFFER_SIZE];
+
+static spektrumPort_t   spektrumPort[2] = { { spektrumDmaBuffer, 0, 0, 0, false },
+		                                    { softSerialBuffer,  0, 0, 0, false } };
+
+semaphore_t             spektrumFrameReady = false;
+
+static uint8_t          lastFrame[SPEKTRUM_FRAME_SIZE - 2];
+static uint32_t         lastFrameTime = 0;
+
 
 ///////////////////////////////////////
 
-spektrumStateType primarySpektrumState = {1,0,0,0,0,0,0,0,0,{0}};
+spektrumStateType primarySpektrumState;
 
-spektrumStateType slaveSpektrumState   = {1,0,0,0,0,0,0,0,0,{0}};
+spektrumStateType slaveSpektrumState;
 
-int16_t spektrumBuf[SPEKTRUM_CHANNELS_PER_FRAME * MAX_SPEKTRUM_FRAMES];
+uint16_t spektrumBuf[SPEKTRUM_CHANNELS_PER_FRAME * MAX_SPEKTRUM_FRAMES];
 
 static uint8_t encodingType   = 0;
-static uint8_t expectedFrames = 0;
 
-uint8_t  bestReceiver = 0;
+uint8_t  spektrumSystem = 0;
 uint8_t  channelCnt;
 uint8_t  channelNum;
 uint16_t channelData;
 uint8_t  i;
 uint8_t  maxChannelNum = 0;
 
-uint8_t rcActive = false;
-
 ///////////////////////////////////////
 
 uint32_t primarySpektrumFrameLostCnt;
 uint32_t slaveSpektrumFrameLostCnt;
 
-uint32_t rcDataLostCnt;
+static uint8_t primaryWatchDogRegistered = false;
+static uint8_t slaveWatchDogRegistered   = false;
 
 enum frameWatchDogConsts {
-  rcDataLostTime         = 1000, // 1 second
   spektrumFrameLostTime  = 1000, // 1 second
   };
 
@@ -94,18 +127,20 @@ enum frameWatchDogConsts {
 // Decode Channels
 //////////////////////////////////////////////////////////////////////////////
 
-void decodeChannels(void)
+static void decodeChannels(const uint16_t *values, uint32_t frameTime)
 {
+	uint16_t channels = 0;
+
 	channelCnt = 0;
 
-    // For every piece of channel data we have received
+    // For every piece of channel data in this frame
 
-    for (i = 0; (i < SPEKTRUM_CHANNELS_PER_FRAME * expectedFrames); i++)
+    for (i = 0; i < SPEKTRUM_CHANNELS_PER_FRAME; i++)
     {
-        if ((eepromConfig.slaveSpektrum == true) && false)  // HJI Inhibit Slave Spektrum on Naze32
-    	   	channelData = (!bestReceiver) ? primarySpektrumState.values[i] : slaveSpektrumState.values[i];
-    	else
-    	   	channelData = primarySpektrumState.values[i];
+    	channelData = values[i];
+
+    	if (channelData == 0xFFFF)  // Unused slot
+    		continue;
 
     	// Find out the channel number and its value by
         // using the EncodingType which is only received
@@ -144,231 +179,188 @@ void decodeChannels(void)
             	break;
         }
 
+        if (channelNum < 12)
+        	channels |= 1 << channelNum;
+
         // Store the value of the highest valid channel
 
         if ((channelNum != 0x0F) && (channelNum > maxChannelNum))
             maxChannelNum = channelNum;
     }
 
-    // Indicate valid RC data
+    // Pass on the channels carried by this frame
 
-    if (channelCnt >= (maxChannelNum + 1))
-    {
-        rcActive = true;
-        watchDogReset(rcDataLostCnt);
-    }
-    else
-    {
-		rcActive = false;
-	}
+    if (channelCnt > 0)
+        rcFrameComplete(frameTime, channels, true, spektrumBuf);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-//  Process SpektrumData
+//  Spektrum Frame Parser, one whole 16 byte frame at a time
 ///////////////////////////////////////////////////////////////////////////////
 
-void processSpektrumData(void)
+static void spektrumFrameParser(const uint8_t *frame, uint32_t frameTime, spektrumStateType* spektrumState, bool slaveReceiver)
 {
-    if ((eepromConfig.slaveSpektrum == true) && false)  // HJI Inhibit Slave Spektrum on Naze32
-    {
-    	// If we have two receivers and at least one of them has new data
-
-        // If both receivers have new data select the one
-        // that has had the least number of frames lost
+    uint32_t interval;
+    uint8_t  channel;
 
-        if ((primarySpektrumState.rcAvailable) && (slaveSpektrumState.rcAvailable))
-        {
-            bestReceiver  = (primarySpektrumState.lostFrameCnt <= slaveSpektrumState.lostFrameCnt) ? 0 : 1;
-        }
-        else
-        {
-            // If only one of the receivers has new data use it
-            bestReceiver  = (primarySpektrumState.rcAvailable) ? 0 : 1;
-        }
+    // Frame interval statistics
 
-        //  Clear the data ready flags
-        primarySpektrumState.rcAvailable = 0;
-        slaveSpektrumState.rcAvailable   = 0;
+    interval = frameTime - spektrumState->previousFrameTime;
 
-        decodeChannels();
-	}
-    else
+    if (spektrumState->frameCnt > 0)
     {
-    	// We have one receiver and it has new data
-
-        //  Clear the data ready flag
-        primarySpektrumState.rcAvailable = 0;
+    	spektrumState->frameIntervalAverage = spektrumState->frameIntervalAverage * 0.99f + (float)interval * 0.01f;
 
-        decodeChannels();
+    	if (interval > spektrumState->frameIntervalMax)
+    		spektrumState->frameIntervalMax = interval;
     }
-}
 
-///////////////////////////////////////////////////////////////////////////////
-//  Spektrum Parser captures frame data by using time between frames to sync on
-///////////////////////////////////////////////////////////////////////////////
-
-static inline void spektrumParser(uint8_t c, spektrumStateType* spektrumState, bool slaveReceiver)
-{
-    uint16_t channelData;
-	uint8_t  timedOut;
-	static uint8_t tmpEncType   = 0;  // 0 = 10bit, 1 = 11 bit
-	static uint8_t tmpExpFrames = 0;  // # of frames for channel data
+    spektrumState->previousFrameTime = frameTime;
+    spektrumState->frameCnt++;
 
-    timedOut = (!spektrumState->spektrumTimer) ? 1 : 0;
+    // First byte is the number of lost frames so far.  Second byte
+    // is the system byte for main receiver or is the low byte of
+    // LostFrameCount for slave receiver
 
-    // If we have just started the re-sync process or
-    // if we have received a character before our
-    // 7ms wait has finished
-
-    if ((spektrumState->reSync == 1) || ((spektrumState->sync == 0) && (!timedOut)))
+    if (slaveReceiver)
+    {
+        spektrumState->lostFrameCnt = ((uint16_t)frame[0] << 8) + frame[1];
+    }
+    else
     {
-	    spektrumState->reSync = 0;
-	    spektrumState->spektrumTimer = MIN_FRAME_SPACE;
-	    spektrumState->sync = 0;
-	    spektrumState->channelCnt = 0;
-	    spektrumState->frameCnt = 0;
-	    spektrumState->secondFrame = 0;
-	    return;
+        spektrumState->lostFrameCnt = frame[0];
+        spektrumState->system       = frame[1];
     }
 
-    // The first byte of a new frame. It was received
-	// more than 7ms after the last received byte.
-	// It represents the number of lost frames so far.
+    for (channel = 0; channel < SPEKTRUM_CHANNELS_PER_FRAME; channel++)
+        spektrumState->values[channel] = ((uint16_t)frame[2 + 2 * channel] << 8) | frame[3 + 2 * channel];
 
-    if (spektrumState->sync == 0)
-	{
-	    spektrumState->lostFrameCnt = c;
+    if (!slaveReceiver)
+    {
+	    // Main receiver, resolution and frame rate from the system byte.
+    	// Other values are the low byte of a 16 bit lost frame count from
+    	// a remote receiver, keep the last known encoding
+
+    	switch (frame[1])
+    	{
+    		case 0x01:  // DSM2 1024 22 mSec
+    			encodingType   = 0;
+    			spektrumSystem = frame[1];
+    			break;
+
+    		case 0x12:  // DSM2 2048 11 mSec
+    		case 0xA2:  // DSMX 2048 22 mSec
+    		case 0xB2:  // DSMX 2048 11 mSec
+    			encodingType   = 1;
+    			spektrumSystem = frame[1];
+    			break;
+    	}
+
+        watchDogReset(primarySpektrumFrameLostCnt);
+    }
+    else
+    {
+		watchDogReset(slaveSpektrumFrameLostCnt);
+	}
 
-        if (slaveReceiver)  // slave receiver
-	        spektrumState->lostFrameCnt = spektrumState->lostFrameCnt << 8;
+    // Same frame already decoded from the other receiver ?
 
-        spektrumState->sync = 1;
-        spektrumState->spektrumTimer = MAX_BYTE_SPACE;
-        return;
+    if (((frameTime - lastFrameTime) < DUPLICATE_FRAME_WINDOW) &&
+    	(memcmp(lastFrame, &frame[2], sizeof(lastFrame)) == 0))
+    {
+    	spektrumState->duplicateCnt++;
+    	return;
     }
 
-    // All other bytes should be received within
-	// MAX_BYTE_SPACE time of the last byte received
-	// otherwise something went wrong resynchronise
+    memcpy(lastFrame, &frame[2], sizeof(lastFrame));
+    lastFrameTime = frameTime;
 
-    if (timedOut)
-	{
-	    spektrumState->reSync = 1;
+    decodeChannels(spektrumState->values, frameTime);
+}
 
-	    // Next frame not expected sooner than 7ms
+///////////////////////////////////////////////////////////////////////////////
+//  Spektrum Port Process
+///////////////////////////////////////////////////////////////////////////////
 
-	    spektrumState->spektrumTimer = MIN_FRAME_SPACE;
-	    return;
-	}
+static void spektrumPortProcess(uint8_t receiver)
+{
+	spektrumPort_t *port = &spektrumPort[receiver];
 
-    // Second character determines resolution and frame rate for main
-	// receiver or low byte of LostFrameCount for slave receiver
+	uint8_t  frame[SPEKTRUM_FRAME_SIZE];
+	uint8_t  index, start;
+	uint32_t frameTime;
 
-	if (spektrumState->sync == 1)
-	{
-	    if (slaveReceiver)
-	    {
-	        spektrumState->lostFrameCnt +=c;
-	        tmpExpFrames = expectedFrames;
-	    }
-	    else
-	    {
-	      // @todo collect more data. I suspect that there is a low res
-	      // protocol that is still 10 bit but without using the full range.
-
-	      tmpEncType   = (c & 0x10)>>4;  // 0 = 10bit, 1 = 11 bit
-	      tmpExpFrames =  c & 0x03;      // 1 = 1 frame contains all channels
-	                                     // 2 = 2 channel data in 2 frames
-	    }
+	start     = port->frameStart;
+	frameTime = port->frameTime;
 
-	    spektrumState->sync = 2;
-	    spektrumState->spektrumTimer = MAX_BYTE_SPACE;
-	    return;
-	}
+	port->frameReady = false;
 
-	// High byte of channel data if this is the first byte
-	// of channel data and the most significant bit is set
-	// then this is the second frame of channel data.
+	for (index = 0; index < SPEKTRUM_FRAME_SIZE; index++)
+		frame[index] = port->buffer[(start + index) & (SPEKTRUM_BUFFER_SIZE - 1)];
 
-	if (spektrumState->sync == 2)
-	{
-	    spektrumState->highByte = c;
+	if (receiver == PRIMARY_SPEKTRUM)
+		spektrumFrameParser(frame, frameTime, &primarySpektrumState, false);
+	else
+		spektrumFrameParser(frame, frameTime, &slaveSpektrumState,   true);
+}
 
-	    if (spektrumState->channelCnt == 0)
-	    {
-	        spektrumState->secondFrame = (spektrumState->highByte & 0x80) ? 1 : 0;
-	    }
+///////////////////////////////////////////////////////////////////////////////
+//  Spektrum Process, decodes received frames outside interrupt context
+///////////////////////////////////////////////////////////////////////////////
 
-	    spektrumState->sync = 3;
-	    spektrumState->spektrumTimer = MAX_BYTE_SPACE;
-	    return;
-	}
+void spektrumProcess(void)
+{
+	spektrumFrameReady = false;
 
-    // Low byte of channel data
+	// Oldest first, so the freshest copy of a frame is the one decoded
 
-    if (spektrumState->sync == 3)
-    {
-	    spektrumState->sync = 2;
-	    spektrumState->spektrumTimer = MAX_BYTE_SPACE;
+	if ((spektrumPort[PRIMARY_SPEKTRUM].frameReady) && (spektrumPort[SLAVE_SPEKTRUM].frameReady) &&
+		((int32_t)(spektrumPort[SLAVE_SPEKTRUM].frameTime - spektrumPort[PRIMARY_SPEKTRUM].frameTime) < 0))
+		spektrumPortProcess(SLAVE_SPEKTRUM);
 
-	    // We overwrite the buffer now so rc data is not available now
+	if (spektrumPort[PRIMARY_SPEKTRUM].frameReady)
+		spektrumPortProcess(PRIMARY_SPEKTRUM);
 
-	    spektrumState->rcAvailable = 0;
+	if (spektrumPort[SLAVE_SPEKTRUM].frameReady)
+		spektrumPortProcess(SLAVE_SPEKTRUM);
+}
 
-	    channelData = ((uint16_t)spektrumState->highByte << 8) | c;
+///////////////////////////////////////////////////////////////////////////////
+//  Spektrum Idle Line, called from the receiver interrupt handlers
+///////////////////////////////////////////////////////////////////////////////
 
-	    spektrumState->values[spektrumState->channelCnt + (spektrumState->secondFrame * 7)] = channelData;
+static void spektrumIdleLine(uint8_t receiver, uint8_t head)
+{
+	spektrumPort_t    *port  = &spektrumPort[receiver];
+	spektrumStateType *state = (receiver == PRIMARY_SPEKTRUM) ? &primarySpektrumState : &slaveSpektrumState;
 
-	    spektrumState->channelCnt++;
-    }
+	uint8_t length;
 
-    // If we have a whole frame
+	length = (head - port->tail) & (SPEKTRUM_BUFFER_SIZE - 1);
 
-    if(spektrumState->channelCnt >= SPEKTRUM_CHANNELS_PER_FRAME)
+	if (length == SPEKTRUM_FRAME_SIZE)
 	{
-        // How many frames did we expect ?
-	    ++spektrumState->frameCnt;
-
-	    if (spektrumState->frameCnt == tmpExpFrames)
-	    {
-	        // Set the rc_available_flag
-	        spektrumState->rcAvailable = 1;
-	        spektrumState->frameCnt    = 0;
-	    }
-
-	    if (!slaveReceiver)
-	    {
-		    // Main receiver
-	        encodingType   = tmpEncType;    // Only update on a good
-	        expectedFrames = tmpExpFrames;  // main receiver frame
+		if (port->frameReady == true)
+			state->overrunCnt++;
 
-	        watchDogReset(primarySpektrumFrameLostCnt);
-	    }
-	    else
-	    {
-			watchDogReset(slaveSpektrumFrameLostCnt);
-		}
-
-	    spektrumState->sync          = 0;
-	    spektrumState->channelCnt    = 0;
-	    spektrumState->secondFrame   = 0;
-	    spektrumState->spektrumTimer = MIN_FRAME_SPACE;
-    }
+		port->frameStart   = port->tail;
+		port->frameTime    = micros();
+		port->frameReady   = true;
+		spektrumFrameReady = true;
+	}
+	else
+	{
+		state->badFrameCnt++;
+	}
 
-    if ((primarySpektrumState.rcAvailable) || (slaveSpektrumState.rcAvailable))
-        processSpektrumData();
+	port->tail = head;
 }
 
-///////////////////////////////////////////////////////////////////////////////
-//  RC Data Lost Handler
-///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////
 
-void rcDataLost(void)
+static void slaveSpektrumIdleLine(uint8_t head)
 {
-    evrPush(EVR_rcDataLost,0);
-
-    // Maybe do something more interesting like auto-descent or hover-hold.
-    // armed = false;
+	spektrumIdleLine(SLAVE_SPEKTRUM, head);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -386,48 +378,33 @@ void slaveSpektrumFrameLost(void)
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-//  Primary Spektrum Satellite Receiver UART Interrupt Handler
+//  Primary Spektrum Satellite Receiver UART Idle Line, called from USART2_IRQHandler
 ///////////////////////////////////////////////////////////////////////////////
 
-void USART2_IRQHandler(void)
+void spektrumUsartIdle(void)
 {
-    if (((USART2->CR1 & USART_CR1_TXEIE) != 0) && ((USART2->SR & USART_SR_TXE) != 0))
-    {
-        USART2->CR1 &= ~USART_CR1_TXEIE;
-    }
-
-    if (((USART2->CR1 & USART_CR1_RXNEIE) != 0) && ((USART2->SR & USART_SR_RXNE) != 0))
-    {
-        uint8_t b = USART_ReceiveData(USART2);
-
-        spektrumParser(b, &primarySpektrumState, false);
-    }
+	spektrumIdleLine(PRIMARY_SPEKTRUM, (uint8_t)(SPEKTRUM_BUFFER_SIZE - DMA1_Channel6->CNDTR));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-//  Slave Spektrum Satellite Receiver USART Interrupt Handler
+// Spektrum Statistics Reset
 ///////////////////////////////////////////////////////////////////////////////
 
-void USART1_IRQHandler(void)
+void spektrumStatsReset(void)
 {
-    if (((USART1->CR1 & USART_CR1_TXEIE) != 0) && ((USART1->SR & USART_SR_TXE) != 0))
-	{
-        USART1->CR1 &= ~USART_CR1_TXEIE;
-    }
-
-    if (((USART1->CR1 & USART_CR1_RXNEIE) != 0) && ((USART1->SR & USART_SR_RXNE) != 0))
-    {
-        uint8_t b = USART_ReceiveData(USART1);
-
-        spektrumParser(b, &slaveSpektrumState, true);
-    }
+	primarySpektrumState.frameIntervalMax = 0;
+	slaveSpektrumState.frameIntervalMax   = 0;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-// TIM2 Interrupt Handler - Updates times used by Spektrum Parser
+// Spektrum Stop
 ///////////////////////////////////////////////////////////////////////////////
 
-// See drv_rxCommon.c
+void spektrumStop(void)
+{
+	USART_ITConfig(USART2, USART_IT_IDLE, DISABLE);
+	TIM_ITConfig(TIM2, TIM_IT_CC2 | TIM_IT_CC3, DISABLE);
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 // Spektrum Initialization
@@ -437,35 +414,24 @@ void spektrumInit(void)
 {
     GPIO_InitTypeDef         GPIO_InitStructure;
     NVIC_InitTypeDef         NVIC_InitStructure;
-    TIM_TimeBaseInitTypeDef  TIM_TimeBaseStructure;
+    DMA_InitTypeDef          DMA_InitStructure;
     USART_InitTypeDef        USART_InitStructure;
 
     ///////////////////////////////////
 
-	primarySpektrumState.reSync = 1;
-    slaveSpektrumState.reSync   = 1;
-
-    ///////////////////////////////////
-
-    NVIC_InitStructure.NVIC_IRQChannel                   = TIM2_IRQn;
-    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 2;
-    NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 0;
-    NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
-    NVIC_Init(&NVIC_InitStructure);
-
-    TIM_TimeBaseStructure.TIM_Period            = 100 - 1;             // 100 1 uSec Ticks
-    TIM_TimeBaseStructure.TIM_Prescaler         = 72 - 1;              // 72 MHz / 72 = 1 MHz = 1 uSec Tick
-    TIM_TimeBaseStructure.TIM_ClockDivision     = TIM_CKD_DIV1;
-    TIM_TimeBaseStructure.TIM_CounterMode       = TIM_CounterMode_Down;
-    TIM_TimeBaseStructure.TIM_RepetitionCounter = 0x0000;
+    DMA_Cmd(DMA1_Channel6, DISABLE);
 
-    TIM_TimeBaseInit(TIM2, &TIM_TimeBaseStructure);
+    memset(&primarySpektrumState, 0, sizeof(primarySpektrumState));
+    memset(&slaveSpektrumState,   0, sizeof(slaveSpektrumState));
 
-    TIM_ITConfig(TIM2, TIM_IT_Update, ENABLE);
+    spektrumPort[PRIMARY_SPEKTRUM].tail       = 0;
+    spektrumPort[PRIMARY_SPEKTRUM].frameReady = false;
+    spektrumPort[SLAVE_SPEKTRUM].tail         = 0;
+    spektrumPort[SLAVE_SPEKTRUM].frameReady   = false;
 
-    TIM_ClearFlag(TIM2, TIM_FLAG_Update);
+    spektrumFrameReady = false;
 
-    TIM_Cmd(TIM2, ENABLE);
+    rxIsrStatsReset();
 
     ///////////////////////////////////
 
@@ -490,47 +456,52 @@ void spektrumInit(void)
 
     USART_Init(USART2, &USART_InitStructure);
 
-    USART_ITConfig(USART2, USART_IT_RXNE, ENABLE);
+    // Receive DMA into a circular buffer
 
-    USART_Cmd(USART2, ENABLE);
+    DMA_DeInit(DMA1_Channel6);
 
-    watchDogRegister(&primarySpektrumFrameLostCnt, spektrumFrameLostTime, primarySpektrumFrameLost, true );
+    DMA_InitStructure.DMA_Priority           = DMA_Priority_Medium;
+    DMA_InitStructure.DMA_M2M                = DMA_M2M_Disable;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t) & USART2->DR;
+    DMA_InitStructure.DMA_MemoryBaseAddr     = (uint32_t) spektrumDmaBuffer;
+    DMA_InitStructure.DMA_DIR                = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_PeripheralInc      = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryInc          = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_MemoryDataSize     = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_BufferSize         = SPEKTRUM_BUFFER_SIZE;
+    DMA_InitStructure.DMA_Mode               = DMA_Mode_Circular;
 
-    ///////////////////////////////////
+    DMA_Init(DMA1_Channel6, &DMA_InitStructure);
 
-    if ((eepromConfig.slaveSpektrum == true) && false)  // HJI Inhibit Slave Spektrum on Naze32
-    {
-		NVIC_InitStructure.NVIC_IRQChannel                   = USART1_IRQn;
-        NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 2;
-        NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 0;
-        NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
-        NVIC_Init(&NVIC_InitStructure);
+    DMA_Cmd(DMA1_Channel6, ENABLE);
 
-        GPIO_InitStructure.GPIO_Pin   = SLAVE_SPEKTRUM_UART_PIN;
-      //GPIO_InitStructure.GPIO_Mode  = GPIO_Mode_IN_FLOATING;
-      //GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+    USART_DMACmd(USART2, USART_DMAReq_Rx, ENABLE);
 
-        GPIO_Init(SLAVE_SPEKTRUM_UART_GPIO, &GPIO_InitStructure);
-
-      //USART_InitStructure.USART_BaudRate            = 115200;
-      //USART_InitStructure.USART_WordLength          = USART_WordLength_8b;
-      //USART_InitStructure.USART_StopBits            = USART_StopBits_1;
-      //USART_InitStructure.USART_Parity              = USART_Parity_No;
-      //USART_InitStructure.USART_Mode                = USART_Mode_Rx;
-      //USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+    USART_ITConfig(USART2, USART_IT_IDLE, ENABLE);
 
-        USART_Init(USART1, &USART_InitStructure);
+    USART_Cmd(USART2, ENABLE);
 
-        USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);
+    // Watchdogs are registered once, the watchdog table has no unregister
 
-        USART_Cmd(USART1, ENABLE);
+    if (primaryWatchDogRegistered == false)
+    {
+        watchDogRegister(&primarySpektrumFrameLostCnt, spektrumFrameLostTime, primarySpektrumFrameLost, true );
+        primaryWatchDogRegistered = true;
+    }
 
-        watchDogRegister(&slaveSpektrumFrameLostCnt, spektrumFrameLostTime, slaveSpektrumFrameLost, true );
-	}
+    ///////////////////////////////////
 
-	///////////////////////////////////
+    if (eepromConfig.slaveSpektrum == true)
+    {
+    	softSerialInit(115200, slaveSpektrumIdleLine);
 
-	watchDogRegister(&rcDataLostCnt, rcDataLostTime, rcDataLost, true );
+    	if (slaveWatchDogRegistered == false)
+    	{
+            watchDogRegister(&slaveSpektrumFrameLostCnt, spektrumFrameLostTime, slaveSpektrumFrameLost, true );
+            slaveWatchDogRegistered = true;
+    	}
+	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -575,7 +546,7 @@ void checkSpektrumBind(void)
 
     ///////////////////////////////////
 
-    if ((eepromConfig.slaveSpektrum == true) && false)  // HJI Inhibit Slave Spektrum on Naze32
+    if (eepromConfig.slaveSpektrum == true)
     {
         // Configure Slave UART pin as output
         GPIO_InitStructure.GPIO_Pin   = SLAVE_SPEKTRUM_UART_PIN;
@@ -601,7 +572,7 @@ void checkSpektrumBind(void)
 
     ///////////////////////////////////
 
-    if ((eepromConfig.slaveSpektrum == true) && false)  // HJI Inhibit Slave Spektrum on Naze32
+    if (eepromConfig.slaveSpektrum == true)
     {
         for (i = 0; i < SLAVE_BIND_COUNT; i++)
         {
@@ -43,16 +43,16 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 struct spektrumStateStruct
 {
-    uint8_t  reSync;
-    uint8_t  spektrumTimer;
-    uint8_t  sync;
-    uint8_t  channelCnt;
-    uint8_t  frameCnt;
-    uint8_t  highByte;
-    uint8_t  secondFrame;
-    uint16_t lostFrameCnt;
-    uint8_t  rcAvailable;
-    uint16_t values[SPEKTRUM_CHANNELS_PER_FRAME * MAX_SPEKTRUM_FRAMES];
+    uint16_t lostFrameCnt;                         // Fades reported by the receiver
+    uint8_t  system;                               // Main receiver only
+    uint16_t values[SPEKTRUM_CHANNELS_PER_FRAME];  // Channel words of the latest frame
+    uint32_t frameCnt;
+    uint32_t duplicateCnt;                         // Frames already decoded from the other receiver
+    uint32_t badFrameCnt;                          // Bursts that were not a whole frame
+    uint32_t overrunCnt;                           // Frames replaced before they were decoded
+    uint32_t previousFrameTime;
+    float    frameIntervalAverage;                 // uSec
+    uint32_t frameIntervalMax;                     // uSec
 };
 
 typedef struct spektrumStateStruct spektrumStateType;
@@ -61,17 +61,37 @@ extern spektrumStateType primarySpektrumState;
 
 extern spektrumStateType slaveSpektrumState;
 
-extern int16_t spektrumBuf[SPEKTRUM_CHANNELS_PER_FRAME * MAX_SPEKTRUM_FRAMES];
+extern uint16_t spektrumBuf[SPEKTRUM_CHANNELS_PER_FRAME * MAX_SPEKTRUM_FRAMES];
 
 extern uint8_t maxChannelNum;
 
-extern uint8_t rcActive;
+extern uint8_t spektrumSystem;
+
+extern semaphore_t spektrumFrameReady;
+
+///////////////////////////////////////////////////////////////////////////////
+//  Spektrum Process
+///////////////////////////////////////////////////////////////////////////////
+
+void spektrumProcess(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Primary Spektrum Satellite Receiver UART Idle Line
+///////////////////////////////////////////////////////////////////////////////
+
+void spektrumUsartIdle(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Spektrum Statistics Reset
+///////////////////////////////////////////////////////////////////////////////
+
+void spektrumStatsReset(void);
 
 ///////////////////////////////////////////////////////////////////////////////
-//  Process SpektrumData
+// Spektrum Stop
 ///////////////////////////////////////////////////////////////////////////////
 
-void processSpektrumData(void);
+void spektrumStop(void);
 
 ///////////////////////////////////////////////////////////////////////////////
 // Spektrum Initialization
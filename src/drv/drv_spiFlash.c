@@ -0,0 +1,492 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+// SPI2, M25P16 2 MByte NOR flash on the Naze32 rev 5
+// NSS  PB12
+// SCK  PB13
+// MISO PB14
+// MOSI PB15
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+// The SPI2 DMA channels, 4 and 5, carry UART1, so transfers are polled.  A
+// page program holds chip select across main loop passes and clocks out
+// SPI_FLASH_CHUNK bytes a pass, the chip doesn't mind the pauses, so no one
+// pass stalls the loop for a whole page.  Further pages queue in RAM while
+// the chip programs the last one, 0.64 mSec typical and 5 mSec worst case.
+//
+// Pages go to the chip in order from the first erased page found at start
+// up, a partial page flushed at the end of a log leaves its tail erased.
+
+#define SPI_FLASH_GPIO      GPIOB
+#define SPI_FLASH_CS_PIN    GPIO_Pin_12
+#define SPI_FLASH_SCK_PIN   GPIO_Pin_13
+#define SPI_FLASH_MISO_PIN  GPIO_Pin_14
+#define SPI_FLASH_MOSI_PIN  GPIO_Pin_15
+
+#define SPI_FLASH_CS_LOW    GPIO_ResetBits(SPI_FLASH_GPIO, SPI_FLASH_CS_PIN)
+#define SPI_FLASH_CS_HIGH   GPIO_SetBits(SPI_FLASH_GPIO,   SPI_FLASH_CS_PIN)
+
+#define SPI_FLASH_CHUNK     32  // Bytes a pass, about 20 uSec at 18 MHz
+
+#define CMD_WRITE_ENABLE    0x06
+#define CMD_READ_STATUS     0x05
+#define CMD_READ_DATA       0x03
+#define CMD_PAGE_PROGRAM    0x02
+#define CMD_BULK_ERASE      0xC7
+#define CMD_READ_ID         0x9F
+
+#define STATUS_WIP          0x01  // Write in progress
+
+enum { SPI_FLASH_READY, SPI_FLASH_PROGRAMMING };
+
+spiFlashStatsType spiFlashStats;
+
+uint8_t  spiFlashPresent = false;
+uint32_t spiFlashJedecId = 0;
+uint32_t spiFlashSize    = 0;
+
+static uint8_t  spiFlashPage[SPI_FLASH_QUEUE_PAGES][SPI_FLASH_PAGE_SIZE];
+static uint16_t spiFlashPageLength[SPI_FLASH_QUEUE_PAGES];
+
+static uint8_t  spiFlashHead   = 0;       // Page being filled
+static uint16_t spiFlashFill   = 0;       // Bytes in the head page
+static uint8_t  spiFlashTail   = 0;       // Oldest queued page
+static uint8_t  spiFlashQueued = 0;       // Pages waiting to be programmed
+
+static uint32_t spiFlashAppendAddress;    // Chip address of the head page
+static uint32_t spiFlashProgramAddress;   // Chip address of the tail page
+
+static uint8_t  spiFlashState  = SPI_FLASH_READY;
+static uint16_t spiFlashOffset;           // Bytes of the tail page clocked out
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Transfer
+///////////////////////////////////////////////////////////////////////////////
+
+static uint8_t spiTransfer(uint8_t data)
+{
+    while (SPI_I2S_GetFlagStatus(SPI2, SPI_I2S_FLAG_TXE) == RESET);
+
+    SPI_I2S_SendData(SPI2, data);
+
+    while (SPI_I2S_GetFlagStatus(SPI2, SPI_I2S_FLAG_RXNE) == RESET);
+
+    return (uint8_t)SPI_I2S_ReceiveData(SPI2);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Commands
+///////////////////////////////////////////////////////////////////////////////
+
+static void spiFlashCommand(uint8_t command)
+{
+    SPI_FLASH_CS_LOW;
+    spiTransfer(command);
+    SPI_FLASH_CS_HIGH;
+}
+
+///////////////////////////////////////
+
+static void spiFlashAddressCommand(uint8_t command, uint32_t address)  // Leaves chip select low
+{
+    SPI_FLASH_CS_LOW;
+    spiTransfer(command);
+    spiTransfer((uint8_t)(address >> 16));
+    spiTransfer((uint8_t)(address >>  8));
+    spiTransfer((uint8_t)(address      ));
+}
+
+///////////////////////////////////////
+
+static uint8_t spiFlashStatus(void)
+{
+    uint8_t status;
+
+    SPI_FLASH_CS_LOW;
+    spiTransfer(CMD_READ_STATUS);
+    status = spiTransfer(0x00);
+    SPI_FLASH_CS_HIGH;
+
+    return status;
+}
+
+///////////////////////////////////////
+
+static void spiFlashReadData(uint32_t address, uint8_t *buffer, uint16_t length)
+{
+    spiFlashAddressCommand(CMD_READ_DATA, address);
+
+    while (length--)
+        *buffer++ = spiTransfer(0x00);
+
+    SPI_FLASH_CS_HIGH;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Find End
+//
+// Binary search for the first erased page, data is only ever appended.
+///////////////////////////////////////////////////////////////////////////////
+
+static bool spiFlashPageErased(uint32_t address)
+{
+    uint8_t  buffer[32];
+    uint16_t offset;
+    uint8_t  index;
+
+    for (offset = 0; offset < SPI_FLASH_PAGE_SIZE; offset += sizeof(buffer))
+    {
+        spiFlashReadData(address + offset, buffer, sizeof(buffer));
+
+        for (index = 0; index < sizeof(buffer); index++)
+        {
+            if (buffer[index] != 0xFF)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+///////////////////////////////////////
+
+static uint32_t spiFlashFindEnd(void)
+{
+    uint32_t low  = 0;
+    uint32_t high = spiFlashSize / SPI_FLASH_PAGE_SIZE;
+    uint32_t middle;
+
+    while (low < high)
+    {
+        middle = (low + high) / 2;
+
+        if (spiFlashPageErased(middle * SPI_FLASH_PAGE_SIZE))
+            high = middle;
+        else
+            low = middle + 1;
+    }
+
+    return low * SPI_FLASH_PAGE_SIZE;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Queue Head
+///////////////////////////////////////////////////////////////////////////////
+
+static void spiFlashQueueHead(void)
+{
+    spiFlashPageLength[spiFlashHead] = spiFlashFill;
+
+    spiFlashHead = (spiFlashHead + 1) % SPI_FLASH_QUEUE_PAGES;
+    spiFlashFill = 0;
+
+    spiFlashAppendAddress += SPI_FLASH_PAGE_SIZE;
+
+    if (++spiFlashQueued > spiFlashStats.highWater)
+        spiFlashStats.highWater = spiFlashQueued;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Initialization
+//
+// Only the rev 5 board carries the chip, on rev 4 PB12 is the mag DRDY input.
+///////////////////////////////////////////////////////////////////////////////
+
+void spiFlashInit(void)
+{
+#ifdef REV5
+    GPIO_InitTypeDef GPIO_InitStructure;
+    SPI_InitTypeDef  SPI_InitStructure;
+    uint8_t          id[3];
+
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_SPI2, ENABLE);
+
+    GPIO_InitStructure.GPIO_Pin   = SPI_FLASH_CS_PIN;
+    GPIO_InitStructure.GPIO_Mode  = GPIO_Mode_Out_PP;
+    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+
+    GPIO_Init(SPI_FLASH_GPIO, &GPIO_InitStructure);
+
+    SPI_FLASH_CS_HIGH;
+
+    GPIO_InitStructure.GPIO_Pin   = SPI_FLASH_SCK_PIN | SPI_FLASH_MOSI_PIN;
+    GPIO_InitStructure.GPIO_Mode  = GPIO_Mode_AF_PP;
+
+    GPIO_Init(SPI_FLASH_GPIO, &GPIO_InitStructure);
+
+    GPIO_InitStructure.GPIO_Pin   = SPI_FLASH_MISO_PIN;
+    GPIO_InitStructure.GPIO_Mode  = GPIO_Mode_IN_FLOATING;
+
+    GPIO_Init(SPI_FLASH_GPIO, &GPIO_InitStructure);
+
+    SPI_InitStructure.SPI_Direction         = SPI_Direction_2Lines_FullDuplex;
+    SPI_InitStructure.SPI_Mode              = SPI_Mode_Master;
+    SPI_InitStructure.SPI_DataSize          = SPI_DataSize_8b;
+    SPI_InitStructure.SPI_CPOL              = SPI_CPOL_High;
+    SPI_InitStructure.SPI_CPHA              = SPI_CPHA_2Edge;
+    SPI_InitStructure.SPI_NSS               = SPI_NSS_Soft;
+    SPI_InitStructure.SPI_BaudRatePrescaler = SPI_BaudRatePrescaler_2;  // 36 MHz APB1 / 2, 18 MHz
+    SPI_InitStructure.SPI_FirstBit          = SPI_FirstBit_MSB;
+    SPI_InitStructure.SPI_CRCPolynomial     = 7;
+
+    SPI_Init(SPI2, &SPI_InitStructure);
+
+    SPI_Cmd(SPI2, ENABLE);
+
+    SPI_FLASH_CS_LOW;
+    spiTransfer(CMD_READ_ID);
+    id[0] = spiTransfer(0x00);  // Manufacturer
+    id[1] = spiTransfer(0x00);  // Memory type
+    id[2] = spiTransfer(0x00);  // Capacity, log2 of the size in bytes
+    SPI_FLASH_CS_HIGH;
+
+    spiFlashJedecId = ((uint32_t)id[0] << 16) | ((uint32_t)id[1] << 8) | id[2];
+
+    if ((id[0] != 0x00) && (id[0] != 0xFF) && (id[2] >= 0x10) && (id[2] <= 0x18))  // Up to 16 MBytes, 3 byte addresses
+    {
+        spiFlashSize    = (uint32_t)1 << id[2];
+        spiFlashPresent = true;
+
+        spiFlashAppendAddress  = spiFlashFindEnd();
+        spiFlashProgramAddress = spiFlashAppendAddress;
+    }
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Service
+//
+// Called every main loop pass, starts or continues programming the oldest
+// queued page.
+///////////////////////////////////////////////////////////////////////////////
+
+void spiFlashService(void)
+{
+    uint32_t startCycles;
+    uint32_t cycles;
+    uint16_t count;
+
+    if ((spiFlashState == SPI_FLASH_READY) && (spiFlashQueued == 0))
+        return;
+
+    startCycles = *DWT_CYCCNT;
+
+    if ((spiFlashState == SPI_FLASH_READY) && ((spiFlashStatus() & STATUS_WIP) == 0))
+    {
+        spiFlashCommand(CMD_WRITE_ENABLE);
+        spiFlashAddressCommand(CMD_PAGE_PROGRAM, spiFlashProgramAddress);
+
+        spiFlashOffset = 0;
+        spiFlashState  = SPI_FLASH_PROGRAMMING;
+    }
+
+    if (spiFlashState == SPI_FLASH_PROGRAMMING)
+    {
+        count = spiFlashPageLength[spiFlashTail] - spiFlashOffset;
+
+        if (count > SPI_FLASH_CHUNK)
+            count = SPI_FLASH_CHUNK;
+
+        while (count--)
+            spiTransfer(spiFlashPage[spiFlashTail][spiFlashOffset++]);
+
+        if (spiFlashOffset == spiFlashPageLength[spiFlashTail])
+        {
+            SPI_FLASH_CS_HIGH;  // The chip programs the page on chip select high
+
+            spiFlashProgramAddress += SPI_FLASH_PAGE_SIZE;
+
+            spiFlashTail = (spiFlashTail + 1) % SPI_FLASH_QUEUE_PAGES;
+            spiFlashQueued--;
+
+            spiFlashStats.pageCnt++;
+
+            spiFlashState = SPI_FLASH_READY;
+        }
+    }
+
+    cycles = *DWT_CYCCNT - startCycles;
+
+    spiFlashStats.cycles += cycles;
+
+    if (cycles > spiFlashStats.cyclesMax)
+        spiFlashStats.cyclesMax = cycles;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Write
+//
+// All or nothing, a write that doesn't fit in the queue or on the chip is
+// dropped and counted.
+///////////////////////////////////////////////////////////////////////////////
+
+bool spiFlashWrite(const uint8_t *data, uint16_t length)
+{
+    uint32_t space = (uint32_t)(SPI_FLASH_QUEUE_PAGES - spiFlashQueued) * SPI_FLASH_PAGE_SIZE - spiFlashFill;
+    uint16_t count;
+
+    if (space > spiFlashFree())
+        space = spiFlashFree();
+
+    if (length > space)
+    {
+        spiFlashStats.dropCnt++;
+        spiFlashStats.dropBytes += length;
+
+        return false;
+    }
+
+    while (length > 0)
+    {
+        count = SPI_FLASH_PAGE_SIZE - spiFlashFill;
+
+        if (count > length)
+            count = length;
+
+        memcpy(&spiFlashPage[spiFlashHead][spiFlashFill], data, count);
+
+        spiFlashFill += count;
+        data         += count;
+        length       -= count;
+
+        if (spiFlashFill == SPI_FLASH_PAGE_SIZE)
+            spiFlashQueueHead();
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Flush
+//
+// Queues a partial head page, the next write starts on a fresh page.
+///////////////////////////////////////////////////////////////////////////////
+
+void spiFlashFlush(void)
+{
+    if (spiFlashFill > 0)
+        spiFlashQueueHead();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Used and Free
+///////////////////////////////////////////////////////////////////////////////
+
+uint32_t spiFlashUsed(void)
+{
+    return spiFlashAppendAddress + spiFlashFill;
+}
+
+///////////////////////////////////////
+
+uint32_t spiFlashFree(void)
+{
+    if (spiFlashPresent == false)
+        return 0;
+
+    return spiFlashSize - spiFlashAppendAddress - spiFlashFill;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Idle
+//
+// Nothing queued and the chip done with its last program or erase.
+///////////////////////////////////////////////////////////////////////////////
+
+bool spiFlashIdle(void)
+{
+    if (spiFlashPresent == false)
+        return true;
+
+    return (spiFlashState == SPI_FLASH_READY) && (spiFlashQueued == 0) && ((spiFlashStatus() & STATUS_WIP) == 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Read
+//
+// Blocking, finishes the queued pages first.
+///////////////////////////////////////////////////////////////////////////////
+
+void spiFlashRead(uint32_t address, uint8_t *buffer, uint16_t length)
+{
+    if (spiFlashPresent == false)
+        return;
+
+    while (spiFlashIdle() == false)
+        spiFlashService();
+
+    spiFlashReadData(address, buffer, length);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Erase Chip
+//
+// Starts a bulk erase, 13 seconds typical, spiFlashIdle() reports the end.
+// Anything queued is programmed first, then discarded with the rest.
+///////////////////////////////////////////////////////////////////////////////
+
+void spiFlashEraseChip(void)
+{
+    if (spiFlashPresent == false)
+        return;
+
+    while (spiFlashIdle() == false)
+        spiFlashService();
+
+    spiFlashCommand(CMD_WRITE_ENABLE);
+    spiFlashCommand(CMD_BULK_ERASE);
+
+    spiFlashHead   = 0;
+    spiFlashFill   = 0;
+    spiFlashTail   = 0;
+    spiFlashQueued = 0;
+
+    spiFlashAppendAddress  = 0;
+    spiFlashProgramAddress = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Stats Reset
+///////////////////////////////////////////////////////////////////////////////
+
+void spiFlashStatsReset(void)
+{
+    memset(&spiFlashStats, 0, sizeof(spiFlashStats));
+}
+
+///////////////////////////////////////////////////////////////////////////////
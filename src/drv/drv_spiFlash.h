@@ -0,0 +1,111 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define SPI_FLASH_PAGE_SIZE   256
+#define SPI_FLASH_QUEUE_PAGES 2    // Pages of RAM waiting to be programmed
+
+typedef struct spiFlashStatsType
+{
+    uint32_t pageCnt;     // Pages programmed
+    uint32_t dropCnt;     // Writes refused, queue or chip full
+    uint32_t dropBytes;
+    uint32_t highWater;   // Most pages queued at once
+    uint32_t cycles;      // Service cost, all passes
+    uint32_t cyclesMax;   // Longest single pass
+} spiFlashStatsType;
+
+extern spiFlashStatsType spiFlashStats;
+
+extern uint8_t  spiFlashPresent;
+extern uint32_t spiFlashJedecId;
+extern uint32_t spiFlashSize;
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Initialization
+///////////////////////////////////////////////////////////////////////////////
+
+void spiFlashInit(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Service
+///////////////////////////////////////////////////////////////////////////////
+
+void spiFlashService(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Write
+///////////////////////////////////////////////////////////////////////////////
+
+bool spiFlashWrite(const uint8_t *data, uint16_t length);
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Flush
+///////////////////////////////////////////////////////////////////////////////
+
+void spiFlashFlush(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Used and Free
+///////////////////////////////////////////////////////////////////////////////
+
+uint32_t spiFlashUsed(void);
+
+uint32_t spiFlashFree(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Idle
+///////////////////////////////////////////////////////////////////////////////
+
+bool spiFlashIdle(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Read
+///////////////////////////////////////////////////////////////////////////////
+
+void spiFlashRead(uint32_t address, uint8_t *buffer, uint16_t length);
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Erase Chip
+///////////////////////////////////////////////////////////////////////////////
+
+void spiFlashEraseChip(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// SPI Flash Stats Reset
+///////////////////////////////////////////////////////////////////////////////
+
+void spiFlashStatsReset(void);
+
+///////////////////////////////////////////////////////////////////////////////
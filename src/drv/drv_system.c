@@ -33,13 +33,6 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 ///////////////////////////////////////////////////////////////////////////////
 
-// Cycle counter stuff - these should be defined by CMSIS, but they aren't
-#define DWT_CTRL    (*(volatile uint32_t *)0xE0001000)
-#define DWT_CYCCNT  ((volatile uint32_t *)0xE0001004)
-#define CYCCNTENA   (1 << 0)
-
-///////////////////////////////////////////////////////////////////////////////
-
 // Cycles per microsecond
 static volatile uint32_t usTicks = 0;
 
@@ -108,10 +101,7 @@ void SysTick_Handler(void)
 
     if ((systemReady        == true ) &&
     	(cliBusy            == false) &&
-    	(accelCalibrating   == false) &&
-    	(escCalibrating     == false) &&
-    	(magCalibrating     == false) &&
-    	(mpuCalibrating     == false))
+    	(rtDataComputing    == false))
 
     {
         frameCounter++;
@@ -154,37 +144,16 @@ void SysTick_Handler(void)
         if ((frameCounter % COUNT_100HZ) == 0)
         {
             frame_100Hz = true;
-
-            if (eepromConfig.useMs5611 == true)
-            {
-                if (!newTemperatureReading)
-    			{
-    				ms5611ReadTemperatureRequestPressure();
-    			    newTemperatureReading = true;
-    			}
-    			else
-    			{
-    			    ms5611ReadPressureRequestTemperature();
-    			    newPressureReading = true;
-    			}
-            }
-            else
-            {
-            	if (!newTemperatureReading)
-                {
-					bmp085ReadTemperatureRequestPressure();
-					newTemperatureReading = true;
-				}
-                else
-                {
-					bmp085ReadPressureRequestTemperature();
-                    newPressureReading = true;
-				}
-            }
         }
 
         ///////////////////////////////
 
+        baroManagerTick();
+
+        magTick();
+
+        ///////////////////////////////
+
         if ((frameCounter % COUNT_50HZ) == 0)
         {
             frame_50Hz = true;
@@ -192,9 +161,6 @@ void SysTick_Handler(void)
 
         ///////////////////////////////
 
-        if (((frameCounter + 1) % COUNT_10HZ) == 0)
-            newMagData = readMag();
-
         if ((frameCounter % COUNT_10HZ) == 0)
             frame_10Hz = true;
 
@@ -316,6 +282,7 @@ void systemInit(void)
 	cliPortAvailable         = &uart1Available;
 	cliPortPrint             = &uart1Print;
 	cliPortPrintF            = &uart1PrintF;
+	cliPortPrintBinary       = &uart1PrintBinary;
 	cliPortRead              = &uart1Read;
 
     //gpsPortClearBuffer       = &uart2ClearBuffer;
@@ -323,13 +290,17 @@ void systemInit(void)
     //gpsPortPrintBinary       = &uart2PrintBinary;
     //gpsPortRead              = &uart2Read;
 
-	mavlinkPortPrintBinary   = &uart1PrintBinary;
+	mavlinkPortAvailable     = &uart1Available;
+	mavlinkPortRead          = &uart1Read;
+	mavlinkPortReserve       = &uart1TxReserve;
+	mavlinkPortCommit        = &uart1TxCommit;
 
-	telemPortPrintF          = &uart1PrintF;
+	telemPortReserve         = &uart1TxReserve;
+	telemPortCommit          = &uart1TxCommit;
 
 	///////////////////////////////////
 
-	uart1Init(115200);
+	uart1Init(UART1_BAUD_RATE);
     gpioInit();
     adcInit();
 
@@ -370,10 +341,8 @@ void systemInit(void)
     else
     	cliPortPrint("Using BMP085....\n\n");
 
-    if (eepromConfig.receiverType == PPM)
-    	cliPortPrint("Using PPM Receiver....\n\n");
-    else
-    	cliPortPrint("Using Spektrum Satellite Receiver....\n\n");
+    if (eepromConfig.receiverType < NUMBER_OF_RECEIVER_TYPES)
+    	cliPortPrintF("Using %s Receiver....\n\n", rxDrivers[eepromConfig.receiverType].name);
 
     delay(10000);  // Remaining 10 seconds of 20 second delay for sensor stabilization - probably not long enough..
 
@@ -381,16 +350,20 @@ void systemInit(void)
 
     batteryInit();
 
-    if (eepromConfig.receiverType == SPEKTRUM)
-        spektrumInit();
-    else
-        ppmRxInit();
+    rxInit();
+
+    flightRecorderInit();
+
+    spiFlashInit();
+    blackboxInit();
 
     i2cInit(I2C2);
 
     initFirstOrderFilter();
     initPID();
 
+    gainScheduleVoltageUpdate();
+
     if (eepromConfig.useMpu6050 == true)
     	initMpu6050();
     else
@@ -405,6 +378,8 @@ void systemInit(void)
     	initMs5611();
     else
     	initBmp085();
+
+    initBaroManager();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
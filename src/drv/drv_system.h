@@ -31,6 +31,13 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
+///////////////////////////////////////////////////////////////////////////////
+
+// Cycle counter stuff - these should be defined by CMSIS, but they aren't
+#define DWT_CTRL    (*(volatile uint32_t *)0xE0001000)
+#define DWT_CYCCNT  ((volatile uint32_t *)0xE0001004)
+#define CYCCNTENA   (1 << 0)
+
 ///////////////////////////////////////////////////////////////////////////////
 // Frame Timing Defines and Variables
 ///////////////////////////////////////////////////////////////////////////////
@@ -42,6 +42,8 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 #define UART1_BUFFER_SIZE 2048
 
+#define UART1_PRINTF_LENGTH 256
+
 // Receive buffer, circular DMA
 volatile uint8_t rx1Buffer[UART1_BUFFER_SIZE];
 uint32_t rx1DMAPos = 0;
@@ -49,29 +51,55 @@ uint32_t rx1DMAPos = 0;
 volatile uint8_t  tx1Buffer[UART1_BUFFER_SIZE];
 volatile uint32_t tx1BufferTail = 0;
 volatile uint32_t tx1BufferHead = 0;
+volatile uint32_t tx1BufferEnd  = UART1_BUFFER_SIZE;  // Wrap mark, data runs tail to end then 0 to head
 
 volatile uint8_t  tx1DmaEnabled = false;
+volatile uint16_t tx1DmaLength  = 0;
+
+uint8_t  tx1Hold         = false;
+uint32_t tx1ReserveStart = 0;
+uint8_t  tx1ReserveWrap  = false;
+
+uart1TxStatsType uart1TxStats;
 
+///////////////////////////////////////////////////////////////////////////////
+// Transmit ring
+//
+// Producers reserve a contiguous block, write into it in place and commit
+// the length actually used.  The main loop is the only producer, the DMA
+// transfer complete interrupt is the only consumer.  The tail only moves
+// once a transfer completes so the bytes in flight are never overwritten,
+// a reservation that doesn't fit is refused and counted instead.
 ///////////////////////////////////////////////////////////////////////////////
 
 static void uart1TxDMA(void)
 {
-    if ((tx1DmaEnabled == true) || (tx1BufferHead == tx1BufferTail))  // Ignore call if already active or no new data in buffer
-        return;
+    uint32_t head;
 
-    DMA1_Channel4->CMAR = (uint32_t) & tx1Buffer[tx1BufferTail];
+    if (tx1DmaEnabled == true)  // Ignore call if already active
+        return;
 
-    if (tx1BufferHead > tx1BufferTail)
+    if (tx1BufferTail == tx1BufferEnd)  // Drained up to the wrap mark
     {
-        DMA1_Channel4->CNDTR = tx1BufferHead - tx1BufferTail;
-        tx1BufferTail = tx1BufferHead;
-    }
-    else
-    {
-        DMA1_Channel4->CNDTR = UART1_BUFFER_SIZE - tx1BufferTail;
         tx1BufferTail = 0;
+        tx1BufferEnd  = UART1_BUFFER_SIZE;
     }
 
+    head = tx1BufferHead;
+
+    if (head == tx1BufferTail)  // No new data in buffer
+        return;
+
+    if (head > tx1BufferTail)
+        tx1DmaLength = head - tx1BufferTail;
+    else
+        tx1DmaLength = tx1BufferEnd - tx1BufferTail;
+
+    DMA1_Channel4->CMAR  = (uint32_t) & tx1Buffer[tx1BufferTail];
+    DMA1_Channel4->CNDTR = tx1DmaLength;
+
+    uart1TxStats.dmaCnt++;
+
     tx1DmaEnabled = true;
 
     DMA_Cmd(DMA1_Channel4, ENABLE);
@@ -84,11 +112,125 @@ void DMA1_Channel4_IRQHandler(void)
     DMA_ClearITPendingBit(DMA1_IT_TC4);
     DMA_Cmd(DMA1_Channel4, DISABLE);
 
+    tx1BufferTail += tx1DmaLength;
+
     tx1DmaEnabled = false;
 
+    if (tx1Hold == false)  // While held the rest of the tick goes out with the flush
+        uart1TxDMA();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// UART1 Transmit Reserve
+///////////////////////////////////////////////////////////////////////////////
+
+static uint8_t *uart1TxClaim(uint16_t length)
+{
+    uint32_t head = tx1BufferHead;
+    uint32_t tail = tx1BufferTail;  // Only ever moves away from head, a stale copy is conservative
+
+    if (length == 0)
+        return NULL;
+
+    if (head >= tail)
+    {
+        if ((head + length) < UART1_BUFFER_SIZE)
+        {
+            tx1ReserveStart = head;
+            tx1ReserveWrap  = false;
+            return (uint8_t *)&tx1Buffer[head];
+        }
+
+        if (length < tail)  // Leave the end of the buffer unused and start over at 0
+        {
+            tx1ReserveStart = 0;
+            tx1ReserveWrap  = true;
+            return (uint8_t *)&tx1Buffer[0];
+        }
+    }
+    else if ((head + length) < tail)
+    {
+        tx1ReserveStart = head;
+        tx1ReserveWrap  = false;
+        return (uint8_t *)&tx1Buffer[head];
+    }
+
+    return NULL;
+}
+
+///////////////////////////////////////
+
+uint8_t *uart1TxReserve(uint16_t length)
+{
+    uint8_t *buf = uart1TxClaim(length);
+
+    if (buf == NULL)
+    {
+        uart1TxStats.dropCnt++;
+        uart1TxStats.dropBytes += length;
+    }
+
+    return buf;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// UART1 Transmit Commit
+///////////////////////////////////////////////////////////////////////////////
+
+void uart1TxCommit(uint16_t length)
+{
+    uint32_t used;
+
+    if (length == 0)
+        return;
+
+    if (tx1ReserveWrap == true)
+        tx1BufferEnd = tx1BufferHead;  // Mark before moving head, the consumer reads head first
+
+    tx1BufferHead = tx1ReserveStart + length;
+
+    uart1TxStats.byteCnt += length;
+
+    used = (tx1BufferHead >= tx1BufferTail) ? tx1BufferHead - tx1BufferTail
+                                            : tx1BufferEnd  - tx1BufferTail + tx1BufferHead;
+
+    if (used > uart1TxStats.highWater)
+        uart1TxStats.highWater = used;
+
+    if (tx1Hold == false)
+        uart1TxDMA();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// UART1 Transmit Hold and Flush
+//
+// Output committed between a hold and the following flush is sent as one
+// DMA transfer, the main loop holds for the duration of each pass.
+///////////////////////////////////////////////////////////////////////////////
+
+void uart1TxHold(void)
+{
+    tx1Hold = true;
+}
+
+///////////////////////////////////////
+
+void uart1TxFlush(void)
+{
+    tx1Hold = false;
+
     uart1TxDMA();
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// UART1 Transmit Statistics Reset
+///////////////////////////////////////////////////////////////////////////////
+
+void uart1TxStatsReset(void)
+{
+    memset(&uart1TxStats, 0, sizeof(uart1TxStats));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // UART1 Initialization
 ///////////////////////////////////////////////////////////////////////////////
@@ -254,10 +396,14 @@ uint8_t uart1ReadPoll(void)
 
 void uart1Write(uint8_t ch)
 {
-    tx1Buffer[tx1BufferHead] = ch;
-    tx1BufferHead = (tx1BufferHead + 1) % UART1_BUFFER_SIZE;
+    uint8_t *buf = uart1TxReserve(1);
 
-    uart1TxDMA();
+    if (buf == NULL)
+        return;
+
+    *buf = ch;
+
+    uart1TxCommit(1);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -266,8 +412,7 @@ void uart1Write(uint8_t ch)
 
 void uart1Print(char *str)
 {
-    while (*str)
-        uart1Write(*(str++));
+    uart1PrintBinary((uint8_t *)str, strlen(str));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -277,13 +422,32 @@ void uart1Print(char *str)
 
 void uart1PrintF(const char * fmt, ...)
 {
-	char buf[256];
-
+	char    *buf;
+	char     localBuf[UART1_PRINTF_LENGTH];
+	int      length;
 	va_list  vlist;
+
 	va_start (vlist, fmt);
 
-	vsnprintf(buf, sizeof(buf), fmt, vlist);
-	uart1Print(buf);
+	// Format straight into the ring when a full line fits, else go through the stack
+
+	buf = (char *)uart1TxClaim(UART1_PRINTF_LENGTH);
+
+	if (buf != NULL)
+	{
+		length = vsnprintf(buf, UART1_PRINTF_LENGTH, fmt, vlist);
+
+		if (length > 0)
+			uart1TxCommit((length < UART1_PRINTF_LENGTH) ? length : UART1_PRINTF_LENGTH - 1);
+	}
+	else
+	{
+		length = vsnprintf(localBuf, sizeof(localBuf), fmt, vlist);
+
+		if (length > 0)
+			uart1PrintBinary((uint8_t *)localBuf, (length < (int)sizeof(localBuf)) ? length : sizeof(localBuf) - 1);
+	}
+
 	va_end(vlist);
 }
 
@@ -293,15 +457,14 @@ void uart1PrintF(const char * fmt, ...)
 
 void uart1PrintBinary(uint8_t *buf, uint16_t length)
 {
-    uint16_t i;
+    uint8_t *dst = uart1TxReserve(length);
 
-   for (i = 0; i < length; i++)
-    {
-    	tx1Buffer[tx1BufferHead] = buf[i];
-    	tx1BufferHead = (tx1BufferHead + 1) % UART1_BUFFER_SIZE;
-    }
+    if (dst == NULL)
+        return;
+
+    memcpy(dst, buf, length);
 
-	uart1TxDMA();
+    uart1TxCommit(length);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
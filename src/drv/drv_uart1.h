@@ -31,6 +31,21 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
+///////////////////////////////////////////////////////////////////////////////
+
+#define UART1_BAUD_RATE 115200
+
+typedef struct uart1TxStatsType
+{
+    uint32_t dmaCnt;     // DMA transfers started
+    uint32_t byteCnt;    // Bytes committed
+    uint32_t dropCnt;    // Reservations refused, buffer full
+    uint32_t dropBytes;
+    uint32_t highWater;  // Most bytes waiting in the buffer
+} uart1TxStatsType;
+
+extern uart1TxStatsType uart1TxStats;
+
 ///////////////////////////////////////////////////////////////////////////////
 // UART1 Init
 ///////////////////////////////////////////////////////////////////////////////
@@ -67,6 +82,32 @@ uint8_t uart1Read(void);
 
 uint8_t uart1ReadPoll(void);
 
+///////////////////////////////////////////////////////////////////////////////
+// UART1 Transmit Reserve
+///////////////////////////////////////////////////////////////////////////////
+
+uint8_t *uart1TxReserve(uint16_t length);
+
+///////////////////////////////////////////////////////////////////////////////
+// UART1 Transmit Commit
+///////////////////////////////////////////////////////////////////////////////
+
+void uart1TxCommit(uint16_t length);
+
+///////////////////////////////////////////////////////////////////////////////
+// UART1 Transmit Hold and Flush
+///////////////////////////////////////////////////////////////////////////////
+
+void uart1TxHold(void);
+
+void uart1TxFlush(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// UART1 Transmit Statistics Reset
+///////////////////////////////////////////////////////////////////////////////
+
+void uart1TxStatsReset(void);
+
 ///////////////////////////////////////////////////////////////////////////////
 // UART1 Write
 ///////////////////////////////////////////////////////////////////////////////
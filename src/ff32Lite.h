@@ -33,10 +33,6 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 ///////////////////////////////////////////////////////////////////////////////
 
-extern void (*telemPortPrintF)(const char * fmt, ...);
-
-///////////////////////////////////////////////////////////////////////////////
-
 #define __FF32LITE_VERSION "1.0"
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -110,7 +106,7 @@ typedef struct sensors_t
     float accel100Hz[3];
     float attitude500Hz[3];
     float gyro500Hz[3];
-    float mag10Hz[3];
+    float mag75Hz[3];
     float pressureAlt50Hz;
 } sensors_t;
 
@@ -124,22 +120,11 @@ typedef struct homeData_t
 extern homeData_t homeData;
 
 ///////////////////////////////////////////////////////////////////////////////
-// PID Definitions
+// Gain Schedule Definitions
 ///////////////////////////////////////////////////////////////////////////////
 
-#define NUMBER_OF_PIDS 8
-
-#define ROLL_RATE_PID  0
-#define PITCH_RATE_PID 1
-#define YAW_RATE_PID   2
-
-#define ROLL_ATT_PID   3
-#define PITCH_ATT_PID  4
-#define HEADING_PID    5
-
-#define HDOT_PID       6
-
-#define H_PID          7
+#define GS_THROTTLE_POINTS 4
+#define GS_VOLTAGE_POINTS  3
 
 ///////////////////////////////////////////////////////////////////////////////
 // Mixer Configurations
@@ -177,7 +162,29 @@ enum { DLPF_256HZ, DLPF_188HZ, DLPF_98HZ, DLPF_42HZ };
 // Receiver Configurations
 ///////////////////////////////////////////////////////////////////////////////
 
-enum { PPM, SPEKTRUM };
+enum { PPM, SPEKTRUM, SBUS, MAVLINK_RC };
+
+#define NUMBER_OF_RECEIVER_TYPES 4
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Configurations
+///////////////////////////////////////////////////////////////////////////////
+
+enum { TELEMETRY_TEXT, TELEMETRY_BINARY };
+
+#define NUMBER_OF_TELEMETRY_SETS 6
+
+///////////////////////////////////////////////////////////////////////////////
+// ESC Protocols
+///////////////////////////////////////////////////////////////////////////////
+
+enum { ESC_PWM,
+       ESC_ONESHOT125,
+       ESC_ONESHOT42,
+       ESC_DSHOT150,
+       ESC_DSHOT300,
+       ESC_DSHOT600,
+     };
 
 ///////////////////////////////////////////////////////////////////////////////
 // EEPROM
@@ -191,6 +198,10 @@ typedef struct eepromConfig_t
 
     uint8_t useMs5611;
 
+    uint8_t ms5611Osr;              // 0 to 4, OSR 256 to 4096
+    uint8_t bmp085Oss;              // 0 to 3
+    uint8_t baroTemperatureDivider; // Temperature conversion every Nth conversion
+
     float accelBias[3];             // For ADXL345
     float accelScaleFactor[3];      // For ADXL345
 
@@ -200,7 +211,8 @@ typedef struct eepromConfig_t
     float gyroTCBiasSlope[3];
     float gyroTCBiasIntercept[3];
 
-    float magBias[3];
+    float magBias[3];               // Hard iron offset
+    float magSoftIron[3][3];        // Soft iron correction, applied after the offset
 
     float accelCutoff;
 
@@ -232,6 +244,10 @@ typedef struct eepromConfig_t
 
     uint8_t rcMap[8];
 
+    uint8_t rcInterpolation;
+    float   rcSmoothingCutoff;  // Hz, 0 disables the smoothing filter
+
+    uint8_t  escProtocol;
     uint16_t escPwmRate;
     uint16_t servoPwmRate;
 
@@ -254,7 +270,7 @@ typedef struct eepromConfig_t
 
     uint8_t  freeMixMotors;
 
-    float    freeMix[6][3];
+    float    freeMix[8][3];
 
     ///////////////////////////////////
 
@@ -268,6 +284,12 @@ typedef struct eepromConfig_t
 
     PIDdata_t PID[NUMBER_OF_PIDS];
 
+    uint8_t   autoTuneChannel;  // 0 disabled, else AUX1 thru AUX4
+
+    uint16_t  gainScheduleThrottle[GS_THROTTLE_POINTS];
+    float     gainScheduleCellVoltage[GS_VOLTAGE_POINTS];
+    uint8_t   gainScheduleTable[3][3][GS_THROTTLE_POINTS][GS_VOLTAGE_POINTS];  // Percent, [axis][P,I,D][throttle][voltage]
+
     ///////////////////////////////////
 
     uint8_t batteryCells;
@@ -278,6 +300,9 @@ typedef struct eepromConfig_t
     float   batteryVeryLow;
     float   batteryMaxLow;
 
+    uint8_t voltageCompensation;
+    float   voltageCompensationCell;
+
     ///////////////////////////////////
 
     uint8_t armCount;
@@ -285,10 +310,17 @@ typedef struct eepromConfig_t
 
     ///////////////////////////////////
 
-    uint16_t activeTelemetry;
+    uint16_t activeTelemetry;                             // Bit per telemetry set
+    uint8_t  telemetryDivider[NUMBER_OF_TELEMETRY_SETS];  // Set rate is 500 Hz / divider
+    uint8_t  telemetryFormat;
 
     uint8_t  mavlinkEnabled;
 
+    ///////////////////////////////////
+
+    uint8_t  blackboxEnabled;
+    uint8_t  blackboxDivider;  // Frame rate is 500 Hz / divider
+
 	///////////////////////////////////
 
     uint8_t verticalVelocityHoldOnly;
@@ -37,9 +37,34 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 float    rxCommand[8] = { 0.0f, 0.0f, 0.0f, 2000.0f, 2000.0f, 2000.0f, 2000.0f, 2000.0f };
 
+// Latest receiver value of each command, rcMap and mid command applied.  Frames may
+// carry only some channels, rxCommand is rebuilt from these every frame so deadband
+// and simple mode are applied once to each value, never to their own output.
+
+static float rxRawCommand[8] = { 0.0f, 0.0f, 0.0f, 2000.0f, 2000.0f, 2000.0f, 2000.0f, 2000.0f };
+
 uint8_t  commandInDetent[3]         = { true, true, true };
 uint8_t  previousCommandInDetent[3] = { true, true, true };
 
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Frame Timing Variables
+///////////////////////////////////////////////////////////////////////////////
+
+uint32_t rcFrameDeltaTime    = 0;
+uint32_t previousRcFrameTime = 0;
+
+float    rcLatencyAverage    = 0.0f;
+float    rcLatencyMax        = 0.0f;
+
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Failsafe Variables
+///////////////////////////////////////////////////////////////////////////////
+
+uint8_t  rcFailsafe     = false;  // Flying on invalid frames
+uint32_t rcFailsafeTime = 0;      // uSec since the first invalid frame
+
+static float rcFailsafeThrottle;
+
 ///////////////////////////////////////////////////////////////////////////////
 // Flight Mode Defines and Variables
 ///////////////////////////////////////////////////////////////////////////////
@@ -53,8 +78,8 @@ uint8_t headingHoldEngaged     = false;
 ///////////////////////////////////////////////////////////////////////////////
 
 semaphore_t armed          = false;
-uint8_t     armingTimer    = 0;
-uint8_t     disarmingTimer = 0;
+uint32_t    armingTimer    = 0;
+uint32_t    disarmingTimer = 0;
 
 ///////////////////////////////////////////////////////////////////////////////
 // Vertical Mode State Variables
@@ -65,43 +90,126 @@ uint8_t  verticalModeState = ALT_DISENGAGED_THROTTLE_ACTIVE;
 uint16_t previousAUX2State = MINCOMMAND;
 uint16_t previousAUX4State = MINCOMMAND;
 
+///////////////////////////////////////////////////////////////////////////////
+// Autotune Switch Variables
+///////////////////////////////////////////////////////////////////////////////
+
+uint16_t previousAutoTuneState = MINCOMMAND;
+
 uint8_t  vertRefCmdInDetent         = true;
 uint8_t  previousVertRefCmdInDetent = true;
 
 float    verticalReferenceCommand;
 
+///////////////////////////////////////////////////////////////////////////////
+// Failsafe Commands
+//
+// An invalid frame means the receiver is in failsafe, or no frames arrive at
+// all and the main loop passes on invalid frames at 50 Hz.  Roll, pitch and
+// yaw centre at once with attitude mode and heading hold selected, simple
+// mode, autotune and altitude hold drop out.  Throttle holds where it was
+// for RC_FAILSAFE_HOLD_TIME in case the link comes back, then ramps down at
+// RC_FAILSAFE_RAMP_RATE and the motors disarm when it reaches MINCOMMAND.
+///////////////////////////////////////////////////////////////////////////////
+
+static void failsafeCommands(void)
+{
+    if (rcFailsafe == false)
+    {
+    	rcFailsafe         = true;
+    	rcFailsafeTime     = 0;
+    	rcFailsafeThrottle = throttleCmd;  // Hover throttle in altitude hold as well as throttle active
+    }
+    else
+    {
+    	rcFailsafeTime += rcFrameDeltaTime;
+    }
+
+    if (rcFailsafeTime > RC_FAILSAFE_HOLD_TIME)
+    	rcFailsafeThrottle -= RC_FAILSAFE_RAMP_RATE * (float)rcFrameDeltaTime * 1.0e-6f;
+
+    if (rcFailsafeThrottle <= MINCOMMAND)
+    {
+    	rcFailsafeThrottle = MINCOMMAND;
+
+    	if (armed == true)
+    	{
+    		zeroPIDstates();
+    		armed = false;
+    	}
+    }
+
+    rxRawCommand[ROLL    ] = 0.0f;
+    rxRawCommand[PITCH   ] = 0.0f;
+    rxRawCommand[YAW     ] = 0.0f;
+    rxRawCommand[THROTTLE] = rcFailsafeThrottle;
+    rxRawCommand[AUX1    ] = MAXCOMMAND;  // Attitude mode
+    rxRawCommand[AUX3    ] = MINCOMMAND;  // Simple mode off
+
+    if (eepromConfig.autoTuneChannel != 0)
+    	rxRawCommand[eepromConfig.autoTuneChannel] = MINCOMMAND;
+
+    verticalModeState = ALT_DISENGAGED_THROTTLE_ACTIVE;  // AUX2 holds its last value, no edge re-engages it
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Read Flight Commands
 ///////////////////////////////////////////////////////////////////////////////
 
 void processFlightCommands(void)
 {
-    uint8_t channel;
+    uint8_t   channel, rcChannel;
+    uint8_t   frameCommands = 0;
+    rxFrame_t frame;
 
-    float hdgDelta, simpleX, simpleY;
+    float     hdgDelta, latency, simpleX, simpleY;
 
-    if (rcActive == true)
+    rcFrameRead(&frame);
+
+    rcFrameDeltaTime    = frame.time - previousRcFrameTime;
+    previousRcFrameTime = frame.time;
+
+    if (rcFrameDeltaTime > RC_FRAME_DELTA_MAX)  // Don't let a receiver dropout count toward arm/disarm
+    	rcFrameDeltaTime = RC_FRAME_DELTA_MAX;
+
+    if (frame.valid == true)
     {
-		// Read receiver commands
+    	rcFailsafe = false;
+
+		// Receiver commands carried by this frame, rcMap and mid command applied once per frame
+
         for (channel = 0; channel < 8; channel++)
         {
-			if (eepromConfig.receiverType == SPEKTRUM)
-			    rxCommand[channel] = (float)spektrumRead(eepromConfig.rcMap[channel]);
-			else
-			    rxCommand[channel] = (float)ppmRxRead(eepromConfig.rcMap[channel]);
+        	rcChannel = eepromConfig.rcMap[channel];
+
+        	if ((frame.channels & (1 << rcChannel)) == 0)
+        		continue;
+
+        	if (channel < THROTTLE)
+        		rxRawCommand[channel] = (float)frame.value[rcChannel] - eepromConfig.midCommand;                 // Roll, Pitch, Yaw  -1000:1000
+        	else
+        		rxRawCommand[channel] = (float)frame.value[rcChannel] - (eepromConfig.midCommand - MIDCOMMAND);  // Throttle, Aux     2000:4000
+
+        	frameCommands |= 1 << channel;
         }
 
-        rxCommand[ROLL]  -= eepromConfig.midCommand;                  // Roll Range    -1000:1000
-        rxCommand[PITCH] -= eepromConfig.midCommand;                  // Pitch Range   -1000:1000
-        rxCommand[YAW]   -= eepromConfig.midCommand;                  // Yaw Range     -1000:1000
+        latency = (float)(micros() - frame.time);
+
+        rcLatencyAverage = rcLatencyAverage * 0.99f + latency * 0.01f;
+
+        if (latency > rcLatencyMax)
+        	rcLatencyMax = latency;
+    }
+    else
+    {
+    	failsafeCommands();
 
-        rxCommand[THROTTLE] -= eepromConfig.midCommand - MIDCOMMAND;  // Throttle Range 2000:4000
-        rxCommand[AUX1]     -= eepromConfig.midCommand - MIDCOMMAND;  // Aux1 Range     2000:4000
-        rxCommand[AUX2]     -= eepromConfig.midCommand - MIDCOMMAND;  // Aux2 Range     2000:4000
-        rxCommand[AUX3]     -= eepromConfig.midCommand - MIDCOMMAND;  // Aux3 Range     2000:4000
-        rxCommand[AUX4]     -= eepromConfig.midCommand - MIDCOMMAND;  // Aux4 Range     2000:4000
+    	frameCommands = (1 << ROLL) | (1 << PITCH) | (1 << YAW) | (1 << THROTTLE);
     }
 
+    for (channel = 0; channel < 8; channel++)
+    	rxCommand[channel] = rxRawCommand[channel];
+
     // Set past command in detent values
     for (channel = 0; channel < 3; channel++)
     	previousCommandInDetent[channel] = commandInDetent[channel];
@@ -136,9 +244,9 @@ void processFlightCommands(void)
 		// Check for disarm command ( low throttle, left yaw )
 		if (((rxCommand[YAW] < (eepromConfig.minCheck - MIDCOMMAND)) && (armed == true)) && (verticalModeState == ALT_DISENGAGED_THROTTLE_ACTIVE))
 		{
-			disarmingTimer++;
+			disarmingTimer += rcFrameDeltaTime;
 
-			if (disarmingTimer > eepromConfig.disarmCount)
+			if (disarmingTimer > eepromConfig.disarmCount * ARM_COUNT_PERIOD)
 			{
 				zeroPIDstates();
 			    armed = false;
@@ -160,11 +268,11 @@ void processFlightCommands(void)
 		}
 
 		// Check for arm command ( low throttle, right yaw)
-		if ((rxCommand[YAW] > (eepromConfig.maxCheck - MIDCOMMAND) ) && (armed == false) && (execUp == true))
+		if ((rxCommand[YAW] > (eepromConfig.maxCheck - MIDCOMMAND) ) && (armed == false) && (execUp == true) && (calibrationActive() == false))
 		{
-			armingTimer++;
+			armingTimer += rcFrameDeltaTime;
 
-			if (armingTimer > eepromConfig.armCount)
+			if (armingTimer > eepromConfig.armCount * ARM_COUNT_PERIOD)
 			{
 				zeroPIDstates();
 				armed = true;
@@ -224,6 +332,22 @@ void processFlightCommands(void)
 
 	///////////////////////////////////
 
+	// Check autotune switch, rising edge tunes the loop of the current flight mode
+
+	if (eepromConfig.autoTuneChannel != 0)
+	{
+		if ((rxCommand[eepromConfig.autoTuneChannel] > MIDCOMMAND) && (previousAutoTuneState <= MIDCOMMAND) && (pidReset == false))
+			autoTuneStart((flightMode == RATE) ? AUTOTUNE_RATE : AUTOTUNE_ATTITUDE);
+
+		if ((rxCommand[eepromConfig.autoTuneChannel] <= MIDCOMMAND) || (pidReset == true) ||
+		    ((autoTuneLoop == AUTOTUNE_RATE) != (flightMode == RATE)))
+			autoTuneStop();
+
+		previousAutoTuneState = rxCommand[eepromConfig.autoTuneChannel];
+	}
+
+	///////////////////////////////////
+
 	// Simple Mode Command Processing
 
 	if (rxCommand[AUX3] > MIDCOMMAND)
@@ -356,6 +480,14 @@ void processFlightCommands(void)
 	previousAUX4State = rxCommand[AUX4];
 
 	///////////////////////////////////
+
+	// Hand the stick commands carried by this frame to the interpolator, the control loop ramps between frames
+
+	for (channel = ROLL; channel <= THROTTLE; channel++)
+		if ((frameCommands & (1 << channel)) != 0)
+			rcInterpolationSample(channel, rxCommand[channel], frame.time);
+
+	///////////////////////////////////
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -50,6 +50,29 @@ extern uint8_t previousCommandInDetent[3];
 
 extern uint8_t channelOrder[8];
 
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Frame Timing Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+#define RC_FRAME_DELTA_MAX 100000  // uSec, longest frame interval credited to the arm/disarm timers
+
+#define ARM_COUNT_PERIOD    20000  // uSec, armCount and disarmCount are in units of the original 50 Hz frame
+
+extern uint32_t rcFrameDeltaTime;
+
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Failsafe Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+#define RC_FAILSAFE_HOLD_TIME 1000000  // uSec of invalid frames before the throttle starts down
+#define RC_FAILSAFE_RAMP_RATE     200  // Throttle command per second, the full range in 10 seconds
+
+extern uint8_t  rcFailsafe;
+extern uint32_t rcFailsafeTime;
+
+extern float    rcLatencyAverage;
+extern float    rcLatencyMax;
+
 ///////////////////////////////////////////////////////////////////////////////
 // Flight Mode Defines and Variables
 ///////////////////////////////////////////////////////////////////////////////
@@ -63,8 +86,8 @@ extern uint8_t headingHoldEngaged;
 ///////////////////////////////////////////////////////////////////////////////
 
 extern semaphore_t armed;
-extern uint8_t     armingTimer;
-extern uint8_t     disarmingTimer;
+extern uint32_t    armingTimer;
+extern uint32_t    disarmingTimer;
 
 ///////////////////////////////////////////////////////////////////////////////
 // Verical Mode State Variables
@@ -0,0 +1,442 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Flight Recorder Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+// Every 500 Hz cycle while armed a record of 29 values, scaled to int16, goes
+// into a ring of 512 byte blocks in RAM.  A block starts with a keyframe,
+// the time and absolute values, followed by records holding the change from
+// the previous cycle.  A record is a 16 bit tag word, 2 bits for each group
+// of values, then each group at the width its tag gives:
+//
+//   0 - every value unchanged, nothing stored
+//   1 - 4 bit changes, two to a byte
+//   2 - 8 bit changes
+//   3 - 16 bit changes
+//
+// A record that doesn't fit in the rest of a block starts a new block, the
+// oldest block is dropped once the ring is full.  Blocks decode on their own.
+//
+// Recording freezes on disarm, or RECORDER_POST_TRIGGER cycles after an
+// impact above RECORDER_CRASH_G or an error EVR, until the next arm.  The
+// buffer is shared with system ID, the recorder stays idle while system ID
+// holds it and takes it back when a new flight is armed.
+
+#define RECORDER_BLOCK_SIZE    512
+#define RECORDER_BLOCKS        (CAPTURE_BUFFER_SIZE / RECORDER_BLOCK_SIZE)
+
+#define RECORDER_BLOCK_HEADER  6   // Keyframe time (uint32), record count (uint16)
+#define RECORDER_KEYFRAME      (RECORDER_BLOCK_HEADER + RECORDER_FIELDS * 2)
+#define RECORDER_RECORD_MAX    (2 + RECORDER_FIELDS * 2)
+
+#define RECORDER_PERIOD        2000  // uSec, 500 Hz
+
+#define RECORDER_POST_TRIGGER  125   // 0.25 seconds of 500 Hz cycles kept after a trigger
+#define RECORDER_CRASH_G       6.0f
+
+#define RECORDER_VERSION       1
+
+// Decoders rely on this order, change RECORDER_VERSION and BLACKBOX_VERSION with it
+
+const recorderGroup_t recorderGroups[RECORDER_GROUPS] =
+{
+    { 3,  100.0f, sensors.gyro500Hz     },  // 0.01 rad/sec
+    { 3,   10.0f, sensors.accel500Hz    },  // 0.1 m/sec^2
+    { 3, 1000.0f, sensors.attitude500Hz },  // mrad
+    { 3,  100.0f, rateCmd               },  // 0.01 rad/sec
+    { 3,    1.0f, ratePID               },  // Motor command counts
+    { 6,    1.0f, motor                 },  // Motor command counts
+    { 8,    1.0f, rxCommand             },  // Receiver command counts
+};
+
+uint32_t captureBuffer[CAPTURE_BUFFER_SIZE / 4];
+
+#define recorderBuffer ((uint8_t *)captureBuffer)
+
+flightRecorderStateType flightRecorderState;
+
+static uint8_t  recorderWriteBlock;
+static uint16_t recorderBlockUsed;    // Bytes used in the write block, 0 before the first keyframe
+static int16_t  recorderPrevious[RECORDER_FIELDS];
+static uint16_t recorderPostTrigger;
+static uint8_t  recorderWasArmed = false;
+
+///////////////////////////////////////////////////////////////////////////////
+// Recorder Trigger
+///////////////////////////////////////////////////////////////////////////////
+
+static void recorderTrigger(uint8_t trigger)
+{
+    if (flightRecorderState.state != RECORDER_RECORDING)
+        return;
+
+    flightRecorderState.trigger     = trigger;
+    flightRecorderState.triggerTime = micros();
+
+    recorderPostTrigger = RECORDER_POST_TRIGGER;
+
+    flightRecorderState.state = RECORDER_TRIGGERED;
+}
+
+///////////////////////////////////////
+
+static void recorderEvrCB(evr_t e)
+{
+    if (evrSeverity(e.evr) >= 2)  // Errors and fatal
+        recorderTrigger(RECORDER_TRIGGER_EVR);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Flight Recorder Sample
+///////////////////////////////////////////////////////////////////////////////
+
+void flightRecorderSample(int16_t *sample)
+{
+    const recorderGroup_t *group;
+
+    uint8_t groupIndex;
+    uint8_t index;
+    float   value;
+
+    for (groupIndex = 0; groupIndex < RECORDER_GROUPS; groupIndex++)
+    {
+        group = &recorderGroups[groupIndex];
+
+        for (index = 0; index < group->count; index++)
+        {
+            value = group->data[index] * group->scale;
+
+            if (value > 32767.0f)
+                value = 32767.0f;
+            else if (value < -32767.0f)
+                value = -32767.0f;
+
+            *sample++ = (int16_t)value;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Recorder Encode
+//
+// Changes wrap at 16 bits, the decoder adds them back the same way.
+///////////////////////////////////////////////////////////////////////////////
+
+static uint8_t recorderEncode(const int16_t *sample, uint8_t *record)
+{
+    int16_t  delta[8];
+    int16_t  changed;
+    int16_t  magnitude;
+    uint16_t tags = 0;
+    uint8_t  tag;
+    uint8_t  groupIndex;
+    uint8_t  index;
+    uint8_t  count;
+    uint8_t  field = 0;
+    uint8_t *out   = record + 2;
+
+    for (groupIndex = 0; groupIndex < RECORDER_GROUPS; groupIndex++)
+    {
+        count     = recorderGroups[groupIndex].count;
+        changed   = 0;
+        magnitude = 0;
+
+        for (index = 0; index < count; index++)
+        {
+            delta[index] = sample[field + index] - recorderPrevious[field + index];
+
+            changed   |= delta[index];
+            magnitude |= (delta[index] < 0) ? ~delta[index] : delta[index];  // Or of 2^n - 1 bounds is the bound of the largest
+        }
+
+        if (changed == 0)
+            tag = 0;
+        else if (magnitude <= 7)
+            tag = 1;
+        else if (magnitude <= 127)
+            tag = 2;
+        else
+            tag = 3;
+
+        tags |= tag << (groupIndex * 2);
+
+        switch (tag)
+        {
+            case 1:
+                for (index = 0; index < count; index += 2)
+                    *out++ = (delta[index] & 0x0F) | (((index + 1) < count) ? (delta[index + 1] << 4) : 0);
+                break;
+
+            case 2:
+                for (index = 0; index < count; index++)
+                    *out++ = (uint8_t)delta[index];
+                break;
+
+            case 3:
+                for (index = 0; index < count; index++)
+                {
+                    *out++ = (uint8_t)delta[index];
+                    *out++ = (uint8_t)(delta[index] >> 8);
+                }
+                break;
+        }
+
+        field += count;
+    }
+
+    record[0] = (uint8_t)tags;
+    record[1] = (uint8_t)(tags >> 8);
+
+    return out - record;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Recorder Keyframe
+///////////////////////////////////////////////////////////////////////////////
+
+static void recorderKeyframe(const int16_t *sample)
+{
+    uint8_t  *block;
+    uint32_t  time = micros();
+    uint16_t  count = 1;
+
+    if (flightRecorderState.blockCnt != 0)
+        recorderWriteBlock = (recorderWriteBlock + 1) % RECORDER_BLOCKS;
+
+    if (flightRecorderState.blockCnt < RECORDER_BLOCKS)
+        flightRecorderState.blockCnt++;
+
+    block = &recorderBuffer[recorderWriteBlock * RECORDER_BLOCK_SIZE];
+
+    memcpy(&block[0], &time,  4);
+    memcpy(&block[4], &count, 2);
+    memcpy(&block[RECORDER_BLOCK_HEADER], sample, RECORDER_FIELDS * 2);
+
+    recorderBlockUsed = RECORDER_KEYFRAME;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Recorder Record
+///////////////////////////////////////////////////////////////////////////////
+
+static void recorderRecord(void)
+{
+    int16_t   sample[RECORDER_FIELDS];
+    uint8_t   record[RECORDER_RECORD_MAX];
+    uint8_t  *block;
+    uint8_t   length;
+
+    flightRecorderSample(sample);
+
+    if (recorderBlockUsed == 0)
+    {
+        recorderKeyframe(sample);
+    }
+    else
+    {
+        length = recorderEncode(sample, record);
+
+        if ((recorderBlockUsed + length) > RECORDER_BLOCK_SIZE)
+        {
+            recorderKeyframe(sample);
+        }
+        else
+        {
+            block = &recorderBuffer[recorderWriteBlock * RECORDER_BLOCK_SIZE];
+
+            memcpy(&block[recorderBlockUsed], record, length);
+            recorderBlockUsed += length;
+
+            (*(uint16_t *)&block[4])++;
+        }
+    }
+
+    memcpy(recorderPrevious, sample, sizeof(recorderPrevious));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Flight Recorder Initialization
+///////////////////////////////////////////////////////////////////////////////
+
+void flightRecorderInit(void)
+{
+    memset(&flightRecorderState, 0, sizeof(flightRecorderState));
+
+    evrRegisterListener(recorderEvrCB);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Flight Recorder Update
+//
+// Called every 500 Hz cycle after the mixer, armed or not.
+///////////////////////////////////////////////////////////////////////////////
+
+void flightRecorderUpdate(void)
+{
+    uint32_t startCycles = *DWT_CYCCNT;
+    float    accelSquared;
+
+    if ((armed == true) && (recorderWasArmed == false))
+    {
+        if (sysIdState == SYSID_COMPLETE)
+            sysIdState = SYSID_IDLE;  // A new flight takes the buffer back from a finished system ID
+
+        if (sysIdState == SYSID_IDLE)
+        {
+            flightRecorderState.state    = RECORDER_RECORDING;
+            flightRecorderState.trigger  = RECORDER_TRIGGER_NONE;
+            flightRecorderState.blockCnt = 0;
+
+            recorderWriteBlock = 0;
+            recorderBlockUsed  = 0;
+        }
+    }
+
+    if ((armed == false) && (recorderWasArmed == true))
+    {
+        recorderTrigger(RECORDER_TRIGGER_DISARM);  // Keeps the reason of an earlier trigger
+
+        if (flightRecorderState.state == RECORDER_TRIGGERED)
+            flightRecorderState.state = RECORDER_FROZEN;
+    }
+
+    recorderWasArmed = armed;
+
+    if (sysIdState != SYSID_IDLE)
+        flightRecorderState.state = RECORDER_IDLE;  // System ID has the buffer
+
+    if ((flightRecorderState.state == RECORDER_RECORDING) || (flightRecorderState.state == RECORDER_TRIGGERED))
+    {
+        recorderRecord();
+
+        accelSquared = SQR(sensors.accel500Hz[XAXIS]) + SQR(sensors.accel500Hz[YAXIS]) + SQR(sensors.accel500Hz[ZAXIS]);
+
+        if (accelSquared > SQR(RECORDER_CRASH_G * accelOneG))
+            recorderTrigger(RECORDER_TRIGGER_CRASH);
+
+        if ((flightRecorderState.state == RECORDER_TRIGGERED) && (--recorderPostTrigger == 0))
+            flightRecorderState.state = RECORDER_FROZEN;
+    }
+
+    flightRecorderState.cyclesLast = *DWT_CYCCNT - startCycles;
+
+    if (flightRecorderState.cyclesLast > flightRecorderState.cyclesMax)
+        flightRecorderState.cyclesMax = flightRecorderState.cyclesLast;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Flight Recorder Records
+///////////////////////////////////////////////////////////////////////////////
+
+uint16_t flightRecorderRecords(void)
+{
+    uint16_t records = 0;
+    uint8_t  block;
+
+    for (block = 0; block < flightRecorderState.blockCnt; block++)
+        records += *(uint16_t *)&recorderBuffer[block * RECORDER_BLOCK_SIZE + 4];
+
+    return records;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Flight Recorder Dump
+//
+// Binary, a header then the blocks oldest first:
+//
+//   "FFRC", version, group count, block count, trigger (uint8),
+//   block size, record period in uSec (uint16), trigger time (uint32),
+//   per group the value count (uint8) and scale (float)
+//
+// Paced to the 115200 baud CLI port, tools/recorderDecode.c makes CSV of it.
+///////////////////////////////////////////////////////////////////////////////
+
+void flightRecorderDump(void)
+{
+    uint8_t  header[16 + RECORDER_GROUPS * 5];
+    uint8_t  length = 0;
+    uint8_t  groupIndex;
+    uint8_t  block;
+    uint8_t  count;
+    uint16_t offset;
+    uint16_t value;
+
+    memcpy(&header[length], "FFRC", 4);
+    length += 4;
+
+    header[length++] = RECORDER_VERSION;
+    header[length++] = RECORDER_GROUPS;
+    header[length++] = flightRecorderState.blockCnt;
+    header[length++] = flightRecorderState.trigger;
+
+    value = RECORDER_BLOCK_SIZE;
+    memcpy(&header[length], &value, 2);
+    length += 2;
+
+    value = RECORDER_PERIOD;
+    memcpy(&header[length], &value, 2);
+    length += 2;
+
+    memcpy(&header[length], &flightRecorderState.triggerTime, 4);
+    length += 4;
+
+    for (groupIndex = 0; groupIndex < RECORDER_GROUPS; groupIndex++)
+    {
+        header[length++] = recorderGroups[groupIndex].count;
+        memcpy(&header[length], &recorderGroups[groupIndex].scale, 4);
+        length += 4;
+    }
+
+    cliPortPrintBinary(header, length);
+
+    // Oldest block first, the one after the write block once the ring has wrapped
+
+    block = (flightRecorderState.blockCnt < RECORDER_BLOCKS) ? 0 : (recorderWriteBlock + 1) % RECORDER_BLOCKS;
+
+    for (count = 0; count < flightRecorderState.blockCnt; count++)
+    {
+        for (offset = 0; offset < RECORDER_BLOCK_SIZE; offset += 256)
+        {
+            delay(25);  // 256 bytes take 22 mSec at 115200 baud
+            cliPortPrintBinary(&recorderBuffer[block * RECORDER_BLOCK_SIZE + offset], 256);
+        }
+
+        block = (block + 1) % RECORDER_BLOCKS;
+    }
+
+    delay(25);
+}
+
+///////////////////////////////////////////////////////////////////////////////
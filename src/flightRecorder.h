@@ -0,0 +1,100 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Flight Recorder Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+#define CAPTURE_BUFFER_SIZE 6144
+
+extern uint32_t captureBuffer[CAPTURE_BUFFER_SIZE / 4];  // Flight recorder ring, lent to system ID while it runs
+
+#define RECORDER_GROUPS 7
+#define RECORDER_FIELDS 29
+
+typedef struct recorderGroup_t
+{
+    uint8_t      count;
+    float        scale;  // To int16 counts
+    const float *data;
+} recorderGroup_t;
+
+extern const recorderGroup_t recorderGroups[RECORDER_GROUPS];  // Also sampled by the blackbox
+
+enum { RECORDER_IDLE, RECORDER_RECORDING, RECORDER_TRIGGERED, RECORDER_FROZEN };
+
+enum { RECORDER_TRIGGER_NONE, RECORDER_TRIGGER_DISARM, RECORDER_TRIGGER_CRASH, RECORDER_TRIGGER_EVR };
+
+typedef struct flightRecorderStateType
+{
+    uint8_t  state;
+    uint8_t  trigger;
+    uint32_t triggerTime;
+    uint8_t  blockCnt;     // Blocks holding data, oldest is overwritten once all are used
+    uint32_t cyclesLast;   // Cost of the last update
+    uint32_t cyclesMax;
+} flightRecorderStateType;
+
+extern flightRecorderStateType flightRecorderState;
+
+///////////////////////////////////////////////////////////////////////////////
+// Flight Recorder Initialization
+///////////////////////////////////////////////////////////////////////////////
+
+void flightRecorderInit(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Flight Recorder Sample
+///////////////////////////////////////////////////////////////////////////////
+
+void flightRecorderSample(int16_t *sample);
+
+///////////////////////////////////////////////////////////////////////////////
+// Flight Recorder Update
+///////////////////////////////////////////////////////////////////////////////
+
+void flightRecorderUpdate(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Flight Recorder Records
+///////////////////////////////////////////////////////////////////////////////
+
+uint16_t flightRecorderRecords(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Flight Recorder Dump
+///////////////////////////////////////////////////////////////////////////////
+
+void flightRecorderDump(void);
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,130 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Gain Schedule Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+// Rate loop P, I and D of each axis are scaled by a table over throttle
+// command and battery cell voltage, stored in percent in eepromConfig.
+//
+// The voltage changes slowly, so at the battery monitor rate the table is
+// interpolated in voltage down to one column over the throttle breakpoints,
+// with the slope of each throttle segment.  The control cycle then only
+// finds the throttle segment and does one multiply-add per gain.
+
+PIDdata_t scheduledRateGains[3];
+
+float     gainScale[3][3];
+
+static float columnValue[3][3][GS_THROTTLE_POINTS];
+static float columnSlope[3][3][GS_THROTTLE_POINTS - 1];
+
+///////////////////////////////////////////////////////////////////////////////
+// Gain Schedule Voltage Update
+///////////////////////////////////////////////////////////////////////////////
+
+void gainScheduleVoltageUpdate(void)
+{
+	float   cellVoltage, fraction;
+	float   lower, upper;
+	uint8_t axis, term, t, v;
+
+	if (batteryNumCells == 0)
+		cellVoltage = eepromConfig.gainScheduleCellVoltage[GS_VOLTAGE_POINTS - 1];
+	else
+		cellVoltage = batteryVoltage / (float)batteryNumCells;
+
+	// Voltage segment and fraction, clamped at the end breakpoints
+
+	for (v = 0; v < (GS_VOLTAGE_POINTS - 2); v++)
+		if (cellVoltage < eepromConfig.gainScheduleCellVoltage[v + 1])
+			break;
+
+	fraction = (cellVoltage - eepromConfig.gainScheduleCellVoltage[v]) /
+			   (eepromConfig.gainScheduleCellVoltage[v + 1] - eepromConfig.gainScheduleCellVoltage[v]);
+
+	fraction = constrain(fraction, 0.0f, 1.0f);
+
+	for (axis = 0; axis < 3; axis++)
+	{
+		for (term = 0; term < 3; term++)
+		{
+			for (t = 0; t < GS_THROTTLE_POINTS; t++)
+			{
+				lower = (float)eepromConfig.gainScheduleTable[axis][term][t][v    ];
+				upper = (float)eepromConfig.gainScheduleTable[axis][term][t][v + 1];
+
+				columnValue[axis][term][t] = (lower + (upper - lower) * fraction) * 0.01f;
+			}
+
+			for (t = 0; t < (GS_THROTTLE_POINTS - 1); t++)
+				columnSlope[axis][term][t] = (columnValue[axis][term][t + 1] - columnValue[axis][term][t]) /
+				                             (float)(eepromConfig.gainScheduleThrottle[t + 1] - eepromConfig.gainScheduleThrottle[t]);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Gain Schedule Update
+///////////////////////////////////////////////////////////////////////////////
+
+// Once per control cycle, before the rate PIDs
+
+void gainScheduleUpdate(float throttle)
+{
+	float   delta;
+	uint8_t axis, t;
+
+	for (t = 0; t < (GS_THROTTLE_POINTS - 2); t++)
+		if (throttle < eepromConfig.gainScheduleThrottle[t + 1])
+			break;
+
+	delta = constrain(throttle - eepromConfig.gainScheduleThrottle[t], 0.0f,
+			          (float)(eepromConfig.gainScheduleThrottle[t + 1] - eepromConfig.gainScheduleThrottle[t]));
+
+	for (axis = 0; axis < 3; axis++)
+	{
+		gainScale[axis][GS_P] = columnValue[axis][GS_P][t] + columnSlope[axis][GS_P][t] * delta;
+		gainScale[axis][GS_I] = columnValue[axis][GS_I][t] + columnSlope[axis][GS_I][t] * delta;
+		gainScale[axis][GS_D] = columnValue[axis][GS_D][t] + columnSlope[axis][GS_D][t] * delta;
+
+		scheduledRateGains[axis].P = eepromConfig.PID[ROLL_RATE_PID + axis].P * gainScale[axis][GS_P];
+		scheduledRateGains[axis].I = eepromConfig.PID[ROLL_RATE_PID + axis].I * gainScale[axis][GS_I];
+		scheduledRateGains[axis].D = eepromConfig.PID[ROLL_RATE_PID + axis].D * gainScale[axis][GS_D];
+		scheduledRateGains[axis].N = eepromConfig.PID[ROLL_RATE_PID + axis].N;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
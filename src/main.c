@@ -41,8 +41,6 @@ sensors_t      sensors;
 
 homeData_t     homeData;
 
-void           (*telemPortPrintF)(const char * fmt, ...);
-
 ///////////////////////////////////////////////////////////////////////////////
 
 int main(void)
@@ -51,6 +49,12 @@ int main(void)
 
 	uint32_t currentTime;
 
+	float    magHardIron[3];
+
+	uint32_t previousMagTime = 0;
+
+	float    dtMag = 0.0f;
+
     systemReady = false;
 
     systemInit();
@@ -61,8 +65,22 @@ int main(void)
 
     while (1)
     {
+    	uart1TxHold();  // Everything this pass prints goes out as one DMA transfer at the bottom
+
     	evrCheck();
 
+    	spiFlashService();  // Streams queued blackbox pages to the flash a chunk at a time
+
+    	///////////////////////////////
+
+    	if (eepromConfig.mavlinkEnabled == true)  // RC_CHANNELS_OVERRIDE is a receiver frame source
+    		mavlinkReceive();
+
+    	rxProcess();  // Decode serial receiver frames outside of the UART interrupt
+
+    	if (rcFrameReady)  // Process pilot commands as soon as a receiver frame completes
+    		processFlightCommands();
+
     	///////////////////////////////
 
         if (frame_50Hz)
@@ -73,36 +91,10 @@ int main(void)
 			deltaTime50Hz    = currentTime - previous50HzTime;
 			previous50HzTime = currentTime;
 
-			processFlightCommands();
+            if ((rcDataLostActive == true) && (rcFrameReady == false))  // No receiver frames, keep the flight command failsafe running
+            	rcFrameComplete(currentTime, 0, false, NULL);
 
-            if (eepromConfig.useMs5611 == true)
-			{
-				if (newTemperatureReading && newPressureReading)
-                {
-                    d1Value = d1.value;
-                    d2Value = d2.value;
-
-                    calculateMs5611Temperature();
-                    calculateMs5611PressureAltitude();
-
-                    newTemperatureReading = false;
-                    newPressureReading    = false;
-                }
-           }
-           else
-           {
-			   if (newTemperatureReading && newPressureReading)
-			   {
-				   uncompensatedTemperatureValue = uncompensatedTemperature.value;
-				   uncompensatedPressureValue    = uncompensatedPressure.value;
-
-				   calculateBmp085Temperature();
-				   calculateBmp085PressureAltitude();
-
-				   newTemperatureReading = false;
-				   newPressureReading    = false;
-			   }
-           }
+            baroManagerUpdate();
 
             sensors.pressureAlt50Hz = firstOrderFilter(sensors.pressureAlt50Hz, &firstOrderFilters[PRESSURE_ALT_LOWPASS]);
 
@@ -119,16 +111,16 @@ int main(void)
 			deltaTime10Hz    = currentTime - previous10HzTime;
 			previous10HzTime = currentTime;
 
-			sensors.mag10Hz[XAXIS] = -((float)rawMag[XAXIS].value * magScaleFactor[XAXIS] - eepromConfig.magBias[XAXIS]);
-			sensors.mag10Hz[YAXIS] =   (float)rawMag[YAXIS].value * magScaleFactor[YAXIS] - eepromConfig.magBias[YAXIS];
-			sensors.mag10Hz[ZAXIS] = -((float)rawMag[ZAXIS].value * magScaleFactor[ZAXIS] - eepromConfig.magBias[ZAXIS]);
-
-			newMagData = false;
-			magDataUpdate = true;
-
         	batMonTick();
 
+        	gainScheduleVoltageUpdate();
+
+            uart1TxFlush();  // The CLI menus loop on their own, let them print as they go
             cliCom();
+            uart1TxHold();
+
+            if (escCalibrating == true)
+            	escCalibrationTick();
 
             if (eepromConfig.mavlinkEnabled == true)
             {
@@ -180,21 +172,74 @@ int main(void)
                 sensors.gyro500Hz[YAW  ] = -((float)gyroData500Hz[YAW  ]  - gyroRTBias[YAW  ] - gyroTCBias[YAW  ]) * MPU3050_GYRO_SCALE_FACTOR;
 		    }
 
+            if (accelCalibrating == true)
+            {
+                if (eepromConfig.useMpu6050 == true)
+                    accelCalibrationMPUTick();
+                else
+                    accelCalibrationADXL345Tick();
+            }
+
+            if (mpuCalibrating == true)
+            {
+                if (eepromConfig.useMpu6050 == true)
+                    mpu6050CalibrationTick();
+                else
+                    mpu3050CalibrationTick();
+            }
+
+            if (newMagData == true)
+            {
+            	dtMag           = constrain((float)(currentTime - previousMagTime) * 0.000001f, 0.0f, 0.1f);
+            	previousMagTime = currentTime;
+
+    			magHardIron[XAXIS] = (float)rawMag[XAXIS].value * magScaleFactor[XAXIS] - eepromConfig.magBias[XAXIS];
+    			magHardIron[YAXIS] = (float)rawMag[YAXIS].value * magScaleFactor[YAXIS] - eepromConfig.magBias[YAXIS];
+    			magHardIron[ZAXIS] = (float)rawMag[ZAXIS].value * magScaleFactor[ZAXIS] - eepromConfig.magBias[ZAXIS];
+
+    			sensors.mag75Hz[XAXIS] = -(eepromConfig.magSoftIron[XAXIS][XAXIS] * magHardIron[XAXIS] +
+    					                   eepromConfig.magSoftIron[XAXIS][YAXIS] * magHardIron[YAXIS] +
+    					                   eepromConfig.magSoftIron[XAXIS][ZAXIS] * magHardIron[ZAXIS]);
+    			sensors.mag75Hz[YAXIS] =   eepromConfig.magSoftIron[YAXIS][XAXIS] * magHardIron[XAXIS] +
+    					                   eepromConfig.magSoftIron[YAXIS][YAXIS] * magHardIron[YAXIS] +
+    					                   eepromConfig.magSoftIron[YAXIS][ZAXIS] * magHardIron[ZAXIS];
+    			sensors.mag75Hz[ZAXIS] = -(eepromConfig.magSoftIron[ZAXIS][XAXIS] * magHardIron[XAXIS] +
+    					                   eepromConfig.magSoftIron[ZAXIS][YAXIS] * magHardIron[YAXIS] +
+    					                   eepromConfig.magSoftIron[ZAXIS][ZAXIS] * magHardIron[ZAXIS]);
+
+    			if (magCalibrating == true)
+    				magCalibrationTick();
+
+    			newMagData = false;
+    			magDataUpdate = true;
+            }
+
             MargAHRSupdate( sensors.gyro500Hz[ROLL],   sensors.gyro500Hz[PITCH],  sensors.gyro500Hz[YAW],
                             sensors.accel500Hz[XAXIS], sensors.accel500Hz[YAXIS], sensors.accel500Hz[ZAXIS],
-                            sensors.mag10Hz[XAXIS],    sensors.mag10Hz[YAXIS],    sensors.mag10Hz[ZAXIS],
-                            magDataUpdate,
+                            sensors.mag75Hz[XAXIS],    sensors.mag75Hz[YAXIS],    sensors.mag75Hz[ZAXIS],
+                            magDataUpdate, dtMag,
                             dt500Hz );
 
             magDataUpdate = false;
 
+            rcInterpolationUpdate(dt500Hz);
+
             computeAxisCommands(dt500Hz);
-            mixTable();
-            writeMotors();
 
-            if (eepromConfig.receiverType == SPEKTRUM)
+            if (escCalibrating == false)
+                mixTable();
+
+            writeMotors();  // Also during ESC calibration, OneShot ESCs need a pulse every cycle
+
+            if (eepromConfig.receiverType != PPM)  // Servo outputs are on RC5 thru RC8, free with a serial receiver
             	writeServos();
 
+            flightRecorderUpdate();
+            blackboxUpdate();
+
+            if (armed == true)
+            	telemetryUpdate();  // Sets run at their own dividers of the loop rate
+
             executionTime500Hz = micros() - currentTime;
         }
 
@@ -222,54 +267,6 @@ int main(void)
             bodyAccelToEarthAccel();
             vertCompFilter(dt100Hz);
 
-            if (armed == true)
-            {
-				if ( eepromConfig.activeTelemetry == 1 )
-                {
-            	    // 500 Hz Accels
-            	    telemPortPrintF("%9.4f, %9.4f, %9.4f\n", sensors.accel500Hz[XAXIS],
-            	            	                             sensors.accel500Hz[YAXIS],
-            	            			                     sensors.accel500Hz[ZAXIS]);
-                }
-
-                if ( eepromConfig.activeTelemetry == 2 )
-                {
-            	    // 500 Hz Gyros
-            	    telemPortPrintF("%9.4f, %9.4f, %9.4f\n", sensors.gyro500Hz[ROLL ],
-            	            			                     sensors.gyro500Hz[PITCH],
-            	            					             sensors.gyro500Hz[YAW  ]);
-                }
-
-                if ( eepromConfig.activeTelemetry == 4 )
-                {
-            	    // 500 Hz Attitudes
-            	    telemPortPrintF("%9.4f, %9.4f, %9.4f\n", sensors.attitude500Hz[ROLL ],
-            	            			                     sensors.attitude500Hz[PITCH],
-            	            			                     sensors.attitude500Hz[YAW  ]);
-                }
-
-                if ( eepromConfig.activeTelemetry == 8 )
-                {
-               	    // Vertical Variables
-            	    telemPortPrintF("%9.4f, %9.4f, %9.4f, %9.4f\n", earthAxisAccels[ZAXIS],
-            	    		                                        sensors.pressureAlt50Hz,
-            	    		                                        hDotEstimate,
-            	    		                                        hEstimate);
-                }
-
-                if ( eepromConfig.activeTelemetry == 16)
-                {
-               	    // Vertical Variables
-            	    telemPortPrintF("%9.4f, %9.4f, %9.4f, %4ld, %1d, %9.4f\n", verticalVelocityCmd,
-            	    		                                                   hDotEstimate,
-            	    		                                                   hEstimate,
-            	    		                                                   ms5611Temperature,
-            	    		                                                   verticalModeState,
-            	    		                                                   throttleCmd);
-                }
-
-            }
-
             executionTime100Hz = micros() - currentTime;
         }
 
@@ -333,6 +330,8 @@ int main(void)
         }
 
         ////////////////////////////////
+
+        uart1TxFlush();
     }
 
     ///////////////////////////////////////////////////////////////////////////
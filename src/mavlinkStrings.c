@@ -33,7 +33,19 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void (*mavlinkPortPrintBinary)(uint8_t *buf, uint16_t length);
+uint32_t (*mavlinkPortAvailable)(void);
+
+uint8_t  (*mavlinkPortRead)(void);
+
+uint8_t *(*mavlinkPortReserve)(uint16_t length);
+
+void     (*mavlinkPortCommit)(uint16_t length);
+
+///////////////////////////////////////
+
+semaphore_t mavlinkCliEscape     = false;
+
+uint32_t    mavlinkRcOverrideCnt = 0;
 
 ///////////////////////////////////////
 
@@ -50,9 +62,24 @@ uint8_t  system_state;
 // Initialize the required buffers
 mavlink_message_t msg;
 
-uint8_t  buffer[MAVLINK_MAX_PACKET_LEN];
+///////////////////////////////////////////////////////////////////////////////
+// MAVLink Send
+//
+// Serialise a packed message straight into the port transmit buffer, a
+// message that doesn't fit is dropped whole and counted by the port.
+///////////////////////////////////////////////////////////////////////////////
+
+static void mavlinkSend(mavlink_message_t *txMsg)
+{
+	uint8_t *dst;
+
+	dst = mavlinkPortReserve(MAVLINK_NUM_NON_PAYLOAD_BYTES + txMsg->len);
 
-uint16_t length;
+	if (dst == NULL)
+		return;
+
+	mavlinkPortCommit(mavlink_msg_to_send_buffer(dst, txMsg));
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -85,11 +112,7 @@ void mavlinkSendAttitude(void)
 						      sensors.gyro500Hz[ROLL ],           // float              rollspeed,
 						      sensors.gyro500Hz[PITCH],           // float              pitchspeed,
 						      sensors.gyro500Hz[YAW  ]);          // float              yawspeed);
-
-	// Copy the message to the send buffer
-	length = mavlink_msg_to_send_buffer(buffer, &msg);
-
-    mavlinkPortPrintBinary(buffer, length);
+    mavlinkSend(&msg);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -104,11 +127,7 @@ void mavlinkSendHeartbeat(void)
 			                   system_mode,                       // uint8_t            base_mode,
 			                   custom_mode,                       // uint32_t           custom_mode,
 			                   system_state);                     // uint8_t            system_status);
-
-	// Copy the message to the send buffer
-	length = mavlink_msg_to_send_buffer(buffer, &msg);
-
-	mavlinkPortPrintBinary(buffer, length);
+    mavlinkSend(&msg);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -141,11 +160,7 @@ void mavlinkSendSysStatus(void)
 							    0,                                   // uint16_t           errors_count2,
 							    0,                                   // uint16_t           errors_count3,
 							    0);                                  // uint16_t           errors_count4)
-
-	// Copy the message to the send buffer
-    length = mavlink_msg_to_send_buffer(buffer, &msg);
-
-    mavlinkPortPrintBinary(buffer, length);
+    mavlinkSend(&msg);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -161,11 +176,130 @@ void mavlinkSendVfrHud(void)
 						     0,                                                  // uint16_t           throttle,
 						     hEstimate,                                          // float              alt,
 						     hDotEstimate);                                      // float              climb);
+    mavlinkSend(&msg);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void mavlinkSendStatusText(uint8_t severity, char *str)
+{
+    char    text[MAVLINK_MSG_ID_STATUSTEXT_LEN - 1];
+    uint8_t index = 0;
 
-	// Copy the message to the send buffer
-    length = mavlink_msg_to_send_buffer(buffer, &msg);
+    // STATUSTEXT carries a single line, so drop the CLI line feeds
 
-    mavlinkPortPrintBinary(buffer, length);
+    while ((*str != '\0') && (index < sizeof(text) - 1))
+    {
+        if (*str != '\n')
+            text[index++] = *str;
+
+        str++;
+    }
+
+    text[index] = '\0';
+
+    if (index == 0)
+        return;
+
+    mavlink_msg_statustext_pack(mavlink_system.sysid,             // uint8_t            system_id,
+                                mavlink_system.compid,            // uint8_t            component_id,
+                                &msg,                             // mavlink_message_t* msg,
+                                severity,                         // uint8_t            severity,
+                                text);                            // const char*        text);
+    mavlinkSend(&msg);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// MAVLink RC Channels Override
+//
+// RC_CHANNELS_OVERRIDE is a receiver frame source, channels are in uSec and
+// UINT16_MAX or 0 leaves a channel to the previous value.
+///////////////////////////////////////////////////////////////////////////////
+
+static void mavlinkRcOverride(mavlink_message_t *rxMsg)
+{
+	mavlink_rc_channels_override_t override;
+
+	uint16_t raw[8];
+	uint16_t values[8];
+	uint32_t channels = 0;
+	uint8_t  channel;
+
+	mavlink_msg_rc_channels_override_decode(rxMsg, &override);
+
+	if ((override.target_system != mavlink_system.sysid) || (eepromConfig.receiverType != MAVLINK_RC))
+		return;
+
+	raw[0] = override.chan1_raw;
+	raw[1] = override.chan2_raw;
+	raw[2] = override.chan3_raw;
+	raw[3] = override.chan4_raw;
+	raw[4] = override.chan5_raw;
+	raw[5] = override.chan6_raw;
+	raw[6] = override.chan7_raw;
+	raw[7] = override.chan8_raw;
+
+	for (channel = 0; channel < 8; channel++)
+	{
+		if ((raw[channel] != UINT16_MAX) && (raw[channel] != 0))
+		{
+			values[channel] = (uint16_t)constrain((float)raw[channel], 750.0f, 2250.0f) * 2;  // 0.5 uSec ticks
+			channels |= 1 << channel;
+		}
+	}
+
+	mavlinkRcOverrideCnt++;
+
+	if (channels != 0)
+		rcFrameComplete(micros(), channels, true, values);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// MAVLink Receive
+//
+// Called from the main loop while MAVLink is enabled, parses everything
+// waiting on the port.  The CLI doesn't read the port in MAVLink mode, a '#'
+// outside of a message stops the parse and hands the port to cliCom() for
+// the MAVLink toggle.
+///////////////////////////////////////////////////////////////////////////////
+
+void mavlinkReceive(void)
+{
+	mavlink_message_t rxMsg;
+	mavlink_status_t  rxStatus;
+	uint8_t           c;
+
+	while ((mavlinkCliEscape == false) && mavlinkPortAvailable())
+	{
+		c = mavlinkPortRead();
+
+		if ((c == '#') && (mavlink_get_channel_status(MAVLINK_COMM_0)->parse_state <= MAVLINK_PARSE_STATE_IDLE))
+		{
+			mavlinkCliEscape = true;
+			break;
+		}
+
+		if (mavlink_parse_char(MAVLINK_COMM_0, c, &rxMsg, &rxStatus))
+		{
+			switch (rxMsg.msgid)
+			{
+				case MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE:
+					mavlinkRcOverride(&rxMsg);
+					break;
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// MAVLink RC Override Receiver Initialization
+///////////////////////////////////////////////////////////////////////////////
+
+void mavlinkRcInit(void)
+{
+	mavlinkRcOverrideCnt = 0;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -33,7 +33,17 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 ///////////////////////////////////////////////////////////////////////////////
 
-extern void (*mavlinkPortPrintBinary)(uint8_t *buf, uint16_t length);
+extern uint32_t (*mavlinkPortAvailable)(void);
+
+extern uint8_t  (*mavlinkPortRead)(void);
+
+extern uint8_t *(*mavlinkPortReserve)(uint16_t length);
+
+extern void     (*mavlinkPortCommit)(uint16_t length);
+
+extern semaphore_t mavlinkCliEscape;
+
+extern uint32_t    mavlinkRcOverrideCnt;
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -56,3 +66,15 @@ void mavlinkSendSysStatus(void);
 void mavlinkSendVfrHud(void);
 
 ///////////////////////////////////////////////////////////////////////////////
+
+void mavlinkSendStatusText(uint8_t severity, char *str);
+
+///////////////////////////////////////////////////////////////////////////////
+
+void mavlinkReceive(void);
+
+///////////////////////////////////////////////////////////////////////////////
+
+void mavlinkRcInit(void);
+
+///////////////////////////////////////////////////////////////////////////////
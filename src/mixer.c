@@ -37,43 +37,100 @@ uint8_t numberMotor;
 
 float throttleCmd = 2000.0f;
 
-float motor[6] = { 2000.0f, 2000.0f, 2000.0f, 2000.0f, 2000.0f, 2000.0f, };
+float motor[MAX_NUMBER_OF_MOTORS] = { 2000.0f, 2000.0f, 2000.0f, 2000.0f, 2000.0f, 2000.0f, 2000.0f, 2000.0f, };
 
 float servo[4] = { 3000.0f, 3000.0f, 3000.0f, 3000.0f, };
 
+///////////////////////////////////////////////////////////////////////////////
+
+// Mix matrix, one row per motor, columns ROLL, PITCH, YAW, throttle is
+// applied equally to every motor.  Built by initMixer() with yaw direction
+// folded into the yaw column
+
+static float mixMatrix[MAX_NUMBER_OF_MOTORS][3];
+
+///////////////////////////////////////
+
+static const float triMix[3][3] =
+{
+    {  1.0f,      -0.666667f,  0.0f },  // Left  CW
+    { -1.0f,      -0.666667f,  0.0f },  // Right CCW
+    {  0.0f,       1.333333f,  0.0f },  // Rear  CW or CCW
+};
+
+static const float quadXMix[4][3] =
+{
+    {  1.0f,      -1.0f,      -1.0f },  // Front Left  CW
+    { -1.0f,      -1.0f,       1.0f },  // Front Right CCW
+    { -1.0f,       1.0f,      -1.0f },  // Rear Right  CW
+    {  1.0f,       1.0f,       1.0f },  // Rear Left   CCW
+};
+
+static const float hex6XMix[6][3] =
+{
+    {  0.866025f, -1.0f,      -1.0f },  // Front Left  CW
+    { -0.866025f, -1.0f,       1.0f },  // Front Right CCW
+    { -0.866025f,  0.0f,      -1.0f },  // Right       CW
+    { -0.866025f,  1.0f,       1.0f },  // Rear Right  CCW
+    {  0.866025f,  1.0f,      -1.0f },  // Rear Left   CW
+    {  0.866025f,  0.0f,       1.0f },  // Left        CCW
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // Initialize Mixer
 ///////////////////////////////////////////////////////////////////////////////
 
 void initMixer(void)
 {
+    const float (*mix)[3];
+    uint8_t i;
+
     switch (eepromConfig.mixerConfiguration)
     {
         case MIXERTYPE_TRI:
             numberMotor = 3;
+            mix = triMix;
             motor[5] = eepromConfig.triYawServoMid;
             break;
 
         case MIXERTYPE_QUADX:
             numberMotor = 4;
+            mix = quadXMix;
             break;
 
         case MIXERTYPE_HEX6X:
             numberMotor = 6;
+            mix = hex6XMix;
             break;
 
         case MIXERTYPE_FREE:
+        default:
+        	eepromConfig.freeMixMotors = constrain(eepromConfig.freeMixMotors, 1, MAX_NUMBER_OF_MOTORS);
 		    numberMotor = eepromConfig.freeMixMotors;
+		    mix = (const float (*)[3])eepromConfig.freeMix;
         	break;
     }
+
+    for (i = 0; i < numberMotor; i++)
+    {
+    	mixMatrix[i][ROLL ] = mix[i][ROLL ];
+    	mixMatrix[i][PITCH] = mix[i][PITCH];
+    	mixMatrix[i][YAW  ] = mix[i][YAW  ] * eepromConfig.yawDirection;
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 // Write to Servos
 ///////////////////////////////////////////////////////////////////////////////
 
+// With more than 6 motors servo outputs 1 and 2 drive motors 7 and 8, and
+// TIM3 runs at the ESC rate, so no servo output is driven.
+
 void writeServos(void)
 {
+    if (numberMotor > 6)
+        return;
+
     pwmServoWrite(0, (uint16_t)servo[0]);
     pwmServoWrite(1, (uint16_t)servo[1]);
     pwmServoWrite(2, (uint16_t)servo[2]);
@@ -93,6 +150,8 @@ void writeMotors(void)
 
     if (eepromConfig.mixerConfiguration == MIXERTYPE_TRI)
         pwmEscWrite(5, (uint16_t)motor[5]);
+
+    pwmEscTrigger();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -109,6 +168,24 @@ void writeAllMotors(float mc)
     writeMotors();
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Hold All Motors
+///////////////////////////////////////////////////////////////////////////////
+
+// OneShot ESCs only output a pulse per write, so a command is held by
+// rewriting it every 2 mSec.
+
+static void holdAllMotors(float mc, uint16_t duration)
+{
+    uint16_t i;
+
+    for (i = 0; i < duration; i += 2)
+    {
+        writeAllMotors(mc);
+        delay(2);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Pulse Motors
 ///////////////////////////////////////////////////////////////////////////////
@@ -119,20 +196,20 @@ void pulseMotors(uint8_t quantity)
 
     for ( i = 0; i < quantity; i++ )
     {
-        writeAllMotors( eepromConfig.minThrottle );
-        delay(250);
-        writeAllMotors( (float)MINCOMMAND );
-        delay(250);
+        holdAllMotors( eepromConfig.minThrottle, 250 );
+        holdAllMotors( (float)MINCOMMAND,        250 );
     }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-// Mixer
+// Switch Mixer
 ///////////////////////////////////////////////////////////////////////////////
 
+// Original per-airframe mixer, retained as the mixer benchmark reference
+
 #define PIDMIX(X,Y,Z) (throttleCmd + ratePID[ROLL] * (X) + ratePID[PITCH] * (Y) + eepromConfig.yawDirection * ratePID[YAW] * (Z))
 
-void mixTable(void)
+static void mixTableSwitch(void)
 {
     int16_t maxMotor;
     uint8_t i;
@@ -213,3 +290,208 @@ void mixTable(void)
 }
 
 ///////////////////////////////////////////////////////////////////////////////
+// Mixer
+///////////////////////////////////////////////////////////////////////////////
+
+// Desaturation keeps roll/pitch authority first.  If roll/pitch alone span
+// more than the throttle range they are scaled to fit and yaw is dropped,
+// otherwise yaw is scaled to the largest fraction that still fits.  The
+// throttle is then shifted so the whole mix lies inside the throttle range.
+
+void mixTable(void)
+{
+    float   mix[MAX_NUMBER_OF_MOTORS];
+    float   yaw[MAX_NUMBER_OF_MOTORS];
+    float   range, rollPitchMin, rollPitchMax, mixMin, mixMax;
+    float   scale, limit, throttle, throttleMin, throttleMax;
+    float   minOutput, maxOutput;
+    uint8_t i, j;
+
+    ///////////////////////////////////
+
+    // Battery voltage compensation scales the output above MINCOMMAND, so
+    // desaturate against the output limits as seen before that scaling.
+    // Throttle commands, including altitude hold's throttleReference, stay
+    // in compensated thrust terms and need no correction as the pack sags.
+
+    minOutput = MINCOMMAND + (eepromConfig.minThrottle - MINCOMMAND) * voltageCompensationInverse;
+    maxOutput = MINCOMMAND + (eepromConfig.maxThrottle - MINCOMMAND) * voltageCompensationInverse;
+
+    range = maxOutput - minOutput;
+
+    rollPitchMin = rollPitchMax = 0.0f;
+    mixMin       = mixMax       = 0.0f;
+
+    for (i = 0; i < numberMotor; i++)
+    {
+    	mix[i] = ratePID[ROLL ] * mixMatrix[i][ROLL ] +
+    			 ratePID[PITCH] * mixMatrix[i][PITCH];
+
+    	yaw[i] = ratePID[YAW  ] * mixMatrix[i][YAW  ];
+
+    	if (i == 0)
+    	{
+    		rollPitchMin = rollPitchMax = mix[0];
+    		mixMin       = mixMax       = mix[0] + yaw[0];
+    	}
+
+    	if (mix[i] < rollPitchMin) rollPitchMin = mix[i];
+    	if (mix[i] > rollPitchMax) rollPitchMax = mix[i];
+
+    	if ((mix[i] + yaw[i]) < mixMin) mixMin = mix[i] + yaw[i];
+    	if ((mix[i] + yaw[i]) > mixMax) mixMax = mix[i] + yaw[i];
+    }
+
+    ///////////////////////////////////
+
+    if ((rollPitchMax - rollPitchMin) > range)
+    {
+    	scale = range / (rollPitchMax - rollPitchMin);
+
+    	for (i = 0; i < numberMotor; i++)
+    	{
+    		mix[i] *= scale;
+    		yaw[i]  = 0.0f;
+    	}
+    }
+    else if ((mixMax - mixMin) > range)
+    {
+    	// Every motor pair must satisfy (mix[i] - mix[j]) + scale * (yaw[i] - yaw[j]) <= range
+
+    	scale = 1.0f;
+
+    	for (i = 0; i < numberMotor; i++)
+    	{
+    		for (j = 0; j < numberMotor; j++)
+    		{
+    			if (yaw[i] > yaw[j])
+    			{
+    				limit = (range - (mix[i] - mix[j])) / (yaw[i] - yaw[j]);
+
+    				if (limit < scale)
+    					scale = limit;
+    			}
+    		}
+    	}
+
+    	for (i = 0; i < numberMotor; i++)
+    		yaw[i] *= scale;
+    }
+
+    ///////////////////////////////////
+
+    throttleMin = minOutput - 100000.0f;
+    throttleMax = maxOutput + 100000.0f;
+
+    for (i = 0; i < numberMotor; i++)
+    {
+    	mix[i] += yaw[i];
+
+    	limit = maxOutput - mix[i];
+    	if (limit < throttleMax)
+    		throttleMax = limit;
+
+    	limit = minOutput - mix[i];
+    	if (limit > throttleMin)
+    		throttleMin = limit;
+    }
+
+    throttle = throttleCmd;
+
+    if (throttle > throttleMax)
+    	throttle = throttleMax;
+
+    if (throttle < throttleMin)
+    	throttle = throttleMin;
+
+    ///////////////////////////////////
+
+    for (i = 0; i < numberMotor; i++)
+    {
+        motor[i] = (throttle + mix[i] - MINCOMMAND) * voltageCompensation + MINCOMMAND;
+
+        motor[i] = constrain(motor[i], eepromConfig.minThrottle, eepromConfig.maxThrottle);
+
+        if ((rxCommand[THROTTLE] < eepromConfig.minCheck) && (verticalModeState == ALT_DISENGAGED_THROTTLE_ACTIVE))
+            motor[i] = eepromConfig.minThrottle;
+
+        if ( armed == false )
+            motor[i] = (float)MINCOMMAND;
+    }
+
+    ///////////////////////////////////
+
+    if (eepromConfig.mixerConfiguration == MIXERTYPE_TRI)
+    {
+        motor[5] = eepromConfig.triYawServoMid + eepromConfig.yawDirection * ratePID[YAW];
+
+        motor[5] = firstOrderFilter(motor[5], &firstOrderFilters[TRICOPTER_YAW_LOWPASS]);
+
+        motor[5] = constrain(motor[5], eepromConfig.triYawServoMid, eepromConfig.triYawServoMax);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Mixer Benchmark
+///////////////////////////////////////////////////////////////////////////////
+
+// Both mixers run the tricopter yaw servo lowpass, its state is restored
+// afterwards so the live filter does not see the benchmark commands.
+
+#define MIXER_BENCHMARK_ITERATIONS 1000
+
+void mixerBenchmark(void)
+{
+	firstOrderFilterData_t savedTriYawFilter;
+
+	float    savedRatePID[3];
+	float    savedThrottleCmd;
+	float    savedMotor[MAX_NUMBER_OF_MOTORS];
+	uint32_t cycles;
+	uint32_t switchCycles = 0;
+	uint32_t matrixCycles = 0;
+	uint16_t i;
+
+	savedRatePID[ROLL ] = ratePID[ROLL ];
+	savedRatePID[PITCH] = ratePID[PITCH];
+	savedRatePID[YAW  ] = ratePID[YAW  ];
+	savedThrottleCmd    = throttleCmd;
+	savedTriYawFilter   = firstOrderFilters[TRICOPTER_YAW_LOWPASS];
+
+	for (i = 0; i < MAX_NUMBER_OF_MOTORS; i++)
+		savedMotor[i] = motor[i];
+
+	for (i = 0; i < MIXER_BENCHMARK_ITERATIONS; i++)
+	{
+		// Sweep from unsaturated to fully saturated commands
+
+		throttleCmd    = eepromConfig.minThrottle + (float)(i % 100) * 0.01f * (eepromConfig.maxThrottle - eepromConfig.minThrottle);
+		ratePID[ROLL ] = (float)((int16_t)(i % 37) - 18) * 40.0f;
+		ratePID[PITCH] = (float)((int16_t)(i % 29) - 14) * 50.0f;
+		ratePID[YAW  ] = (float)((int16_t)(i % 23) - 11) * 60.0f;
+
+		cycles        = *DWT_CYCCNT;
+		mixTableSwitch();
+		switchCycles += *DWT_CYCCNT - cycles;
+
+		cycles        = *DWT_CYCCNT;
+		mixTable();
+		matrixCycles += *DWT_CYCCNT - cycles;
+	}
+
+	ratePID[ROLL ] = savedRatePID[ROLL ];
+	ratePID[PITCH] = savedRatePID[PITCH];
+	ratePID[YAW  ] = savedRatePID[YAW  ];
+	throttleCmd    = savedThrottleCmd;
+
+	firstOrderFilters[TRICOPTER_YAW_LOWPASS] = savedTriYawFilter;
+
+	for (i = 0; i < MAX_NUMBER_OF_MOTORS; i++)
+		motor[i] = savedMotor[i];
+
+	cliPortPrintF("\nMixer Benchmark, %d motors, %d iterations\n\n", numberMotor, MIXER_BENCHMARK_ITERATIONS);
+	cliPortPrintF("Switch Mixer: %5ld cycles per mix\n",   switchCycles / MIXER_BENCHMARK_ITERATIONS);
+	cliPortPrintF("Matrix Mixer: %5ld cycles per mix\n\n", matrixCycles / MIXER_BENCHMARK_ITERATIONS);
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -33,11 +33,15 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 ///////////////////////////////////////////////////////////////////////////////
 
+#define MAX_NUMBER_OF_MOTORS 8
+
+///////////////////////////////////////////////////////////////////////////////
+
 extern uint8_t numberMotor;
 
 extern float throttleCmd;
 
-extern float motor[6];
+extern float motor[MAX_NUMBER_OF_MOTORS];
 
 extern float servo[4];
 
@@ -78,3 +82,9 @@ void pulseMotors(uint8_t quantity);
 void mixTable(void);
 
 ///////////////////////////////////////////////////////////////////////////////
+// Mixer Benchmark
+///////////////////////////////////////////////////////////////////////////////
+
+void mixerBenchmark(void);
+
+///////////////////////////////////////////////////////////////////////////////
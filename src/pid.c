@@ -35,6 +35,8 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 uint8_t pidReset = true;
 
+pidState_t pidState;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void initPID(void)
@@ -43,32 +45,34 @@ void initPID(void)
 
     for (index = 0; index < NUMBER_OF_PIDS; index++)
     {
-    	eepromConfig.PID[index].integratorState = 0.0f;
-    	eepromConfig.PID[index].filterState     = 0.0f;
-    	eepromConfig.PID[index].prevResetState  = false;
+    	pidState.integratorState[index] = 0.0f;
+    	pidState.filterState[index]     = 0.0f;
+    	pidState.prevResetState[index]  = false;
     }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-float updatePID(float error, float deltaT, float maxCmd, uint8_t reset, struct PIDdata *PIDparameters)
+float updatePID(float error, float deltaT, float maxCmd, uint8_t reset, uint8_t IDPid)
 {
+    PIDdata_t *gains = &eepromConfig.PID[IDPid];
+
     float dTerm;
     float pidSum;
     float pidLimited;
     float windup;
 
-    windup = 1000.0f * PIDparameters->P * maxCmd;
+    windup = 1000.0f * gains->P * maxCmd;
 
-    if ((reset == true) || (PIDparameters->prevResetState == true))
+    if ((reset == true) || (pidState.prevResetState[IDPid] == true))
     {
-        PIDparameters->integratorState = 0.0f;
-        PIDparameters->filterState     = 0.0f;
+        pidState.integratorState[IDPid] = 0.0f;
+        pidState.filterState[IDPid]     = 0.0f;
     }
 
-    dTerm = ((error * PIDparameters->D) - PIDparameters->filterState) * PIDparameters->N;
+    dTerm = ((error * gains->D) - pidState.filterState[IDPid]) * gains->N;
 
-    pidSum = (error * PIDparameters->P) + PIDparameters->integratorState + dTerm;
+    pidSum = (error * gains->P) + pidState.integratorState[IDPid] + dTerm;
 
     if (pidSum > windup)
     {
@@ -84,24 +88,79 @@ float updatePID(float error, float deltaT, float maxCmd, uint8_t reset, struct P
         }
     }
 
-    PIDparameters->integratorState += ((error * PIDparameters->I) + 100.0f * (pidLimited - pidSum)) * deltaT;
+    pidState.integratorState[IDPid] += ((error * gains->I) + 100.0f * (pidLimited - pidSum)) * deltaT;
 
-    PIDparameters->filterState += deltaT * dTerm;
+    pidState.filterState[IDPid] += deltaT * dTerm;
 
     if (reset == true)
-        PIDparameters->prevResetState = true;
+        pidState.prevResetState[IDPid] = true;
     else
-        PIDparameters->prevResetState = false;
+        pidState.prevResetState[IDPid] = false;
 
     return pidLimited;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Steps three consecutive PIDs (roll, pitch, yaw of the rate or attitude
+// bank) in one pass, same arithmetic as updatePID().  Gains are passed in
+// so scheduled gains can be used.
+
+void updatePID3(float error[3], float deltaT, float maxCmd[3], uint8_t reset, uint8_t firstPid, PIDdata_t *gains, float output[3])
+{
+    float     *integrator = &pidState.integratorState[firstPid];
+    float     *filter     = &pidState.filterState[firstPid];
+    uint8_t   *prevReset  = &pidState.prevResetState[firstPid];
+
+    float   dTerm;
+    float   pidSum;
+    float   pidLimited;
+    float   windup;
+    uint8_t axis;
+
+    if ((reset == true) || (prevReset[0] == true) || (prevReset[1] == true) || (prevReset[2] == true))
+    {
+    	for (axis = 0; axis < 3; axis++)
+    	{
+    		if ((reset == true) || (prevReset[axis] == true))
+    		{
+    			integrator[axis] = 0.0f;
+    			filter[axis]     = 0.0f;
+    		}
+    	}
+    }
+
+    for (axis = 0; axis < 3; axis++)
+    {
+    	windup = 1000.0f * gains[axis].P * maxCmd[axis];
+
+    	dTerm = ((error[axis] * gains[axis].D) - filter[axis]) * gains[axis].N;
+
+    	pidSum = (error[axis] * gains[axis].P) + integrator[axis] + dTerm;
+
+    	if (pidSum > windup)
+    		pidLimited = windup;
+    	else if (pidSum < -windup)
+    		pidLimited = -windup;
+    	else
+    		pidLimited = pidSum;
+
+    	integrator[axis] += ((error[axis] * gains[axis].I) + 100.0f * (pidLimited - pidSum)) * deltaT;
+
+    	filter[axis] += deltaT * dTerm;
+
+    	prevReset[axis] = (reset == true);
+
+    	output[axis] = pidLimited;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void setPIDstates(uint8_t IDPid, float value)
 {
-    eepromConfig.PID[IDPid].integratorState = value;
-    eepromConfig.PID[IDPid].filterState     = value;
+    pidState.integratorState[IDPid] = value;
+    pidState.filterState[IDPid]     = value;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -115,5 +174,60 @@ void zeroPIDstates(void)
 }
 
 ///////////////////////////////////////////////////////////////////////////////
+// PID Benchmark
+///////////////////////////////////////////////////////////////////////////////
+
+// Cycle counts for one control cycle of all 8 PIDs, as 8 updatePID() calls
+// and as 2 updatePID3() banks plus the 2 altitude PIDs.  Runtime states are
+// saved and restored around the run.
+
+#define PID_BENCHMARK_PASSES 1000
+
+void pidBenchmark(void)
+{
+	pidState_t savedState;
+	float      error[3]  = { 0.01f, -0.02f, 0.03f };
+	float      maxCmd[3];
+	float      output[3];
+	uint32_t   cycles;
+	uint32_t   separateCycles = 0;
+	uint32_t   batchedCycles  = 0;
+	uint16_t   pass;
+	uint8_t    index;
+
+	savedState = pidState;
+
+	maxCmd[ROLL ] = eepromConfig.rollAndPitchRateScaling;
+	maxCmd[PITCH] = eepromConfig.rollAndPitchRateScaling;
+	maxCmd[YAW  ] = eepromConfig.yawRateScaling;
+
+	for (pass = 0; pass < PID_BENCHMARK_PASSES; pass++)
+	{
+		cycles = *DWT_CYCCNT;
 
+		for (index = 0; index < NUMBER_OF_PIDS; index++)
+			output[0] = updatePID(error[index % 3], 0.002f, maxCmd[index % 3], false, index);
 
+		separateCycles += *DWT_CYCCNT - cycles;
+
+		cycles = *DWT_CYCCNT;
+
+		updatePID3(error, 0.002f, maxCmd, false, ROLL_RATE_PID, &eepromConfig.PID[ROLL_RATE_PID], output);
+		updatePID3(error, 0.002f, maxCmd, false, ROLL_ATT_PID,  &eepromConfig.PID[ROLL_ATT_PID ], output);
+
+		output[0] = updatePID(error[0], 0.002f, maxCmd[0], false, HDOT_PID);
+		output[0] = updatePID(error[1], 0.002f, maxCmd[1], false, H_PID   );
+
+		batchedCycles += *DWT_CYCCNT - cycles;
+	}
+
+	pidState = savedState;
+
+	cliPortPrintF("\nPID Benchmark, %d passes of 8 PIDs....\n\n", PID_BENCHMARK_PASSES);
+	cliPortPrintF("8 x updatePID:             %6ld cycles, %6.2f uSec\n",   separateCycles / PID_BENCHMARK_PASSES,
+			                                                              (float)separateCycles / PID_BENCHMARK_PASSES / 72.0f);
+	cliPortPrintF("2 x updatePID3 + 2 PIDs:   %6ld cycles, %6.2f uSec\n\n", batchedCycles  / PID_BENCHMARK_PASSES,
+			                                                              (float)batchedCycles  / PID_BENCHMARK_PASSES / 72.0f);
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -33,14 +33,39 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 ///////////////////////////////////////////////////////////////////////////////
 
-// PID Variables
+// PID Definitions
+///////////////////////////////////////////////////////////////////////////////
+
+#define NUMBER_OF_PIDS 8
+
+#define ROLL_RATE_PID  0
+#define PITCH_RATE_PID 1
+#define YAW_RATE_PID   2
+
+#define ROLL_ATT_PID   3
+#define PITCH_ATT_PID  4
+#define HEADING_PID    5
+
+#define HDOT_PID       6
+
+#define H_PID          7
+
+///////////////////////////////////////////////////////////////////////////////
+
+// PID Gains, stored in eepromConfig
 typedef struct PIDdata {
   float   P, I, D, N;
-  float   integratorState;
-  float   filterState;
-  uint8_t prevResetState;
 } PIDdata_t;
 
+// PID Runtime States, one array per state indexed by PID number
+typedef struct pidState_t {
+  float   integratorState[NUMBER_OF_PIDS];
+  float   filterState[NUMBER_OF_PIDS];
+  uint8_t prevResetState[NUMBER_OF_PIDS];
+} pidState_t;
+
+extern pidState_t pidState;
+
 extern uint8_t pidReset;
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -49,7 +74,15 @@ void initPID(void);
 
 ///////////////////////////////////////////////////////////////////////////////
 
-float updatePID(float error, float deltaT, float maxCmd, uint8_t reset, struct PIDdata *PIDparameters);
+float updatePID(float error, float deltaT, float maxCmd, uint8_t reset, uint8_t IDPid);
+
+///////////////////////////////////////////////////////////////////////////////
+
+void updatePID3(float error[3], float deltaT, float maxCmd[3], uint8_t reset, uint8_t firstPid, PIDdata_t *gains, float output[3]);
+
+///////////////////////////////////////////////////////////////////////////////
+
+void pidBenchmark(void);
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,155 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// RC Interpolation Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+// Receiver frames arrive every 11 to 22 mSec, so rxCommand steps at that
+// rate while the rate loop runs at 500 Hz.  Each stick channel keeps an
+// online estimate of its own frame interval and ramps linearly from where
+// it is toward the latest sample so it arrives as the next frame is due.
+// An optional first order low pass then rounds off the ramp corners.
+//
+// Per channel cost is one divide per frame and a few multiply-adds per
+// control cycle.
+
+#define RC_INTERVAL_MIN   0.005f  // Seconds, shorter intervals are glitches
+#define RC_INTERVAL_MAX   0.050f  // Seconds, longer intervals are dropouts, step to the new value
+#define RC_INTERVAL_GAIN  0.05f   // Frame interval estimate filter gain
+
+typedef struct rcInterpolator_t
+{
+	float    target;      // Latest sample from processFlightCommands
+	float    ramp;        // Linear ramp toward target
+	float    slope;       // Ramp slope, command units per second
+	float    output;      // Ramp after the smoothing filter
+	float    interval;    // Estimated frame interval, seconds
+	uint32_t sampleTime;  // Receiver frame time of the latest sample, uSec
+} rcInterpolator_t;
+
+static rcInterpolator_t rcInterpolator[4];
+
+float rcInterpolatedCommand[4] = { 0.0f, 0.0f, 0.0f, 2000.0f };
+
+///////////////////////////////////////////////////////////////////////////////
+// RC Interpolation Sample
+///////////////////////////////////////////////////////////////////////////////
+
+// Once per receiver frame, for each of ROLL, PITCH, YAW and THROTTLE
+
+void rcInterpolationSample(uint8_t channel, float value, uint32_t frameTime)
+{
+	rcInterpolator_t *rc = &rcInterpolator[channel];
+
+	float delta;
+
+	delta = (float)(frameTime - rc->sampleTime) * 0.000001f;
+
+	rc->sampleTime = frameTime;
+	rc->target     = value;
+
+	if ((delta >= RC_INTERVAL_MIN) && (delta <= RC_INTERVAL_MAX))
+	{
+		if (rc->interval == 0.0f)
+			rc->interval  = delta;
+		else
+			rc->interval += (delta - rc->interval) * RC_INTERVAL_GAIN;
+	}
+
+	if ((eepromConfig.rcInterpolation == false) || (delta > RC_INTERVAL_MAX) || (rc->interval == 0.0f))
+	{
+		// Disabled, no interval estimate yet or after a dropout, step straight to the new value
+
+		rc->ramp  = value;
+		rc->slope = 0.0f;
+
+		if (rc->interval == 0.0f)
+			rc->output = value;
+
+		return;
+	}
+
+	rc->slope = (value - rc->ramp) / rc->interval;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// RC Interpolation Update
+///////////////////////////////////////////////////////////////////////////////
+
+// Once per control cycle, before computeAxisCommands
+
+void rcInterpolationUpdate(float dt)
+{
+	rcInterpolator_t *rc;
+
+	float   alpha;
+	uint8_t channel;
+
+	if (eepromConfig.rcSmoothingCutoff > 0.0f)
+		alpha = dt / (dt + 1.0f / (TWO_PI * eepromConfig.rcSmoothingCutoff));
+	else
+		alpha = 1.0f;
+
+	for (channel = 0; channel < 4; channel++)
+	{
+		rc = &rcInterpolator[channel];
+
+		if (rc->slope != 0.0f)
+		{
+			rc->ramp += rc->slope * dt;
+
+			if (((rc->slope > 0.0f) && (rc->ramp >= rc->target)) ||
+				((rc->slope < 0.0f) && (rc->ramp <= rc->target)))
+			{
+				rc->ramp  = rc->target;
+				rc->slope = 0.0f;
+			}
+		}
+
+		rc->output += (rc->ramp - rc->output) * alpha;
+
+		rcInterpolatedCommand[channel] = rc->output;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// RC Interpolation Interval
+///////////////////////////////////////////////////////////////////////////////
+
+float rcInterpolationInterval(uint8_t channel)
+{
+	return rcInterpolator[channel].interval;
+}
+
+///////////////////////////////////////////////////////////////////////////////
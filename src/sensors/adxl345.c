@@ -68,7 +68,7 @@ void computeAdxl345RTData(void)
     uint16_t samples;
     float accelSum[3] = { 0.0f, 0.0f, 0.0f };
 
-    accelCalibrating = true;
+    rtDataComputing = true;
 
     for (samples = 0; samples < 2000; samples++)
     {
@@ -88,7 +88,7 @@ void computeAdxl345RTData(void)
 
     accelOneG = sqrt(SQR(accelSum[XAXIS]) + SQR(accelSum[YAXIS]) + SQR(accelSum[ZAXIS]));
 
-    accelCalibrating = false;
+    rtDataComputing = false;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
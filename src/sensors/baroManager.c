@@ -0,0 +1,409 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Baro Manager Variables
+///////////////////////////////////////////////////////////////////////////////
+
+// Conversion times in 1 mSec SysTick counts, indexed by OSR/OSS setting
+
+static const uint8_t ms5611ConversionTicks[5] = { 1, 2, 3, 5, 10 };
+
+static const uint8_t bmp085ConversionTicks[4] = { 5, 8, 14, 26 };
+
+#define BMP085_TEMPERATURE_TICKS  5
+
+#define BARO_MAX_PRESSURE_SAMPLES 128
+
+#define BARO_STATISTICS_SAMPLES   50
+
+///////////////////////////////////////
+
+enum { CONVERTING_PRESSURE, CONVERTING_TEMPERATURE };
+
+static uint8_t  conversionType;
+
+static uint8_t  conversionTicks;
+
+static uint8_t  conversionTimer;
+
+static uint8_t  temperatureCounter;
+
+static uint8_t  temperatureValid;
+
+static uint32_t pressureSum;
+
+static uint16_t pressureSamples;
+
+static uint32_t temperature;
+
+static uint16_t rateTimer;
+
+static uint16_t pressureCount;
+
+static uint16_t temperatureCount;
+
+static uint16_t statisticsSamples;
+
+static float    statisticsMean;
+
+static float    statisticsM2;
+
+uint16_t baroPressureRate;
+
+uint16_t baroTemperatureRate;
+
+float    baroAltitudeMean;
+
+float    baroAltitudeNoise;
+
+///////////////////////////////////////////////////////////////////////////////
+// Request Conversion
+///////////////////////////////////////////////////////////////////////////////
+
+static void requestConversion(uint8_t type)
+{
+    conversionType  = type;
+    conversionTimer = 0;
+
+    if (eepromConfig.useMs5611 == true)
+    {
+    	conversionTicks = ms5611ConversionTicks[eepromConfig.ms5611Osr];
+
+    	if (type == CONVERTING_TEMPERATURE)
+    		ms5611RequestTemperature();
+    	else
+    		ms5611RequestPressure();
+    }
+    else
+    {
+    	if (type == CONVERTING_TEMPERATURE)
+    	{
+    		conversionTicks = BMP085_TEMPERATURE_TICKS;
+    		bmp085RequestTemperature();
+    	}
+    	else
+    	{
+    		conversionTicks = bmp085ConversionTicks[eepromConfig.bmp085Oss];
+    		bmp085RequestPressure();
+    	}
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Latch Baro Data
+///////////////////////////////////////////////////////////////////////////////
+
+static uint8_t latchBaroData(void)
+{
+	uint32_t sum;
+	uint16_t samples;
+	uint32_t latchedTemperature;
+
+	__disable_irq();
+
+	sum                = pressureSum;
+	samples            = pressureSamples;
+	latchedTemperature = temperature;
+
+	pressureSum     = 0;
+	pressureSamples = 0;
+
+	__enable_irq();
+
+	if ((samples == 0) || (temperatureValid == false))
+		return false;
+
+	if (eepromConfig.useMs5611 == true)
+	{
+		d1Value = (sum + samples / 2) / samples;
+		d2Value = latchedTemperature;
+	}
+	else
+	{
+		uncompensatedPressureValue    = (sum + samples / 2) / samples;
+		uncompensatedTemperatureValue = latchedTemperature;
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Baro Manager Initialization
+///////////////////////////////////////////////////////////////////////////////
+
+void initBaroManager(void)
+{
+	// Driver init leaves a valid temperature reading in d2/uncompensatedTemperature
+
+	if (eepromConfig.useMs5611 == true)
+		temperature = d2.value;
+	else
+		temperature = uncompensatedTemperature.value;
+
+	temperatureValid   = true;
+	temperatureCounter = 0;
+
+	pressureSum     = 0;
+	pressureSamples = 0;
+
+	rateTimer        = 0;
+	pressureCount    = 0;
+	temperatureCount = 0;
+
+	statisticsSamples = 0;
+	statisticsMean    = 0.0f;
+	statisticsM2      = 0.0f;
+
+	requestConversion(CONVERTING_PRESSURE);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Baro Manager Tick
+///////////////////////////////////////////////////////////////////////////////
+
+void baroManagerTick(void)
+{
+	if (++rateTimer >= 1000)
+	{
+		baroPressureRate    = pressureCount;
+		baroTemperatureRate = temperatureCount;
+
+		rateTimer        = 0;
+		pressureCount    = 0;
+		temperatureCount = 0;
+	}
+
+	if (++conversionTimer < conversionTicks)
+		return;
+
+	///////////////////////////////////
+
+	if (conversionType == CONVERTING_PRESSURE)
+	{
+		if (eepromConfig.useMs5611 == true)
+		{
+			ms5611ReadPressure();
+			pressureSum += d1.value;
+		}
+		else
+		{
+			bmp085ReadPressure();
+			pressureSum += uncompensatedPressure.value;
+		}
+
+		// Latch has not run for a while, start a fresh average rather than overflow
+
+		if (++pressureSamples >= BARO_MAX_PRESSURE_SAMPLES)
+		{
+			pressureSum     = 0;
+			pressureSamples = 0;
+		}
+
+		pressureCount++;
+	}
+	else
+	{
+		if (eepromConfig.useMs5611 == true)
+		{
+			ms5611ReadTemperature();
+			temperature = d2.value;
+		}
+		else
+		{
+			bmp085ReadTemperature();
+			temperature = uncompensatedTemperature.value;
+		}
+
+		temperatureValid = true;
+
+		temperatureCount++;
+	}
+
+	///////////////////////////////////
+
+	if (++temperatureCounter >= eepromConfig.baroTemperatureDivider)
+	{
+		temperatureCounter = 0;
+		requestConversion(CONVERTING_TEMPERATURE);
+	}
+	else
+	{
+		requestConversion(CONVERTING_PRESSURE);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Baro Manager Statistics
+///////////////////////////////////////////////////////////////////////////////
+
+void baroManagerStatistics(float altitude)
+{
+	float delta;
+
+	// Welford running mean/variance over a block of unfiltered altitudes
+
+	statisticsSamples++;
+
+	delta           = altitude - statisticsMean;
+	statisticsMean += delta / (float)statisticsSamples;
+	statisticsM2   += delta * (altitude - statisticsMean);
+
+	if (statisticsSamples >= BARO_STATISTICS_SAMPLES)
+	{
+		baroAltitudeMean  = statisticsMean;
+		baroAltitudeNoise = sqrt(statisticsM2 / (float)(statisticsSamples - 1));
+
+		statisticsSamples = 0;
+		statisticsMean    = 0.0f;
+		statisticsM2      = 0.0f;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Baro Manager Update
+///////////////////////////////////////////////////////////////////////////////
+
+uint8_t baroManagerUpdate(void)
+{
+	if (latchBaroData() == false)
+		return false;
+
+	if (eepromConfig.useMs5611 == true)
+	{
+		calculateMs5611Temperature();
+		calculateMs5611PressureAltitude();
+	}
+	else
+	{
+		calculateBmp085Temperature();
+		calculateBmp085PressureAltitude();
+	}
+
+	baroManagerStatistics(sensors.pressureAlt50Hz);
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Baro Manager Report
+///////////////////////////////////////////////////////////////////////////////
+
+void baroManagerReport(void)
+{
+	uint32_t startTime;
+	uint32_t lastTick;
+	uint16_t ticks = 0;
+
+	// SysTick sensor reads are suspended while the CLI is busy, so run
+	// the manager here for 5 seconds to measure the current settings
+
+	cliPortPrint("\nMeasuring baro rate and noise, hold still for 5 seconds....\n\n");
+
+	initBaroManager();
+
+	startTime = millis();
+	lastTick  = startTime;
+
+	while ((millis() - startTime) < 5000)
+	{
+		if (millis() == lastTick)
+			continue;
+
+		lastTick = millis();
+
+		baroManagerTick();
+
+		if ((++ticks % COUNT_50HZ) == 0)
+			baroManagerUpdate();
+	}
+
+	initBaroManager();
+
+	if (eepromConfig.useMs5611 == true)
+		cliPortPrintF("MS5611 OSR:                  %4d\n", 256 << eepromConfig.ms5611Osr);
+	else
+		cliPortPrintF("BMP085 OSS:                  %4d\n", eepromConfig.bmp085Oss);
+
+	cliPortPrintF("Temperature Divider:         %4d\n",     eepromConfig.baroTemperatureDivider);
+	cliPortPrintF("Pressure Rate:               %4d Hz\n",  baroPressureRate);
+	cliPortPrintF("Temperature Rate:            %4d Hz\n",  baroTemperatureRate);
+	cliPortPrintF("Altitude Mean:             %6.2f m\n",   baroAltitudeMean);
+	cliPortPrintF("Altitude Noise (1 sigma):  %6.3f m\n\n", baroAltitudeNoise);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Baro Altitude Benchmark
+///////////////////////////////////////////////////////////////////////////////
+
+void baroAltitudeBenchmark(void)
+{
+	int32_t  pressure;
+	int32_t  worstPressure = 0;
+	uint16_t samples       = 0;
+	uint32_t cycles;
+	uint32_t tableCycles   = 0;
+	uint32_t powCycles     = 0;
+	float    tableAltitude, powAltitude, error;
+	float    worstError    = 0.0f;
+
+	cliPortPrint("\nBaro Altitude Benchmark, 1000 to 120000 Pa....\n\n");
+
+	for (pressure = 1000; pressure <= 120000; pressure += 17)
+	{
+		cycles        = *DWT_CYCCNT;
+		tableAltitude = pressureToAltitude(pressure);
+		tableCycles  += *DWT_CYCCNT - cycles;
+
+		cycles        = *DWT_CYCCNT;
+		powAltitude   = 44330.0f * (1.0f - pow((float)pressure / 101325.0f, 0.190295f));
+		powCycles    += *DWT_CYCCNT - cycles;
+
+		error = fabs(tableAltitude - powAltitude);
+
+		if (error > worstError)
+		{
+			worstError    = error;
+			worstPressure = pressure;
+		}
+
+		samples++;
+	}
+
+	cliPortPrintF("Table:       %6ld cycles per conversion\n",   tableCycles / samples);
+	cliPortPrintF("pow:         %6ld cycles per conversion\n",   powCycles   / samples);
+	cliPortPrintF("Worst Error: %6.3f m at %ld Pa\n\n",          worstError, worstPressure);
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,83 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Baro Manager Variables
+///////////////////////////////////////////////////////////////////////////////
+
+extern uint16_t baroPressureRate;
+
+extern uint16_t baroTemperatureRate;
+
+extern float    baroAltitudeMean;
+
+extern float    baroAltitudeNoise;
+
+///////////////////////////////////////////////////////////////////////////////
+// Baro Manager Initialization
+///////////////////////////////////////////////////////////////////////////////
+
+void initBaroManager(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Baro Manager Tick, called at 1000 Hz from SysTick
+///////////////////////////////////////////////////////////////////////////////
+
+void baroManagerTick(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Baro Manager Statistics
+///////////////////////////////////////////////////////////////////////////////
+
+void baroManagerStatistics(float altitude);
+
+///////////////////////////////////////////////////////////////////////////////
+// Baro Manager Update, returns true if a new pressure altitude was computed
+///////////////////////////////////////////////////////////////////////////////
+
+uint8_t baroManagerUpdate(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Baro Manager Report
+///////////////////////////////////////////////////////////////////////////////
+
+void baroManagerReport(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Baro Altitude Benchmark
+///////////////////////////////////////////////////////////////////////////////
+
+void baroAltitudeBenchmark(void);
+
+///////////////////////////////////////////////////////////////////////////////
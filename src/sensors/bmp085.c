@@ -39,10 +39,14 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 ///////////////////////////////////
 
-//#define OSS 0  //  4.5 mSec conversion time (222.22 Hz)
-#define OSS 1                   //  7.5 mSec conversion time (133.33 Hz)
-//#define OSS 2  // 13.5 mSec conversion time ( 74.07 Hz)
-//#define OSS 3  // 25.5 mSec conversion time ( 39.22 Hz)
+// eepromConfig.bmp085Oss selects the oversampling setting at runtime
+//
+// 0,  4.5 mSec conversion time (222.22 Hz)
+// 1,  7.5 mSec conversion time (133.33 Hz)
+// 2, 13.5 mSec conversion time ( 74.07 Hz)
+// 3, 25.5 mSec conversion time ( 39.22 Hz)
+
+#define OSS eepromConfig.bmp085Oss
 
 ///////////////////////////////////////
 
@@ -50,7 +54,7 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 #define BMP085_PROM_DATA_LEN    22
 
 #define BMP085_T_MEASURE        0x2E    // temperature measurement
-#define BMP085_P_MEASURE        0x34 + (OSS<<6) // pressure measurement
+#define BMP085_P_MEASURE        (0x34 + (OSS<<6)) // pressure measurement
 #define BMP085_CTRL_MEAS_REG    0xF4
 #define BMP085_ADC_OUT_MSB_REG  0xF6
 
@@ -73,10 +77,10 @@ int32_t x1, x2, x3, b3, b5, b6, p;
 uint32_t b4, b7;
 
 ///////////////////////////////////////////////////////////////////////////////
-// BMP085 Read Temperature Request Pressure
+// BMP085 Read Temperature
 ///////////////////////////////////////////////////////////////////////////////
 
-void bmp085ReadTemperatureRequestPressure(void)
+void bmp085ReadTemperature(void)
 {
     uint8_t data[2];
 
@@ -84,15 +88,13 @@ void bmp085ReadTemperatureRequestPressure(void)
 
     uncompensatedTemperature.bytes[1] = data[0];
     uncompensatedTemperature.bytes[0] = data[1];
-
-    i2cWrite(I2C2, BMP085_ADDRESS, BMP085_CTRL_MEAS_REG, BMP085_P_MEASURE);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-// BMP085Read Pressure Request Temperature
+// BMP085 Read Pressure
 ///////////////////////////////////////////////////////////////////////////////
 
-void bmp085ReadPressureRequestTemperature(void)
+void bmp085ReadPressure(void)
 {
     uint8_t data[3];
 
@@ -103,10 +105,26 @@ void bmp085ReadPressureRequestTemperature(void)
     uncompensatedPressure.bytes[0] = data[2];
 
     uncompensatedPressure.value = uncompensatedPressure.value >> (8 - OSS);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// BMP085 Request Temperature
+///////////////////////////////////////////////////////////////////////////////
 
+void bmp085RequestTemperature(void)
+{
     i2cWrite(I2C2, BMP085_ADDRESS, BMP085_CTRL_MEAS_REG, BMP085_T_MEASURE);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// BMP085 Request Pressure
+///////////////////////////////////////////////////////////////////////////////
+
+void bmp085RequestPressure(void)
+{
+    i2cWrite(I2C2, BMP085_ADDRESS, BMP085_CTRL_MEAS_REG, BMP085_P_MEASURE);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Calculate BMP085 Temperature
 ///////////////////////////////////////////////////////////////////////////////
@@ -140,7 +158,7 @@ void calculateBmp085PressureAltitude(void)
     x2 = (-7357 * p) >> 16;
     p = p + ((x1 + x2 + 3791) >> 4);
 
-    sensors.pressureAlt50Hz = (44330.0f * (1.0f - pow((float) p / 101325.0f, 0.190295f)));
+    sensors.pressureAlt50Hz = pressureToAltitude(p);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -180,17 +198,16 @@ void initBmp085(void)
     md.bytes[1] = promData[20];
     md.bytes[0] = promData[21];
 
-    i2cWrite(I2C2, BMP085_ADDRESS, BMP085_CTRL_MEAS_REG, BMP085_T_MEASURE);
+    bmp085RequestTemperature();
 
     delay(10);
 
-    bmp085ReadTemperatureRequestPressure();
-
-    delay(10);
+    bmp085ReadTemperature();
+    bmp085RequestPressure();
 
-    bmp085ReadPressureRequestTemperature();
+    delay(30);
 
-    delay(10);
+    bmp085ReadPressure();
 
     uncompensatedTemperatureValue = uncompensatedTemperature.value;
     uncompensatedPressureValue    = uncompensatedPressure.value;
@@ -44,16 +44,28 @@ extern int32andUint8_t uncompensatedTemperature;
 extern int32_t         uncompensatedTemperatureValue;
 
 ///////////////////////////////////////////////////////////////////////////////
-// BMP085 Read Temperature Request Pressure
+// BMP085 Read Temperature
 ///////////////////////////////////////////////////////////////////////////////
 
-void bmp085ReadTemperatureRequestPressure(void);
+void bmp085ReadTemperature(void);
 
 ///////////////////////////////////////////////////////////////////////////////
-// BMP085 Read Pressure Request Temperature
+// BMP085 Read Pressure
 ///////////////////////////////////////////////////////////////////////////////
 
-void bmp085ReadPressureRequestTemperature(void);
+void bmp085ReadPressure(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// BMP085 Request Temperature
+///////////////////////////////////////////////////////////////////////////////
+
+void bmp085RequestTemperature(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// BMP085 Request Pressure
+///////////////////////////////////////////////////////////////////////////////
+
+void bmp085RequestPressure(void);
 
 ///////////////////////////////////////////////////////////////////////////////
 // Calculate BMP085 Temperature
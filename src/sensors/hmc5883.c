@@ -71,6 +71,26 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// HMC5883 DRDY pulses low for 250 uSec when a new sample is in the data registers
+
+#ifdef REV5
+#define MAG_DRDY_GPIO         GPIOC
+#define MAG_DRDY_PIN          GPIO_Pin_14
+#define MAG_DRDY_PORT_SOURCE  GPIO_PortSourceGPIOC
+#define MAG_DRDY_PIN_SOURCE   GPIO_PinSource14
+#define MAG_DRDY_EXTI_LINE    EXTI_Line14
+#else
+#define MAG_DRDY_GPIO         GPIOB
+#define MAG_DRDY_PIN          GPIO_Pin_12
+#define MAG_DRDY_PORT_SOURCE  GPIO_PortSourceGPIOB
+#define MAG_DRDY_PIN_SOURCE   GPIO_PinSource12
+#define MAG_DRDY_EXTI_LINE    EXTI_Line12
+#endif
+
+#define MAG_DRDY_TIMEOUT      100  // mSec, read anyway if DRDY is not seen
+
+///////////////////////////////////////////////////////////////////////////////
+
 float magScaleFactor[3];
 
 uint8_t magDataUpdate = false;
@@ -79,22 +99,46 @@ uint8_t newMagData = false;
 
 int16andUint8_t rawMag[3];
 
+uint16_t magSampleRate;
+
+static volatile uint8_t magDataReady = false;
+
+static uint8_t  magReadPending = false;
+
+static uint8_t  magBuffer[6];
+
+static uint16_t magDataReadyTimer = 0;
+
+static uint16_t magRateTimer = 0;
+
+static uint16_t magSampleCount = 0;
+
 ///////////////////////////////////////////////////////////////////////////////
-// Read Magnetometer
+// Mag Data Ready Interrupt Handler
 ///////////////////////////////////////////////////////////////////////////////
 
-uint8_t readMag(void)
+void EXTI15_10_IRQHandler(void)
 {
-    uint8_t I2C2_Buffer_Rx[6];
+    if (EXTI_GetITStatus(MAG_DRDY_EXTI_LINE) != RESET)
+    {
+        EXTI_ClearITPendingBit(MAG_DRDY_EXTI_LINE);
 
-    i2cRead(I2C2, HMC5883_ADDRESS, HMC5883_DATA_X_MSB_REG, 6, I2C2_Buffer_Rx);
+        magDataReady = true;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Unpack Magnetometer Data
+///////////////////////////////////////////////////////////////////////////////
 
-    rawMag[XAXIS].bytes[1] = I2C2_Buffer_Rx[0];
-    rawMag[XAXIS].bytes[0] = I2C2_Buffer_Rx[1];
-    rawMag[ZAXIS].bytes[1] = I2C2_Buffer_Rx[2];
-    rawMag[ZAXIS].bytes[0] = I2C2_Buffer_Rx[3];
-    rawMag[YAXIS].bytes[1] = I2C2_Buffer_Rx[4];
-    rawMag[YAXIS].bytes[0] = I2C2_Buffer_Rx[5];
+static uint8_t unpackMag(uint8_t *buffer)
+{
+    rawMag[XAXIS].bytes[1] = buffer[0];
+    rawMag[XAXIS].bytes[0] = buffer[1];
+    rawMag[ZAXIS].bytes[1] = buffer[2];
+    rawMag[ZAXIS].bytes[0] = buffer[3];
+    rawMag[YAXIS].bytes[1] = buffer[4];
+    rawMag[YAXIS].bytes[0] = buffer[5];
 
     // check for valid data
 	if (rawMag[XAXIS].value == -4096 || rawMag[YAXIS].value == -4096 || rawMag[ZAXIS].value == -4096)
@@ -103,12 +147,71 @@ uint8_t readMag(void)
 	    return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Read Magnetometer
+///////////////////////////////////////////////////////////////////////////////
+
+uint8_t readMag(void)
+{
+    uint8_t I2C2_Buffer_Rx[6];
+
+    i2cRead(I2C2, HMC5883_ADDRESS, HMC5883_DATA_X_MSB_REG, 6, I2C2_Buffer_Rx);
+
+    return unpackMag(I2C2_Buffer_Rx);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Magnetometer Tick, called at 1000 Hz from SysTick after the blocking reads
+///////////////////////////////////////////////////////////////////////////////
+
+void magTick(void)
+{
+    if (++magRateTimer >= 1000)
+    {
+    	magSampleRate  = magSampleCount;
+    	magRateTimer   = 0;
+    	magSampleCount = 0;
+    }
+
+    ///////////////////////////////////
+
+    if (magReadPending == true)
+    {
+    	if (i2cBusy() == true)
+    		return;
+
+    	magReadPending = false;
+
+    	if (unpackMag(magBuffer) == true)
+    	{
+    		newMagData = true;
+    		magSampleCount++;
+    	}
+    }
+
+    ///////////////////////////////////
+
+    if ((magDataReady == true) || (++magDataReadyTimer >= MAG_DRDY_TIMEOUT))
+    {
+    	if (i2cReadAsync(I2C2, HMC5883_ADDRESS, HMC5883_DATA_X_MSB_REG, 6, magBuffer) == true)
+    	{
+    		magDataReady      = false;
+    		magDataReadyTimer = 0;
+    		magReadPending    = true;
+    	}
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Initialize Magnetometer
 ///////////////////////////////////////////////////////////////////////////////
 
 void initMag(void)
 {
+    GPIO_InitTypeDef GPIO_InitStructure;
+    EXTI_InitTypeDef EXTI_InitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+
     uint8_t I2C_Buffer_Rx[1] = { 0 };
     uint8_t i;
 
@@ -152,6 +255,31 @@ void initMag(void)
     readMag();
 
     delay(20);
+
+    ///////////////////////////////////
+
+    GPIO_StructInit(&GPIO_InitStructure);
+
+    GPIO_InitStructure.GPIO_Pin  = MAG_DRDY_PIN;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IPU;
+
+    GPIO_Init(MAG_DRDY_GPIO, &GPIO_InitStructure);
+
+    GPIO_EXTILineConfig(MAG_DRDY_PORT_SOURCE, MAG_DRDY_PIN_SOURCE);
+
+    EXTI_InitStructure.EXTI_Line    = MAG_DRDY_EXTI_LINE;
+    EXTI_InitStructure.EXTI_Mode    = EXTI_Mode_Interrupt;
+    EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Falling;
+    EXTI_InitStructure.EXTI_LineCmd = ENABLE;
+
+    EXTI_Init(&EXTI_InitStructure);
+
+    NVIC_InitStructure.NVIC_IRQChannel                   = EXTI15_10_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 2;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
+
+    NVIC_Init(&NVIC_InitStructure);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -33,6 +33,10 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 ///////////////////////////////////////////////////////////////////////////////
 
+#define MAG_RATE  75  // Hz, continuous mode sample rate read on DRDY
+
+///////////////////////////////////////////////////////////////////////////////
+
 extern float magScaleFactor[3];
 
 extern uint8_t magDataUpdate;
@@ -41,12 +45,18 @@ extern uint8_t newMagData;
 
 extern int16andUint8_t rawMag[3];
 
+extern uint16_t magSampleRate;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 uint8_t readMag(void);
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void magTick(void);
+
+///////////////////////////////////////////////////////////////////////////////
+
 void initMag(void);
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -129,7 +129,7 @@ void computeMpu3050RTBias(void)
     uint16_t samples;
     float gyroSum[3] = { 0.0f, 0.0f, 0.0f };
 
-    mpuCalibrating = true;
+    rtDataComputing = true;
 
     for (samples = 0; samples < 2000; samples++)
     {
@@ -149,7 +149,7 @@ void computeMpu3050RTBias(void)
 
     }
 
-    mpuCalibrating = false;
+    rtDataComputing = false;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -161,7 +161,7 @@ void computeMpu6050RTData(void)
     double accelSum[3]    = { 0.0f, 0.0f, 0.0f };
     double gyroSum[3]     = { 0.0f, 0.0f, 0.0f };
 
-    mpuCalibrating = true;
+    rtDataComputing = true;
 
     for (samples = 0; samples < 5000; samples++)
     {
@@ -188,7 +188,7 @@ void computeMpu6050RTData(void)
 
     accelOneG = sqrt(SQR(accelSum[XAXIS]) + SQR(accelSum[YAXIS]) + SQR(accelSum[ZAXIS]));
 
-    mpuCalibrating = false;
+    rtDataComputing = false;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -35,11 +35,16 @@ along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
 
 #define MS5611_ADDRESS  0x77
 
-//#define OSR  256  // 0.60 mSec conversion time (1666.67 Hz)
-//#define OSR  512  // 1.17 mSec conversion time ( 854.70 Hz)
-//#define OSR 1024  // 2.28 mSec conversion time ( 357.14 Hz)
-//#define OSR 2048  // 4.54 mSec conversion time ( 220.26 Hz)
-  #define OSR 4096  // 9.04 mSec conversion time ( 110.62 Hz)
+// eepromConfig.ms5611Osr selects the oversampling ratio at runtime
+//
+// 0, OSR  256, 0.60 mSec conversion time (1666.67 Hz)
+// 1, OSR  512, 1.17 mSec conversion time ( 854.70 Hz)
+// 2, OSR 1024, 2.28 mSec conversion time ( 357.14 Hz)
+// 3, OSR 2048, 4.54 mSec conversion time ( 220.26 Hz)
+// 4, OSR 4096, 9.04 mSec conversion time ( 110.62 Hz)
+
+#define MS5611_CONVERT_D1  0x40  // Pressure conversion,    OSR 256
+#define MS5611_CONVERT_D2  0x50  // Temperature conversion, OSR 256
 
 ///////////////////////////////////////
 
@@ -58,57 +63,51 @@ int32_t dT;
 int32_t ms5611Temperature;
 
 ///////////////////////////////////////////////////////////////////////////////
-// MS5611 Read Temperature Request Pressure
+// MS5611 Read Temperature
 ///////////////////////////////////////////////////////////////////////////////
 
-void ms5611ReadTemperatureRequestPressure(void)
+void ms5611ReadTemperature(void)
 {
     uint8_t data[3];
 
-    i2cRead(I2C2, MS5611_ADDRESS, 0x00, 3, data);    // Request temperature read
+    i2cRead(I2C2, MS5611_ADDRESS, 0x00, 3, data);    // Read temperature conversion result
 
     d2.bytes[2] = data[0];
     d2.bytes[1] = data[1];
     d2.bytes[0] = data[2];
-
-    #if   (OSR ==  256)
-	    i2cWriteI2C2, (MS5611_ADDRESS, 0xFF, 0x40);  // Request pressure conversion
-	#elif (OSR ==  512)
-	    i2cWrite(I2C2, MS5611_ADDRESS, 0xFF, 0x42);
-	#elif (OSR == 1024)
-	    i2cWrite(I2C2, MS5611_ADDRESS, 0xFF, 0x44);
-	#elif (OSR == 2048)
-	    i2cWrite(I2C2, MS5611_ADDRESS, 0xFF, 0x46);
-	#elif (OSR == 4096)
-	    i2cWrite(I2C2, MS5611_ADDRESS, 0xFF, 0x48);
-    #endif
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-// MS5611 Read Pressure Request Temperature
+// MS5611 Read Pressure
 ///////////////////////////////////////////////////////////////////////////////
 
-void ms5611ReadPressureRequestTemperature(void)
+void ms5611ReadPressure(void)
 {
     uint8_t data[3];
 
-    i2cRead(I2C2, MS5611_ADDRESS, 0x00, 3, data);    // Request pressure read
+    i2cRead(I2C2, MS5611_ADDRESS, 0x00, 3, data);    // Read pressure conversion result
 
     d1.bytes[2] = data[0];
     d1.bytes[1] = data[1];
     d1.bytes[0] = data[2];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// MS5611 Request Temperature
+///////////////////////////////////////////////////////////////////////////////
 
-    #if   (OSR ==  256)
-	    i2cWrite(I2C2, MS5611_ADDRESS, 0xFF, 0x50);   // Request temperature converison
-	#elif (OSR ==  512)
-	    i2cWrite(I2C2, MS5611_ADDRESS, 0xFF, 0x52);
-	#elif (OSR == 1024)
-	    i2cWrite(I2C2, MS5611_ADDRESS, 0xFF, 0x54);
-	#elif (OSR == 2048)
-	    i2cWrite(I2C2, MS5611_ADDRESS, 0xFF, 0x56);
-	#elif (OSR == 4096)
-	    i2cWrite(I2C2, MS5611_ADDRESS, 0xFF, 0x58);
-    #endif
+void ms5611RequestTemperature(void)
+{
+    i2cWrite(I2C2, MS5611_ADDRESS, 0xFF, MS5611_CONVERT_D2 + (eepromConfig.ms5611Osr << 1));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// MS5611 Request Pressure
+///////////////////////////////////////////////////////////////////////////////
+
+void ms5611RequestPressure(void)
+{
+    i2cWrite(I2C2, MS5611_ADDRESS, 0xFF, MS5611_CONVERT_D1 + (eepromConfig.ms5611Osr << 1));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -165,7 +164,7 @@ void calculateMs5611PressureAltitude(void)
 
 	p = (((d1Value * sensitivity) >> 21) - offset) >> 15;
 
-	sensors.pressureAlt50Hz = 44330.0f * (1.0f - pow((float)p / 101325.0f, 1.0f / 5.255f));
+	sensors.pressureAlt50Hz = pressureToAltitude(p);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -204,25 +203,14 @@ void initMs5611(void)
 	c6.bytes[1] = data[0];
     c6.bytes[0] = data[1];
 
-    #if   (OSR ==  256)
-	    i2cWrite(I2C2, MS5611_ADDRESS, 0xFF, 0x50);  // Request temperature conversion
-	#elif (OSR ==  512)
-	    i2cWrite(I2C2, MS5611_ADDRESS, 0xFF, 0x52);
-	#elif (OSR == 1024)
-	    i2cWrite(I2C2, MS5611_ADDRESS, 0xFF, 0x54);
-	#elif (OSR == 2048)
-	    i2cWrite(MS5611_ADDRESS, 0xFF, 0x56);
-	#elif (OSR == 4096)
-	    i2cWrite(I2C2, MS5611_ADDRESS, 0xFF, 0x58);
-    #endif
-
+    ms5611RequestTemperature();
     delay(10);
 
-    ms5611ReadTemperatureRequestPressure();
+    ms5611ReadTemperature();
+    ms5611RequestPressure();
     delay(10);
 
-    ms5611ReadPressureRequestTemperature();
-    delay(10);
+    ms5611ReadPressure();
 
     d1Value = d1.value;
     d2Value = d2.value;
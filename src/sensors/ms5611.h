@@ -44,16 +44,28 @@ extern uint32_t d2Value;
 extern int32_t ms5611Temperature;
 
 ///////////////////////////////////////////////////////////////////////////////
-// MS5611 Read Temperature Request Pressure
+// MS5611 Read Temperature
 ///////////////////////////////////////////////////////////////////////////////
 
-void ms5611ReadTemperatureRequestPressure(void);
+void ms5611ReadTemperature(void);
 
 ///////////////////////////////////////////////////////////////////////////////
-// MS5611 Read Pressure Request Temperature
+// MS5611 Read Pressure
 ///////////////////////////////////////////////////////////////////////////////
 
-void ms5611ReadPressureRequestTemperature(void);
+void ms5611ReadPressure(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// MS5611 Request Temperature
+///////////////////////////////////////////////////////////////////////////////
+
+void ms5611RequestTemperature(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// MS5611 Request Pressure
+///////////////////////////////////////////////////////////////////////////////
+
+void ms5611RequestPressure(void);
 
 ///////////////////////////////////////////////////////////////////////////////
 // Calculate MS5611 Temperature
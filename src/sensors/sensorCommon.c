@@ -57,10 +57,6 @@ float           mpuTemperature;
 
 int16andUint8_t rawMpuTemperature;
 
-///////////////////////////////////////////////////////////////////////////////
-
-uint8_t         newPressureReading    = false;
-
-uint8_t         newTemperatureReading = false;
+uint8_t         rtDataComputing = false;
 
 ///////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -57,11 +57,6 @@ extern float           mpuTemperature;
 
 extern int16andUint8_t rawMpuTemperature;
 
-///////////////////////////////////////////////////////////////////////////////
-
-extern uint8_t         newPressureReading;
-
-extern uint8_t         newTemperatureReading;
+extern uint8_t         rtDataComputing;
 
 ///////////////////////////////////////////////////////////////////////////////
-
@@ -39,7 +39,7 @@
 //#include "stm32f10x_dac.h"
 //#include "stm32f10x_dbgmcu.h"
 #include "stm32f10x_dma.h"
-//#include "stm32f10x_exti.h"
+#include "stm32f10x_exti.h"
 #include "stm32f10x_flash.h"
 //#include "stm32f10x_fsmc.h"
 #include "stm32f10x_gpio.h"
@@ -49,7 +49,7 @@
 #include "stm32f10x_rcc.h"
 //#include "stm32f10x_rtc.h"
 //#include "stm32f10x_sdio.h"
-//#include "stm32f10x_spi.h"
+#include "stm32f10x_spi.h"
 #include "stm32f10x_tim.h"
 #include "stm32f10x_usart.h"
 //#include "stm32f10x_wwdg.h"
@@ -0,0 +1,222 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// System Identification Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+// An excitation is added to rateCmd of one axis, once armed and above
+// minimum throttle for SYSID_START_DELAY.  The rate command, rate PID output
+// and gyro are stored every 500 Hz cycle straight into the capture buffer
+// and dumped from it over the CLI once disarmed.
+//
+// Chirp is logarithmic from fMin to fMax over the capture length, generated
+// by rotating a unit phasor with polynomial sin/cos of the step angle, so
+// every sample costs the same few multiplies.  PRBS is a 9 bit LFSR, each
+// bit held for 500 Hz / fMax cycles.
+
+#define SYSID_SAMPLES      1024
+#define SYSID_SAMPLE_TIME  0.002f  // 500 Hz
+
+#define SYSID_START_DELAY  500     // 1 second of 500 Hz cycles
+
+#define SYSID_RATE_SCALE   1000.0f // rad/sec to int16, 0.001 rad/sec resolution
+
+uint8_t sysIdState = SYSID_IDLE;
+uint8_t sysIdAxis  = ROLL;
+
+static uint8_t  sysIdType;
+static float    sysIdAmplitude;
+static float    sysIdFMin;
+static float    sysIdFMax;
+
+#define sysIdBuffer ((int16_t (*)[3])captureBuffer)  // SYSID_SAMPLES of 3, borrowed from the flight recorder
+static uint16_t sysIdIndex;
+static uint16_t sysIdStartCount;
+
+static float    phasorCos;
+static float    phasorSin;
+static float    stepAngle;
+static float    stepAngleRatio;
+
+static uint16_t prbsRegister;
+static uint8_t  prbsHold;
+static uint8_t  prbsCount;
+
+///////////////////////////////////////////////////////////////////////////////
+// System Identification Start
+///////////////////////////////////////////////////////////////////////////////
+
+void sysIdStart(uint8_t axis, uint8_t type, float amplitude, float fMin, float fMax)
+{
+	sysIdAxis      = axis;
+	sysIdType      = type;
+	sysIdAmplitude = amplitude;
+	sysIdFMin      = fMin;
+	sysIdFMax      = fMax;
+
+	sysIdIndex      = 0;
+	sysIdStartCount = 0;
+
+	phasorCos      = 1.0f;
+	phasorSin      = 0.0f;
+	stepAngle      = TWO_PI * fMin * SYSID_SAMPLE_TIME;
+	stepAngleRatio = powf(fMax / fMin, 1.0f / (float)SYSID_SAMPLES);
+
+	prbsRegister = 0x01FF;
+	prbsHold     = (uint8_t)constrain(1.0f / (fMax * SYSID_SAMPLE_TIME), 1.0f, 255.0f);
+	prbsCount    = 0;
+
+	sysIdState = SYSID_PENDING;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// System Identification Excitation
+///////////////////////////////////////////////////////////////////////////////
+
+// Called every 500 Hz cycle while sysIdState is not idle, returns the value
+// to add to rateCmd[sysIdAxis].
+
+float sysIdExcitation(void)
+{
+	float a2, c, s, norm;
+
+	if (sysIdState == SYSID_PENDING)
+	{
+		if (pidReset == true)
+			sysIdStartCount = 0;
+		else if (++sysIdStartCount >= SYSID_START_DELAY)
+			sysIdState = SYSID_RUNNING;
+
+		return 0.0f;
+	}
+
+	if (sysIdState != SYSID_RUNNING)
+		return 0.0f;
+
+	if (pidReset == true)
+	{
+		sysIdState = SYSID_COMPLETE;  // Disarmed or throttle cut, keep what was captured
+		return 0.0f;
+	}
+
+	if (sysIdType == SYSID_PRBS)
+	{
+		if (++prbsCount >= prbsHold)
+		{
+			// x^9 + x^5 + 1
+
+			prbsCount    = 0;
+			prbsRegister = ((prbsRegister << 1) | (((prbsRegister >> 8) ^ (prbsRegister >> 4)) & 1)) & 0x01FF;
+		}
+
+		return (prbsRegister & 1) ? sysIdAmplitude : -sysIdAmplitude;
+	}
+
+	// Rotate the phasor by the step angle, angle is at most pi/2
+
+	a2 = stepAngle * stepAngle;
+	c  = 1.0f - a2 * (0.5f - a2 * (1.0f / 24.0f - a2 * (1.0f / 720.0f)));
+	s  = stepAngle * (1.0f - a2 * (1.0f / 6.0f - a2 * (1.0f / 120.0f - a2 * (1.0f / 5040.0f))));
+
+	a2        = phasorCos * c - phasorSin * s;
+	phasorSin = phasorSin * c + phasorCos * s;
+	phasorCos = a2;
+
+	// One Newton step keeps the phasor at unit length
+
+	norm       = 1.5f - 0.5f * (phasorCos * phasorCos + phasorSin * phasorSin);
+	phasorCos *= norm;
+	phasorSin *= norm;
+
+	stepAngle *= stepAngleRatio;
+
+	return sysIdAmplitude * phasorSin;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// System Identification Capture
+///////////////////////////////////////////////////////////////////////////////
+
+void sysIdCapture(float command, float pidOutput, float gyro)
+{
+	int16_t *sample;
+
+	if (sysIdState != SYSID_RUNNING)
+		return;
+
+	sample = sysIdBuffer[sysIdIndex];
+
+	sample[0] = (int16_t)constrain(command * SYSID_RATE_SCALE, -32767.0f, 32767.0f);
+	sample[1] = (int16_t)constrain(pidOutput,                  -32767.0f, 32767.0f);
+	sample[2] = (int16_t)constrain(gyro    * SYSID_RATE_SCALE, -32767.0f, 32767.0f);
+
+	if (++sysIdIndex >= SYSID_SAMPLES)
+		sysIdState = SYSID_COMPLETE;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// System Identification Dump
+///////////////////////////////////////////////////////////////////////////////
+
+// CSV, time in mSec, rate command and gyro in mrad/sec, PID output in motor
+// command counts.  Paced to the 115200 baud CLI port.
+
+void sysIdDump(void)
+{
+	uint16_t i;
+
+	const char *stateNames[4] = { "Idle", "Waiting for Armed Flight", "Running", "Complete" };
+
+	cliPortPrintF("\nSystem ID:  %s, %s on axis %1d, %d samples\n", stateNames[sysIdState],
+			                                                       (sysIdType == SYSID_CHIRP) ? "Chirp" : "PRBS",
+			                                                       sysIdAxis, sysIdIndex);
+
+	cliPortPrintF("Amplitude %6.3f rad/sec, %5.1f to %5.1f Hz\n\n", sysIdAmplitude, sysIdFMin, sysIdFMax);
+
+	if ((sysIdState != SYSID_COMPLETE) || (armed == true))
+		return;
+
+	cliPortPrint("mSec, RateCmd, RatePID, Gyro\n");
+
+	for (i = 0; i < sysIdIndex; i++)
+	{
+		cliPortPrintF("%d, %d, %d, %d\n", i * 2, sysIdBuffer[i][0], sysIdBuffer[i][1], sysIdBuffer[i][2]);
+		delay(3);
+	}
+
+	cliPortPrint("\n");
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,70 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// System Identification Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+enum { SYSID_CHIRP, SYSID_PRBS };
+
+enum { SYSID_IDLE, SYSID_PENDING, SYSID_RUNNING, SYSID_COMPLETE };
+
+extern uint8_t sysIdState;
+extern uint8_t sysIdAxis;
+
+///////////////////////////////////////////////////////////////////////////////
+// System Identification Start
+///////////////////////////////////////////////////////////////////////////////
+
+void sysIdStart(uint8_t axis, uint8_t type, float amplitude, float fMin, float fMax);
+
+///////////////////////////////////////////////////////////////////////////////
+// System Identification Excitation
+///////////////////////////////////////////////////////////////////////////////
+
+float sysIdExcitation(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// System Identification Capture
+///////////////////////////////////////////////////////////////////////////////
+
+void sysIdCapture(float command, float pidOutput, float gyro);
+
+///////////////////////////////////////////////////////////////////////////////
+// System Identification Dump
+///////////////////////////////////////////////////////////////////////////////
+
+void sysIdDump(void);
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,578 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+uint8_t *(*telemPortReserve)(uint16_t length);
+
+void     (*telemPortCommit)(uint16_t length);
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+#define TELEMETRY_TEXT_LENGTH      96
+#define TELEMETRY_HEADER_LENGTH     8
+#define TELEMETRY_FRAME_LENGTH    160  // Largest raw frame, the longest schema fits with room to spare
+
+#define TELEMETRY_SCHEMA_INTERVAL 100  // Data frames between schema repeats, a decoder can join at any time
+
+#define COBS_LENGTH(n) ((n) + (n) / 254 + 2)  // Worst case encoded length including the delimiter
+
+// Link budget, the port is UART1 at 10 bits per byte.  The budget is kept in
+// 1/TELEMETRY_RATE byte units so a tick adds the link's bytes per second.
+
+#define TELEMETRY_LINK_BYTES   (UART1_BAUD_RATE / 10)
+#define TELEMETRY_BURST_TICKS  2  // Budget saved while idle, caps the burst after a quiet spell
+
+uint16_t telemetrySequence = 0;
+
+telemetryStats_t telemetryStats[NUMBER_OF_TELEMETRY_SETS];
+
+static uint8_t telemetrySchemaCountdown[NUMBER_OF_TELEMETRY_SETS];
+
+static uint8_t telemetryCountdown[NUMBER_OF_TELEMETRY_SETS];
+static uint8_t telemetryPending[NUMBER_OF_TELEMETRY_SETS];
+static uint8_t telemetryNextSet = 0;  // Round robin start, a deferred set goes first next tick
+
+static int32_t telemetryBudget  = 0;
+
+///////////////////////////////////////
+
+static const telemetryField_t accelFields[] =
+{
+    { "accelX", 'f', &sensors.accel500Hz[XAXIS] },
+    { "accelY", 'f', &sensors.accel500Hz[YAXIS] },
+    { "accelZ", 'f', &sensors.accel500Hz[ZAXIS] },
+};
+
+static const telemetryField_t gyroFields[] =
+{
+    { "gyroRoll",  'f', &sensors.gyro500Hz[ROLL ] },
+    { "gyroPitch", 'f', &sensors.gyro500Hz[PITCH] },
+    { "gyroYaw",   'f', &sensors.gyro500Hz[YAW  ] },
+};
+
+static const telemetryField_t attitudeFields[] =
+{
+    { "roll",  'f', &sensors.attitude500Hz[ROLL ] },
+    { "pitch", 'f', &sensors.attitude500Hz[PITCH] },
+    { "yaw",   'f', &sensors.attitude500Hz[YAW  ] },
+};
+
+static const telemetryField_t verticalFields[] =
+{
+    { "earthAccelZ",   'f', &earthAxisAccels[ZAXIS]   },
+    { "pressureAlt",   'f', &sensors.pressureAlt50Hz },
+    { "hDotEstimate",  'f', &hDotEstimate            },
+    { "hEstimate",     'f', &hEstimate               },
+};
+
+static const telemetryField_t altitudeHoldFields[] =
+{
+    { "verticalVelocityCmd", 'f', &verticalVelocityCmd },
+    { "hDotEstimate",        'f', &hDotEstimate        },
+    { "hEstimate",           'f', &hEstimate           },
+    { "ms5611Temperature",   'l', &ms5611Temperature   },
+    { "verticalModeState",   'B', &verticalModeState   },
+    { "throttleCmd",         'f', &throttleCmd         },
+};
+
+static const telemetryField_t motorFields[] =
+{
+    { "motor1", 'f', &motor[0] },
+    { "motor2", 'f', &motor[1] },
+    { "motor3", 'f', &motor[2] },
+    { "motor4", 'f', &motor[3] },
+    { "motor5", 'f', &motor[4] },
+    { "motor6", 'f', &motor[5] },
+};
+
+#define FIELDS(f) (sizeof(f) / sizeof(telemetryField_t)), f
+
+const telemetrySet_t telemetrySets[NUMBER_OF_TELEMETRY_SETS] =
+{
+    { "accels",       FIELDS(accelFields)        },
+    { "gyros",        FIELDS(gyroFields)         },
+    { "attitudes",    FIELDS(attitudeFields)     },
+    { "vertical",     FIELDS(verticalFields)     },
+    { "altitudeHold", FIELDS(altitudeHoldFields) },
+    { "motors",       FIELDS(motorFields)        },
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Field Size
+///////////////////////////////////////////////////////////////////////////////
+
+static uint8_t fieldSize(char type)
+{
+    switch (type)
+    {
+        case 'h':
+            return 2;
+
+        case 'B':
+            return 1;
+
+        default:  // 'f' and 'l'
+            return 4;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CRC16 CCITT, initial value 0xFFFF
+///////////////////////////////////////////////////////////////////////////////
+
+static uint16_t crc16Ccitt(const uint8_t *buf, uint16_t length)
+{
+    uint16_t crc = 0xFFFF;
+
+    while (length--)
+    {
+        crc  = (crc >> 8) | (crc << 8);
+        crc ^= *buf++;
+        crc ^= (crc & 0xFF) >> 4;
+        crc ^= crc << 12;
+        crc ^= (crc & 0xFF) << 5;
+    }
+
+    return crc;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// COBS Encode
+//
+// Consistent overhead byte stuffing, the encoded frame has no zero bytes
+// so the trailing zero marks the frame boundary.
+///////////////////////////////////////////////////////////////////////////////
+
+static uint16_t cobsEncode(const uint8_t *src, uint16_t length, uint8_t *dst)
+{
+    uint8_t *code  = dst;      // Where the current block's code byte goes
+    uint8_t *out   = dst + 1;
+    uint8_t  count = 1;
+
+    while (length--)
+    {
+        if (*src != 0)
+        {
+            *out++ = *src;
+            count++;
+        }
+
+        if ((*src == 0) || (count == 0xFF))
+        {
+            *code = count;
+            code  = out++;
+            count = 1;
+        }
+
+        src++;
+    }
+
+    *code  = count;
+    *out++ = 0x00;
+
+    return out - dst;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Build Frame
+///////////////////////////////////////////////////////////////////////////////
+
+static uint16_t telemetryBuildFrame(uint8_t frameType, uint8_t set, uint32_t frameTime, uint8_t *frame)
+{
+    const telemetrySet_t   *telemetrySet = &telemetrySets[set];
+    const telemetryField_t *field;
+
+    uint16_t length = TELEMETRY_HEADER_LENGTH;
+    uint16_t crc;
+    uint8_t  size;
+    uint8_t  index;
+
+    frame[0] = frameType;
+    frame[1] = set;
+
+    memcpy(&frame[2], &telemetrySequence, 2);
+    memcpy(&frame[4], &frameTime,         4);
+
+    if (frameType == TELEMETRY_DATA_FRAME)
+    {
+        for (index = 0; index < telemetrySet->fieldCount; index++)
+        {
+            field = &telemetrySet->fields[index];
+            size  = fieldSize(field->type);
+
+            memcpy(&frame[length], field->data, size);
+            length += size;
+        }
+    }
+    else
+    {
+        size = strlen(telemetrySet->name) + 1;
+        memcpy(&frame[length], telemetrySet->name, size);
+        length += size;
+
+        frame[length++] = telemetrySet->fieldCount;
+
+        for (index = 0; index < telemetrySet->fieldCount; index++)
+        {
+            field = &telemetrySet->fields[index];
+            size  = strlen(field->name) + 1;
+
+            frame[length++] = field->type;
+            memcpy(&frame[length], field->name, size);
+            length += size;
+        }
+    }
+
+    crc = crc16Ccitt(frame, length);
+
+    frame[length++] = (uint8_t)crc;
+    frame[length++] = (uint8_t)(crc >> 8);
+
+    return length;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Encode Text
+//
+// The comma separated text lines the telemetry sets have always printed.
+///////////////////////////////////////////////////////////////////////////////
+
+uint16_t telemetryEncodeText(uint8_t set, char *buf, uint16_t size)
+{
+    const telemetrySet_t   *telemetrySet = &telemetrySets[set];
+    const telemetryField_t *field;
+
+    int     length = 0;
+    uint8_t index;
+
+    for (index = 0; index < telemetrySet->fieldCount; index++)
+    {
+        field = &telemetrySet->fields[index];
+
+        switch (field->type)
+        {
+            case 'f':
+                length += snprintf(&buf[length], size - length, "%9.4f", *(const float *)field->data);
+                break;
+
+            case 'l':
+                length += snprintf(&buf[length], size - length, "%4ld", (long)*(const int32_t *)field->data);
+                break;
+
+            case 'h':
+                length += snprintf(&buf[length], size - length, "%6d", *(const int16_t *)field->data);
+                break;
+
+            case 'B':
+                length += snprintf(&buf[length], size - length, "%1d", *(const uint8_t *)field->data);
+                break;
+        }
+
+        if (length >= (size - 2))  // Doesn't fit with the separator or line feed, don't send a partial line
+            return 0;
+
+        if (index < (telemetrySet->fieldCount - 1))
+        {
+            buf[length++] = ',';
+            buf[length++] = ' ';
+        }
+    }
+
+    buf[length++] = '\n';
+
+    return length;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Encode Binary
+///////////////////////////////////////////////////////////////////////////////
+
+uint16_t telemetryEncodeBinary(uint8_t frameType, uint8_t set, uint32_t frameTime, uint8_t *buf, uint16_t size)
+{
+    uint8_t  frame[TELEMETRY_FRAME_LENGTH];
+    uint16_t length;
+
+    length = telemetryBuildFrame(frameType, set, frameTime, frame);
+
+    if (COBS_LENGTH(length) > size)
+        return 0;
+
+    return cobsEncode(frame, length, buf);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Send Frame
+//
+// Builds the raw frame on the stack and COBS encodes it straight into the
+// port transmit buffer.  The sequence advances even when the port drops the
+// frame so the gap shows up in the decoder.
+///////////////////////////////////////////////////////////////////////////////
+
+static uint16_t telemetrySendFrame(uint8_t frameType, uint8_t set, uint32_t frameTime)
+{
+    uint8_t  frame[TELEMETRY_FRAME_LENGTH];
+    uint8_t *dst;
+    uint16_t length;
+
+    length = telemetryBuildFrame(frameType, set, frameTime, frame);
+
+    telemetrySequence++;
+
+    dst = telemPortReserve(COBS_LENGTH(length));
+
+    if (dst == NULL)
+        return 0;
+
+    length = cobsEncode(frame, length, dst);
+
+    telemPortCommit(length);
+
+    return length;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Send
+///////////////////////////////////////////////////////////////////////////////
+
+uint16_t telemetrySend(uint8_t set)
+{
+    uint32_t frameTime;
+    uint16_t length = 0;
+    uint8_t *dst;
+
+    if (eepromConfig.telemetryFormat == TELEMETRY_BINARY)
+    {
+        frameTime = micros();
+
+        if (telemetrySchemaCountdown[set] == 0)
+        {
+            length += telemetrySendFrame(TELEMETRY_SCHEMA_FRAME, set, frameTime);
+            telemetrySchemaCountdown[set] = TELEMETRY_SCHEMA_INTERVAL;
+        }
+
+        telemetrySchemaCountdown[set]--;
+
+        length += telemetrySendFrame(TELEMETRY_DATA_FRAME, set, frameTime);
+    }
+    else
+    {
+        dst = telemPortReserve(TELEMETRY_TEXT_LENGTH);
+
+        if (dst == NULL)
+            return 0;
+
+        length = telemetryEncodeText(set, (char *)dst, TELEMETRY_TEXT_LENGTH);
+
+        telemPortCommit(length);
+    }
+
+    return length;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Line Bytes
+//
+// Bytes one line of a set takes on the link, text lines are counted at
+// their minimum field widths.
+///////////////////////////////////////////////////////////////////////////////
+
+uint16_t telemetryLineBytes(uint8_t set)
+{
+    const telemetrySet_t *telemetrySet = &telemetrySets[set];
+
+    uint16_t length = 0;
+    uint8_t  index;
+
+    for (index = 0; index < telemetrySet->fieldCount; index++)
+    {
+        if (eepromConfig.telemetryFormat == TELEMETRY_BINARY)
+        {
+            length += fieldSize(telemetrySet->fields[index].type);
+        }
+        else
+        {
+            switch (telemetrySet->fields[index].type)
+            {
+                case 'f': length += 9; break;
+                case 'l': length += 4; break;
+                case 'h': length += 6; break;
+                case 'B': length += 1; break;
+            }
+
+            length += 2;  // Separator, the last one stands in for the line feed
+        }
+    }
+
+    if (eepromConfig.telemetryFormat == TELEMETRY_BINARY)
+        length = COBS_LENGTH(TELEMETRY_HEADER_LENGTH + length + 2);
+    else
+        length--;
+
+    return length;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Bandwidth
+//
+// Bytes per second of a set at its divider, and of all the active sets.
+///////////////////////////////////////////////////////////////////////////////
+
+uint32_t telemetrySetBandwidth(uint8_t set)
+{
+    return (uint32_t)telemetryLineBytes(set) * TELEMETRY_RATE / eepromConfig.telemetryDivider[set];
+}
+
+///////////////////////////////////////
+
+uint32_t telemetryBandwidth(void)
+{
+    uint32_t bandwidth = 0;
+    uint8_t  set;
+
+    for (set = 0; set < NUMBER_OF_TELEMETRY_SETS; set++)
+    {
+        if (eepromConfig.activeTelemetry & (1 << set))
+            bandwidth += telemetrySetBandwidth(set);
+    }
+
+    return bandwidth;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Update
+//
+// Called every control loop.  Each active set comes due every divider ticks
+// and waits in pending until the link budget allows, sets are served round
+// robin starting after the last one sent so no set is starved.  A tick adds
+// the link's bytes, a line spends what it actually took, so the average
+// never exceeds the link and one tick bursts at most a line past it.
+///////////////////////////////////////////////////////////////////////////////
+
+void telemetryUpdate(void)
+{
+    uint8_t set;
+    uint8_t index;
+    uint8_t first = telemetryNextSet;
+
+    for (set = 0; set < NUMBER_OF_TELEMETRY_SETS; set++)
+    {
+        if ((eepromConfig.activeTelemetry & (1 << set)) == 0)
+        {
+            telemetryPending[set] = false;
+            continue;
+        }
+
+        if (telemetryCountdown[set] > 1)
+        {
+            telemetryCountdown[set]--;
+            continue;
+        }
+
+        telemetryCountdown[set] = eepromConfig.telemetryDivider[set];
+
+        if (telemetryPending[set] == true)
+            telemetryStats[set].skipCnt++;
+
+        telemetryPending[set] = true;
+    }
+
+    telemetryBudget += TELEMETRY_LINK_BYTES;
+
+    if (telemetryBudget > (TELEMETRY_BURST_TICKS * TELEMETRY_LINK_BYTES))
+        telemetryBudget = TELEMETRY_BURST_TICKS * TELEMETRY_LINK_BYTES;
+
+    for (index = 0; index < NUMBER_OF_TELEMETRY_SETS; index++)
+    {
+        set = (first + index) % NUMBER_OF_TELEMETRY_SETS;
+
+        if (telemetryPending[set] == false)
+            continue;
+
+        if (telemetryBudget <= 0)
+        {
+            telemetryStats[set].deferCnt++;
+            continue;
+        }
+
+        telemetryBudget -= (int32_t)telemetrySend(set) * TELEMETRY_RATE;
+
+        telemetryPending[set] = false;
+        telemetryStats[set].lineCnt++;
+
+        telemetryNextSet = (set + 1) % NUMBER_OF_TELEMETRY_SETS;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Stats Reset
+///////////////////////////////////////////////////////////////////////////////
+
+void telemetryStatsReset(void)
+{
+    memset(telemetryStats, 0, sizeof(telemetryStats));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Benchmark
+//
+// Average cycles and bytes to encode one line of a set each way, the port
+// transmit buffer isn't touched.
+///////////////////////////////////////////////////////////////////////////////
+
+void telemetryBenchmark(uint8_t set, uint16_t iterations, uint32_t *textCycles, uint16_t *textBytes,
+                                                          uint32_t *binaryCycles, uint16_t *binaryBytes)
+{
+    char     text[TELEMETRY_TEXT_LENGTH];
+    uint8_t  binary[COBS_LENGTH(TELEMETRY_FRAME_LENGTH)];
+    uint16_t iteration;
+    uint32_t startCycles;
+
+    startCycles = *DWT_CYCCNT;
+
+    for (iteration = 0; iteration < iterations; iteration++)
+        *textBytes = telemetryEncodeText(set, text, sizeof(text));
+
+    *textCycles = (*DWT_CYCCNT - startCycles) / iterations;
+
+    startCycles = *DWT_CYCCNT;
+
+    for (iteration = 0; iteration < iterations; iteration++)
+        *binaryBytes = telemetryEncodeBinary(TELEMETRY_DATA_FRAME, set, 0, binary, sizeof(binary));
+
+    *binaryCycles = (*DWT_CYCCNT - startCycles) / iterations;
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,133 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Defines and Variables
+///////////////////////////////////////////////////////////////////////////////
+
+#define TELEMETRY_RATE 500  // telemetryUpdate() is called from the 500 Hz frame
+
+// Binary frames are COBS encoded and end with a zero byte, before encoding:
+//
+//   type, set, sequence (uint16), time in uSec (uint32), payload, CRC16 (CCITT)
+//
+// A schema frame payload is the set name then a field count followed by a
+// type character and name for each field, names NUL terminated.  A data frame
+// payload is the field values, little endian, in schema order.
+
+#define TELEMETRY_SCHEMA_FRAME 0x01
+#define TELEMETRY_DATA_FRAME   0x02
+
+typedef struct telemetryField_t
+{
+    char       *name;
+    char        type;   // 'f' float, 'l' int32_t, 'h' int16_t, 'B' uint8_t
+    const void *data;
+} telemetryField_t;
+
+typedef struct telemetrySet_t
+{
+    char                   *name;
+    uint8_t                 fieldCount;
+    const telemetryField_t *fields;
+} telemetrySet_t;
+
+extern const telemetrySet_t telemetrySets[NUMBER_OF_TELEMETRY_SETS];
+
+extern uint8_t *(*telemPortReserve)(uint16_t length);
+
+extern void     (*telemPortCommit)(uint16_t length);
+
+extern uint16_t telemetrySequence;
+
+typedef struct telemetryStats_t
+{
+    uint32_t lineCnt;    // Lines handed to the port
+    uint32_t deferCnt;   // Lines held over a tick for link budget
+    uint32_t skipCnt;    // Lines still waiting when the next one came due
+} telemetryStats_t;
+
+extern telemetryStats_t telemetryStats[NUMBER_OF_TELEMETRY_SETS];
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Encode Text
+///////////////////////////////////////////////////////////////////////////////
+
+uint16_t telemetryEncodeText(uint8_t set, char *buf, uint16_t size);
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Encode Binary
+///////////////////////////////////////////////////////////////////////////////
+
+uint16_t telemetryEncodeBinary(uint8_t frameType, uint8_t set, uint32_t frameTime, uint8_t *buf, uint16_t size);
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Send
+///////////////////////////////////////////////////////////////////////////////
+
+uint16_t telemetrySend(uint8_t set);
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Line Bytes
+///////////////////////////////////////////////////////////////////////////////
+
+uint16_t telemetryLineBytes(uint8_t set);
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Bandwidth
+///////////////////////////////////////////////////////////////////////////////
+
+uint32_t telemetrySetBandwidth(uint8_t set);
+
+uint32_t telemetryBandwidth(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Update
+///////////////////////////////////////////////////////////////////////////////
+
+void telemetryUpdate(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Stats Reset
+///////////////////////////////////////////////////////////////////////////////
+
+void telemetryStatsReset(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Telemetry Benchmark
+///////////////////////////////////////////////////////////////////////////////
+
+void telemetryBenchmark(uint8_t set, uint16_t iterations, uint32_t *textCycles, uint16_t *textBytes,
+                                                          uint32_t *binaryCycles, uint16_t *binaryBytes);
+
+///////////////////////////////////////////////////////////////////////////////
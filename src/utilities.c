@@ -240,6 +240,370 @@ uint16_t sphereFit(float    d[][3],
 	return (Iterations);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+//  Streaming Least Squares Fit an Ellipsoid to 3D Data
+///////////////////////////////////////////////////////////////////////////////
+
+// Fits the quadric
+//
+//   a*x^2 + b*y^2 + c*z^2 + 2d*xy + 2e*xz + 2f*yz + 2g*x + 2h*y + 2i*z = 1
+//
+// by accumulating the normal equations D'D v = D'1 one sample at a time, so
+// no sample buffer is required.  Only the upper triangle of D'D is updated.
+
+void ellipsoidFitInit(ellipsoidFitData_t *fit)
+{
+	uint8_t i, j;
+
+	for (i = 0; i < 9; i++)
+	{
+		for (j = 0; j < 9; j++)
+		    fit->dtd[i][j] = 0.0;
+
+		fit->dto[i] = 0.0;
+	}
+
+	fit->samples = 0;
+}
+
+///////////////////////////////////////
+
+void ellipsoidFitAccumulate(ellipsoidFitData_t *fit, float x, float y, float z)
+{
+	uint8_t i, j;
+	double  row[9];
+
+	row[0] = x * x;
+	row[1] = y * y;
+	row[2] = z * z;
+	row[3] = 2.0f * x * y;
+	row[4] = 2.0f * x * z;
+	row[5] = 2.0f * y * z;
+	row[6] = 2.0f * x;
+	row[7] = 2.0f * y;
+	row[8] = 2.0f * z;
+
+	for (i = 0; i < 9; i++)
+	{
+		for (j = i; j < 9; j++)
+		    fit->dtd[i][j] += row[i] * row[j];
+
+		fit->dto[i] += row[i];
+	}
+
+	fit->samples++;
+}
+
+///////////////////////////////////////
+
+// Jacobi eigen decomposition of a symmetric 3x3 matrix.  On return a[][] is
+// diagonal (the eigenvalues) and the columns of v[][] are the eigenvectors.
+
+static void jacobi3x3(float a[3][3], float v[3][3])
+{
+	uint8_t sweep, p, q, k;
+	float   theta, t, c, s, apk, aqk, vkp, vkq;
+
+	for (p = 0; p < 3; p++)
+		for (q = 0; q < 3; q++)
+			v[p][q] = (p == q) ? 1.0f : 0.0f;
+
+	for (sweep = 0; sweep < 10; sweep++)
+	{
+		if ((fabsf(a[0][1]) + fabsf(a[0][2]) + fabsf(a[1][2])) < 1.0e-12f)
+			break;
+
+		for (p = 0; p < 2; p++)
+		{
+			for (q = p + 1; q < 3; q++)
+			{
+				if (a[p][q] == 0.0f)
+					continue;
+
+				theta = (a[q][q] - a[p][p]) / (2.0f * a[p][q]);
+				t     = 1.0f / (fabsf(theta) + sqrtf(theta * theta + 1.0f));
+
+				if (theta < 0.0f)
+					t = -t;
+
+				c = 1.0f / sqrtf(t * t + 1.0f);
+				s = t * c;
+
+				for (k = 0; k < 3; k++)
+				{
+					apk = a[p][k];
+					aqk = a[q][k];
+					a[p][k] = c * apk - s * aqk;
+					a[q][k] = s * apk + c * aqk;
+				}
+
+				for (k = 0; k < 3; k++)
+				{
+					apk = a[k][p];
+					aqk = a[k][q];
+					a[k][p] = c * apk - s * aqk;
+					a[k][q] = s * apk + c * aqk;
+				}
+
+				for (k = 0; k < 3; k++)
+				{
+					vkp = v[k][p];
+					vkq = v[k][q];
+					v[k][p] = c * vkp - s * vkq;
+					v[k][q] = s * vkp + c * vkq;
+				}
+			}
+		}
+	}
+}
+
+///////////////////////////////////////
+
+// Solves the accumulated normal equations and converts the quadric into a
+// hard iron offset and a symmetric soft iron matrix.  Corrected data is
+//
+//   softIron * (raw - offset)
+//
+// which lies on a sphere of the returned radius, the geometric mean of the
+// ellipsoid semi-axes.  Returns false if the data does not describe an
+// ellipsoid, which usually means too little rotation was covered.
+// tools/magCalTest checks the fit against known synthetic ellipsoids.
+
+uint8_t ellipsoidFitSolve(ellipsoidFitData_t *fit, float offset[3], float softIron[3][3], float *radius)
+{
+	uint8_t i, j, k, pivot;
+	double  m[9][10], factor, temp, v[9];
+	float   a[3][3], vec[3][3], inv[3][3], det, scale, sqrtEig[3];
+
+	if (fit->samples < 9)
+		return false;
+
+	///////////////////////////////////
+	// Gaussian elimination with partial pivoting on [D'D | D'1]
+	///////////////////////////////////
+
+	for (i = 0; i < 9; i++)
+	{
+		for (j = 0; j < 9; j++)
+		    m[i][j] = (j >= i) ? fit->dtd[i][j] : fit->dtd[j][i];
+
+		m[i][9] = fit->dto[i];
+	}
+
+	for (i = 0; i < 9; i++)
+	{
+		pivot = i;
+
+		for (j = i + 1; j < 9; j++)
+			if (fabs(m[j][i]) > fabs(m[pivot][i]))
+				pivot = j;
+
+		if (fabs(m[pivot][i]) < 1.0e-12 * fabs(m[0][0]))
+			return false;
+
+		if (pivot != i)
+		{
+			for (k = i; k < 10; k++)
+			{
+				temp        = m[i][k];
+				m[i][k]     = m[pivot][k];
+				m[pivot][k] = temp;
+			}
+		}
+
+		for (j = i + 1; j < 9; j++)
+		{
+			factor = m[j][i] / m[i][i];
+
+			for (k = i; k < 10; k++)
+				m[j][k] -= factor * m[i][k];
+		}
+	}
+
+	for (i = 9; i-- > 0; )
+	{
+		temp = m[i][9];
+
+		for (k = i + 1; k < 9; k++)
+			temp -= m[i][k] * v[k];
+
+		v[i] = temp / m[i][i];
+	}
+
+	///////////////////////////////////
+	// Center = -A^-1 * [g h i]
+	///////////////////////////////////
+
+	a[0][0] = v[0]; a[0][1] = v[3]; a[0][2] = v[4];
+	a[1][0] = v[3]; a[1][1] = v[1]; a[1][2] = v[5];
+	a[2][0] = v[4]; a[2][1] = v[5]; a[2][2] = v[2];
+
+	inv[0][0] = a[1][1] * a[2][2] - a[1][2] * a[2][1];
+	inv[0][1] = a[0][2] * a[2][1] - a[0][1] * a[2][2];
+	inv[0][2] = a[0][1] * a[1][2] - a[0][2] * a[1][1];
+	inv[1][1] = a[0][0] * a[2][2] - a[0][2] * a[2][0];
+	inv[1][2] = a[0][2] * a[1][0] - a[0][0] * a[1][2];
+	inv[2][2] = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+	inv[1][0] = inv[0][1];
+	inv[2][0] = inv[0][2];
+	inv[2][1] = inv[1][2];
+
+	det = a[0][0] * inv[0][0] + a[0][1] * inv[1][0] + a[0][2] * inv[2][0];
+
+	if (det == 0.0f)
+		return false;
+
+	for (i = 0; i < 3; i++)
+		offset[i] = -(inv[i][0] * (float)v[6] + inv[i][1] * (float)v[7] + inv[i][2] * (float)v[8]) / det;
+
+	///////////////////////////////////
+	// Shape matrix A / (1 + c'Ac)
+	///////////////////////////////////
+
+	scale = 1.0f;
+
+	for (i = 0; i < 3; i++)
+		for (j = 0; j < 3; j++)
+			scale += offset[i] * a[i][j] * offset[j];
+
+	if (scale <= 0.0f)
+		return false;
+
+	for (i = 0; i < 3; i++)
+		for (j = 0; j < 3; j++)
+			a[i][j] /= scale;
+
+	///////////////////////////////////
+	// Soft iron = R * V * sqrt(L) * V'
+	///////////////////////////////////
+
+	jacobi3x3(a, vec);
+
+	if ((a[0][0] <= 0.0f) || (a[1][1] <= 0.0f) || (a[2][2] <= 0.0f))
+		return false;
+
+	for (i = 0; i < 3; i++)
+		sqrtEig[i] = sqrtf(a[i][i]);
+
+	// Geometric mean of the semi-axes 1/sqrt(L) keeps the corrected field strength
+
+	*radius = 1.0f / powf(sqrtEig[0] * sqrtEig[1] * sqrtEig[2], 1.0f / 3.0f);
+
+	for (i = 0; i < 3; i++)
+	{
+		for (j = 0; j < 3; j++)
+		{
+			softIron[i][j] = 0.0f;
+
+			for (k = 0; k < 3; k++)
+				softIron[i][j] += vec[i][k] * sqrtEig[k] * vec[j][k];
+
+			softIron[i][j] *= *radius;
+		}
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Pressure to Altitude
+///////////////////////////////////////////////////////////////////////////////
+
+// Altitude in mm from h = 44330 * (1 - (p / 101325)^0.190295), sampled at
+// 32 equal steps per pressure octave from 512 Pa to 131072 Pa.  Each octave
+// carries two extra points so the quadratic interpolation never has to
+// cross into the next octave.  Worst case error is 0.022 m over 1000 Pa to
+// 120000 Pa, the full MS5611 range, tools/altitudeTest checks it.
+
+#define ALTITUDE_TABLE_MIN_OCTAVE   9
+#define ALTITUDE_TABLE_MAX_OCTAVE  17
+#define ALTITUDE_TABLE_SUB_BITS     5
+#define ALTITUDE_TABLE_OCTAVE_SIZE ((1 << ALTITUDE_TABLE_SUB_BITS) + 2)
+
+static const int32_t altitudeTable[(ALTITUDE_TABLE_MAX_OCTAVE - ALTITUDE_TABLE_MIN_OCTAVE) * ALTITUDE_TABLE_OCTAVE_SIZE] =
+{
+    //    512 Pa
+     28123269,  28028089,  27935217,  27844530,  27755918,  27669277,  27584512,  27501534,
+     27420261,  27340617,  27262531,  27185936,  27110770,  27036975,  26964496,  26893281,
+     26823283,  26754457,  26686758,  26620147,  26554585,  26490036,  26426466,  26363842,
+     26302133,  26241310,  26181346,  26122212,  26063885,  26006339,  25949553,  25893503,
+     25838169,  25783531,
+    //   1024 Pa
+     25838169,  25729569,  25623601,  25520128,  25419022,  25320165,  25223448,  25128770,
+     25036038,  24945165,  24856069,  24768674,  24682910,  24598710,  24516012,  24434756,
+     24354889,  24276358,  24199113,  24123110,  24048304,  23974654,  23902121,  23830667,
+     23760258,  23690859,  23622440,  23554969,  23488417,  23422758,  23357965,  23294012,
+     23230876,  23168534,
+    //   2048 Pa
+     23230876,  23106964,  22986055,  22867993,  22752631,  22639835,  22529481,  22421454,
+     22315648,  22211961,  22110303,  22010586,  21912729,  21816657,  21722299,  21629586,
+     21538458,  21448854,  21360719,  21273999,  21188646,  21104612,  21021851,  20940323,
+     20859986,  20780802,  20702736,  20625752,  20549817,  20474900,  20400971,  20328001,
+     20255963,  20184831,
+    //   4096 Pa
+     20255963,  20114579,  19976623,  19841914,  19710287,  19581587,  19455674,  19332415,
+     19211690,  19093384,  18977392,  18863616,  18751961,  18642344,  18534681,  18428896,
+     18324919,  18222681,  18122119,  18023173,  17925785,  17829902,  17735472,  17642449,
+     17550784,  17460436,  17371362,  17283524,  17196882,  17111402,  17027049,  16943791,
+     16861596,  16780434,
+    //   8192 Pa
+     16861596,  16700278,  16542870,  16389168,  16238981,  16092135,  15948468,  15807831,
+     15670084,  15535097,  15402751,  15272932,  15145535,  15020461,  14897618,  14776918,
+     14658281,  14541628,  14426886,  14313989,  14202869,  14093467,  13985724,  13879584,
+     13774995,  13671908,  13570275,  13470052,  13371194,  13273661,  13177415,  13082418,
+     12988633,  12896028,
+    //  16384 Pa
+     12988633,  12804569,  12624968,  12449594,  12278231,  12110681,  11946757,  11786290,
+     11629121,  11475102,  11324095,  11175972,  11030613,  10887904,  10747740,  10610022,
+     10474657,  10341556,  10210637,  10081821,   9955034,   9830207,   9707272,   9586167,
+      9466831,   9349209,   9233246,   9118891,   9006095,   8894811,   8784994,   8676602,
+      8569595,   8463932,
+    //  32768 Pa
+      8569595,   8359578,   8154654,   7954552,   7759028,   7567853,   7380817,   7197725,
+      7018396,   6842660,   6670362,   6501354,   6335499,   6172669,   6012742,   5855607,
+      5701155,   5549288,   5399909,   5252931,   5108267,   4965839,   4825571,   4687390,
+      4551229,   4417023,   4284709,   4154231,   4025530,   3898555,   3773255,   3649580,
+      3527485,   3406924,
+    //  65536 Pa
+      3527485,   3287857,   3054038,   2825723,   2602631,   2384501,   2171093,   1962186,
+      1757571,   1557058,   1360466,   1167628,    978388,    792599,    610124,    430833,
+       254604,     81324,    -89117,   -256819,   -421879,   -584389,   -744435,   -902099,
+     -1057458,  -1210587,  -1361556,  -1510432,  -1657279,  -1802157,  -1945125,  -2086237,
+     -2225548,  -2363107
+};
+
+///////////////////////////////////////
+
+float pressureToAltitude(int32_t pressure)
+{
+    const int32_t *y;
+    int32_t octave, shift, t, d1, d2, altitude;
+
+    if (pressure < (1 << ALTITUDE_TABLE_MIN_OCTAVE))
+    	pressure = (1 << ALTITUDE_TABLE_MIN_OCTAVE);
+
+    if (pressure > ((1 << ALTITUDE_TABLE_MAX_OCTAVE) - 1))
+    	pressure = ((1 << ALTITUDE_TABLE_MAX_OCTAVE) - 1);
+
+    octave = 31 - __CLZ(pressure);
+    shift  = octave - ALTITUDE_TABLE_SUB_BITS;
+
+    y = &altitudeTable[(octave - ALTITUDE_TABLE_MIN_OCTAVE) * ALTITUDE_TABLE_OCTAVE_SIZE +
+                       ((pressure >> shift) & ((1 << ALTITUDE_TABLE_SUB_BITS) - 1))];
+
+    // Fraction of the table step in Q16, then Newton forward differences
+
+    t  = (pressure & ((1 << shift) - 1)) << (16 - shift);
+
+    d1 = y[1] - y[0];
+    d2 = y[2] - 2 * y[1] + y[0];
+
+    altitude = y[0] + (int32_t)(((int64_t)d1 * t) >> 16)
+                    + ((d2 * (int32_t)(((int64_t)t * (t - 65536)) >> 17)) >> 16);
+
+    return (float)altitude * 0.001f;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //  Standard Radian Format Limiter
 ////////////////////////////////////////////////////////////////////////////////
@@ -78,6 +78,30 @@ uint16_t sphereFit(float    d[][3],
 		           float    SphereOrigin[],
 		           float    * SphereRadius);
 
+///////////////////////////////////////////////////////////////////////////////
+//  Streaming Least Squares Fit an Ellipsoid to 3D Data
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct ellipsoidFitData {
+    double   dtd[9][9];
+    double   dto[9];
+    uint16_t samples;
+} ellipsoidFitData_t;
+
+///////////////////////////////////////
+
+void ellipsoidFitInit(ellipsoidFitData_t *fit);
+
+void ellipsoidFitAccumulate(ellipsoidFitData_t *fit, float x, float y, float z);
+
+uint8_t ellipsoidFitSolve(ellipsoidFitData_t *fit, float offset[3], float softIron[3][3], float *radius);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Pressure to Altitude
+///////////////////////////////////////////////////////////////////////////////
+
+float pressureToAltitude(int32_t pressure);
+
 ///////////////////////////////////////////////////////////////////////////////
 //  Standard Radian Format Limiter
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,112 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+// Altitude Test
+//
+// Sweeps src/utilities.c pressureToAltitude() across 1 to 120 kPa, every
+// pascal, against the barometric formula in double precision, and fails if
+// the error ever passes the bound the table is documented to.  The sensor
+// CLI 'g' still gives the cycle comparison on the board.
+//
+//   gcc -O2 -Itools/altitudeTest -I- -Isrc -o altitudeTest
+//       tools/altitudeTest/altitudeTest.c src/utilities.c -lm
+//
+//   altitudeTest [-l low Pa] [-h high Pa] [-b bound m]
+//
+// -I- keeps the sources' own directory from supplying the real board.h.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+#include <unistd.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define ALTITUDE_ERROR_BOUND  0.022  // m, as stated at the table in src/utilities.c
+
+///////////////////////////////////////////////////////////////////////////////
+// Firmware Hooks
+///////////////////////////////////////////////////////////////////////////////
+
+char _ebss;
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char *argv[])
+{
+    int32_t pressure, low = 1000, high = 120000, worstPressure = 0;
+    double  bound = ALTITUDE_ERROR_BOUND;
+    double  altitude, error, worstError = 0.0, sumError = 0.0;
+    int     option, failures = 0;
+
+    while ((option = getopt(argc, argv, "l:h:b:")) != -1)
+    {
+        switch (option)
+        {
+            case 'l': low   = atoi(optarg); break;
+            case 'h': high  = atoi(optarg); break;
+            case 'b': bound = atof(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-l low Pa] [-h high Pa] [-b bound m]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    for (pressure = low; pressure <= high; pressure++)
+    {
+        altitude = 44330.0 * (1.0 - pow(pressure / 101325.0, 0.190295));
+
+        error = fabs(pressureToAltitude(pressure) - altitude);
+
+        sumError += error;
+
+        if (error > worstError)
+        {
+            worstError    = error;
+            worstPressure = pressure;
+        }
+
+        if (error > bound)
+        {
+            if (failures < 10)
+                printf("FAIL %6d Pa: table %10.3f m, pow %10.3f m, error %.4f m\n",
+                       pressure, pressureToAltitude(pressure), altitude, error);
+
+            failures++;
+        }
+    }
+
+    printf("%d to %d Pa: worst error %.4f m at %d Pa, mean %.4f m, bound %.4f m, %d over\n",
+           low, high, worstError, worstPressure, sumError / (high - low + 1), bound, failures);
+
+    return failures ? 1 : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
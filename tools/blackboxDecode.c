@@ -0,0 +1,404 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+// Blackbox Decoder
+//
+// Host side decoder for the SPI flash blackbox (blackbox.c), reading either
+// a CLI download capture (Blackbox CLI 'd') or a raw flash image.  Every log
+// found becomes CSV rows in engineering units, one per frame.  Without -p
+// the logs go to stdout behind a log number column, with it each log goes to
+// its own prefix_N.csv.  A summary of each log goes to stderr, -v adds the
+// mean bytes a value takes in P frames for each group, groups skipped as
+// predicted count as none.
+//
+//   gcc -O2 -o blackboxDecode blackboxDecode.c
+//   blackboxDecode [-v] [-p prefix] capture.bin > flights.csv
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define BLACKBOX_VERSION 1
+#define MAX_GROUPS       16
+#define MAX_FIELDS       64
+
+enum { PREDICT_PREVIOUS, PREDICT_LINEAR, PREDICT_AVERAGE };
+
+static const char *predictorNames[] = { "previous", "linear", "average" };
+
+static const char *groupNames[] = { "gyro", "accel", "attitude", "rateCmd", "ratePID", "motor", "rxCommand" };
+
+static const char *axisNames[]  = { "Roll", "Pitch", "Yaw" };
+static const char *accelNames[] = { "X", "Y", "Z" };
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void fieldName(int group, int index, char *name, size_t size)
+{
+    const char *groupName = (group < (int)(sizeof(groupNames) / sizeof(groupNames[0]))) ? groupNames[group] : "group";
+
+    if ((group == 1) && (index < 3))
+        snprintf(name, size, "%s%s", groupName, accelNames[index]);
+    else if ((group <= 4) && (index < 3))
+        snprintf(name, size, "%s%s", groupName, axisNames[index]);
+    else
+        snprintf(name, size, "%s%d", groupName, index + 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct reader_t
+{
+    const uint8_t *p;
+    const uint8_t *end;
+    int            ok;
+} reader_t;
+
+static uint32_t readUnsigned(reader_t *r)
+{
+    uint32_t value = 0;
+    int      shift = 0;
+    uint8_t  byte;
+
+    do
+    {
+        if ((r->p >= r->end) || (shift > 28))
+        {
+            r->ok = 0;
+            return 0;
+        }
+
+        byte   = *r->p++;
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    return value;
+}
+
+static int32_t readSigned(reader_t *r)
+{
+    uint32_t value = readUnsigned(r);
+
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);  // Zigzag
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static long findTag(const uint8_t *data, long size, long from, const char *tag)
+{
+    for (; from + 4 <= size; from++)
+        if (memcmp(&data[from], tag, 4) == 0)
+            return from;
+
+    return -1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char *argv[])
+{
+    FILE       *in = stdin, *out = stdout;
+    const char *prefix = NULL;
+    int         verbose = 0, option;
+    uint8_t    *data;
+    long        size, capacity = 1 << 20, start, from = 0;
+    int         log = 0;
+
+    while ((option = getopt(argc, argv, "vp:")) != -1)
+    {
+        switch (option)
+        {
+            case 'v': verbose = 1;      break;
+            case 'p': prefix  = optarg; break;
+            default:
+                fprintf(stderr, "usage: %s [-v] [-p prefix] [capture]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    if ((optind < argc) && ((in = fopen(argv[optind], "rb")) == NULL))
+    {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    data = malloc(capacity);
+
+    for (size = 0; !feof(in); )
+    {
+        if (size == capacity)
+            data = realloc(data, capacity *= 2);
+
+        size += fread(&data[size], 1, capacity - size, in);
+    }
+
+    if ((start = findTag(data, size, 0, "FFBD")) >= 0 && (start + 8 <= size))
+    {
+        uint32_t length;
+
+        memcpy(&length, &data[start + 4], 4);
+
+        if ((size - start - 8) < (long)length)
+            fprintf(stderr, "Download of %lu bytes, capture holds %ld\n", (unsigned long)length, size - start - 8);
+
+        from = start + 8;
+    }
+
+    while ((start = findTag(data, size, from, "FFBB")) >= 0)
+    {
+        reader_t  r;
+        int       groups, interval, period, predictor[MAX_GROUPS], count[MAX_GROUPS];
+        int       fieldGroup[MAX_FIELDS], fields = 0, g, i, f;
+        float     scale[MAX_FIELDS], groupScale;
+        int16_t   last[MAX_FIELDS], before[MAX_FIELDS], value[MAX_FIELDS];
+        uint32_t  startTime, time = 0, lastTime = 0;
+        long      iFrames = 0, pFrames = 0, frameBytes = 0, drops = -1;
+        long      groupBytes[MAX_GROUPS] = { 0 };
+        const uint8_t *p = &data[start + 4], *frame;
+        const char    *ending = "no end marker, power lost?";
+
+        from = start + 4;
+
+        if ((start + 13 > size) || (p[0] != BLACKBOX_VERSION) || (p[1] > MAX_GROUPS) || (start + 13 + p[1] * 6 > size))
+        {
+            fprintf(stderr, "Skipping a log header at %ld, version %d, this decoder reads %d\n", start, p[0], BLACKBOX_VERSION);
+            continue;
+        }
+
+        groups   = p[1];
+        interval = p[2];
+        period   = p[3] | (p[4] << 8);
+        memcpy(&startTime, &p[5], 4);
+        p += 9;
+
+        for (g = 0; g < groups; g++)
+        {
+            count[g] = p[0];
+            memcpy(&groupScale, &p[1], 4);
+            predictor[g] = p[5];
+            p += 6;
+
+            for (i = 0; i < count[g]; i++)
+            {
+                if (fields >= MAX_FIELDS)
+                    return 1;
+
+                fieldGroup[fields] = g;
+                scale[fields++]    = groupScale;
+            }
+        }
+
+        log++;
+
+        if (prefix != NULL)
+        {
+            char name[256];
+
+            snprintf(name, sizeof(name), "%s_%d.csv", prefix, log);
+
+            if ((out = fopen(name, "w")) == NULL)
+            {
+                perror(name);
+                return 1;
+            }
+        }
+
+        if ((prefix != NULL) || (log == 1))
+        {
+            if (prefix == NULL)
+                fprintf(out, "log,");
+
+            fprintf(out, "timeUs");
+
+            for (g = 0; g < groups; g++)
+            {
+                for (i = 0; i < count[g]; i++)
+                {
+                    char name[32];
+
+                    fieldName(g, i, name, sizeof(name));
+                    fprintf(out, ",%s", name);
+                }
+            }
+
+            fprintf(out, "\n");
+        }
+
+        r.end = &data[size];
+
+        for (;;)
+        {
+            frame = p;
+            r.p   = p + 1;
+            r.ok  = 1;
+
+            if (p >= r.end)
+            {
+                ending = "capture ends";
+                break;
+            }
+
+            if (*p == 'I')
+            {
+                time = readUnsigned(&r);
+
+                for (f = 0; f < fields; f++)
+                    value[f] = (int16_t)readSigned(&r);
+
+                memcpy(before, value, sizeof(value));
+            }
+            else if ((*p == 'P') && (iFrames > 0))
+            {
+                uint32_t predicted;
+
+                time      = lastTime + period + readSigned(&r);
+                predicted = readUnsigned(&r);
+
+                for (f = 0; f < fields; f++)
+                {
+                    const uint8_t *fieldStart = r.p;
+                    int32_t        prediction;
+
+                    switch (predictor[fieldGroup[f]])
+                    {
+                        case PREDICT_LINEAR:
+                            prediction = 2 * (int32_t)last[f] - before[f];
+                            break;
+
+                        case PREDICT_AVERAGE:
+                            prediction = ((int32_t)last[f] + before[f]) / 2;
+                            break;
+
+                        default:
+                            prediction = last[f];
+                            break;
+                    }
+
+                    if ((predicted & (1u << fieldGroup[f])) == 0)
+                        prediction += readSigned(&r);
+
+                    value[f] = (int16_t)prediction;
+
+                    groupBytes[fieldGroup[f]] += r.p - fieldStart;
+                }
+
+                memcpy(before, last, sizeof(last));
+            }
+            else if (*p == 'E')
+            {
+                drops = readUnsigned(&r);
+
+                ending = r.ok ? "end marker" : "capture ends";
+                p      = r.p;
+                break;
+            }
+            else
+            {
+                break;
+            }
+
+            if (r.ok == 0)
+            {
+                ending = "capture ends mid frame";
+                break;
+            }
+
+            if (findTag(frame, r.p - frame, 0, "FFBB") >= 0)  // Torn by a power loss, the next log follows
+            {
+                ending = "no end marker, power lost?";
+                break;
+            }
+
+            if (*frame == 'I')
+                iFrames++;
+            else
+                pFrames++;
+
+            memcpy(last, value, sizeof(value));
+            lastTime    = time;
+            frameBytes += r.p - frame;
+            p           = r.p;
+
+            if (prefix == NULL)
+                fprintf(out, "%d,", log);
+
+            fprintf(out, "%lu", (unsigned long)time);
+
+            for (f = 0; f < fields; f++)
+                fprintf(out, ",%.6g", value[f] / scale[f]);
+
+            fprintf(out, "\n");
+        }
+
+        from = p - data;
+
+        fprintf(stderr, "Log %d: %ld frames, %ld I, %ld P, %.1f seconds, %ld bytes, %.1f bytes/frame, %.2f:1 against %d byte raw frames, ",
+                log, iFrames + pFrames, iFrames, pFrames, (double)(lastTime - startTime) * 1e-6, frameBytes,
+                (iFrames + pFrames) ? (double)frameBytes / (iFrames + pFrames) : 0.0,
+                frameBytes ? (double)(iFrames + pFrames) * (4 + fields * 2) / frameBytes : 0.0, 4 + fields * 2);
+
+        if (drops >= 0)
+            fprintf(stderr, "%ld dropped, ", drops);
+
+        fprintf(stderr, "%s\n", ending);
+
+        if (verbose && (pFrames > 0))
+        {
+            for (g = 0; g < groups; g++)
+                fprintf(stderr, "    %-10s %-8s  %.2f bytes/value in P frames\n",
+                        (g < (int)(sizeof(groupNames) / sizeof(groupNames[0]))) ? groupNames[g] : "group",
+                        (predictor[g] < 3) ? predictorNames[predictor[g]] : "?",
+                        (double)groupBytes[g] / ((double)pFrames * count[g]));
+
+            fprintf(stderr, "    I frame interval %d, %d uSec period\n", interval, period);
+        }
+
+        if (prefix != NULL)
+            fclose(out);
+    }
+
+    if (log == 0)
+    {
+        fprintf(stderr, "No blackbox log found\n");
+        return 1;
+    }
+
+    free(data);
+
+    return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
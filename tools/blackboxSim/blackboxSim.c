@@ -0,0 +1,610 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+// Blackbox Simulator
+//
+// Runs the firmware blackbox, flight recorder sampling and SPI flash driver
+// on the host against a model of the M25P16, for checking the log format,
+// the page queue and the compression before flying.  The model enforces
+// the chip's rules, write enable before program or erase, nothing but a
+// status read while busy, programming only clears bits, and counts every
+// break of them.  Time advances by the SPI bytes clocked, so the driver's
+// own cycle counts estimate the polled transfer cost on the board.
+//
+//   gcc -O2 -DREV5 -Itools/blackboxSim -I- -Isrc -Isrc/drv -o blackboxSim
+//       tools/blackboxSim/blackboxSim.c src/blackbox.c src/flightRecorder.c
+//       src/drv/drv_spiFlash.c -lm
+//
+//   blackboxSim [-f flights] [-s seconds] [-d divider] [-i image] [-o image]
+//               [-c capture] [-r reference.csv] [-k]
+//
+//   -i  start from an existing flash image, logs are appended
+//   -o  flash image written at the end, blackbox.bin by default
+//   -c  CLI download stream, as captured from the Blackbox CLI 'd', not with -k
+//   -r  the values logged, one row per frame as blackboxDecode prints them
+//   -k  the last flight loses power instead of disarming
+//
+// -I- keeps the sources' own directory from supplying the real board.h.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+#include <time.h>
+#include <unistd.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// Simulated Firmware Globals
+///////////////////////////////////////////////////////////////////////////////
+
+sensors_t      sensors;
+
+float          rateCmd[3];
+float          ratePID[3];
+float          motor[8];
+float          rxCommand[8];
+
+float          accelOneG = 9.8065f;
+
+uint8_t        armed      = false;
+uint8_t        sysIdState = SYSID_IDLE;
+
+eepromConfig_t eepromConfig;
+
+GPIO_TypeDef   simGPIOB;
+SPI_TypeDef    simSPI2;
+
+void (*cliPortPrintBinary)(uint8_t *buf, uint16_t length);
+
+uint16_t evrSeverity(uint16_t evr)
+{
+    return evr >> 14;
+}
+
+int evrRegisterListener(void (*listener)(evr_t e))
+{
+    return 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Simulated Time
+///////////////////////////////////////////////////////////////////////////////
+
+#define SPI_BYTE_NS     700       // 444 nSec on the wire at 18 MHz, plus the polled StdPeriph calls, an estimate
+#define CS_NS           100
+#define FRAME_NS        2000000   // 500 Hz
+#define FRAME_WORK_NS   800000    // Sensors, AHRS, PIDs and mixer before the blackbox runs
+#define LOOP_PASS_NS    20000     // Main loop pass between frames
+
+static uint64_t simNs;
+static uint32_t simCycles;
+
+uint32_t micros(void)
+{
+    return (uint32_t)(simNs / 1000);
+}
+
+void delay(unsigned long ms)
+{
+    simNs += (uint64_t)ms * 1000000;
+}
+
+volatile uint32_t *simCycleCounter(void)
+{
+    simCycles = (uint32_t)(simNs * 72 / 1000);
+
+    return &simCycles;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// M25P16 Model
+///////////////////////////////////////////////////////////////////////////////
+
+#define FLASH_SIZE         (2 * 1024 * 1024)
+#define FLASH_PROGRAM_NS   640000         // Page program, typical
+#define FLASH_ERASE_NS     13000000000ULL // Bulk erase, typical
+
+static uint8_t  flash[FLASH_SIZE];
+
+static int      csLow;
+static uint8_t  command;
+static uint32_t byteIndex;
+static uint32_t address;
+static uint8_t  response;
+static int      writeEnabled;
+static uint64_t busyUntilNs;
+
+static uint8_t  latch[256];
+static uint8_t  latched[256];
+
+static uint64_t spiBytes;
+static uint32_t pagePrograms;
+static uint32_t violations;
+
+static void violation(const char *what)
+{
+    if (violations++ < 10)
+        fprintf(stderr, "Flash model: %s at %.6f s\n", what, simNs * 1e-9);
+}
+
+///////////////////////////////////////
+
+static int flashBusy(void)
+{
+    return simNs < busyUntilNs;
+}
+
+///////////////////////////////////////
+
+static void flashSelect(void)
+{
+    csLow     = 1;
+    byteIndex = 0;
+    address   = 0;
+
+    memset(latched, 0, sizeof(latched));
+
+    simNs += CS_NS;
+}
+
+///////////////////////////////////////
+
+static void flashDeselect(void)
+{
+    int index;
+
+    csLow  = 0;
+    simNs += CS_NS;
+
+    if (byteIndex == 0)
+        return;
+
+    switch (command)
+    {
+        case 0x06:  // Write enable
+            writeEnabled = 1;
+            break;
+
+        case 0x02:  // Page program
+            if (byteIndex <= 4)
+                break;
+
+            if (writeEnabled == 0)
+            {
+                violation("page program without write enable");
+                break;
+            }
+
+            for (index = 0; index < 256; index++)
+            {
+                if (latched[index])
+                {
+                    uint32_t target = (address & ~0xFFu) | index;
+
+                    if ((flash[target] & latch[index]) != latch[index])
+                        violation("program over unerased bits");
+
+                    flash[target] &= latch[index];
+                }
+            }
+
+            pagePrograms++;
+            writeEnabled = 0;
+            busyUntilNs  = simNs + FLASH_PROGRAM_NS;
+            break;
+
+        case 0xC7:  // Bulk erase
+            if (writeEnabled == 0)
+            {
+                violation("bulk erase without write enable");
+                break;
+            }
+
+            memset(flash, 0xFF, sizeof(flash));
+
+            writeEnabled = 0;
+            busyUntilNs  = simNs + FLASH_ERASE_NS;
+            break;
+    }
+}
+
+///////////////////////////////////////
+
+static uint8_t flashTransfer(uint8_t in)
+{
+    static const uint8_t jedecId[3] = { 0x20, 0x20, 0x15 };
+
+    uint8_t out = 0xFF;
+
+    if (csLow == 0)
+        violation("clocked without chip select");
+
+    if (byteIndex == 0)
+    {
+        command = in;
+
+        if (flashBusy() && (command != 0x05))
+            violation("command while busy");
+    }
+    else
+    {
+        switch (command)
+        {
+            case 0x9F:  // Read ID
+                if (byteIndex <= 3)
+                    out = jedecId[byteIndex - 1];
+                break;
+
+            case 0x05:  // Read status
+                out = (flashBusy() ? 0x01 : 0x00) | (writeEnabled ? 0x02 : 0x00);
+                break;
+
+            case 0x03:  // Read data
+                if (byteIndex <= 3)
+                    address = (address << 8) | in;
+                else
+                    out = flash[address++ % FLASH_SIZE];
+                break;
+
+            case 0x02:  // Page program, wraps within the page
+                if (byteIndex <= 3)
+                {
+                    address = (address << 8) | in;
+                }
+                else
+                {
+                    uint8_t index = (uint8_t)(address + byteIndex - 4);
+
+                    latch[index]   = in;
+                    latched[index] = 1;
+                }
+                break;
+        }
+    }
+
+    byteIndex++;
+    spiBytes++;
+
+    simNs += SPI_BYTE_NS;
+
+    return out;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// StdPeriph Subset
+///////////////////////////////////////////////////////////////////////////////
+
+void RCC_APB1PeriphClockCmd(uint32_t periph, int state)
+{
+}
+
+void GPIO_Init(GPIO_TypeDef *gpio, GPIO_InitTypeDef *init)
+{
+}
+
+void GPIO_SetBits(GPIO_TypeDef *gpio, uint16_t pins)
+{
+    if (pins & GPIO_Pin_12)
+        flashDeselect();
+}
+
+void GPIO_ResetBits(GPIO_TypeDef *gpio, uint16_t pins)
+{
+    if (pins & GPIO_Pin_12)
+        flashSelect();
+}
+
+void SPI_Init(SPI_TypeDef *spi, SPI_InitTypeDef *init)
+{
+}
+
+void SPI_Cmd(SPI_TypeDef *spi, int state)
+{
+}
+
+int SPI_I2S_GetFlagStatus(SPI_TypeDef *spi, uint16_t flag)
+{
+    return SET;
+}
+
+void SPI_I2S_SendData(SPI_TypeDef *spi, uint16_t data)
+{
+    response = flashTransfer((uint8_t)data);
+}
+
+uint16_t SPI_I2S_ReceiveData(SPI_TypeDef *spi)
+{
+    return response;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Synthetic Flight
+//
+// Stick moves at the 50 Hz receiver rate, rates following them through a
+// lag, vibration and sensor noise on top, motors mixing the rate PIDs.
+///////////////////////////////////////////////////////////////////////////////
+
+static float noise(float amplitude)
+{
+    return amplitude * ((float)rand() / (float)RAND_MAX + (float)rand() / (float)RAND_MAX - 1.0f);
+}
+
+///////////////////////////////////////
+
+static void flightStep(uint32_t frame)
+{
+    static const float mix[6][3] = { { -1.0f,  0.5f,  1.0f }, {  1.0f,  0.5f, -1.0f }, { -1.0f, -0.5f, -1.0f },
+                                     {  1.0f, -0.5f,  1.0f }, { -1.0f,  0.0f,  1.0f }, {  1.0f,  0.0f, -1.0f } };
+    static float rate[3];
+
+    float t = (float)frame * 0.002f;
+    float vibration;
+    int   axis, index;
+
+    if ((frame % 10) == 0)  // New receiver frame
+    {
+        for (axis = 0; axis < 3; axis++)
+            rxCommand[axis] = floorf(400.0f * sinf(t * (0.7f + 0.3f * axis) + axis) * sinf(t * 0.13f));
+
+        rxCommand[3] = 2900.0f + floorf(300.0f * sinf(t * 0.2f));
+
+        for (index = 4; index < 8; index++)
+            rxCommand[index] = (index == 4) ? 4000.0f : 2000.0f;
+    }
+
+    for (axis = 0; axis < 3; axis++)
+    {
+        rateCmd[axis] = rxCommand[axis] * 0.005f;
+        rate[axis]   += (rateCmd[axis] - rate[axis]) * 0.05f;
+
+        vibration = 0.08f * sinf(t * 2.0f * 3.14159f * 173.0f + axis);
+
+        sensors.gyro500Hz[axis]      = rate[axis] + vibration + noise(0.02f);
+        sensors.accel500Hz[axis]     = ((axis == ZAXIS) ? -accelOneG : 0.0f) + 20.0f * vibration + noise(0.3f);
+        sensors.attitude500Hz[axis] += rate[axis] * 0.002f;
+
+        if (sensors.attitude500Hz[axis] > 3.14159f)
+            sensors.attitude500Hz[axis] -= 6.28318f;
+        else if (sensors.attitude500Hz[axis] < -3.14159f)
+            sensors.attitude500Hz[axis] += 6.28318f;
+
+        ratePID[axis] = 150.0f * (rateCmd[axis] - sensors.gyro500Hz[axis]);
+    }
+
+    for (index = 0; index < 6; index++)
+    {
+        motor[index] = rxCommand[3] + noise(4.0f);
+
+        for (axis = 0; axis < 3; axis++)
+            motor[index] += mix[index][axis] * ratePID[axis];
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CLI Download Capture
+///////////////////////////////////////////////////////////////////////////////
+
+static FILE *captureFile;
+
+static void capturePrintBinary(uint8_t *buf, uint16_t length)
+{
+    fwrite(buf, 1, length, captureFile);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char *argv[])
+{
+    int         flights = 2, seconds = 60, divider = 1, powerLoss = 0;
+    const char *inName = NULL, *outName = "blackbox.bin", *captureName = NULL, *refName = NULL;
+    FILE       *file, *ref = NULL;
+    uint32_t    frame = 0, frames, logged, loggedFrames = 0;
+    uint64_t    frameStartNs;
+    uint64_t    startSpiBytes, startNs;
+    double      encodeNs = 0.0;
+    int         flight, option, index;
+
+    while ((option = getopt(argc, argv, "f:s:d:i:o:c:r:k")) != -1)
+    {
+        switch (option)
+        {
+            case 'f': flights     = atoi(optarg); break;
+            case 's': seconds     = atoi(optarg); break;
+            case 'd': divider     = atoi(optarg); break;
+            case 'i': inName      = optarg;       break;
+            case 'o': outName     = optarg;       break;
+            case 'c': captureName = optarg;       break;
+            case 'r': refName     = optarg;       break;
+            case 'k': powerLoss   = 1;            break;
+            default:
+                fprintf(stderr, "usage: %s [-f flights] [-s seconds] [-d divider] [-i image] [-o image] [-c capture] [-r reference.csv] [-k]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    memset(flash, 0xFF, sizeof(flash));
+
+    if (inName != NULL)
+    {
+        if ((file = fopen(inName, "rb")) == NULL)
+        {
+            perror(inName);
+            return 1;
+        }
+
+        fread(flash, 1, sizeof(flash), file);
+        fclose(file);
+    }
+
+    if ((refName != NULL) && ((ref = fopen(refName, "w")) == NULL))
+    {
+        perror(refName);
+        return 1;
+    }
+
+    srand(1);
+
+    eepromConfig.blackboxEnabled = true;
+    eepromConfig.blackboxDivider = divider;
+
+    spiFlashInit();
+    blackboxInit();
+
+    printf("Flash %06X, %u KBytes, %u KBytes in use at start\n\n", spiFlashJedecId, spiFlashSize / 1024, spiFlashUsed() / 1024);
+
+    startSpiBytes = spiBytes;
+    startNs       = simNs;
+
+    for (flight = 1; flight <= flights; flight++)
+    {
+        // 2 seconds disarmed, the flight, 3 seconds disarmed after unless power is lost
+
+        int last    = (flight == flights) && powerLoss;
+        int armAt   = 1000;
+        int disarm  = armAt + seconds * 500;
+        int end     = last ? disarm : disarm + 1500;
+        int step;
+
+        blackboxStateType flown = blackboxState;
+
+        for (step = 0; step < end; step++, frame++)
+        {
+            struct timespec before, after;
+
+            frameStartNs = simNs;
+
+            armed = (step >= armAt) && (step < disarm);
+
+            flightStep(frame);
+
+            simNs += FRAME_WORK_NS;
+
+            logged = blackboxState.iFrameCnt + blackboxState.pFrameCnt;
+
+            clock_gettime(CLOCK_MONOTONIC, &before);
+            blackboxUpdate();
+            clock_gettime(CLOCK_MONOTONIC, &after);
+
+            if ((blackboxState.iFrameCnt + blackboxState.pFrameCnt) != logged)
+            {
+                encodeNs += (after.tv_sec - before.tv_sec) * 1e9 + (after.tv_nsec - before.tv_nsec);
+                loggedFrames++;
+
+                if (ref != NULL)
+                {
+                    int16_t sample[RECORDER_FIELDS];
+                    int     group, field = 0;
+
+                    flightRecorderSample(sample);
+
+                    fprintf(ref, "%u", micros());
+
+                    for (group = 0; group < RECORDER_GROUPS; group++)
+                        for (index = 0; index < recorderGroups[group].count; index++, field++)
+                            fprintf(ref, ",%.6g", sample[field] / recorderGroups[group].scale);
+
+                    fprintf(ref, "\n");
+                }
+            }
+
+            if (step == disarm - 1)
+                flown = blackboxState;
+
+            while (simNs < (frameStartNs + FRAME_NS))
+            {
+                spiFlashService();
+                simNs += LOOP_PASS_NS;
+            }
+        }
+
+        frames = flown.iFrameCnt + flown.pFrameCnt;
+
+        printf("Flight %d: %u frames, %u I, %u P, %u dropped, %.1f KBytes, %.1f bytes/frame, %.2f:1 against %d byte raw frames%s\n",
+               flight, frames, flown.iFrameCnt, flown.pFrameCnt, flown.dropCnt,
+               flown.logBytes / 1024.0, frames ? (double)flown.logBytes / frames : 0.0,
+               flown.logBytes ? (double)flown.rawBytes / flown.logBytes : 0.0,
+               4 + RECORDER_FIELDS * 2, last ? ", power lost" : "");
+    }
+
+    printf("\nFlash: %u pages programmed, queue high water %u of %d pages, %u writes dropped\n",
+           pagePrograms, spiFlashStats.highWater, SPI_FLASH_QUEUE_PAGES, spiFlashStats.dropCnt);
+
+    printf("SPI:   %.1f KBytes clocked, %.2f%% of the time at %d nSec a byte, longest service pass %.1f uSec\n",
+           (spiBytes - startSpiBytes) / 1024.0, 100.0 * (spiBytes - startSpiBytes) * SPI_BYTE_NS / (double)(simNs - startNs),
+           SPI_BYTE_NS, spiFlashStats.cyclesMax / 72.0);
+
+    printf("Encode: %.0f nSec/frame on this host, the Blackbox CLI 'a' gives cycles on the board\n",
+           loggedFrames ? encodeNs / loggedFrames : 0.0);
+
+    printf("Model: %u protocol violations\n", violations);
+
+    if (powerLoss == 0)
+    {
+        while (spiFlashIdle() == false)
+            spiFlashService();
+    }
+
+    printf("Image: %u KBytes used of %u\n", spiFlashUsed() / 1024, spiFlashSize / 1024);
+
+    if ((file = fopen(outName, "wb")) == NULL)
+    {
+        perror(outName);
+        return 1;
+    }
+
+    fwrite(flash, 1, sizeof(flash), file);
+    fclose(file);
+
+    if ((captureName != NULL) && powerLoss)
+    {
+        fprintf(stderr, "No download after a power loss, decode the image\n");
+    }
+    else if (captureName != NULL)
+    {
+        if ((captureFile = fopen(captureName, "wb")) == NULL)
+        {
+            perror(captureName);
+            return 1;
+        }
+
+        cliPortPrintBinary = capturePrintBinary;
+
+        fwrite("Blackbox CLI -> d\n", 1, 18, captureFile);  // Text ahead of the stream, as a terminal capture would have it
+        blackboxDownload();
+
+        fclose(captureFile);
+    }
+
+    if (ref != NULL)
+        fclose(ref);
+
+    return violations ? 1 : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
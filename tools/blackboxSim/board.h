@@ -0,0 +1,185 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+// Blackbox Simulator Board
+//
+// Stands in for src/board.h so src/blackbox.c, src/flightRecorder.c and
+// src/drv/drv_spiFlash.c build on the host.  The StdPeriph SPI and GPIO
+// calls land in the flash chip model in blackboxSim.c.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <string.h>
+#include <stdio.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define XAXIS    0
+#define YAXIS    1
+#define ZAXIS    2
+
+#define SQR(x)  ((x) * (x))
+
+typedef struct sensors_t
+{
+    float accel500Hz[3];
+    float attitude500Hz[3];
+    float gyro500Hz[3];
+} sensors_t;
+
+extern sensors_t sensors;
+
+extern float rateCmd[3];
+extern float ratePID[3];
+extern float motor[8];
+extern float rxCommand[8];
+
+extern float accelOneG;
+
+extern uint8_t armed;
+
+typedef struct eepromConfig_t
+{
+    uint8_t blackboxEnabled;
+    uint8_t blackboxDivider;
+} eepromConfig_t;
+
+extern eepromConfig_t eepromConfig;
+
+///////////////////////////////////////////////////////////////////////////////
+
+enum { SYSID_IDLE, SYSID_PENDING, SYSID_RUNNING, SYSID_COMPLETE };
+
+extern uint8_t sysIdState;
+
+typedef struct evr_t
+{
+    uint32_t time;
+    uint16_t evr;
+    uint16_t reason;
+} evr_t;
+
+uint16_t evrSeverity(uint16_t evr);
+int      evrRegisterListener(void (*listener)(evr_t e));
+
+///////////////////////////////////////////////////////////////////////////////
+
+uint32_t micros(void);
+void     delay(unsigned long ms);
+
+volatile uint32_t *simCycleCounter(void);
+
+#define DWT_CYCCNT  (simCycleCounter())  // 72 MHz cycles of simulated time
+
+extern void (*cliPortPrintBinary)(uint8_t *buf, uint16_t length);
+
+///////////////////////////////////////////////////////////////////////////////
+// StdPeriph Subset
+///////////////////////////////////////////////////////////////////////////////
+
+enum { RESET = 0, SET = 1 };
+enum { DISABLE = 0, ENABLE = 1 };
+
+typedef struct { int dummy; } GPIO_TypeDef;
+typedef struct { int dummy; } SPI_TypeDef;
+
+extern GPIO_TypeDef simGPIOB;
+extern SPI_TypeDef  simSPI2;
+
+#define GPIOB  (&simGPIOB)
+#define SPI2   (&simSPI2)
+
+#define GPIO_Pin_12  0x1000
+#define GPIO_Pin_13  0x2000
+#define GPIO_Pin_14  0x4000
+#define GPIO_Pin_15  0x8000
+
+enum { GPIO_Mode_IN_FLOATING, GPIO_Mode_Out_PP, GPIO_Mode_AF_PP };
+enum { GPIO_Speed_50MHz };
+
+typedef struct
+{
+    uint16_t GPIO_Pin;
+    int      GPIO_Speed;
+    int      GPIO_Mode;
+} GPIO_InitTypeDef;
+
+typedef struct
+{
+    uint16_t SPI_Direction;
+    uint16_t SPI_Mode;
+    uint16_t SPI_DataSize;
+    uint16_t SPI_CPOL;
+    uint16_t SPI_CPHA;
+    uint16_t SPI_NSS;
+    uint16_t SPI_BaudRatePrescaler;
+    uint16_t SPI_FirstBit;
+    uint16_t SPI_CRCPolynomial;
+} SPI_InitTypeDef;
+
+#define SPI_Direction_2Lines_FullDuplex  0
+#define SPI_Mode_Master                  1
+#define SPI_DataSize_8b                  0
+#define SPI_CPOL_High                    1
+#define SPI_CPHA_2Edge                   1
+#define SPI_NSS_Soft                     1
+#define SPI_BaudRatePrescaler_2          0
+#define SPI_FirstBit_MSB                 0
+
+#define SPI_I2S_FLAG_RXNE  0x01
+#define SPI_I2S_FLAG_TXE   0x02
+
+#define RCC_APB1Periph_SPI2  0x4000
+
+void     RCC_APB1PeriphClockCmd(uint32_t periph, int state);
+void     GPIO_Init(GPIO_TypeDef *gpio, GPIO_InitTypeDef *init);
+void     GPIO_SetBits(GPIO_TypeDef *gpio, uint16_t pins);
+void     GPIO_ResetBits(GPIO_TypeDef *gpio, uint16_t pins);
+void     SPI_Init(SPI_TypeDef *spi, SPI_InitTypeDef *init);
+void     SPI_Cmd(SPI_TypeDef *spi, int state);
+int      SPI_I2S_GetFlagStatus(SPI_TypeDef *spi, uint16_t flag);
+void     SPI_I2S_SendData(SPI_TypeDef *spi, uint16_t data);
+uint16_t SPI_I2S_ReceiveData(SPI_TypeDef *spi);
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "drv_spiFlash.h"
+
+#include "blackbox.h"
+#include "flightRecorder.h"
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,65 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+// DShot Test Board
+//
+// Stands in for src/board.h so src/drv/drv_dshot.c builds on the host.  The
+// DMA channel is plain memory, dshotTest.c plays the controller's part.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define MINCOMMAND  2000
+
+// DMA channel registers as dshotDmaBusy()/dshotDmaArm() use them
+
+typedef struct
+{
+    volatile uint32_t CCR;
+    volatile uint32_t CNDTR;
+} DMA_Channel_TypeDef;
+
+#define DMA_CCR1_EN  0x0001
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "drv_dshot.h"
+
+///////////////////////////////////////////////////////////////////////////////
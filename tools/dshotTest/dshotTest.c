@@ -0,0 +1,238 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+// DShot Test
+//
+// Checks src/drv/drv_dshot.c against hand worked frame vectors, then every
+// value with and without the telemetry bit against the frame layout, 11
+// bit value, telemetry bit and a checksum that XORs the four nibbles to
+// zero, and the motor command to throttle mapping across its whole range.
+// Then runs the trigger path, bit rows filled and a DMA channel armed from
+// the state DMA_Init() leaves it in, through a simulated burst transfer.
+//
+//   gcc -O2 -Itools/dshotTest -I- -Isrc/drv -o dshotTest
+//       tools/dshotTest/dshotTest.c src/drv/drv_dshot.c
+//
+// -I- keeps the sources' own directory from supplying the real board.h.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+static int failures = 0;
+
+static void check(const char *what, uint32_t got, uint32_t expected)
+{
+    if (got != expected)
+    {
+        if (failures < 20)
+            printf("FAIL %s: got 0x%04X, expected 0x%04X\n", what, got, expected);
+
+        failures++;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Frame Vectors
+///////////////////////////////////////////////////////////////////////////////
+
+// value, telemetry, frame as sent MSB first
+
+static const struct
+{
+    uint16_t    value;
+    uint8_t     telemetry;
+    uint16_t    frame;
+    const char *name;
+} frameVectors[] =
+{
+    {    0, 0, 0x0000, "motor stop"                  },
+    {    1, 1, 0x0033, "command 1, beep"             },
+    {    7, 1, 0x00FF, "command 7, spin direction 1" },
+    {   12, 1, 0x0198, "command 12, save settings"   },
+    {   47, 1, 0x05FA, "command 47, last command"    },
+    {   48, 0, 0x0606, "throttle 48, minimum"        },
+    {   48, 1, 0x0617, "throttle 48, telemetry"      },
+    { 1046, 0, 0x82C6, "throttle 1046"               },
+    { 2047, 0, 0xFFEE, "throttle 2047, maximum"      },
+    { 2047, 1, 0xFFFF, "throttle 2047, telemetry"    },
+    { 2048, 0, 0x0000, "value over 11 bits wraps"    },
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Trigger Path
+///////////////////////////////////////////////////////////////////////////////
+
+#define BIT_ONE   90  // DShot600 at 72 MHz, 3/4 and 3/8 of 120
+#define BIT_ZERO  45
+
+// CCR as pwmEscInit() configures it, high priority, half words, memory
+// increment, memory to peripheral, EN clear
+
+#define DMA_CCR_CONFIG  0x2590
+
+static void checkTrigger(void)
+{
+    DMA_Channel_TypeDef dma;
+    uint16_t rows[DSHOT_FRAME_ROWS][4];
+    uint16_t frames[4], received[4] = { 0, 0, 0, 0 };
+    uint8_t  row, column;
+
+    memset(rows, 0, sizeof(rows));
+
+    // DMA_Init() writes CNDTR with the buffer size and leaves the channel off,
+    // that must not read as a frame in progress or no frame is ever sent
+
+    dma.CCR   = DMA_CCR_CONFIG;
+    dma.CNDTR = DSHOT_FRAME_ROWS * 4;
+
+    check("busy after DMA_Init", dshotDmaBusy(&dma), false);
+
+    dma.CNDTR = 0;
+
+    check("busy after init CNDTR cleared", dshotDmaBusy(&dma), false);
+
+    for (column = 0; column < 4; column++)
+    {
+        frames[column] = dshotEncodeFrame(dshotThrottle(MINCOMMAND + 1 + column * 600), 0);
+        dshotFillColumn(rows, column, frames[column], BIT_ONE, BIT_ZERO);
+    }
+
+    dshotDmaArm(&dma);
+
+    check("armed CCR", dma.CCR, DMA_CCR_CONFIG | DMA_CCR1_EN);
+    check("armed CNDTR", dma.CNDTR, DSHOT_FRAME_ROWS * 4);
+    check("busy when armed", dshotDmaBusy(&dma), true);
+
+    // Each timer update bursts one row into CCR1 to CCR4, the pulse width is the bit
+
+    for (row = 0; row < DSHOT_FRAME_ROWS; row++)
+    {
+        check("busy during frame", dshotDmaBusy(&dma), true);
+
+        for (column = 0; column < 4; column++)
+        {
+            if (row < DSHOT_FRAME_BITS)
+            {
+                if ((rows[row][column] != BIT_ONE) && (rows[row][column] != BIT_ZERO))
+                    check("bit row pulse", rows[row][column], BIT_ZERO);
+
+                received[column] = (received[column] << 1) | (rows[row][column] == BIT_ONE);
+            }
+            else
+            {
+                check("trailing row low", rows[row][column], 0);
+            }
+
+            dma.CNDTR--;
+        }
+    }
+
+    for (column = 0; column < 4; column++)
+        check("frame from bit rows", received[column], frames[column]);
+
+    check("busy after frame", dshotDmaBusy(&dma), false);
+
+    dshotDmaArm(&dma);
+
+    check("re-armed CNDTR", dma.CNDTR, DSHOT_FRAME_ROWS * 4);
+
+    // A protocol change disables the channel part way through a frame
+
+    dma.CNDTR = DSHOT_FRAME_ROWS * 2;
+
+    check("busy mid frame", dshotDmaBusy(&dma), true);
+
+    dma.CCR &= ~DMA_CCR1_EN;
+
+    check("busy when disabled mid frame", dshotDmaBusy(&dma), false);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+    char     name[64];
+    uint16_t frame, previous = 0;
+    uint32_t value, telemetry, command;
+    unsigned i;
+
+    for (i = 0; i < sizeof(frameVectors) / sizeof(frameVectors[0]); i++)
+        check(frameVectors[i].name, dshotEncodeFrame(frameVectors[i].value, frameVectors[i].telemetry), frameVectors[i].frame);
+
+    // Every frame decodes back, and its four nibbles XOR to zero
+
+    for (value = 0; value < 2048; value++)
+    {
+        for (telemetry = 0; telemetry < 2; telemetry++)
+        {
+            frame = dshotEncodeFrame(value, telemetry);
+
+            snprintf(name, sizeof(name), "value %u telemetry %u layout", value, telemetry);
+
+            check(name, frame >> 5, value);
+            check(name, (frame >> 4) & 1, telemetry);
+            check(name, (frame ^ (frame >> 4) ^ (frame >> 8) ^ (frame >> 12)) & 0x000F, 0);
+        }
+    }
+
+    // Commands at and below MINCOMMAND stop the motor, the top end saturates,
+    // everything between is throttle, never a special command, and rises
+
+    check("throttle below MINCOMMAND",   dshotThrottle(0),                 0);
+    check("throttle at MINCOMMAND",      dshotThrottle(MINCOMMAND),        0);
+    check("throttle MINCOMMAND + 1",     dshotThrottle(MINCOMMAND + 1),    48);
+    check("throttle MINCOMMAND + 1000",  dshotThrottle(MINCOMMAND + 1000), 1047);
+    check("throttle MINCOMMAND + 1999",  dshotThrottle(MINCOMMAND + 1999), 2046);
+    check("throttle MINCOMMAND + 2000",  dshotThrottle(MINCOMMAND + 2000), 2047);
+    check("throttle above range",        dshotThrottle(0xFFFF),            2047);
+
+    for (command = MINCOMMAND + 1; command <= MINCOMMAND + 2000; command++)
+    {
+        value = dshotThrottle(command);
+
+        snprintf(name, sizeof(name), "command %u", command);
+
+        if ((value < 48) || (value > 2047) || (value < previous))
+            check(name, value, previous);
+
+        previous = value;
+    }
+
+    checkTrigger();
+
+    printf("DShot: %u frame vectors, 4096 frames, 2000 motor commands, trigger path, %d failures\n",
+           (unsigned)(sizeof(frameVectors) / sizeof(frameVectors[0])), failures);
+
+    return failures ? 1 : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
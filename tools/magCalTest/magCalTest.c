@@ -0,0 +1,320 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+// Mag Calibration Test
+//
+// Fits src/utilities.c ellipsoidFitAccumulate()/ellipsoidFitSolve() to
+// synthetic magnetometer data with a known hard iron offset and soft iron
+// distortion, and checks the recovered offset, soft iron matrix and field
+// radius, and that the corrected samples lie on a sphere.  The sensor CLI
+// 'e' still gives the cycle comparison on the board.
+//
+// Raw samples are offset + S * u * field for unit vectors u, S symmetric.
+// The fit is expected to return softIron = cbrt(det S) * S^-1 and
+// radius = cbrt(det S) * field, the correction that keeps the mean field
+// strength.
+//
+//   gcc -O2 -Itools/magCalTest -I- -Isrc -o magCalTest
+//       tools/magCalTest/magCalTest.c src/utilities.c -lm
+//
+//   magCalTest [-v]
+//
+// -I- keeps the sources' own directory from supplying the real board.h.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+#include <unistd.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct magCalCase_t
+{
+    const char *name;
+    float       offset[3];
+    float       distortion[3][3];  // S, symmetric
+    float       field;             // Counts, 0.5 Gauss at 1090 LSB/Gauss is about 545
+    uint16_t    samples;
+    float       noise;             // Counts, uniform +/-, 22500 samples is the 5 minute calibration cap
+    uint8_t     coverage;          // 2 whole sphere, 1 upper hemisphere, 0 one plane
+    uint8_t     fits;              // Whether ellipsoidFitSolve() should succeed
+    float       offsetBound;       // Counts
+    float       softIronBound;     // Largest element error
+    float       sphereBound;       // Largest corrected radius error, fraction of radius
+} magCalCase_t;
+
+static const magCalCase_t magCalCases[] =
+{
+    { "sphere",           {    0.0f,   0.0f,   0.0f }, { { 1.00f, 0.00f, 0.00f }, { 0.00f, 1.00f, 0.00f }, { 0.00f, 0.00f, 1.00f } },
+      545.0f, 2000, 0.0f, 2, true,  0.01f, 1.0e-5f, 1.0e-5f },
+    { "hard iron",        {  120.0f, -85.0f,  40.0f }, { { 1.00f, 0.00f, 0.00f }, { 0.00f, 1.00f, 0.00f }, { 0.00f, 0.00f, 1.00f } },
+      545.0f, 2000, 0.0f, 2, true,  0.01f, 1.0e-5f, 1.0e-5f },
+    { "axis scaling",     {  -60.0f, 210.0f, -15.0f }, { { 1.20f, 0.00f, 0.00f }, { 0.00f, 0.90f, 0.00f }, { 0.00f, 0.00f, 1.05f } },
+      545.0f, 2000, 0.0f, 2, true,  0.01f, 1.0e-5f, 1.0e-5f },
+    { "soft iron",        {   35.0f,  -5.0f, 150.0f }, { { 1.10f, 0.08f, -0.05f }, { 0.08f, 0.92f, 0.06f }, { -0.05f, 0.06f, 1.03f } },
+      545.0f, 2000, 0.0f, 2, true,  0.01f, 1.0e-5f, 1.0e-5f },
+    { "soft iron, noise", {   35.0f,  -5.0f, 150.0f }, { { 1.10f, 0.08f, -0.05f }, { 0.08f, 0.92f, 0.06f }, { -0.05f, 0.06f, 1.03f } },
+      545.0f, 22500, 3.0f, 2, true, 0.2f,  5.0e-4f, 1.0e-3f },
+    { "upper hemisphere", {   35.0f,  -5.0f, 150.0f }, { { 1.10f, 0.08f, -0.05f }, { 0.08f, 0.92f, 0.06f }, { -0.05f, 0.06f, 1.03f } },
+      545.0f, 2000, 0.0f, 1, true,  0.01f, 1.0e-5f, 1.0e-5f },
+    { "one plane",        {   35.0f,  -5.0f, 150.0f }, { { 1.10f, 0.08f, -0.05f }, { 0.08f, 0.92f, 0.06f }, { -0.05f, 0.06f, 1.03f } },
+      545.0f, 2000, 0.0f, 0, false, 0.0f,  0.0f,    0.0f    },
+};
+
+#define NUMBER_OF_CASES  (sizeof(magCalCases) / sizeof(magCalCases[0]))
+
+static int verbose = false;
+
+///////////////////////////////////////////////////////////////////////////////
+// Firmware Hooks
+///////////////////////////////////////////////////////////////////////////////
+
+char _ebss;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Fixed seed generator so every host gives the same samples
+
+static uint32_t randomState;
+
+static double randomUniform(void)
+{
+    randomState = randomState * 1664525UL + 1013904223UL;
+
+    return (double)randomState / 4294967296.0 * 2.0 - 1.0;
+}
+
+///////////////////////////////////////
+
+// Unit vector n of count on a Fibonacci spiral, evenly spread over the
+// sphere, the upper hemisphere, or the equator only
+
+static void unitVector(uint8_t coverage, uint16_t n, uint16_t count, double u[3])
+{
+    double z, r, phi;
+
+    if (coverage == 2)
+        z = 1.0 - (2.0 * n + 1.0) / count;
+    else if (coverage == 1)
+        z = 1.0 - (n + 0.5) / count;
+    else
+        z = 0.0;
+
+    r   = sqrt(1.0 - z * z);
+    phi = n * M_PI * (3.0 - sqrt(5.0));
+
+    u[XAXIS] = r * cos(phi);
+    u[YAXIS] = r * sin(phi);
+    u[ZAXIS] = z;
+}
+
+///////////////////////////////////////
+
+static double det3x3(const double m[3][3])
+{
+    return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+           m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+           m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+
+///////////////////////////////////////
+
+static int runCase(const magCalCase_t *test)
+{
+    ellipsoidFitData_t fit;
+    double   s[3][3], inv[3][3], expectedSoftIron[3][3], u[3], raw[3], det, scale;
+    double   error, corrected, length, offsetError = 0.0, softIronError = 0.0, sphereError = 0.0;
+    float    offset[3], softIron[3][3], radius, sample[3];
+    uint16_t n;
+    uint8_t  i, j, solved;
+    int      failures = 0;
+
+    randomState = 12345;
+
+    for (i = 0; i < 3; i++)
+        for (j = 0; j < 3; j++)
+            s[i][j] = test->distortion[i][j];
+
+    det = det3x3(s);
+
+    for (i = 0; i < 3; i++)
+        for (j = 0; j < 3; j++)
+            inv[j][i] = (s[(i + 1) % 3][(j + 1) % 3] * s[(i + 2) % 3][(j + 2) % 3] -
+                         s[(i + 1) % 3][(j + 2) % 3] * s[(i + 2) % 3][(j + 1) % 3]) / det;
+
+    scale = cbrt(det);
+
+    for (i = 0; i < 3; i++)
+        for (j = 0; j < 3; j++)
+            expectedSoftIron[i][j] = scale * inv[i][j];
+
+    ///////////////////////////////////
+
+    ellipsoidFitInit(&fit);
+
+    for (n = 0; n < test->samples; n++)
+    {
+        unitVector(test->coverage, n, test->samples, u);
+
+        for (i = 0; i < 3; i++)
+        {
+            raw[i] = test->offset[i] + test->noise * randomUniform();
+
+            for (j = 0; j < 3; j++)
+                raw[i] += s[i][j] * u[j] * test->field;
+
+            sample[i] = (float)raw[i];
+        }
+
+        ellipsoidFitAccumulate(&fit, sample[XAXIS], sample[YAXIS], sample[ZAXIS]);
+    }
+
+    solved = ellipsoidFitSolve(&fit, offset, softIron, &radius);
+
+    if (solved != test->fits)
+    {
+        printf("FAIL %-17s fit %s, expected %s\n", test->name,
+               solved ? "solved" : "refused", test->fits ? "solved" : "refused");
+        return 1;
+    }
+
+    if (solved == false)
+    {
+        printf("     %-17s fit refused as expected\n", test->name);
+        return 0;
+    }
+
+    ///////////////////////////////////
+
+    for (i = 0; i < 3; i++)
+    {
+        error = fabs(offset[i] - test->offset[i]);
+
+        if (error > offsetError)
+            offsetError = error;
+
+        for (j = 0; j < 3; j++)
+        {
+            error = fabs(softIron[i][j] - expectedSoftIron[i][j]);
+
+            if (error > softIronError)
+                softIronError = error;
+        }
+    }
+
+    // Corrected noise free samples should all lie on the returned radius
+
+    for (n = 0; n < test->samples; n++)
+    {
+        unitVector(test->coverage, n, test->samples, u);
+
+        length = 0.0;
+
+        for (i = 0; i < 3; i++)
+        {
+            corrected = 0.0;
+
+            for (j = 0; j < 3; j++)
+            {
+                raw[j] = test->offset[j];
+
+                raw[j] += s[j][0] * u[0] * test->field + s[j][1] * u[1] * test->field + s[j][2] * u[2] * test->field;
+
+                corrected += softIron[i][j] * (raw[j] - offset[j]);
+            }
+
+            length += corrected * corrected;
+        }
+
+        error = fabs(sqrt(length) - radius) / radius;
+
+        if (error > sphereError)
+            sphereError = error;
+    }
+
+    error = fabs(radius - scale * test->field) / (scale * test->field);
+
+    if (error > sphereError)
+        sphereError = error;
+
+    ///////////////////////////////////
+
+    if (offsetError > test->offsetBound)
+        failures++;
+
+    if (softIronError > test->softIronBound)
+        failures++;
+
+    if (sphereError > test->sphereBound)
+        failures++;
+
+    printf("%s %-17s offset error %.4f counts, soft iron error %.2e, radius %.2f (%.2f), sphere error %.2e\n",
+           failures ? "FAIL" : "    ", test->name, offsetError, softIronError, radius, scale * test->field, sphereError);
+
+    if (verbose)
+    {
+        printf("       offset % 9.3f % 9.3f % 9.3f\n", offset[XAXIS], offset[YAXIS], offset[ZAXIS]);
+
+        for (i = 0; i < 3; i++)
+            printf("       soft iron % 8.5f % 8.5f % 8.5f   expected % 8.5f % 8.5f % 8.5f\n",
+                   softIron[i][0], softIron[i][1], softIron[i][2],
+                   expectedSoftIron[i][0], expectedSoftIron[i][1], expectedSoftIron[i][2]);
+    }
+
+    return failures ? 1 : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char *argv[])
+{
+    uint8_t testCase;
+    int     option, failures = 0;
+
+    while ((option = getopt(argc, argv, "v")) != -1)
+    {
+        switch (option)
+        {
+            case 'v': verbose = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-v]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    for (testCase = 0; testCase < NUMBER_OF_CASES; testCase++)
+        failures += runCase(&magCalCases[testCase]);
+
+    printf("%u cases, %d failed\n", (unsigned)NUMBER_OF_CASES, failures);
+
+    return failures ? 1 : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
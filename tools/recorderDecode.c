@@ -0,0 +1,234 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+// Flight Recorder Decoder
+//
+// Host side decoder for the flight recorder dump (flightRecorder.c, CLI 'X'),
+// writes one CSV row per 500 Hz record in engineering units.  Any text in
+// the capture before the "FFRC" header is skipped.
+//
+//   gcc -O2 -o recorderDecode recorderDecode.c
+//   recorderDecode capture.bin > flight.csv
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define RECORDER_VERSION 1
+#define MAX_GROUPS       16
+#define MAX_FIELDS       64
+
+static const char *groupNames[] = { "gyro", "accel", "attitude", "rateCmd", "ratePID", "motor", "rxCommand" };
+
+static const char *axisNames[]  = { "Roll", "Pitch", "Yaw" };
+static const char *accelNames[] = { "X", "Y", "Z" };
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void fieldName(int group, int index, char *name, size_t size)
+{
+    const char *groupName = (group < (int)(sizeof(groupNames) / sizeof(groupNames[0]))) ? groupNames[group] : "group";
+
+    if ((group == 1) && (index < 3))
+        snprintf(name, size, "%s%s", groupName, accelNames[index]);
+    else if ((group <= 4) && (index < 3))
+        snprintf(name, size, "%s%s", groupName, axisNames[index]);
+    else
+        snprintf(name, size, "%s%d", groupName, index + 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char *argv[])
+{
+    FILE     *in = stdin;
+    uint8_t  *data;
+    long      size, capacity = 65536, start;
+    int       groups, blocks, trigger, blockSize, period;
+    int       groupCount[MAX_GROUPS];
+    float     groupScale[MAX_GROUPS];
+    float     scale[MAX_FIELDS];
+    int16_t   value[MAX_FIELDS];
+    uint32_t  triggerTime;
+    int       fields = 0, g, i, b;
+    const uint8_t *p;
+
+    static const char *triggerNames[] = { "none", "disarm", "crash", "EVR" };
+
+    if ((argc > 1) && ((in = fopen(argv[1], "rb")) == NULL))
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    data = malloc(capacity);
+
+    for (size = 0; !feof(in); )
+    {
+        if (size == capacity)
+            data = realloc(data, capacity *= 2);
+
+        size += fread(&data[size], 1, capacity - size, in);
+    }
+
+    for (start = 0; start + 4 <= size; start++)
+        if (memcmp(&data[start], "FFRC", 4) == 0)
+            break;
+
+    if (start + 16 > size)
+    {
+        fprintf(stderr, "No flight recorder header found\n");
+        return 1;
+    }
+
+    p = &data[start + 4];
+
+    if (p[0] != RECORDER_VERSION)
+    {
+        fprintf(stderr, "Recorder version %d, this decoder reads %d\n", p[0], RECORDER_VERSION);
+        return 1;
+    }
+
+    groups    = p[1];
+    blocks    = p[2];
+    trigger   = p[3];
+    blockSize = p[4] | (p[5] << 8);
+    period    = p[6] | (p[7] << 8);
+    memcpy(&triggerTime, &p[8], 4);
+    p += 12;
+
+    if (groups > MAX_GROUPS)
+        return 1;
+
+    for (g = 0; g < groups; g++)
+    {
+        groupCount[g] = p[0];
+        memcpy(&groupScale[g], &p[1], 4);
+        p += 5;
+
+        for (i = 0; i < groupCount[g]; i++)
+        {
+            if (fields >= MAX_FIELDS)
+                return 1;
+
+            scale[fields++] = groupScale[g];
+        }
+    }
+
+    if ((p + (long)blocks * blockSize) > (data + size))
+    {
+        fprintf(stderr, "Capture holds %ld of %d blocks\n", (long)((data + size - p) / blockSize), blocks);
+        blocks = (data + size - p) / blockSize;
+    }
+
+    fprintf(stderr, "%d blocks, trigger %s at %lu uSec\n", blocks, (trigger < 4) ? triggerNames[trigger] : "?", (unsigned long)triggerTime);
+
+    printf("timeUs");
+
+    for (g = 0; g < groups; g++)
+    {
+        for (i = 0; i < groupCount[g]; i++)
+        {
+            char name[32];
+
+            fieldName(g, i, name, sizeof(name));
+            printf(",%s", name);
+        }
+    }
+
+    printf("\n");
+
+    for (b = 0; b < blocks; b++, p += blockSize)
+    {
+        const uint8_t *q   = p;
+        const uint8_t *end = p + blockSize;
+        uint32_t       time;
+        uint16_t       records, r;
+
+        memcpy(&time,    &q[0], 4);
+        memcpy(&records, &q[4], 2);
+        memcpy(value,    &q[6], fields * 2);
+        q += 6 + fields * 2;
+
+        for (r = 0; r < records; r++)
+        {
+            if (r > 0)
+            {
+                uint16_t tags;
+                int      field = 0, tag;
+
+                if (q + 2 > end)
+                    break;
+
+                tags = q[0] | (q[1] << 8);
+                q += 2;
+
+                for (g = 0; g < groups; g++)
+                {
+                    tag = (tags >> (g * 2)) & 3;
+
+                    for (i = 0; i < groupCount[g]; i++)
+                    {
+                        int16_t delta = 0;
+
+                        if (tag == 1)
+                            delta = ((((i & 1) ? (q[i / 2] >> 4) : q[i / 2]) & 0x0F) ^ 8) - 8;
+                        else if (tag == 2)
+                            delta = (int8_t)q[i];
+                        else if (tag == 3)
+                            delta = (int16_t)(q[2 * i] | (q[2 * i + 1] << 8));
+
+                        value[field + i] = (int16_t)(value[field + i] + delta);
+                    }
+
+                    q     += (tag == 1) ? (groupCount[g] + 1) / 2 : (tag == 2) ? groupCount[g] : (tag == 3) ? 2 * groupCount[g] : 0;
+                    field += groupCount[g];
+                }
+            }
+
+            printf("%lu", (unsigned long)(time + (uint32_t)r * period));
+
+            for (i = 0; i < fields; i++)
+                printf(",%.6g", value[i] / scale[i]);
+
+            printf("\n");
+        }
+    }
+
+    free(data);
+
+    return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,214 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Test Board
+//
+// Stands in for src/board.h so the serial receiver drivers build on the
+// host.  USART2 and its receive DMA channel are modelled in rxTest.c, the
+// capture bytes land in the driver's DMA buffer and the idle line handler
+// is called at the end of each burst.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+typedef volatile uint8_t semaphore_t;
+
+#define MINCOMMAND  2000
+#define MAXCOMMAND  4000
+
+enum { PPM, SPEKTRUM, SBUS, MAVLINK_RC };
+
+#define NUMBER_OF_RECEIVER_TYPES 4
+
+typedef struct eepromConfig_t
+{
+    uint8_t slaveSpektrum;
+} eepromConfig_t;
+
+extern eepromConfig_t eepromConfig;
+
+///////////////////////////////////////////////////////////////////////////////
+
+uint32_t micros(void);
+void     delay(unsigned long ms);
+void     delayMicroseconds(uint32_t us);
+
+// The cycle counter does not run on the host, rxTest times with the host clock
+
+extern volatile uint32_t simCycleCounter;
+
+#define DWT_CYCCNT  (&simCycleCounter)
+
+///////////////////////////////////////////////////////////////////////////////
+// StdPeriph Subset
+///////////////////////////////////////////////////////////////////////////////
+
+enum { RESET = 0, SET = 1 };
+enum { DISABLE = 0, ENABLE = 1 };
+
+typedef struct { int dummy; } GPIO_TypeDef;
+typedef struct { int dummy; } TIM_TypeDef;
+
+typedef struct
+{
+    volatile uint32_t CCR;
+    volatile uint32_t CNDTR;
+} DMA_Channel_TypeDef;
+
+typedef struct
+{
+    volatile uint16_t SR;
+    volatile uint16_t DR;
+} USART_TypeDef;
+
+extern GPIO_TypeDef        simGPIOA;
+extern TIM_TypeDef         simTIM2;
+extern DMA_Channel_TypeDef simDMA1_Channel6;
+extern USART_TypeDef       simUSART2;
+
+#define GPIOA          (&simGPIOA)
+#define TIM2           (&simTIM2)
+#define DMA1_Channel6  (&simDMA1_Channel6)
+#define USART2         (&simUSART2)
+
+#define GPIO_Pin_0  0x0001
+#define GPIO_Pin_1  0x0002
+#define GPIO_Pin_3  0x0008
+
+enum { GPIO_Mode_IN_FLOATING, GPIO_Mode_IPU, GPIO_Mode_Out_PP };
+enum { GPIO_Speed_50MHz };
+
+typedef struct
+{
+    uint16_t GPIO_Pin;
+    int      GPIO_Speed;
+    int      GPIO_Mode;
+} GPIO_InitTypeDef;
+
+enum { USART2_IRQn = 38 };
+
+typedef struct
+{
+    uint8_t NVIC_IRQChannel;
+    uint8_t NVIC_IRQChannelPreemptionPriority;
+    uint8_t NVIC_IRQChannelSubPriority;
+    int     NVIC_IRQChannelCmd;
+} NVIC_InitTypeDef;
+
+typedef struct
+{
+    uint32_t USART_BaudRate;
+    uint16_t USART_WordLength;
+    uint16_t USART_StopBits;
+    uint16_t USART_Parity;
+    uint16_t USART_Mode;
+    uint16_t USART_HardwareFlowControl;
+} USART_InitTypeDef;
+
+#define USART_WordLength_8b                  0x0000
+#define USART_WordLength_9b                  0x1000
+#define USART_StopBits_1                     0x0000
+#define USART_StopBits_2                     0x2000
+#define USART_Parity_No                      0x0000
+#define USART_Parity_Even                    0x0400
+#define USART_Mode_Rx                        0x0004
+#define USART_HardwareFlowControl_None       0x0000
+#define USART_DMAReq_Rx                      0x0040
+#define USART_IT_IDLE                        0x0424
+
+#define USART_SR_PE                          0x0001
+#define USART_SR_FE                          0x0002
+#define USART_SR_NE                          0x0004
+
+// Addresses are passed as uint32_t, as on the F103, so the tests are
+// linked -no-pie to keep the driver buffers below 4 GBytes
+
+typedef struct
+{
+    uint32_t DMA_PeripheralBaseAddr;
+    uint32_t DMA_MemoryBaseAddr;
+    uint32_t DMA_DIR;
+    uint32_t DMA_BufferSize;
+    uint32_t DMA_PeripheralInc;
+    uint32_t DMA_MemoryInc;
+    uint32_t DMA_PeripheralDataSize;
+    uint32_t DMA_MemoryDataSize;
+    uint32_t DMA_Mode;
+    uint32_t DMA_Priority;
+    uint32_t DMA_M2M;
+} DMA_InitTypeDef;
+
+#define DMA_DIR_PeripheralSRC            0x0000
+#define DMA_PeripheralInc_Disable        0x0000
+#define DMA_MemoryInc_Enable             0x0080
+#define DMA_PeripheralDataSize_Byte      0x0000
+#define DMA_MemoryDataSize_Byte          0x0000
+#define DMA_Mode_Circular                0x0020
+#define DMA_Priority_Medium              0x1000
+#define DMA_M2M_Disable                  0x0000
+
+#define TIM_IT_CC2  0x0004
+#define TIM_IT_CC3  0x0008
+
+void    GPIO_Init(GPIO_TypeDef *gpio, GPIO_InitTypeDef *init);
+void    GPIO_SetBits(GPIO_TypeDef *gpio, uint16_t pins);
+void    GPIO_ResetBits(GPIO_TypeDef *gpio, uint16_t pins);
+uint8_t GPIO_ReadInputDataBit(GPIO_TypeDef *gpio, uint16_t pin);
+void    NVIC_Init(NVIC_InitTypeDef *init);
+void    USART_Init(USART_TypeDef *usart, USART_InitTypeDef *init);
+void    USART_DMACmd(USART_TypeDef *usart, uint16_t request, int state);
+void    USART_ITConfig(USART_TypeDef *usart, uint16_t it, int state);
+void    USART_Cmd(USART_TypeDef *usart, int state);
+void    DMA_DeInit(DMA_Channel_TypeDef *channel);
+void    DMA_Init(DMA_Channel_TypeDef *channel, DMA_InitTypeDef *init);
+void    DMA_Cmd(DMA_Channel_TypeDef *channel, int state);
+void    TIM_ITConfig(TIM_TypeDef *tim, uint16_t it, int state);
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "evr.h"
+#include "watchdogs.h"
+
+#include "drv_rxCommon.h"
+#include "drv_sbus.h"
+#include "drv_softSerial.h"
+#include "drv_spektrum.h"
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,678 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+// Receiver Test
+//
+// Replays receiver byte streams through the Spektrum and SBUS serial
+// receiver drivers on the host.  Each burst of a capture is written into the
+// driver's receive DMA buffer, or the soft serial buffer for a slave
+// satellite, and the idle line handler is called with the burst's time,
+// as the USART2 interrupt would.  The frame the driver then passes to
+// rcFrameComplete(), or the lack of one, is checked against the capture.
+//
+//   gcc -O2 -no-pie -Wno-pointer-to-int-cast -Itools/rxTest -I- -Isrc -Isrc/drv
+//       -o rxTest tools/rxTest/rxTest.c src/drv/drv_spektrum.c src/drv/drv_sbus.c
+//
+//   rxTest [-s spektrum capture]... [-b sbus capture]... [-n sbus benchmark frames]
+//
+//   rxTest -s tools/rxTest/spektrumDsm2_22ms.txt -s tools/rxTest/spektrumDsmx_11ms.txt
+//          -s tools/rxTest/spektrumDsmx_22ms.txt
+//          -b tools/rxTest/sbusFutaba_7ms.txt -b tools/rxTest/sbus2_14ms.txt -n 1000000
+//
+// Capture files are text, one burst or check per line, # starts a comment
+//
+//   <time uSec> <P primary | S slave satellite>[/PE|/FE|/NE] <burst bytes, hex>
+//   = <channel mask, hex> <values of the masked channels, lowest first>
+//   = invalid <channel mask, hex> <values>     frame passed on as not valid
+//   = none
+//   ! <counter> <value>
+//
+// /PE, /FE and /NE are USART error flags raised during the burst.  An = line
+// follows every burst.  Counters are the driver statistics, for Spektrum
+// frames, bad, duplicates, overruns, fades, system (hex), slavebad and
+// slavefades, frames counting every 16 byte burst the parser sees, and for
+// SBUS frames, bad, lost, failsafe, overruns and flags (hex).
+//
+// The SBUS benchmark feeds frames through the DMA buffer, idle line and
+// sbusProcess() and reports the host time per frame.
+//
+// -I- keeps the sources' own directory from supplying the real board.h.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "board.h"
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <time.h>
+#include <unistd.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+GPIO_TypeDef        simGPIOA;
+TIM_TypeDef         simTIM2;
+DMA_Channel_TypeDef simDMA1_Channel6;
+USART_TypeDef       simUSART2;
+
+eepromConfig_t eepromConfig;
+
+volatile uint32_t simCycleCounter = 0;
+
+static uint32_t simTime = 0;
+
+static int failures = 0;
+
+static volatile uint8_t *dmaBuffer = NULL;  // Receive buffer handed to DMA1 Channel 6
+static uint16_t          dmaSize   = 0;
+static uint16_t          dmaHead   = 0;
+
+volatile uint8_t softSerialBuffer[SOFT_SERIAL_BUFFER_SIZE];
+volatile uint8_t softSerialHead = 0;
+
+static void (*softSerialIdle)(uint8_t head) = NULL;
+
+///////////////////////////////////////
+
+// Frames passed on by the driver since the last burst
+
+static struct
+{
+    uint32_t count;
+    uint32_t time;
+    uint32_t channels;
+    uint8_t  valid;
+    uint16_t value[32];
+} rcFrame;
+
+///////////////////////////////////////////////////////////////////////////////
+// Firmware Hooks
+///////////////////////////////////////////////////////////////////////////////
+
+uint32_t micros(void)
+{
+    return simTime;
+}
+
+void delay(unsigned long ms)
+{
+    simTime += ms * 1000;
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    simTime += us;
+}
+
+void evrPush(uint16_t evr, uint16_t reason)
+{
+    (void)evr;
+    (void)reason;
+}
+
+int watchDogRegister(uint32_t *hnd, uint32_t timeout, timeout_fp fp, int enabled)
+{
+    (void)timeout;
+    (void)fp;
+    (void)enabled;
+
+    *hnd = 0;
+
+    return 0;
+}
+
+void watchDogReset(uint32_t hnd)
+{
+    (void)hnd;
+}
+
+void rxIsrStatsReset(void)
+{
+}
+
+void softSerialInit(uint32_t baudRate, void (*idleCallback)(uint8_t head))
+{
+    (void)baudRate;
+
+    softSerialHead = 0;
+    softSerialIdle = idleCallback;
+}
+
+void rcFrameComplete(uint32_t frameTime, uint32_t channels, uint8_t valid, const uint16_t *values)
+{
+    uint8_t channel;
+
+    rcFrame.count++;
+    rcFrame.time     = frameTime;
+    rcFrame.channels = channels;
+    rcFrame.valid    = valid;
+
+    for (channel = 0; channel < 32; channel++)
+        if (channels & (1UL << channel))
+            rcFrame.value[channel] = values[channel];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// StdPeriph Subset
+///////////////////////////////////////////////////////////////////////////////
+
+void    GPIO_Init(GPIO_TypeDef *gpio, GPIO_InitTypeDef *init)             { (void)gpio; (void)init; }
+void    GPIO_SetBits(GPIO_TypeDef *gpio, uint16_t pins)                   { (void)gpio; (void)pins; }
+void    GPIO_ResetBits(GPIO_TypeDef *gpio, uint16_t pins)                 { (void)gpio; (void)pins; }
+uint8_t GPIO_ReadInputDataBit(GPIO_TypeDef *gpio, uint16_t pin)           { (void)gpio; (void)pin; return SET; }
+void    NVIC_Init(NVIC_InitTypeDef *init)                                 { (void)init; }
+void    USART_Init(USART_TypeDef *usart, USART_InitTypeDef *init)         { (void)usart; (void)init; }
+void    USART_DMACmd(USART_TypeDef *usart, uint16_t request, int state)   { (void)usart; (void)request; (void)state; }
+void    USART_ITConfig(USART_TypeDef *usart, uint16_t it, int state)      { (void)usart; (void)it; (void)state; }
+void    USART_Cmd(USART_TypeDef *usart, int state)                        { (void)usart; (void)state; }
+void    DMA_DeInit(DMA_Channel_TypeDef *channel)                          { (void)channel; }
+void    DMA_Cmd(DMA_Channel_TypeDef *channel, int state)                  { (void)channel; (void)state; }
+void    TIM_ITConfig(TIM_TypeDef *tim, uint16_t it, int state)            { (void)tim; (void)it; (void)state; }
+
+void DMA_Init(DMA_Channel_TypeDef *channel, DMA_InitTypeDef *init)
+{
+    dmaBuffer = (volatile uint8_t *)(uintptr_t)init->DMA_MemoryBaseAddr;
+    dmaSize   = init->DMA_BufferSize;
+    dmaHead   = 0;
+
+    channel->CNDTR = dmaSize;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// USART2 Receive, the burst is written by DMA1 Channel 6
+///////////////////////////////////////////////////////////////////////////////
+
+static void usartReceive(const uint8_t *bytes, int length)
+{
+    int index;
+
+    for (index = 0; index < length; index++)
+    {
+        dmaBuffer[dmaHead] = bytes[index];
+        dmaHead = (dmaHead + 1) % dmaSize;
+    }
+
+    DMA1_Channel6->CNDTR = dmaSize - dmaHead;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Spektrum
+///////////////////////////////////////////////////////////////////////////////
+
+static void spektrumReset(void)
+{
+    eepromConfig.slaveSpektrum = true;
+
+    spektrumInit();
+}
+
+///////////////////////////////////////
+
+static void spektrumBurst(char receiver, uint16_t status, const uint8_t *bytes, int length)
+{
+    int index;
+
+    (void)status;  // The Spektrum driver does not check the USART error flags
+
+    if (receiver == 'S')
+    {
+        for (index = 0; index < length; index++)
+        {
+            softSerialBuffer[softSerialHead] = bytes[index];
+            softSerialHead = (softSerialHead + 1) & (SOFT_SERIAL_BUFFER_SIZE - 1);
+        }
+
+        softSerialIdle(softSerialHead);
+    }
+    else
+    {
+        usartReceive(bytes, length);
+
+        spektrumUsartIdle();
+    }
+
+    if (spektrumFrameReady == true)
+        spektrumProcess();
+}
+
+///////////////////////////////////////
+
+static int spektrumCounter(const char *name, uint32_t *value)
+{
+    if      (strcmp(name, "frames")     == 0) *value = primarySpektrumState.frameCnt + slaveSpektrumState.frameCnt;
+    else if (strcmp(name, "bad")        == 0) *value = primarySpektrumState.badFrameCnt;
+    else if (strcmp(name, "duplicates") == 0) *value = primarySpektrumState.duplicateCnt + slaveSpektrumState.duplicateCnt;
+    else if (strcmp(name, "overruns")   == 0) *value = primarySpektrumState.overrunCnt + slaveSpektrumState.overrunCnt;
+    else if (strcmp(name, "fades")      == 0) *value = primarySpektrumState.lostFrameCnt;
+    else if (strcmp(name, "system")     == 0) *value = spektrumSystem;
+    else if (strcmp(name, "slavebad")   == 0) *value = slaveSpektrumState.badFrameCnt;
+    else if (strcmp(name, "slavefades") == 0) *value = slaveSpektrumState.lostFrameCnt;
+    else return 0;
+
+    return 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SBUS
+///////////////////////////////////////////////////////////////////////////////
+
+static void sbusReset(void)
+{
+    sbusInit();
+}
+
+///////////////////////////////////////
+
+static void sbusBurst(char receiver, uint16_t status, const uint8_t *bytes, int length)
+{
+    (void)receiver;
+
+    usartReceive(bytes, length);
+
+    sbusUsartIdle(status);
+
+    if (sbusFrameReady == true)
+        sbusProcess();
+}
+
+///////////////////////////////////////
+
+static int sbusCounter(const char *name, uint32_t *value)
+{
+    if      (strcmp(name, "frames")   == 0) *value = sbusState.frameCnt;
+    else if (strcmp(name, "bad")      == 0) *value = sbusState.badFrameCnt;
+    else if (strcmp(name, "lost")     == 0) *value = sbusState.lostFrameCnt;
+    else if (strcmp(name, "failsafe") == 0) *value = sbusState.failsafeCnt;
+    else if (strcmp(name, "overruns") == 0) *value = sbusState.overrunCnt;
+    else if (strcmp(name, "flags")    == 0) *value = sbusState.flags;
+    else return 0;
+
+    return 1;
+}
+
+///////////////////////////////////////
+
+// Frames through the DMA buffer, idle line and decode, timed on the host
+// clock.  The channel values change every frame so no decode is skipped.
+
+static void sbusThroughput(uint32_t frames)
+{
+    uint8_t         frame[25];
+    uint8_t         mismatches;
+    uint32_t        index, channel, bits, bitCnt, byte;
+    struct timespec start, end;
+    double          seconds;
+
+    sbusInit();
+
+    rcFrame.count = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (index = 0; index < frames; index++)
+    {
+        frame[0]  = 0x0F;
+        frame[23] = 0x00;
+        frame[24] = 0x00;
+
+        bits   = 0;
+        bitCnt = 0;
+        byte   = 1;
+
+        for (channel = 0; channel < 16; channel++)
+        {
+            bits   |= ((172 + index + channel * 97) & 0x07FF) << bitCnt;
+            bitCnt += 11;
+
+            while (bitCnt >= 8)
+            {
+                frame[byte++] = (uint8_t)bits;
+                bits   >>= 8;
+                bitCnt  -= 8;
+            }
+        }
+
+        simTime += 7000;
+
+        sbusBurst('P', 0, frame, sizeof(frame));
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1.0e-9;
+
+    printf("SBUS benchmark: %u frames, %.1f nSec per frame including packing, %.0f frames per second\n",
+           rcFrame.count, seconds * 1.0e9 / frames, frames / seconds);
+
+    if (rcFrame.count != frames)
+    {
+        printf("FAIL SBUS benchmark: %u of %u frames decoded\n", rcFrame.count, frames);
+        failures++;
+    }
+
+    // The firmware's own decode benchmark checks its full scale ramp
+
+    sbusBenchmark(1, &mismatches);
+
+    if (mismatches != 0)
+    {
+        printf("FAIL sbusBenchmark: %u channel mismatches\n", mismatches);
+        failures++;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Capture Replay
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct rxProtocol_t
+{
+    const char *name;
+    const char *receivers;  // Receiver letters a burst may carry
+    void      (*reset)(void);
+    void      (*burst)(char receiver, uint16_t status, const uint8_t *bytes, int length);
+    int       (*counter)(const char *name, uint32_t *value);
+} rxProtocol_t;
+
+static const rxProtocol_t spektrumProtocol = { "Spektrum", "PS", spektrumReset, spektrumBurst, spektrumCounter };
+static const rxProtocol_t sbusProtocol     = { "SBUS",     "P",  sbusReset,     sbusBurst,     sbusCounter };
+
+static uint32_t timeBase = 0;
+
+///////////////////////////////////////
+
+static void fail(const char *fileName, int line, const char *format, ...) __attribute__((format(printf, 3, 4)));
+
+static void fail(const char *fileName, int line, const char *format, ...)
+{
+    va_list args;
+
+    if (failures < 30)
+    {
+        printf("FAIL %s:%d: ", fileName, line);
+
+        va_start(args, format);
+        vprintf(format, args);
+        va_end(args);
+
+        printf("\n");
+    }
+
+    failures++;
+}
+
+///////////////////////////////////////
+
+static int replay(const rxProtocol_t *protocol, const char *fileName)
+{
+    FILE    *file;
+    char     text[512], name[32], number[32], *token, *end;
+    uint8_t  bytes[128];
+    uint32_t burstTime = 0, lastTime = 0, value, expected, mask;
+    uint32_t bursts = 0, frames = 0, checks = 0;
+    int      line = 0, length, channel, pendingBurst = 0, startFailures = failures;
+    char     receiver;
+    uint16_t status;
+
+    if ((file = fopen(fileName, "r")) == NULL)
+    {
+        perror(fileName);
+        return 0;
+    }
+
+    protocol->reset();
+
+    while (fgets(text, sizeof(text), file) != NULL)
+    {
+        line++;
+
+        token = text;
+
+        while (isspace((unsigned char)*token))
+            token++;
+
+        if ((*token == '\0') || (*token == '#'))
+            continue;
+
+        if (isdigit((unsigned char)*token))
+        {
+            // Burst, the idle line comes at its time
+
+            if (pendingBurst)
+                fail(fileName, line, "no = line after the burst on line %d", pendingBurst);
+
+            burstTime = timeBase + strtoul(token, &end, 10);
+            token     = end;
+
+            while (isspace((unsigned char)*token))
+                token++;
+
+            receiver = *token++;
+            status   = 0;
+
+            if (strchr(protocol->receivers, receiver) == NULL)
+            {
+                fail(fileName, line, "unknown receiver '%c'", receiver);
+                continue;
+            }
+
+            while (*token == '/')
+            {
+                if      (strncmp(token, "/PE", 3) == 0) status |= USART_SR_PE;
+                else if (strncmp(token, "/FE", 3) == 0) status |= USART_SR_FE;
+                else if (strncmp(token, "/NE", 3) == 0) status |= USART_SR_NE;
+                else
+                {
+                    fail(fileName, line, "unknown USART flag");
+                    break;
+                }
+
+                token += 3;
+            }
+
+            for (length = 0; length < (int)sizeof(bytes); length++)
+            {
+                value = strtoul(token, &end, 16);
+
+                if (end == token)
+                    break;
+
+                bytes[length] = (uint8_t)value;
+                token = end;
+            }
+
+            rcFrame.count = 0;
+            simTime       = burstTime;
+            lastTime      = burstTime;
+
+            protocol->burst(receiver, status, bytes, length);
+
+            pendingBurst = line;
+            bursts++;
+        }
+        else if (*token == '=')
+        {
+            // Expected frame, or none
+
+            token++;
+
+            if (pendingBurst == 0)
+            {
+                fail(fileName, line, "= line without a burst");
+                continue;
+            }
+
+            pendingBurst = 0;
+            checks++;
+
+            while (isspace((unsigned char)*token))
+                token++;
+
+            if (strncmp(token, "none", 4) == 0)
+            {
+                if (rcFrame.count != 0)
+                    fail(fileName, line, "no frame expected, got mask %04X", rcFrame.channels);
+
+                continue;
+            }
+
+            expected = 1;
+
+            if (strncmp(token, "invalid", 7) == 0)
+            {
+                expected = 0;
+                token   += 7;
+            }
+
+            mask = strtoul(token, &token, 16);
+
+            if (rcFrame.count != 1)
+            {
+                fail(fileName, line, "expected one frame, got %u", rcFrame.count);
+                continue;
+            }
+
+            frames++;
+
+            if (rcFrame.valid != expected)
+                fail(fileName, line, "frame valid %u, expected %u", rcFrame.valid, expected);
+
+            if (rcFrame.time != burstTime)
+                fail(fileName, line, "frame time %u, expected %u", rcFrame.time, burstTime);
+
+            if (rcFrame.channels != mask)
+                fail(fileName, line, "channel mask %04X, expected %04X", rcFrame.channels, mask);
+
+            for (channel = 0; channel < 32; channel++)
+            {
+                if ((mask & (1UL << channel)) == 0)
+                    continue;
+
+                value = strtoul(token, &end, 10);
+
+                if (end == token)
+                {
+                    fail(fileName, line, "missing value for channel %d", channel);
+                    break;
+                }
+
+                token = end;
+
+                if ((rcFrame.channels & (1UL << channel)) && (rcFrame.value[channel] != value))
+                    fail(fileName, line, "channel %d is %u, expected %u", channel, rcFrame.value[channel], value);
+            }
+        }
+        else if (*token == '!')
+        {
+            // Driver statistics
+
+            if (sscanf(token + 1, "%31s %31s", name, number) != 2)
+            {
+                fail(fileName, line, "bad ! line");
+                continue;
+            }
+
+            // System and flag bytes are hex like the bursts, counts are decimal
+
+            expected = strtoul(number, NULL, ((strcmp(name, "system") == 0) || (strcmp(name, "flags") == 0)) ? 16 : 10);
+
+            checks++;
+
+            if (protocol->counter(name, &value) == 0)
+                fail(fileName, line, "unknown counter '%s'", name);
+            else if (value != expected)
+                fail(fileName, line, "%s is %u, expected %u", name, value, expected);
+        }
+        else
+        {
+            fail(fileName, line, "unrecognised line");
+        }
+    }
+
+    if (pendingBurst)
+        fail(fileName, line, "no = line after the burst on line %d", pendingBurst);
+
+    fclose(file);
+
+    // Next capture starts a second after this one ends
+
+    timeBase = lastTime + 1000000;
+
+    printf("%s %s: %u bursts, %u frames, %u checks, %d failures\n",
+           protocol->name, fileName, bursts, frames, checks, failures - startFailures);
+
+    return 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char *argv[])
+{
+    const char *usage = "usage: %s [-s spektrum capture]... [-b sbus capture]... [-n sbus benchmark frames]\n";
+    int         option, runs = 0;
+
+    while ((option = getopt(argc, argv, "s:b:n:")) != -1)
+    {
+        switch (option)
+        {
+            case 's':
+                if (replay(&spektrumProtocol, optarg) == 0)
+                    return 1;
+
+                runs++;
+                break;
+
+            case 'b':
+                if (replay(&sbusProtocol, optarg) == 0)
+                    return 1;
+
+                runs++;
+                break;
+
+            case 'n':
+                sbusThroughput(strtoul(optarg, NULL, 10));
+
+                runs++;
+                break;
+
+            default:
+                fprintf(stderr, usage, argv[0]);
+                return 1;
+        }
+    }
+
+    if (runs == 0)
+    {
+        fprintf(stderr, usage, argv[0]);
+        return 1;
+    }
+
+    return failures ? 1 : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
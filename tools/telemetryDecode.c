@@ -0,0 +1,370 @@
+/*
+
+FF32lite from FocusFlight, a new alternative firmware
+for the Naze32 controller
+
+Original work Copyright (c) 2013 John Ihlein
+
+This file is part of FF32lite.
+
+Includes code and/or ideas from:
+
+  1)BaseFlight
+  2)S.O.H. Madgwick
+
+FF32lite is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+FF32lite is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with FF32lite. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+// Binary Telemetry Decoder
+//
+// Host side decoder for the COBS framed telemetry stream (telemetry.c),
+// writes one CSV row per data frame.  Schemas are learned from the stream
+// so nothing here knows about the individual sets.
+//
+//   gcc -O2 -o telemetryDecode telemetryDecode.c
+//   telemetryDecode capture.bin > telemetry.csv
+//   telemetryDecode -p flight < capture.bin     writes flight_<set>.csv per set
+//
+// Without -p the rows of all sets go to stdout, each set's header row is
+// written before its first row and again if its schema changes.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define TELEMETRY_SCHEMA_FRAME  0x01
+#define TELEMETRY_DATA_FRAME    0x02
+
+#define TELEMETRY_HEADER_LENGTH 8
+
+#define MAX_SETS                32
+#define MAX_FIELDS              32
+#define MAX_FRAME               512
+
+typedef struct schema_t
+{
+    int   valid;
+    int   headerWritten;
+    char  name[64];
+    int   fieldCount;
+    char  type[MAX_FIELDS];
+    char  field[MAX_FIELDS][64];
+    FILE *out;
+} schema_t;
+
+static schema_t schemas[MAX_SETS];
+
+static const char *prefix = NULL;
+
+static unsigned long frames, crcErrors, cobsErrors, unknownSet, sequenceGaps;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static uint16_t crc16Ccitt(const uint8_t *buf, int length)
+{
+    uint16_t crc = 0xFFFF;
+
+    while (length--)
+    {
+        crc  = (crc >> 8) | (crc << 8);
+        crc ^= *buf++;
+        crc ^= (crc & 0xFF) >> 4;
+        crc ^= crc << 12;
+        crc ^= (crc & 0xFF) << 5;
+    }
+
+    return crc;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static int cobsDecode(const uint8_t *src, int length, uint8_t *dst)
+{
+    int in = 0, out = 0, code, i;
+
+    while (in < length)
+    {
+        code = src[in++];
+
+        if (code == 0)
+            return -1;
+
+        for (i = 1; i < code; i++)
+        {
+            if (in >= length)
+                return -1;
+
+            dst[out++] = src[in++];
+        }
+
+        if ((code < 0xFF) && (in < length))
+            dst[out++] = 0;
+    }
+
+    return out;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static int fieldSize(char type)
+{
+    switch (type)
+    {
+        case 'f': case 'l': return 4;
+        case 'h':           return 2;
+        case 'B':           return 1;
+        default:            return -1;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void parseSchema(int set, const uint8_t *payload, int length)
+{
+    schema_t    s;
+    const char *p   = (const char *)payload;
+    const char *end = (const char *)payload + length;
+    int         i;
+
+    memset(&s, 0, sizeof(s));
+
+    if (memchr(p, 0, end - p) == NULL)
+        return;
+
+    snprintf(s.name, sizeof(s.name), "%.63s", p);
+    p += strlen(p) + 1;
+
+    if (p >= end)
+        return;
+
+    s.fieldCount = (uint8_t)*p++;
+
+    if (s.fieldCount > MAX_FIELDS)
+        return;
+
+    for (i = 0; i < s.fieldCount; i++)
+    {
+        if ((p >= end) || (fieldSize(*p) < 0) || (memchr(p + 1, 0, end - p - 1) == NULL))
+            return;
+
+        s.type[i] = *p++;
+        snprintf(s.field[i], sizeof(s.field[i]), "%.63s", p);
+        p += strlen(p) + 1;
+    }
+
+    s.valid = 1;
+
+    // Same schema again, keep the header state and output file
+
+    if (schemas[set].valid && (schemas[set].fieldCount == s.fieldCount) &&
+        (strcmp(schemas[set].name, s.name) == 0) &&
+        (memcmp(schemas[set].type, s.type, sizeof(s.type)) == 0) &&
+        (memcmp(schemas[set].field, s.field, sizeof(s.field)) == 0))
+        return;
+
+    s.out = schemas[set].out;
+
+    if (prefix != NULL)
+    {
+        char fileName[256];
+
+        if (s.out != NULL)
+            fclose(s.out);
+
+        snprintf(fileName, sizeof(fileName), "%s_%s.csv", prefix, s.name);
+
+        if ((s.out = fopen(fileName, "w")) == NULL)
+        {
+            perror(fileName);
+            exit(1);
+        }
+    }
+    else
+    {
+        s.out = stdout;
+    }
+
+    schemas[set] = s;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void writeRow(int set, uint16_t sequence, uint32_t time, const uint8_t *payload, int length)
+{
+    schema_t *s = &schemas[set];
+    int       i, size, offset = 0;
+
+    for (i = 0; i < s->fieldCount; i++)
+        offset += fieldSize(s->type[i]);
+
+    if (offset != length)
+    {
+        unknownSet++;
+        return;
+    }
+
+    if (s->headerWritten == 0)
+    {
+        fprintf(s->out, "%ssequence,timeUs", prefix ? "" : "set,");
+
+        for (i = 0; i < s->fieldCount; i++)
+            fprintf(s->out, ",%s", s->field[i]);
+
+        fprintf(s->out, "\n");
+        s->headerWritten = 1;
+    }
+
+    if (prefix == NULL)
+        fprintf(s->out, "%s,", s->name);
+
+    fprintf(s->out, "%u,%lu", sequence, (unsigned long)time);
+
+    for (i = 0, offset = 0; i < s->fieldCount; i++, offset += size)
+    {
+        float    f;
+        int32_t  l;
+        int16_t  h;
+
+        size = fieldSize(s->type[i]);
+
+        switch (s->type[i])
+        {
+            case 'f': memcpy(&f, &payload[offset], 4); fprintf(s->out, ",%.6g", f); break;
+            case 'l': memcpy(&l, &payload[offset], 4); fprintf(s->out, ",%ld", (long)l); break;
+            case 'h': memcpy(&h, &payload[offset], 2); fprintf(s->out, ",%d", h); break;
+            case 'B': fprintf(s->out, ",%u", payload[offset]); break;
+        }
+    }
+
+    fprintf(s->out, "\n");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void processFrame(const uint8_t *encoded, int encodedLength)
+{
+    static int      sequenceValid = 0;
+    static uint16_t expectedSequence;
+
+    uint8_t  frame[MAX_FRAME];
+    int      length;
+    int      set;
+    uint16_t sequence;
+    uint32_t time;
+
+    length = cobsDecode(encoded, encodedLength, frame);
+
+    if (length < 0)
+    {
+        cobsErrors++;
+        return;
+    }
+
+    if (length < TELEMETRY_HEADER_LENGTH + 2)
+        return;
+
+    if (crc16Ccitt(frame, length - 2) != (frame[length - 2] | (frame[length - 1] << 8)))
+    {
+        crcErrors++;
+        return;
+    }
+
+    frames++;
+
+    set      = frame[1];
+    sequence = frame[2] | (frame[3] << 8);
+    time     = frame[4] | (frame[5] << 8) | (frame[6] << 16) | ((uint32_t)frame[7] << 24);
+
+    if (sequenceValid && (sequence != expectedSequence))
+        sequenceGaps++;
+
+    sequenceValid    = 1;
+    expectedSequence = sequence + 1;
+
+    if (set >= MAX_SETS)
+    {
+        unknownSet++;
+        return;
+    }
+
+    if (frame[0] == TELEMETRY_SCHEMA_FRAME)
+        parseSchema(set, &frame[TELEMETRY_HEADER_LENGTH], length - TELEMETRY_HEADER_LENGTH - 2);
+    else if ((frame[0] == TELEMETRY_DATA_FRAME) && schemas[set].valid)
+        writeRow(set, sequence, time, &frame[TELEMETRY_HEADER_LENGTH], length - TELEMETRY_HEADER_LENGTH - 2);
+    else
+        unknownSet++;  // Data before its schema, or a frame type this decoder doesn't know
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char *argv[])
+{
+    FILE    *in = stdin;
+    uint8_t  encoded[MAX_FRAME];
+    int      length = 0;
+    int      c, arg, overflow = 0;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        if ((strcmp(argv[arg], "-p") == 0) && (arg + 1 < argc))
+        {
+            prefix = argv[++arg];
+        }
+        else if (argv[arg][0] == '-')
+        {
+            fprintf(stderr, "usage: %s [-p csvPrefix] [capture.bin]\n", argv[0]);
+            return 1;
+        }
+        else if ((in = fopen(argv[arg], "rb")) == NULL)
+        {
+            perror(argv[arg]);
+            return 1;
+        }
+    }
+
+    // Anything up to the first zero is the tail of a frame we joined late
+
+    while ((c = fgetc(in)) != EOF)
+    {
+        if (c == 0)
+        {
+            if ((length > 0) && !overflow)
+                processFrame(encoded, length);
+
+            length   = 0;
+            overflow = 0;
+        }
+        else if (length < MAX_FRAME)
+        {
+            encoded[length++] = (uint8_t)c;
+        }
+        else
+        {
+            overflow = 1;  // Text telemetry or noise, skip to the next delimiter
+        }
+    }
+
+    fprintf(stderr, "%lu frames, %lu CRC errors, %lu COBS errors, %lu sequence gaps, %lu skipped\n",
+            frames, crcErrors, cobsErrors, sequenceGaps, unknownSet);
+
+    return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////